@@ -263,6 +263,7 @@ using Tag = std::string; // @TODO: Fixed length string
 #define AE_ALLOC_TAG_MESH ae::Tag( "aeMesh" )
 #define AE_ALLOC_TAG_FIXME ae::Tag( "aeFixMe" )
 #define AE_ALLOC_TAG_FILE ae::Tag( "aeFile" )
+#define AE_ALLOC_TAG_STRING ae::Tag( "aeString" )
 
 //------------------------------------------------------------------------------
 //! \defgroup Allocation
@@ -982,6 +983,9 @@ public:
 	
 	explicit Frustum( ae::Matrix4 worldToProjection );
 	bool Intersects( const ae::Sphere& sphere ) const;
+	//! Conservative, boxes near the frustum corners may return true even when
+	//! they are outside.
+	bool Intersects( const class AABB& aabb ) const;
 	bool Intersects( ae::Vec3 point ) const;
 	ae::Plane GetPlane( ae::Frustum::Plane plane ) const;
 	
@@ -1259,6 +1263,82 @@ private:
 	double m_frameStart = 0.0;
 };
 
+//------------------------------------------------------------------------------
+// Number formatting and parsing functions
+//------------------------------------------------------------------------------
+// These give exactly the same results as the stdio functions they replace in
+// the "C" locale, but skip stdio and locales in the common case. Like
+// snprintf(), the Format functions return the length of the full result even
+// if it was truncated to fit in the given size.
+
+//! Same as snprintf( buf, size, "%.*f", precision, value )
+uint32_t FormatFloatFixed( char* buf, uint32_t size, double value, uint32_t precision );
+//! Same as snprintf( buf, size, "%.*g", precision, value ), which is also the
+//! format used by std::ostream with std::setprecision()
+uint32_t FormatFloatGeneral( char* buf, uint32_t size, double value, uint32_t precision );
+uint32_t FormatInt( char* buf, uint32_t size, int64_t value );
+uint32_t FormatUint( char* buf, uint32_t size, uint64_t value );
+//! Same as strtof() and strtod(). Leading whitespace is skipped. \p endOut is
+//! set to the first character after the number, or to \p str if there is no
+//! number, in which case 0 is returned.
+float ParseFloat( const char* str, const char** endOut = nullptr );
+double ParseDouble( const char* str, const char** endOut = nullptr );
+//! Same as strtoll() and strtoull(). A \p base of 0 detects hexadecimal and
+//! octal prefixes like scanf's %i.
+int64_t ParseInt( const char* str, const char** endOut = nullptr, uint32_t base = 10 );
+uint64_t ParseUint( const char* str, const char** endOut = nullptr, uint32_t base = 10 );
+
+//------------------------------------------------------------------------------
+// ae::FormatString class
+//------------------------------------------------------------------------------
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+	#define _AE_CONSTEVAL consteval
+#else
+	#define _AE_CONSTEVAL constexpr
+#endif
+//! Returns the number of '#' placeholders in \p format
+constexpr uint32_t GetFormatArgCount( const char* format )
+{
+	uint32_t count = 0;
+	for ( ; *format; format++ ) { count += ( *format == '#' ); }
+	return count;
+}
+//! Intentionally not constexpr, so calling it from ae::FormatString's
+//! constructor fails to compile
+void _FormatStringArgCountMismatch();
+
+//! The format string of ae::FormatTo(), ae::Str::Format() and the AE_LOG()
+//! family of macros. Each '#' is replaced by the next argument. With C++20 the
+//! number of '#' is checked against the number of arguments at compile time,
+//! otherwise the check is done at runtime in debug builds.
+template < typename... Args >
+class FormatString
+{
+public:
+	_AE_CONSTEVAL FormatString( const char* format ) : m_format( format )
+	{
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+		if ( GetFormatArgCount( format ) != sizeof...(Args) ) { _FormatStringArgCountMismatch(); }
+#endif
+	}
+	const char* c_str() const { return m_format; }
+private:
+	const char* m_format;
+};
+template < typename T > struct _NonDeduced { using Type = T; };
+//! Keeps the types of the format string from being deduced from the format
+//! string itself, so they come from the arguments only
+template < typename... Args > using _FormatStringT = typename _NonDeduced< FormatString< Args... > >::Type;
+
+//! Writes \p format to \p buf replacing each '#' with the next argument. The
+//! output is the same as std::ostream with std::setprecision( 4 ) and
+//! std::boolalpha. Numbers, vectors, matrices and strings are written directly
+//! to \p buf without allocating, other types fall back to their std::ostream
+//! operator. The result is always null terminated. Like snprintf(), returns
+//! the length of the full result even if it was truncated to fit in \p size.
+template < typename... Args >
+uint32_t FormatTo( char* buf, uint32_t size, _FormatStringT< Args... > format, Args... args );
+
 //! \defgroup DataStructures
 //! @{
 
@@ -1276,8 +1356,9 @@ public:
 	Str( const char* str );
 	Str( uint32_t length, const char* str );
 	Str( uint32_t length, char c );
-	template < typename... Args > Str( const char* format, Args... args );
-	template < typename... Args > static Str< N > Format( const char* format, Args... args );
+	template < typename... Args > Str( _FormatStringT< Args... > format, Args... args );
+	template < typename... Args > static Str< N > Format( _FormatStringT< Args... > format, Args... args );
+	static Str< N > Format( const char* str );
 	explicit operator const char*() const;
 	
 	template < uint32_t N2 > void operator =( const Str<N2>& str );
@@ -1321,9 +1402,7 @@ private:
 	template < uint32_t N2 > friend bool operator <=( const char*, const Str< N2 >& );
 	template < uint32_t N2 > friend bool operator >=( const char*, const Str< N2 >& );
 	template < uint32_t N2 > friend std::istream& operator>>( std::istream&, Str< N2 >& );
-	void m_Format( const char* format );
-	template < typename T, typename... Args >
-	void m_Format( const char* format, T value, Args... args );
+	template < typename... Args > void m_Format( const char* format, const Args&... args );
 	uint16_t m_length;
 	char m_str[ MaxLength() + 1u ];
 };
@@ -1335,6 +1414,153 @@ using Str128 = Str< 128 >;
 using Str256 = Str< 256 >;
 using Str512 = Str< 512 >;
 
+//------------------------------------------------------------------------------
+// ae::String class
+//! A dynamic length string, for when the length of a string isn't known ahead
+//! of time. Strings of up to ae::String::kMaxInlineLength characters are stored
+//! inside the ae::String itself, longer strings are allocated with its
+//! ae::Tag. An ae::String is the same size as a std::string. Tags are interned
+//! in a global table, so copies only copy a pointer to their tag. The hash is
+//! updated whenever the string changes, so ae::Map and ae::HashMap don't rehash
+//! keys that are already stored, and const functions never modify the string.
+//------------------------------------------------------------------------------
+class String
+{
+public:
+	static constexpr uint32_t kMaxInlineLength = 15;
+
+	//! Strings constructed without a tag allocate with AE_ALLOC_TAG_STRING
+	String();
+	String( const char* str );
+	template < uint32_t N > String( const Str< N >& str );
+	explicit String( const ae::Tag& tag );
+	String( const ae::Tag& tag, const char* str );
+	String( const ae::Tag& tag, const char* str, uint32_t length );
+	template < uint32_t N > String( const ae::Tag& tag, const Str< N >& str );
+	//! The copy uses the same tag as \p other
+	String( const String& other );
+	String( String&& other ) noexcept;
+	~String();
+
+	//! Assignment keeps the current tag
+	void operator =( const String& other );
+	void operator =( String&& other ) noexcept;
+	void operator =( const char* str );
+	template < uint32_t N > void operator =( const Str< N >& str );
+
+	void operator +=( const String& str );
+	void operator +=( const char* str );
+	template < uint32_t N > void operator +=( const Str< N >& str );
+	void Append( const char* str, uint32_t length );
+
+	bool operator ==( const String& str ) const;
+	bool operator !=( const String& str ) const;
+	bool operator <( const String& str ) const;
+	bool operator ==( const char* str ) const;
+	bool operator !=( const char* str ) const;
+	template < uint32_t N > bool operator ==( const Str< N >& str ) const;
+	template < uint32_t N > bool operator !=( const Str< N >& str ) const;
+
+	char operator[]( uint32_t i ) const;
+	const char* c_str() const;
+	//! Returns a fixed length copy of the string, which must fit in ae::Str< N >
+	template < uint32_t N > Str< N > ToStr() const;
+
+	//! Allocates enough memory for a string of \p length characters
+	void Reserve( uint32_t length );
+	//! Sets the length to zero without releasing any memory
+	void Clear();
+
+	uint32_t Length() const;
+	//! The number of characters that can be stored without allocating
+	uint32_t Size() const;
+	bool Empty() const;
+	//! Same as ae::GetHash( const char* ). Computed on each change.
+	uint32_t GetHash() const;
+	const ae::Tag& GetTag() const;
+
+private:
+	static constexpr uint32_t kInlineSize = kMaxInlineLength + 1u;
+	struct Heap
+	{
+		char* data;
+		uint32_t size; // Includes null terminator
+	};
+	String( const ae::Tag* tag, int );
+	char* m_Data() { return m_isHeap ? m_heap.data : m_inline; }
+	const char* m_Data() const { return m_isHeap ? m_heap.data : m_inline; }
+	uint32_t m_Size() const { return m_isHeap ? m_heap.size : kInlineSize; }
+	void m_Assign( const char* str, uint32_t length );
+	const ae::Tag* m_tag; // Interned
+	uint32_t m_length : 31;
+	uint32_t m_isHeap : 1;
+	uint32_t m_hash;
+	union
+	{
+		Heap m_heap;
+		char m_inline[ kInlineSize ];
+	};
+};
+bool operator ==( const char* str0, const String& str1 );
+bool operator !=( const char* str0, const String& str1 );
+std::ostream& operator<<( std::ostream& os, const String& str );
+
+//------------------------------------------------------------------------------
+// ae::Name class
+//! An interned string. Each unique string is stored once in a global table
+//! and an ae::Name is only a 32 bit handle, so names are copied, compared and
+//! hashed as integers. The handle is the same as ae::GetHash( const char* ),
+//! unless that hash is already used by a different string. In that rare case
+//! the new string is given the next unused hash instead, so every name in the
+//! table stays unique. Adding strings to the table is thread safe.
+//------------------------------------------------------------------------------
+class Name
+{
+public:
+	//! The empty string
+	Name() = default;
+	//! Thread safe. Adds \p str to the table if it's not already there.
+	Name( const char* str );
+	template < uint32_t N > Name( const Str< N >& str ) : Name( str.c_str() ) {}
+	Name( const ae::String& str ) : Name( str.c_str() ) {}
+	//! Returns the name of \p str without adding it to the table. This can be
+	//! done at compile time, eg. static constexpr ae::Name kIdle =
+	//! ae::Name::Hashed( "Idle" ). c_str() returns an empty string for these
+	//! names unless the same string was also added to the table. If \p str
+	//! was given a different hash because of a collision the result matches
+	//! the other string instead, so use Find() for runtime strings.
+	static constexpr Name Hashed( const char* str ) { return Name( m_Hash( str ), 0 ); }
+	//! Thread safe. Returns the name of \p str without adding it to the table.
+	//! If \p str isn't in the table the result doesn't match any name that is.
+	static Name Find( const char* str );
+
+	constexpr bool operator ==( Name other ) const { return m_hash == other.m_hash; }
+	constexpr bool operator !=( Name other ) const { return m_hash != other.m_hash; }
+	//! Same as comparing with Find( \p str ), so \p str is not added to the table
+	bool operator ==( const char* str ) const { return *this == Find( str ); }
+	bool operator !=( const char* str ) const { return *this != Find( str ); }
+	//! Orders names by hash, not alphabetically
+	constexpr bool operator <( Name other ) const { return m_hash < other.m_hash; }
+
+	//! Thread safe. The result is valid for the lifetime of the program.
+	const char* c_str() const;
+	constexpr bool Empty() const { return m_hash == kEmptyHash; }
+	constexpr uint32_t GetHash() const { return m_hash; }
+
+private:
+	static constexpr uint32_t kEmptyHash = 0x811c9dc5;
+	constexpr Name( uint32_t hash, int ) : m_hash( hash ) {}
+	//! Same as ae::Hash::HashString(), but usable at compile time
+	static constexpr uint32_t m_Hash( const char* str )
+	{
+		uint32_t hash = kEmptyHash;
+		for ( ; *str; str++ ) { hash = ( hash ^ str[ 0 ] ) * 0x1000193; }
+		return hash;
+	}
+	uint32_t m_hash = kEmptyHash;
+};
+std::ostream& operator<<( std::ostream& os, ae::Name name );
+
 //------------------------------------------------------------------------------
 // ae::Pair class
 //------------------------------------------------------------------------------
@@ -1663,10 +1889,21 @@ private:
 //------------------------------------------------------------------------------
 // ae::Dict class
 //------------------------------------------------------------------------------
+//! Stores values natively by the type they were set with, and only converts
+//! them to and from strings when they are read as another type. Each entry
+//! owns the storage for its string value, so strings returned by GetString()
+//! and GetValue() stay valid until that key is set again or the ae::Dict is
+//! cleared or destroyed. Keys are looked up by hash and compared in full, so
+//! keys with the same hash are still stored separately. Because non-string
+//! values are formatted and cached on demand, the const getters are not safe
+//! to call from multiple threads at once.
 class Dict
 {
 public:
 	Dict( ae::Tag tag );
+	Dict( const Dict& other );
+	Dict& operator=( const Dict& other );
+	~Dict();
 	void SetString( const char* key, const char* value );
 	void SetString( const char* key, char* value ) { SetString( key, (const char*)value ); }
 	void SetInt( const char* key, int32_t value );
@@ -1695,14 +1932,10 @@ public:
 	bool Has( const char* key ) const;
 
 	const char* GetKey( uint32_t idx ) const;
+	//! Non-string values are formatted on the first call and the result is
+	//! cached, as with GetString()
 	const char* GetValue( uint32_t idx ) const;
 	uint32_t Length() const { return m_entries.Length(); }
-	
-	// Ranged-based loop. Lowercase to match c++ standard
-	ae::Pair< ae::Str128, ae::Str128 >* begin() { return m_entries.begin(); }
-	ae::Pair< ae::Str128, ae::Str128 >* end() { return m_entries.end(); }
-	const ae::Pair< ae::Str128, ae::Str128 >* begin() const { return m_entries.begin(); }
-	const ae::Pair< ae::Str128, ae::Str128 >* end() const { return m_entries.end(); }
 
 private:
 	Dict() = delete;
@@ -1718,7 +1951,33 @@ private:
 	template < typename T > void SetVec4( const char*, T ) = delete;
 	template < typename T > void SetInt2( const char*, T ) = delete;
 	template < typename T > void SetMatrix4( const char*, T ) = delete;
-	ae::Map< ae::Str128, ae::Str128 > m_entries; // @TODO: Should support static allocation
+	enum class Type : uint8_t { String, Int, Uint, Float, Double, Bool, Vec2, Vec3, Vec4, Int2, Matrix4 };
+	struct Entry
+	{
+		Type type;
+		mutable bool hasString; // False until a non-string value is formatted
+		uint32_t key; // Offset into m_keys
+		mutable char* string; // Owned, reused when the value changes
+		mutable uint32_t stringSize;
+		union
+		{
+			int32_t i;
+			uint32_t u;
+			float f[ 16 ]; // Float, Vec2, Vec3, Vec4 and Matrix4
+			double d;
+			bool b;
+			int32_t i2[ 2 ];
+		};
+	};
+	Entry* m_Set( const char* key, Type type );
+	const Entry* m_TryGet( const char* key ) const;
+	const char* m_GetString( const Entry& entry ) const;
+	void m_SetString( const Entry& entry, const char* str ) const;
+	void m_FreeStrings();
+	void m_CopyStrings();
+	ae::Tag m_tag;
+	ae::Map< uint32_t, Entry > m_entries; // Hash of key to entry. @TODO: Should support static allocation
+	ae::Array< char > m_keys; // Only grows until Clear(), keys are never removed
 };
 
 inline std::ostream& operator<<( std::ostream& os, const ae::Dict& dict );
@@ -2278,6 +2537,71 @@ private:
 	ae::Array< BVHLeaf< T >, (N + 1)/2 > m_leaves;
 };
 
+//------------------------------------------------------------------------------
+// ae::AABBTree class
+//------------------------------------------------------------------------------
+//! A dynamic bounding volume hierarchy for objects that are added, moved and
+//! removed at runtime, where ae::BVH must be rebuilt from scratch. Each proxy
+//! stores an aabb grown by a margin, so small movements don't change the tree
+//! at all. Proxies are inserted where they increase the surface area of the
+//! tree the least, and the tree is kept balanced with rotations.
+class AABBTree
+{
+public:
+	//! The aabb of each proxy is grown by \p margin on all sides
+	AABBTree( const ae::Tag& tag, float margin = 0.1f );
+	//! Adds a proxy and returns its id. Ids are stable until Remove().
+	int32_t Add( const ae::AABB& aabb, void* userData );
+	//! Updates the bounds of an existing proxy. Returns true if the proxy was
+	//! reinserted, or false if \p aabb is still inside its grown aabb.
+	bool Set( int32_t proxy, const ae::AABB& aabb );
+	void Remove( int32_t proxy );
+	void Clear();
+
+	//! Calls \p fn with the signature void()( int32_t proxy, void* userData )
+	//! for each proxy whose grown aabb intersects \p aabb. The tree must not
+	//! be modified from \p fn.
+	template < typename Fn > void Query( const ae::AABB& aabb, Fn fn ) const;
+	//! Calls \p fn with the signature float()( int32_t proxy, void* userData )
+	//! for each proxy whose grown aabb is hit by the segment from \p source to
+	//! \p source + \p ray, nearest first. \p fn returns the fraction of \p ray
+	//! to keep searching (eg. the fraction of the closest hit so far), 1 to
+	//! continue unchanged, or 0 to stop. The tree must not be modified from
+	//! \p fn.
+	template < typename Fn > void Raycast( ae::Vec3 source, ae::Vec3 ray, Fn fn ) const;
+
+	void* GetUserData( int32_t proxy ) const { return m_nodes[ proxy ].userData; }
+	//! Returns the grown aabb of \p proxy
+	const ae::AABB& GetAABB( int32_t proxy ) const { return m_nodes[ proxy ].aabb; }
+	uint32_t GetCount() const { return m_count; }
+	//! Returns the number of levels in the tree, 0 when empty
+	uint32_t GetHeight() const { return ( m_root >= 0 ) ? m_nodes[ m_root ].height + 1 : 0; }
+
+private:
+	struct Node
+	{
+		bool IsLeaf() const { return child0 < 0; }
+		ae::AABB aabb;
+		void* userData;
+		int32_t parent; // Next free node when unused
+		int32_t child0;
+		int32_t child1;
+		int32_t height; // Leaves are 0, unused nodes are -1
+	};
+	int32_t m_AllocateNode();
+	void m_FreeNode( int32_t index );
+	void m_InsertLeaf( int32_t leaf );
+	void m_RemoveLeaf( int32_t leaf );
+	//! Refits all ancestors of \p index, rebalancing along the way
+	void m_Refit( int32_t index );
+	int32_t m_Balance( int32_t index );
+	float m_margin;
+	int32_t m_root = -1;
+	int32_t m_free = -1;
+	uint32_t m_count = 0;
+	ae::Array< Node > m_nodes;
+};
+
 //------------------------------------------------------------------------------
 // ae::Hash class (fnv1a)
 //! A FNV1a hash utility class. Empty strings and zero-length data buffers do not
@@ -2293,6 +2617,9 @@ public:
 	bool operator != ( Hash o ) const { return m_hash != o.m_hash; }
 
 	Hash& HashString( const char* str );
+	//! Same as HashString( const char* ) for strings of \p length characters
+	//! that are not null terminated
+	Hash& HashString( const char* str, uint32_t length );
 	Hash& HashData( const void* data, uint32_t length );
 	template < typename T > Hash& HashBasicType( const T& v ) { return HashData( &v, sizeof(v) ); }
 
@@ -2315,6 +2642,8 @@ template <> uint32_t GetHash( const char* key );
 template <> uint32_t GetHash( char* key );
 template < uint32_t N > uint32_t GetHash( ae::Str< N > key );
 template <> uint32_t GetHash( std::string key );
+uint32_t GetHash( const ae::String& key ); // Not a specialization so keys aren't copied
+template <> uint32_t GetHash( ae::Name key );
 template <> uint32_t GetHash( ae::Hash key );
 template <> uint32_t GetHash( ae::Int3 key );
 
@@ -2442,14 +2771,29 @@ namespace ae {
 //------------------------------------------------------------------------------
 //! Used to dynamically reload a shared library. The shared library should
 //! use AE_EXPORT to export any functions called with ae::HotLoader::CallFn().
+//! The library is copied to a temporary file before it's loaded, so the
+//! original can be rebuilt while the copy is in use. Only Apple platforms and
+//! Linux are supported.
 class HotLoader
 {
 public:
 	~HotLoader();
+	//! Runs the build commands and loads the library before returning, so
+	//! ae::HotLoader::CallFn() can be used immediately.
 	void Initialize( const char* buildCmd, const char* postBuildCmd, const char* libPath );
+	//! Starts running the build commands in a background process and returns
+	//! immediately. The library is swapped by a later call to
+	//! ae::HotLoader::Update() once the build succeeds. Calling this while a
+	//! build is running starts another build when the current one finishes.
 	void Reload();
+	//! Should be called once per frame, when no functions from the library are
+	//! on the stack. Checks the status of the build without blocking, and if it
+	//! has completed the library is reloaded and all previously called
+	//! functions are resolved again. Returns true if the library was reloaded.
+	bool Update();
 	void Close();
 	bool IsLoaded() const { return m_dylib != nullptr; }
+	bool IsBuilding() const { return m_buildStep != BuildStep::None; }
 
 	template < typename Fn, typename... Args >
 	decltype(auto) CallFn( const char* name, Args... args );
@@ -2459,12 +2803,28 @@ public:
 	static bool GetCopyCommand( ae::Str256* copyCmdOut, const char* dest, const char* src );
 
 private:
+	enum class BuildStep : uint8_t
+	{
+		None,
+		Build,
+		PostBuild
+	};
+	void m_Load();
 	void* m_LoadFn( const char* name );
+	bool m_StartCommand( const char* cmd );
+	bool m_PollCommand( bool* successOut );
+	void m_CancelBuild();
 	void* m_dylib = nullptr;
 	ae::Str256 m_buildCmd;
 	ae::Str256 m_postBuildCmd;
 	ae::Str256 m_libPath;
+	ae::Str256 m_loadedPath; // Temporary copy of m_libPath
 	ae::Map< ae::Str64, void*, 16 > m_fns;
+	BuildStep m_buildStep = BuildStep::None;
+	int32_t m_buildPid = 0;
+	int32_t m_buildResult = 0;
+	bool m_reloadPending = false;
+	bool m_loadPending = false;
 };
 
 //------------------------------------------------------------------------------
@@ -3007,8 +3367,8 @@ public:
 	static bool IsDirectory( const char* path );
 
 	// File dialogs
-	static ae::Array< std::string > OpenDialog( const FileDialogParams& params );
-	static std::string SaveDialog( const FileDialogParams& params );
+	static ae::Array< ae::String > OpenDialog( const FileDialogParams& params );
+	static ae::String SaveDialog( const FileDialogParams& params );
 
 private:
 	void m_SetBundleDir();
@@ -3214,6 +3574,65 @@ extern uint32_t GLMinorVersion;
 // doing this just to write the shaders for reverseZ.  In GL, this won't improve precision.
 // http://www.reedbeta.com/blog/depth-precision-visualized/
 extern bool ReverseZ;
+//! When true graphics objects make no graphics API calls and do no GPU work,
+//! so shaders, textures, vertex data, render targets and everything built on
+//! them can be initialized, updated and drawn headless (eg. for tests or to
+//! benchmark the CPU cost of rendering). ae::GraphicsStats are still recorded.
+//! ae::GraphicsDevice and ae::RenderTarget::Render() still need a real device.
+//! Must be set before any graphics objects are initialized. Defaults to
+//! AE_NULL_GRAPHICS, which can be defined as 1 to default to the null backend.
+extern bool NullGraphics;
+
+//------------------------------------------------------------------------------
+// ae::GraphicsStats struct
+//------------------------------------------------------------------------------
+//! Counts of graphics work issued since the last call to ResetGraphicsStats().
+//! Recorded with both real and null graphics (see ae::NullGraphics).
+struct GraphicsStats
+{
+	uint32_t drawCount = 0;
+	//! Primitives drawn, multiplied by instance count for instanced draws
+	uint64_t primitiveCount = 0;
+	//! Calls to ae::VertexBuffer::Bind(), including from ae::VertexArray::Draw()
+	uint32_t bindCount = 0;
+	//! Number of times the active shader or its render states changed
+	uint32_t shaderChangeCount = 0;
+	//! Uniform values sent to shaders, unchanged values are skipped
+	uint32_t uniformUploadCount = 0;
+	uint32_t textureBindCount = 0;
+	//! Vertex, index, instance and texture data sent to the GPU
+	uint64_t uploadedBytes = 0;
+	//! Times the CPU waited for the GPU to finish reading dynamic vertex data
+	//! before it could be overwritten. See ae::StreamRing.
+	uint32_t streamWaitCount = 0;
+};
+const GraphicsStats& GetGraphicsStats();
+void ResetGraphicsStats();
+
+//------------------------------------------------------------------------------
+// ae::UniformId struct
+//------------------------------------------------------------------------------
+//! A uniform name resolved once to a small integer that is shared by all
+//! shaders. ae::Shader and ae::UniformList match uniforms by id, so resolving
+//! names at initialization (eg. as statics) avoids hashing strings every time
+//! uniforms are set or bound:
+//! static const ae::UniformId u_worldToProj = "u_worldToProj";
+//! uniforms.Set( u_worldToProj, worldToProj );
+struct UniformId
+{
+	UniformId() = default;
+	UniformId( const UniformId& ) = default;
+	//! Thread safe. Returns the same id for every call with the same name.
+	UniformId( const char* name );
+	bool operator==( const UniformId& o ) const { return o.m_id == m_id; }
+	bool operator!=( const UniformId& o ) const { return o.m_id != m_id; }
+	explicit operator bool () const { return m_id != 0; }
+	Str32 GetName() const;
+	uint32_t GetInternalId() const { return m_id; }
+private:
+	uint32_t m_id = 0;
+};
+template <> uint32_t GetHash( ae::UniformId key );
 
 //------------------------------------------------------------------------------
 // ae::UniformList class
@@ -3229,18 +3648,32 @@ public:
 		Matrix4 value;
 	};
 
-	void Set( const char* name, float value );
-	void Set( const char* name, Vec2 value );
-	void Set( const char* name, Vec3 value );
-	void Set( const char* name, Vec4 value );
-	void Set( const char* name, const Matrix4& value );
-	void Set( const char* name, const class Texture* tex );
-
-	const Value* Get( const char* name ) const;
+	void Set( UniformId id, float value );
+	void Set( UniformId id, Vec2 value );
+	void Set( UniformId id, Vec3 value );
+	void Set( UniformId id, Vec4 value );
+	void Set( UniformId id, const Matrix4& value );
+	void Set( UniformId id, const class Texture* tex );
+	//! Convenience overloads that look up the ae::UniformId of \p name on
+	//! every call. Prefer resolving ids once for uniforms set every frame.
+	void Set( const char* name, float value ) { Set( UniformId( name ), value ); }
+	void Set( const char* name, Vec2 value ) { Set( UniformId( name ), value ); }
+	void Set( const char* name, Vec3 value ) { Set( UniformId( name ), value ); }
+	void Set( const char* name, Vec4 value ) { Set( UniformId( name ), value ); }
+	void Set( const char* name, const Matrix4& value ) { Set( UniformId( name ), value ); }
+	void Set( const char* name, const class Texture* tex ) { Set( UniformId( name ), tex ); }
+
+	const Value* Get( UniformId id ) const;
+	const Value* Get( const char* name ) const { return Get( UniformId( name ) ); }
 	ae::Hash GetHash() const { return m_hash; }
+	//! True when both lists set the same uniforms to the same values,
+	//! regardless of the order they were set in
+	bool operator ==( const UniformList& other ) const;
+	bool operator !=( const UniformList& other ) const { return !( *this == other ); }
 
 private:
-	ae::Map< Str32, Value, 64 > m_uniforms;
+	Value& m_Set( UniformId id );
+	ae::Map< UniformId, Value, 64 > m_uniforms;
 	ae::Hash m_hash;
 };
 
@@ -3310,10 +3743,13 @@ public:
 	//! Enable wireframe rendering mode. Defaults to false.
 	void SetWireframe( bool enabled ) { m_wireframe = enabled; }
 	void SetBlendingPremul( bool enabled ) { m_blendingPremul = enabled; }
+	//! Returns true if the linked program uses the uniform \p id
+	bool HasUniform( UniformId id ) const;
 
 	// Internal
 private:
 	int m_LoadShader( const char* shaderStr, Type type, const char* const* defines, int32_t defineCount );
+	void m_ReflectUniforms( const char* shaderStr );
 	uint32_t m_fragmentShader = 0;
 	uint32_t m_vertexShader = 0;
 	uint32_t m_program = 0;
@@ -3333,12 +3769,17 @@ public:
 	struct _Uniform
 	{
 		Str32 name;
+		UniformId id;
 		uint32_t type;
 		int32_t location;
+		// Last value uploaded to the program. Uniforms keep their values
+		// between draws, so only changed values are uploaded.
+		mutable bool uploaded = false;
+		mutable Matrix4 value;
 	};
 private:
 	ae::Array< _Attribute, _kMaxShaderAttributeCount > m_attributes;
-	ae::Map< Str32, _Uniform > m_uniforms = AE_ALLOC_TAG_RENDER;
+	ae::Array< _Uniform > m_uniforms = AE_ALLOC_TAG_RENDER;
 public:
 	void m_Activate( const UniformList& uniforms ) const;
 	const _Attribute* m_GetAttributeByIndex( uint32_t index ) const;
@@ -3351,12 +3792,66 @@ public:
 namespace Vertex
 {
 	// Constants
-	enum class Usage { Dynamic, Static };
+	//! Dynamic data is replaced every frame, Static data is uploaded once, and
+	//! Retained data is kept across frames but can be overwritten in parts
+	//! (ie. pages of terrain chunks).
+	enum class Usage { Dynamic, Static, Retained };
 	enum class Type { UInt8, UInt16, UInt32, NormalizedUInt8, NormalizedUInt16, NormalizedUInt32, Float };
 	//! Don't forget to set gl_PointSize in your vertex shader when using ae::Vertex::Primitive::Point.
 	enum class Primitive { Point, Line, Triangle };
 }
 
+//------------------------------------------------------------------------------
+// ae::StreamRing class
+//------------------------------------------------------------------------------
+//! Sub-allocates regions of a fixed size buffer in order, wrapping back to the
+//! start when the end is reached. Used by ae::VertexBuffer to stream
+//! ae::Vertex::Usage::Dynamic data without overwriting data the GPU may still
+//! be reading. Each region is retired with a fence once no more commands will
+//! use it, and its space is only reused after Release() has been called for
+//! it (when its fence has signaled). Sizes and offsets are in elements, eg.
+//! vertices. Fences are opaque to StreamRing, 0 can be used when there are none.
+class StreamRing
+{
+public:
+	static const uint32_t kMaxRegions = 16;
+
+	void Initialize( uint32_t size );
+	void Terminate();
+
+	//! Retires the current region (if any) with \p fence and starts a new one of
+	//! \p count elements. Returns false without changing anything if there isn't
+	//! enough space or too many regions are retired, in which case wait for the
+	//! oldest fence, call Release(), and try again.
+	bool Begin( uint32_t count, uint64_t fence, uint32_t* offsetOut );
+	//! Grows the current region in place by \p count elements. Returns false if
+	//! there isn't enough contiguous space.
+	bool Extend( uint32_t count );
+	//! Frees the space of the oldest retired region
+	void Release();
+
+	uint32_t GetSize() const { return m_size; }
+	//! Returns the offset of the current region
+	uint32_t GetOffset() const;
+	//! Returns the element count of the current region, 0 if none
+	uint32_t GetCount() const;
+	//! Regions that have been retired but not released, oldest first
+	uint32_t GetRetiredCount() const;
+	uint64_t GetRetiredFence( uint32_t index ) const;
+
+private:
+	struct Region
+	{
+		uint32_t offset;
+		uint32_t count;
+		uint64_t fence;
+	};
+	bool m_Fit( uint32_t count, uint32_t* offsetOut ) const;
+	uint32_t m_size = 0;
+	// Oldest first, the last region is the current region
+	ae::Array< Region, kMaxRegions + 1 > m_regions;
+};
+
 //------------------------------------------------------------------------------
 // ae::VertexBuffer class
 //------------------------------------------------------------------------------
@@ -3370,9 +3865,14 @@ public:
 	void AddAttribute( const char *name, uint32_t componentCount, ae::Vertex::Type type, uint32_t offset );
 	void Terminate();
 	
-	//! Sends vertex data to the gpu.
+	//! Sends vertex data to the gpu. ae::Vertex::Usage::Dynamic data uploaded
+	//! with a \p startIdx of 0 is written to a new region of a buffer three
+	//! times the max size, so the gpu can keep reading previously uploaded data.
+	//! Uploads with a non-zero \p startIdx add to the current region.
+	//! ae::Vertex::Usage::Retained data is written in place at \p startIdx,
+	//! leaving the rest of the buffer unchanged.
 	void UploadVertices( uint32_t startIdx, const void* vertices, uint32_t count );
-	//! Sends index data to the gpu.
+	//! Sends index data to the gpu. See ae::VertexBuffer::UploadVertices().
 	void UploadIndices( uint32_t startIdx, const void* indices, uint32_t count );
 	//! Call once directly before all calls to ae::VertexBuffer::Draw().
 	void Bind( const ae::Shader* shader, const ae::UniformList& uniforms, const ae::InstanceData** instanceDatas = nullptr, uint32_t instanceDataCount = 0 ) const;
@@ -3414,6 +3914,9 @@ private:
 	uint32_t m_array = 0;
 	uint32_t m_vertices = ~0;
 	uint32_t m_indices = ~0;
+	// Dynamic data is streamed through regions of these
+	ae::StreamRing m_vertexRing;
+	ae::StreamRing m_indexRing;
 public:
 	struct _Attribute
 	{
@@ -3492,6 +3995,11 @@ private:
 	void* m_indexReadable = nullptr;
 	bool m_vertexDirty = false;
 	bool m_indexDirty = false;
+	// Appended data is uploaded starting from here
+	uint32_t m_vertexDirtyStart = 0;
+	uint32_t m_indexDirtyStart = 0;
+public:
+	const ae::VertexBuffer* _GetVertexBuffer() const { return &m_buffer; }
 };
 
 //------------------------------------------------------------------------------
@@ -3526,6 +4034,135 @@ public:
 	const VertexBuffer::_Attribute* _GetAttribute( const char* n ) const;
 };
 
+//------------------------------------------------------------------------------
+// ae::InstanceCuller class
+//------------------------------------------------------------------------------
+//! Keeps bounds and per instance data for a large number of instances, and
+//! each frame culls them against a frustum and sorts the visible instances by
+//! level of detail. The data of visible instances is packed per LOD so only
+//! visible instances need to be sent to ae::InstanceData. Everything is done
+//! on the CPU. Bounds are stored as separate arrays of components so culling
+//! runs over tight loops the compiler can vectorize.
+class InstanceCuller
+{
+public:
+	static const uint32_t kMaxLods = 8;
+
+	InstanceCuller( ae::Tag tag );
+	//! \p instanceSize is the size in bytes of the data of each instance, eg.
+	//! the stride of the ae::InstanceData it will be uploaded to. There are
+	//! \p lodCount levels of detail, see SetLodScreenSize().
+	void Initialize( uint32_t instanceSize, uint32_t lodCount );
+	void Terminate();
+	//! Instances are drawn with \p lod while their bounding sphere's radius is
+	//! at least \p minScreenSize times the height of the screen, unless a lower
+	//! lod also qualifies. Instances too small for every lod are culled. All lods
+	//! default to 0, so without calling this all instances use lod 0.
+	void SetLodScreenSize( uint32_t lod, float minScreenSize );
+
+	//! Adds an instance and returns its index. \p data must be instanceSize bytes.
+	uint32_t Add( const ae::Sphere& bounds, const void* data );
+	//! Updates the bounds and data of an existing instance. \p data may be
+	//! null to only update the bounds.
+	void Set( uint32_t index, const ae::Sphere& bounds, const void* data );
+	//! Removes an instance by moving the last instance into its place
+	void Remove( uint32_t index );
+	void Clear();
+
+	//! Culls all instances outside of \p frustum and assigns lods based on the
+	//! distance to \p cameraPos. \p fov is the vertical field of view in
+	//! radians, as given to ae::Matrix4::ViewToProjection().
+	void Cull( const ae::Frustum& frustum, ae::Vec3 cameraPos, float fov );
+	//! Sends visible instances of \p lod to \p instanceData, which must have
+	//! been initialized with a stride of instanceSize. Returns the number of
+	//! instances to pass to ae::VertexBuffer::DrawInstanced().
+	uint32_t Upload( uint32_t lod, ae::InstanceData* instanceData ) const;
+
+	uint32_t GetInstanceCount() const { return m_centerX.Length(); }
+	uint32_t GetLodCount() const { return m_lodCount; }
+	//! Results of the last call to Cull()
+	uint32_t GetVisibleCount( uint32_t lod ) const;
+	const void* GetVisibleData( uint32_t lod ) const;
+
+private:
+	const ae::Tag m_tag;
+	uint32_t m_instanceSize = 0;
+	uint32_t m_lodCount = 0;
+	float m_lodScreenSizes[ kMaxLods ];
+	// Bounds
+	ae::Array< float > m_centerX;
+	ae::Array< float > m_centerY;
+	ae::Array< float > m_centerZ;
+	ae::Array< float > m_radius;
+	ae::Array< uint8_t > m_data;
+	// Cull results. Visible data is packed by lod, these arrays only grow.
+	ae::Array< uint8_t > m_lods;
+	ae::Array< uint8_t > m_visibleData;
+	uint32_t m_visibleStart[ kMaxLods + 1 ];
+};
+
+//------------------------------------------------------------------------------
+// ae::CommandBuffer class
+//------------------------------------------------------------------------------
+//! Records draws to be replayed later on the graphics thread. Recording only
+//! copies plain data and doesn't touch any graphics state, so worker threads
+//! can each record into their own CommandBuffer in parallel. A single
+//! CommandBuffer is not thread safe. On the graphics thread buffers are
+//! combined with Append(), ordered with Sort(), and replayed with Submit().
+//! Within a layer commands are grouped by shader, vertex array and uniforms,
+//! so use separate layers for draws that depend on order (eg. transparency).
+//! Submit() only binds state when it differs from the previous command.
+class CommandBuffer
+{
+public:
+	struct Command
+	{
+		const VertexArray* vertexArray;
+		const Shader* shader;
+		const InstanceData* instanceData; //!< Null when not instanced
+		uint32_t uniformsIndex; //!< Pass to GetUniforms()
+		uint32_t primitiveStart;
+		uint32_t primitiveCount;
+		uint32_t instanceCount;
+		uint16_t layer;
+		//! Set by Sort(). True when any state differs from the previous command.
+		bool bind;
+		uint64_t sortKey; //!< Set by Sort()
+	};
+
+	CommandBuffer( ae::Tag tag );
+	//! Records a draw of all primitives currently in \p vertexArray
+	void Draw( uint16_t layer, const VertexArray* vertexArray, const Shader* shader, const UniformList& uniforms );
+	void Draw( uint16_t layer, const VertexArray* vertexArray, const Shader* shader, const UniformList& uniforms, uint32_t primitiveStart, uint32_t primitiveCount );
+	void DrawInstanced( uint16_t layer, const VertexArray* vertexArray, const Shader* shader, const UniformList& uniforms, const InstanceData* instanceData, uint32_t primitiveStart, uint32_t primitiveCount, uint32_t instanceCount );
+	//! Copies all commands from \p other to the end of this buffer
+	void Append( const CommandBuffer& other );
+	//! Orders commands by layer and then state, and computes which commands
+	//! need to bind state. Commands with identical keys keep their order.
+	void Sort();
+	//! Replays all commands. Must be called on the graphics thread. Vertex
+	//! arrays are uploaded first if they have been modified.
+	void Submit() const;
+	void Clear();
+
+	uint32_t GetCommandCount() const { return m_commands.Length(); }
+	const Command& GetCommand( uint32_t index ) const { return m_commands[ index ]; }
+	const UniformList& GetUniforms( uint32_t uniformsIndex ) const { return m_uniforms[ uniformsIndex ]; }
+	//! The number of unique uniform lists recorded, identical lists are shared
+	uint32_t GetUniformsCount() const { return m_uniforms.Length(); }
+	//! The number of commands that bind state. Only valid after Sort().
+	uint32_t GetBindCount() const { return m_bindCount; }
+
+private:
+	uint32_t m_AddUniforms( const UniformList& uniforms );
+	ae::Array< Command > m_commands;
+	ae::Array< UniformList > m_uniforms;
+	ae::Map< uint32_t, uint32_t > m_uniformsLookup; // UniformList hash to index, probing on collisions
+	ae::Map< const Shader*, uint32_t > m_shaderIds;
+	ae::Map< const VertexArray*, uint32_t > m_vertexArrayIds;
+	uint32_t m_bindCount = 0;
+};
+
 //------------------------------------------------------------------------------
 // ae::Texture class
 //------------------------------------------------------------------------------
@@ -3767,9 +4404,15 @@ public:
 	void Initialize( uint32_t maxStringCount, uint32_t maxGlyphCount, const ae::Texture2D* texture, uint32_t fontSize, float spacing );
 	void Terminate();
 	void Render( const ae::Matrix4& uiToScreen );
+	//! Queues \p str to be drawn by the next call to ae::TextRender::Render().
+	//! The glyph layout of each string is cached, so text that is added again
+	//! with the same \p lineLength and \p charLimit isn't parsed again. Layouts
+	//! not used since the last Render() may be discarded.
 	void Add( ae::Vec3 pos, ae::Vec2 size, const char* str, ae::Color color, uint32_t lineLength, uint32_t charLimit );
 	uint32_t GetLineCount( const char* str, uint32_t lineLength, uint32_t charLimit ) const;
 	uint32_t GetFontSize() const { return m_fontSize; }
+	//! Returns the number of cached glyph layouts
+	uint32_t GetLayoutCount() const { return m_layouts.Length(); }
 
 private:
 	uint32_t m_ParseText( const char* str, uint32_t lineLength, uint32_t charLimit, char** _outStr, uint32_t* lenOut ) const;
@@ -3779,9 +4422,28 @@ private:
 		ae::Vec2 uv;
 		ae::Vec4 color;
 	};
+	struct Glyph
+	{
+		ae::Vec2 offset; // Bottom left corner relative to the text position, in units of glyph size
+		ae::Vec2 cell; // Column and row in the font texture
+	};
+	struct Layout
+	{
+		uint32_t textLength; // Length and second hash of the source string to detect key collisions
+		uint32_t textCheck;
+		uint32_t glyphStart;
+		uint32_t glyphCount;
+		uint32_t parsedLength;
+		uint32_t lineLength;
+		uint32_t charLimit;
+		uint32_t frame; // Last frame this layout was used
+	};
+	Layout* m_AddLayout( uint32_t key, const Layout& params, const char* parsedStr );
+	void m_CompactLayouts();
 	struct TextRect
 	{
-		const char* str;
+		uint32_t glyphStart;
+		uint32_t glyphCount;
 		ae::Vec3 pos;
 		ae::Vec2 size;
 		ae::Color color;
@@ -3800,6 +4462,10 @@ private:
 	char* m_stringData = nullptr;
 	uint32_t m_allocatedStrings = 0;
 	uint32_t m_allocatedChars = 0;
+	// Layout cache
+	ae::Map< uint32_t, Layout > m_layouts;
+	ae::Array< Glyph > m_layoutGlyphs;
+	uint32_t m_frame = 0;
 };
 
 //------------------------------------------------------------------------------
@@ -3810,10 +4476,9 @@ class DebugLines
 public:
 	DebugLines( const ae::Tag& tag );
 	~DebugLines();
-	//! Call this before ae::DebugLines::Add...() and before calling ae::DebugLines::Render(). \p maxVerts
-	//! are allocated when this function is called. All subsequent calls to ae::DebugLines::Add...() will return
-	//! false once this limit has been reached until ae::DebugLines::Clear() or ae::DebugLines::Render()
-	//! is called.
+	//! Call this before ae::DebugLines::Add...() and before calling ae::DebugLines::Render(). GPU buffers for
+	//! \p maxVerts are allocated when this function is called. By default the buffers grow when more vertices
+	//! are added, see ae::DebugLines::SetGrowEnabled().
 	void Initialize( uint32_t maxVerts );
 	//! Deallocates vertices and frees GPU recources.
 	void Terminate();
@@ -3823,25 +4488,28 @@ public:
 	//! Enable or disable drawing of desaturated lines on failed depth test.
 	//! Enabled by default.
 	void SetXRayEnabled( bool enabled ) { m_xray = enabled; }
+	//! When enabled (the default) buffers grow as needed so ae::DebugLines::Add...() always succeeds. When
+	//! disabled ae::DebugLines::Add...() returns 0 and nothing is added once ae::DebugLines::GetMaxVertexCount()
+	//! would be exceeded.
+	void SetGrowEnabled( bool enabled ) { m_grow = enabled; }
 	//! Resets the internal vertex buffer without uploading anything to the GPU. Use this if a call to
 	//! ae::DebugLines::Render() is ever skipped.
 	void Clear();
 
 	//! Adds a line from \p p0 to \p p1 with \p color to be transformed and drawn with ae::DebugLines::Render().
-	//! Returns false and the line is not added if ae::DebugLines::GetMaxVertexCount() would be exceeded.
+	//! Returns the number of vertices added.
 	uint32_t AddLine( Vec3 p0, Vec3 p1, Color color );
 	//! Adds a line from \p p0 to \p p1 to be transformed and drawn with ae::DebugLines::Render(). The
 	//! color will be \p successColor if the distance between \p p0 and \p p1 is less than \p distance,
-	//! otherwise the line color will be \p failColor. Returns false and the line is not added if
-	//! ae::DebugLines::GetMaxVertexCount() would be exceeded.
+	//! otherwise the line color will be \p failColor. Returns the number of vertices added.
 	uint32_t AddDistanceCheck( Vec3 p0, Vec3 p1, float distance, ae::Color successColor, ae::Color failColor );
 	//! Adds a \p color rectangle with center \p pos facing \p normal rotated so the top line is
 	//! perpendicular to \p up to be transformed and drawn with ae::DebugLines::Render().
-	//! Returns false and the rectangle is not added if ae::DebugLines::GetMaxVertexCount() would be exceeded.
+	//! Returns the number of vertices the rectangle is drawn with.
 	uint32_t AddRect( Vec3 pos, Vec3 up, Vec3 normal, Vec2 size, Color color );
 	//! Adds a \p color circle with center \p pos facing \p normal to be transformed and drawn with
 	//! ae::DebugLines::Render(). \p pointCount determines the number of points along the circumference.
-	//! Returns false and the circle is not added if ae::DebugLines::GetMaxVertexCount() would be exceeded.
+	//! Returns the number of vertices the circle is drawn with.
 	uint32_t AddCircle( Vec3 pos, Vec3 normal, float radius, Color color, uint32_t pointCount );
 	uint32_t AddAABB( Vec3 pos, Vec3 halfSize, Color color );
 	uint32_t AddOBB( Matrix4 transform, Color color );
@@ -3849,11 +4517,13 @@ public:
 	uint32_t AddMesh( const Vec3* vertices, uint32_t vertexStride, uint32_t count, Matrix4 transform, Color color );
 	uint32_t AddMesh( const Vec3* vertices, uint32_t vertexStride, uint32_t vertexCount, const void* indices, uint32_t indexSize, uint32_t indexCount, Matrix4 transform, Color color );
 	
-	//! Returns the number of vertices submitted since the last call to ae::DebugLines::Clear() or ae::DebugLines::Render().
-	uint32_t GetVertexCount() const;
+	//! Returns the number of vertices submitted since the last call to ae::DebugLines::Clear() or
+	//! ae::DebugLines::Render(). Rects, circles, spheres and boxes count the vertices they are drawn with.
+	uint32_t GetVertexCount() const { return m_vertexCount; }
 	//! Returns the maximum number of vertices that can be submitted between calls to ae::DebugLines::Clear()
-	//! and ae::DebugLines::Render(). This is the value provided to ae::DebugLines::Initialize().
-	uint32_t GetMaxVertexCount() const;
+	//! and ae::DebugLines::Render() when growing is disabled. This is the value provided to
+	//! ae::DebugLines::Initialize().
+	uint32_t GetMaxVertexCount() const { return m_maxVertexCount; }
 
 private:
 	struct DebugVertex
@@ -3861,9 +4531,36 @@ private:
 		Vec3 pos;
 		Color color;
 	};
-	VertexArray m_vertexArray;
+	// Rects, circles and boxes are drawn as instances of unit shapes
+	struct Instance
+	{
+		Matrix4 transform;
+		Vec4 color;
+	};
+	struct Shape
+	{
+		uint32_t key; // Point count of circles, or one of the unit rect or box keys
+		uint32_t vertexStart;
+		uint32_t vertexCount;
+		ae::Array< Instance > instances;
+		ae::InstanceData* instanceData;
+	};
+	bool m_Reserve( uint32_t vertexCount );
+	uint32_t m_AddShape( uint32_t key, const Matrix4& transform, Color color );
+	void m_UploadShapes();
+	ae::Tag m_tag;
+	ae::Array< DebugVertex > m_lines;
+	ae::Array< Shape > m_shapes;
+	ae::Array< Vec3 > m_shapeVerts;
+	VertexBuffer m_lineBuffer;
+	VertexBuffer m_shapeBuffer;
 	Shader m_shader;
+	Shader m_instanceShader;
+	uint32_t m_vertexCount = 0;
+	uint32_t m_maxVertexCount = 0;
+	bool m_shapesDirty = false;
 	bool m_xray = true;
+	bool m_grow = true;
 };
 
 //------------------------------------------------------------------------------
@@ -4128,7 +4825,7 @@ struct Keyframe
 //------------------------------------------------------------------------------
 struct Bone
 {
-	ae::Str64 name;
+	ae::Name name;
 	uint32_t index = 0;
 	ae::Matrix4 transform = ae::Matrix4::Identity(); //!< Model to bone space
 	ae::Matrix4 localTransform = ae::Matrix4::Identity(); //!< Parent to child space
@@ -4145,14 +4842,18 @@ class Animation
 {
 public:
 	Animation( const ae::Tag& tag ) : keyframes( tag ) {}
+	ae::Keyframe GetKeyframeByTime( ae::Name boneName, float time ) const;
+	ae::Keyframe GetKeyframeByPercent( ae::Name boneName, float percent ) const;
+	//! Does not add \p boneName to the ae::Name table
 	ae::Keyframe GetKeyframeByTime( const char* boneName, float time ) const;
+	//! Does not add \p boneName to the ae::Name table
 	ae::Keyframe GetKeyframeByPercent( const char* boneName, float percent ) const;
 	void AnimateByTime( class Skeleton* target, float time, float strength, const Bone** mask, uint32_t maskCount ) const;
 	void AnimateByPercent( class Skeleton* target, float percent, float strength, const Bone** mask, uint32_t maskCount ) const;
 	
 	float duration = 0.0f;
 	bool loop = false;
-	ae::Map< ae::Str64, ae::Array< ae::Keyframe > > keyframes; // @TODO: boneKeyframes. Maybe private
+	ae::Map< ae::Name, ae::Array< ae::Keyframe > > keyframes; // @TODO: boneKeyframes. Maybe private
 };
 
 //------------------------------------------------------------------------------
@@ -4165,12 +4866,15 @@ public:
 	void Initialize( uint32_t maxBones );
 	void Initialize( const Skeleton* otherPose );
 	const Bone* AddBone( const Bone* parent, const char* name, const ae::Matrix4& localTransform );
+	const Bone* AddBone( const Bone* parent, ae::Name name, const ae::Matrix4& localTransform );
 	void SetLocalTransforms( const Bone** targets, const ae::Matrix4* localTransforms, uint32_t count );
 	void SetLocalTransform( const Bone* target, const ae::Matrix4& localTransform );
 	void SetTransforms( const Bone** targets, const ae::Matrix4* transforms, uint32_t count );
 	void SetTransform( const Bone* target, const ae::Matrix4& transform );
 	
 	const Bone* GetRoot() const;
+	const Bone* GetBoneByName( ae::Name name ) const;
+	//! Does not add \p name to the ae::Name table
 	const Bone* GetBoneByName( const char* name ) const;
 	const Bone* GetBoneByIndex( uint32_t index ) const;
 	const Bone* GetBones() const;
@@ -4782,7 +5486,7 @@ public:
 	};\
 	template <> const ae::Enum* ae::GetEnum< E >(); \
 	inline std::ostream &operator << ( std::ostream &os, E e ) { os << ae::GetEnum< E >()->GetNameByValue( (int32_t)e ); return os; } \
-	namespace ae { template <> inline std::string ToString( E e ) { return ae::GetEnum< E >()->GetNameByValue( e ); } } \
+	namespace ae { template <> inline std::string ToString( E e ) { return ae::GetEnum< E >()->GetNameByValue( e ).c_str(); } } \
 	namespace ae { template <> inline E FromString( const char* str, const E& e ) { return ae::GetEnum< E >()->GetValueFromString( str, e ); } } \
 	namespace ae { template <> inline uint32_t GetHash( E e ) { return (uint32_t)e; } }
 
@@ -4812,7 +5516,7 @@ public:
 		if ( !s_enum ) { s_enum = GetEnum( #E ); }\
 		return s_enum;\
 	}\
-	namespace ae { template <> std::string ToString( E e ) { return ae::GetEnum< E >()->GetNameByValue( e ); } } \
+	namespace ae { template <> std::string ToString( E e ) { return ae::GetEnum< E >()->GetNameByValue( e ).c_str(); } } \
 	namespace ae { template <> E FromString( const char* str, const E& e ) { return ae::GetEnum< E >()->GetValueFromString( str, e ); } }
 
 //! Register an already defined c-style enum type where each value has a prefix
@@ -4946,13 +5650,13 @@ public:
 	uint32_t TypeSize() const { return m_size; }
 	bool TypeIsSigned() const { return m_isSigned; }
 		
-	template < typename T > std::string GetNameByValue( T value ) const;
+	template < typename T > ae::String GetNameByValue( T value ) const;
 	template < typename T > bool GetValueFromString( const char* str, T* valueOut ) const;
 	template < typename T > T GetValueFromString( const char* str, T defaultValue ) const;
 	template < typename T > bool HasValue( T value ) const;
 		
 	int32_t GetValueByIndex( int32_t index ) const;
-	std::string GetNameByIndex( int32_t index ) const;
+	ae::String GetNameByIndex( int32_t index ) const;
 	uint32_t Length() const;
 		
 	//------------------------------------------------------------------------------
@@ -4962,8 +5666,8 @@ private:
 	ae::Str32 m_name;
 	uint32_t m_size;
 	bool m_isSigned;
-	ae::Map< int32_t, std::string, kMetaEnumValues > m_enumValueToName;
-	ae::Map< std::string, int32_t, kMetaEnumValues > m_enumNameToValue;
+	ae::Map< int32_t, ae::Name, kMetaEnumValues > m_enumValueToName;
+	ae::Map< ae::Name, int32_t, kMetaEnumValues > m_enumNameToValue;
 public: // Internal
 	Enum( const char* name, uint32_t size, bool isSigned );
 	void m_AddValue( const char* name, int32_t value );
@@ -5039,7 +5743,7 @@ public:
 	//! less than ae::Var::GetGetArrayLength().
 	//! @return Returns a string representation of the value of this variable
 	//! from the given \p obj.
-	std::string GetObjectValueAsString( const ae::Object* obj, int32_t arrayIdx = -1 ) const;
+	ae::String GetObjectValueAsString( const ae::Object* obj, int32_t arrayIdx = -1 ) const;
 
 	//! Set the value of this variable on the given \p obj. If the type of this
 	//! variable is a reference then ae::SetSerializer() must be called in
@@ -5340,7 +6044,7 @@ struct _Globals
 	// Reflection
 	uint32_t metaCacheSeq = 0;
 	ae::Map< std::string, Enum, kMetaEnumTypes > enums;
-	std::map< ae::Str64, Type* > typeNameMap;
+	std::map< ae::Name, Type* > typeNameMap;
 	std::map< ae::TypeId, Type* > typeIdMap;
 	std::vector< ae::Type* > types;
 	const ae::Var::Serializer* varSerializer = nullptr;
@@ -5400,6 +6104,116 @@ const char* GetTypeName()
 	template <> const char* GetTypeName< float16_t >();
 #endif
 
+//------------------------------------------------------------------------------
+// ae::FormatTo internal implementation
+//------------------------------------------------------------------------------
+//! Writes to a fixed size buffer, counting the full length of the output even
+//! after the buffer is full
+struct _FormatBuffer
+{
+	_FormatBuffer( char* _buf, uint32_t _size ) : buf( _buf ), size( _size ) { if ( size ) { buf[ 0 ] = 0; } }
+	void Append( const char* str, uint32_t len );
+	void Append( const char* str ) { Append( str, (uint32_t)strlen( str ) ); }
+	char* buf;
+	uint32_t size;
+	uint32_t length = 0;
+};
+//! A type erased argument of ae::FormatTo()
+struct _FormatArg
+{
+	void (*fn)( _FormatBuffer* out, const void* value );
+	const void* value;
+};
+template < typename T > struct _IsStr : std::false_type {};
+template < uint32_t N > struct _IsStr< Str< N > > : std::true_type {};
+uint32_t _FormatArgs( _FormatBuffer* out, const char* format, const _FormatArg* args, uint32_t argCount );
+
+template < typename T >
+void _FormatAppend( _FormatBuffer* out, const void* _value )
+{
+	const T& value = *(const T*)_value;
+	char buf[ 32 ];
+	if constexpr ( std::is_same_v< T, float > || std::is_same_v< T, double > )
+	{
+		out->Append( buf, ae::FormatFloatGeneral( buf, sizeof(buf), value, 4 ) );
+	}
+	else if constexpr ( std::is_same_v< T, bool > )
+	{
+		out->Append( value ? "true" : "false" );
+	}
+	else if constexpr ( std::is_same_v< T, char > || std::is_same_v< T, signed char > || std::is_same_v< T, unsigned char > )
+	{
+		out->Append( (const char*)&value, 1 ); // Single byte integers are formatted as characters
+	}
+	else if constexpr ( std::is_integral_v< T > )
+	{
+		if constexpr ( std::is_signed_v< T > ) { out->Append( buf, ae::FormatInt( buf, sizeof(buf), value ) ); }
+		else { out->Append( buf, ae::FormatUint( buf, sizeof(buf), value ) ); }
+	}
+	else if constexpr ( std::is_same_v< T, const char* > || std::is_same_v< T, char* > )
+	{
+		if ( value ) { out->Append( value ); }
+	}
+	else if constexpr ( _IsStr< T >::value )
+	{
+		out->Append( value.c_str(), value.Length() );
+	}
+	else if constexpr ( std::is_same_v< T, std::string > )
+	{
+		out->Append( value.c_str(), (uint32_t)value.size() );
+	}
+	else if constexpr ( std::is_same_v< T, ae::String > )
+	{
+		out->Append( value.c_str(), value.Length() );
+	}
+	else if constexpr ( std::is_same_v< T, ae::Name > )
+	{
+		out->Append( value.c_str() );
+	}
+	else if constexpr ( std::is_same_v< T, ae::Vec2 > || std::is_same_v< T, ae::Vec3 > || std::is_same_v< T, ae::Vec4 >
+		|| std::is_same_v< T, ae::Color > || std::is_same_v< T, ae::Quaternion > || std::is_same_v< T, ae::Matrix4 > )
+	{
+		for ( uint32_t i = 0; i < countof( value.data ); i++ )
+		{
+			if ( i ) { out->Append( " ", 1 ); }
+			out->Append( buf, ae::FormatFloatGeneral( buf, sizeof(buf), value.data[ i ], 4 ) );
+		}
+	}
+	else if constexpr ( std::is_same_v< T, ae::Int2 > || std::is_same_v< T, ae::Int3 > )
+	{
+		for ( uint32_t i = 0; i < countof( value.data ); i++ )
+		{
+			if ( i ) { out->Append( " ", 1 ); }
+			out->Append( buf, ae::FormatInt( buf, sizeof(buf), value.data[ i ] ) );
+		}
+	}
+	else
+	{
+		std::ostringstream stream;
+		stream << std::setprecision( 4 );
+		stream << std::boolalpha;
+		stream << value;
+		const std::string str = stream.str();
+		out->Append( str.c_str(), (uint32_t)str.size() );
+	}
+}
+
+//! Same as ae::FormatTo() but without checking \p format at compile time, for
+//! when it has already been checked
+template < typename... Args >
+uint32_t _FormatTo( _FormatBuffer* out, const char* format, const Args&... args )
+{
+	const _FormatArg formatArgs[] = { { &_FormatAppend< Args >, &args }..., { nullptr, nullptr } };
+	return _FormatArgs( out, format, formatArgs, sizeof...(Args) );
+}
+
+template < typename... Args >
+uint32_t FormatTo( char* buf, uint32_t size, _FormatStringT< Args... > format, Args... args )
+{
+	_FormatBuffer out( buf, size );
+	return _FormatTo( &out, format.c_str(), args... );
+}
+
 //------------------------------------------------------------------------------
 // Log levels internal implementation
 //------------------------------------------------------------------------------
@@ -5409,64 +6223,21 @@ const char* GetTypeName()
 #define _AE_LOG_WARN_ 3
 #define _AE_LOG_ERROR_ 4
 #define _AE_LOG_FATAL_ 5
-void LogInternal( std::stringstream& os, const char* message );
-void LogFormat( std::stringstream& os, uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format );
-template < typename T, typename... Args >
-void LogInternal( std::stringstream& os, const char* format, T value, Args... args );
+void LogInternal( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* message );
+void _LogArgs( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format, const _FormatArg* args, uint32_t argCount );
 template < typename... Args >
-void LogInternal( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format, Args... args );
+void LogInternal( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, _FormatStringT< Args... > format, Args... args );
 extern const char* LogLevelNames[ 6 ];
 extern const char* LogLevelColors[ 6 ];
 
 //------------------------------------------------------------------------------
 // Internal Logging functions internal implementation
 //------------------------------------------------------------------------------
-void LogInternal( std::stringstream& os, const char* message );
-void LogFormat( std::stringstream& os, uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format );
-
-template < typename T, typename... Args >
-void LogInternal( std::stringstream& os, const char* format, T value, Args... args )
-{
-	if ( !(*format) )
-	{
-		os << std::endl;
-		return;
-	}
-	
-	const char* head = format;
-	while ( *head && *head != '#' )
-	{
-		head++;
-	}
-	if ( head > format )
-	{
-		os.write( format, head - format );
-	}
-
-	if ( *head == '#' )
-	{
-		os << value;
-		head++;
-	}
-
-	LogInternal( os, head, args... );
-}
-
 template < typename... Args >
-void LogInternal( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format, Args... args )
+void LogInternal( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, _FormatStringT< Args... > format, Args... args )
 {
-	std::stringstream os;
-	os << std::setprecision( 4 );
-	os << std::boolalpha;
-	LogFormat( os, severity, filePath, line, assertInfo, format );
-	LogInternal( os, format, args... );
-	if ( severity == _AE_LOG_FATAL_ && !ae::IsDebuggerAttached() )
-	{
-		std::stringstream ss;
-		ss << os.rdbuf();
-		std::string str = ss.str();
-		ShowMessage( str.c_str() );
-	}
+	const _FormatArg formatArgs[] = { { &_FormatAppend< Args >, &args }..., { nullptr, nullptr } };
+	_LogArgs( severity, filePath, line, assertInfo, format.c_str(), formatArgs, sizeof...(Args) );
 }
 
 //------------------------------------------------------------------------------
@@ -6872,7 +7643,7 @@ template <>
 inline std::string ToString( int32_t value )
 {
 	char str[ 16 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%d", value );
+	uint32_t length = ae::FormatInt( str, sizeof( str ), value );
 	return std::string( str, length );
 }
 
@@ -6880,23 +7651,37 @@ template <>
 inline std::string ToString( uint32_t value )
 {
 	char str[ 16 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%u", value );
+	uint32_t length = ae::FormatUint( str, sizeof( str ), value );
 	return std::string( str, length );
 }
 
+// Writes floats separated by spaces with ae::FormatFloatFixed()
+inline std::string _ToStringFixed( const float* values, uint32_t count, uint32_t precision )
+{
+	char str[ 64 ]; // Large enough for FLT_MAX
+	std::string result;
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		if ( i )
+		{
+			result += ' ';
+		}
+		result.append( str, ae::FormatFloatFixed( str, sizeof( str ), values[ i ], precision ) );
+	}
+	return result;
+}
+
 template <>
 inline std::string ToString( float value )
 {
-	char str[ 16 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%.3f", value );
-	return std::string( str, length );
+	return _ToStringFixed( &value, 1, 3 );
 }
 
 template <>
 inline std::string ToString( double value )
 {
-	char str[ 16 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%.3f", value );
+	char str[ 512 ]; // Large enough for DBL_MAX
+	uint32_t length = ae::FormatFloatFixed( str, sizeof( str ), value, 3 );
 	return std::string( str, length );
 }
 
@@ -6909,47 +7694,31 @@ inline std::string ToString( bool v )
 template <>
 inline std::string ToString( ae::Vec2 v )
 {
-	char str[ 128 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%.3f %.3f", v.x, v.y );
-	return std::string( str, length );
+	return _ToStringFixed( v.data, 2, 3 );
 }
 
 template <>
 inline std::string ToString( ae::Vec3 v )
 {
-	char str[ 128 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%.3f %.3f %.3f", v.x, v.y, v.z );
-	return std::string( str, length );
+	return _ToStringFixed( v.data, 3, 3 );
 }
 
 template <>
 inline std::string ToString( ae::Vec4 v )
 {
-	char str[ 128 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%.3f %.3f %.3f %.3f", v.x, v.y, v.z, v.w );
-	return std::string( str, length );
+	return _ToStringFixed( v.data, 4, 3 );
 }
 
 template <>
 inline std::string ToString( ae::Color v )
 {
-	char str[ 128 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1, "%.3f %.3f %.3f %.3f", v.r, v.g, v.b, v.a );
-	return std::string( str, length );
+	return _ToStringFixed( v.data, 4, 3 );
 }
 
 template <>
 inline std::string ToString( ae::Matrix4 v )
 {
-	char str[ 128 ];
-	uint32_t length = snprintf( str, sizeof( str ) - 1,
-		"%.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f %.3f",
-		v.data[ 0 ], v.data[ 1 ], v.data[ 2 ], v.data[ 3 ],
-		v.data[ 4 ], v.data[ 5 ], v.data[ 6 ], v.data[ 7 ],
-		v.data[ 8 ], v.data[ 9 ], v.data[ 10 ], v.data[ 11 ],
-		v.data[ 12 ], v.data[ 13 ], v.data[ 14 ], v.data[ 15 ]
-	);
-	return std::string( str, length );
+	return _ToStringFixed( v.data, 16, 3 );
 }
 
 //------------------------------------------------------------------------------
@@ -6960,11 +7729,42 @@ inline std::string ToString( ae::Matrix4 v )
 // for ae::ToString implementations in other modules.
 template < typename T > T FromString( const char* str, const T& defaultValue );
 
+// Reads 'count' numbers separated by whitespace, like sscanf( "%f %f ..." )
+inline bool _FromStringFloats( const char* str, float* valuesOut, uint32_t count )
+{
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		const char* end;
+		valuesOut[ i ] = ae::ParseFloat( str, &end );
+		if ( end == str )
+		{
+			return false;
+		}
+		str = end;
+	}
+	return true;
+}
+
+inline bool _FromStringInts( const char* str, int32_t* valuesOut, uint32_t count )
+{
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		const char* end;
+		valuesOut[ i ] = (int32_t)ae::ParseInt( str, &end );
+		if ( end == str )
+		{
+			return false;
+		}
+		str = end;
+	}
+	return true;
+}
+
 template <>
 inline ae::Int2 FromString( const char* str, const ae::Int2& defaultValue )
 {
 	ae::Int2 r;
-	if ( sscanf( str, "%d %d", r.data, r.data + 1 ) == 2 )
+	if ( _FromStringInts( str, r.data, 2 ) )
 	{
 		return r;
 	}
@@ -6975,7 +7775,7 @@ template <>
 inline ae::Int3 FromString( const char* str, const ae::Int3& defaultValue )
 {
 	ae::Int3 r;
-	if ( sscanf( str, "%d %d %d", r.data, r.data + 1, r.data + 2 ) == 3 )
+	if ( _FromStringInts( str, r.data, 3 ) )
 	{
 		return r;
 	}
@@ -6986,7 +7786,7 @@ template <>
 inline ae::Vec2 FromString( const char* str, const ae::Vec2& defaultValue )
 {
 	ae::Vec2 r;
-	if ( sscanf( str, "%f %f", r.data, r.data + 1 ) == 2 )
+	if ( _FromStringFloats( str, r.data, 2 ) )
 	{
 		return r;
 	}
@@ -6997,7 +7797,7 @@ template <>
 inline ae::Vec3 FromString( const char* str, const ae::Vec3& defaultValue )
 {
 	ae::Vec3 r;
-	if ( sscanf( str, "%f %f %f", r.data, r.data + 1, r.data + 2 ) == 3 )
+	if ( _FromStringFloats( str, r.data, 3 ) )
 	{
 		return r;
 	}
@@ -7008,7 +7808,7 @@ template <>
 inline ae::Vec4 FromString( const char* str, const ae::Vec4& defaultValue )
 {
 	ae::Vec4 r;
-	if ( sscanf( str, "%f %f %f %f", r.data, r.data + 1, r.data + 2, r.data + 3 ) == 4 )
+	if ( _FromStringFloats( str, r.data, 4 ) )
 	{
 		return r;
 	}
@@ -7019,11 +7819,7 @@ template <>
 inline ae::Matrix4 FromString( const char* str, const ae::Matrix4& defaultValue )
 {
 	ae::Matrix4 r;
-	if ( sscanf( str, "%f %f %f %f %f %f %f %f %f %f %f %f %f %f %f %f",
-		r.data, r.data + 1, r.data + 2, r.data + 3,
-		r.data + 4, r.data + 5, r.data + 6, r.data + 7,
-		r.data + 8, r.data + 9, r.data + 10, r.data + 11,
-		r.data + 12, r.data + 13, r.data + 14, r.data + 15 ) == 16 )
+	if ( _FromStringFloats( str, r.data, 16 ) )
 	{
 		return r;
 	}
@@ -7034,7 +7830,7 @@ template <>
 inline ae::Color FromString( const char* str, const ae::Color& defaultValue )
 {
 	ae::Color r;
-	if ( sscanf( str, "%f %f %f %f", r.data, r.data + 1, r.data + 2, r.data + 3 ) == 4 )
+	if ( _FromStringFloats( str, r.data, 4 ) )
 	{
 		return r;
 	}
@@ -7058,7 +7854,7 @@ inline bool FromString( const char* str, const bool& defaultValue )
 	float f;
 	if ( StrCmp( "true", str ) ) { return true; }
 	if ( StrCmp( "false", str ) ) { return false; }
-	if ( sscanf( str, "%f", &f ) == 1 ) { return (bool)f; }
+	if ( _FromStringFloats( str, &f, 1 ) ) { return (bool)f; }
 	return defaultValue;
 }
 
@@ -7125,11 +7921,11 @@ Str< N >::Str( uint32_t length, char c )
 
 template < uint32_t N >
 template < typename... Args >
-Str< N >::Str( const char* format, Args... args )
+Str< N >::Str( _FormatStringT< Args... > format, Args... args )
 {
 	m_length = 0;
 	m_str[ 0 ] = 0;
-	m_Format( format, args... );
+	m_Format( format.c_str(), args... );
 }
 
 template < uint32_t N >
@@ -7360,49 +8156,71 @@ void Str< N >::Trim( uint32_t len )
 
 template < uint32_t N >
 template < typename... Args >
-Str< N > Str< N >::Format( const char* format, Args... args )
+Str< N > Str< N >::Format( _FormatStringT< Args... > format, Args... args )
 {
 	Str< N > result( "" );
-	result.m_Format( format, args... );
+	result.m_Format( format.c_str(), args... );
 	return result;
 }
 
 template < uint32_t N >
-void Str< N >::m_Format( const char* format )
+Str< N > Str< N >::Format( const char* str )
 {
-	*this += format;
+	return Str< N >( str );
 }
 
 template < uint32_t N >
-template < typename T, typename... Args >
-void Str< N >::m_Format( const char* format, T value, Args... args )
+template < typename... Args >
+void Str< N >::m_Format( const char* format, const Args&... args )
 {
-	if ( !*format )
-	{
-		return;
-	}
+	// Written directly after the current contents, without any temporaries
+	_FormatBuffer out( m_str + m_length, MaxLength() + 1u - m_length );
+	const uint32_t length = _FormatTo( &out, format, args... );
+	AE_ASSERT( m_length + length <= MaxLength() );
+	m_length += length;
+}
 
-	const char* head = format;
-	while ( *head && *head != '#' )
-	{
-		head++;
-	}
-	if ( head > format )
-	{
-		*this += Str< N >( head - format, format );
-	}
+//------------------------------------------------------------------------------
+// ae::String templated member functions
+//------------------------------------------------------------------------------
+template < uint32_t N >
+String::String( const Str< N >& str ) :
+	String( AE_ALLOC_TAG_STRING, str.c_str(), str.Length() )
+{}
 
-	if ( *head == '#' )
-	{
-		// @TODO: Replace with ToString()?
-		std::ostringstream stream;
-		stream << std::setprecision( 4 );
-		stream << std::boolalpha;
-		stream << value;
-		*this += stream.str().c_str();
-		head++;
-	}
-	m_Format( head, args... );
+template < uint32_t N >
+String::String( const ae::Tag& tag, const Str< N >& str ) :
+	String( tag, str.c_str(), str.Length() )
+{}
+
+template < uint32_t N >
+void String::operator =( const Str< N >& str )
+{
+	m_Assign( str.c_str(), str.Length() );
+}
+
+template < uint32_t N >
+void String::operator +=( const Str< N >& str )
+{
+	Append( str.c_str(), str.Length() );
+}
+
+template < uint32_t N >
+bool String::operator ==( const Str< N >& str ) const
+{
+	return m_length == str.Length() && memcmp( c_str(), str.c_str(), m_length ) == 0;
+}
+
+template < uint32_t N >
+bool String::operator !=( const Str< N >& str ) const
+{
+	return !( *this == str );
+}
+
+template < uint32_t N >
+Str< N > String::ToStr() const
+{
+	return Str< N >( m_length, c_str() );
 }
 
 //------------------------------------------------------------------------------
@@ -7664,7 +8482,7 @@ T* Array< T, N >::Insert( uint32_t index, const T& value, uint32_t count )
 	{
 		m_array[ i ] = value;
 	}
-	for ( uint32_t i = pivot0; i < indexCount; i++ )
+	for ( uint32_t i = pivot0; i < (uint32_t)indexCount; i++ )
 	{
 		new ( &m_array[ i ] ) T ( value );
 	}
@@ -7696,7 +8514,7 @@ T* Array< T, N >::InsertArray( uint32_t index, const T* values, uint32_t count )
 	{
 		m_array[ i ] = values[ j ];
 	}
-	for ( uint32_t i = pivot0; i < indexCount; i++, j++ )
+	for ( uint32_t i = pivot0; i < (uint32_t)indexCount; i++, j++ )
 	{
 		new ( &m_array[ i ] ) T ( values[ j ] );
 	}
@@ -9393,6 +10211,101 @@ ae::AABB BVH< T, N >::GetAABB() const
 	return GetRoot()->aabb;
 }
 
+//------------------------------------------------------------------------------
+// ae::AABBTree member functions
+//------------------------------------------------------------------------------
+template < typename Fn >
+void AABBTree::Query( const ae::AABB& aabb, Fn fn ) const
+{
+	if ( m_root < 0 )
+	{
+		return;
+	}
+	// The tree is kept balanced, so the stack never grows much past its height
+	ae::Array< int32_t, 256 > stack;
+	stack.Append( m_root );
+	while ( stack.Length() )
+	{
+		const int32_t index = stack[ stack.Length() - 1 ];
+		stack.Remove( stack.Length() - 1 );
+		const Node& node = m_nodes[ index ];
+		if ( !node.aabb.Intersect( aabb ) )
+		{
+			continue;
+		}
+		if ( node.IsLeaf() )
+		{
+			fn( index, node.userData );
+		}
+		else
+		{
+			stack.Append( node.child0 );
+			stack.Append( node.child1 );
+		}
+	}
+}
+
+template < typename Fn >
+void AABBTree::Raycast( ae::Vec3 source, ae::Vec3 ray, Fn fn ) const
+{
+	struct Entry
+	{
+		int32_t index;
+		float t;
+	};
+	float maxFraction = 1.0f;
+	auto intersect = [&]( int32_t index, float* tOut )
+	{
+		float t0, t1;
+		if ( m_nodes[ index ].aabb.IntersectLine( source, ray, &t0, &t1 ) && t1 >= 0.0f && t0 <= maxFraction )
+		{
+			*tOut = ae::Max( t0, 0.0f );
+			return true;
+		}
+		return false;
+	};
+	float rootT;
+	if ( m_root < 0 || !intersect( m_root, &rootT ) )
+	{
+		return;
+	}
+	ae::Array< Entry, 256 > stack;
+	stack.Append( { m_root, rootT } );
+	while ( stack.Length() )
+	{
+		const Entry entry = stack[ stack.Length() - 1 ];
+		stack.Remove( stack.Length() - 1 );
+		if ( entry.t > maxFraction )
+		{
+			continue; // A closer hit was found after this node was pushed
+		}
+		const Node& node = m_nodes[ entry.index ];
+		if ( node.IsLeaf() )
+		{
+			maxFraction = ae::Min( maxFraction, (float)fn( entry.index, node.userData ) );
+			if ( maxFraction <= 0.0f )
+			{
+				return;
+			}
+			continue;
+		}
+		float t0, t1;
+		const bool hit0 = intersect( node.child0, &t0 );
+		const bool hit1 = intersect( node.child1, &t1 );
+		// Push the farther child first so the nearer child is visited first
+		if ( hit0 && hit1 && t0 < t1 )
+		{
+			stack.Append( { node.child1, t1 } );
+			stack.Append( { node.child0, t0 } );
+		}
+		else
+		{
+			if ( hit0 ) { stack.Append( { node.child0, t0 } ); }
+			if ( hit1 ) { stack.Append( { node.child1, t1 } ); }
+		}
+	}
+}
+
 //------------------------------------------------------------------------------
 // ae::GetHash helper
 //------------------------------------------------------------------------------
@@ -10201,7 +11114,7 @@ struct _TypeCreator
 	{
 		_Globals* globals = _Globals::Get();
 		_DefineType< T >( &m_type, 0 );
-		globals->typeNameMap[ typeName ] = &m_type;
+		globals->typeNameMap[ ae::Name( typeName ) ] = &m_type;
 		globals->typeIdMap[ m_type.GetId() ] = &m_type; // @TODO: Should check for hash collision
 		globals->types.push_back( &m_type );
 		globals->metaCacheSeq++;
@@ -10210,7 +11123,7 @@ struct _TypeCreator
 	{
 		const char* typeName = m_type.GetName();
 		_Globals* globals = _Globals::Get();
-		globals->typeNameMap.erase( typeName );
+		globals->typeNameMap.erase( ae::Name::Find( typeName ) );
 		globals->typeIdMap.erase( m_type.GetId() );
 		auto it = std::find( globals->types.begin(), globals->types.end(), &m_type );
 		if( it != globals->types.end() )
@@ -10228,7 +11141,7 @@ struct _PropCreator
 	// Take _TypeCreator param as a safety check that _PropCreator typeName is provided correctly
 	_PropCreator( ae::_TypeCreator< C >&, const char* typeName, const char* propName, const char* propValue )
 	{
-		ae::Type* type = _Globals::Get()->typeNameMap.find( typeName )->second;
+		ae::Type* type = _Globals::Get()->typeNameMap.find( ae::Name::Find( typeName ) )->second;
 		type->m_AddProp( propName, propValue );
 	}
 };
@@ -10239,7 +11152,7 @@ struct _VarCreator
 	// Take _TypeCreator param as a safety check that _VarCreator typeName is provided correctly
 	_VarCreator( ae::_TypeCreator< C >&, const char* typeName, const char* varName )
 	{
-		ae::Type* type = _Globals::Get()->typeNameMap.find( typeName )->second;
+		ae::Type* type = _Globals::Get()->typeNameMap.find( ae::Name::Find( typeName ) )->second;
 		AE_ASSERT( type );
 		
 		Var var;
@@ -10553,7 +11466,7 @@ const ae::Type* ae::GetType()
 		// @TODO: Conditionally enable this check when T is not a forward declaration
 		//AE_STATIC_ASSERT( (std::is_base_of< ae::Object, T >::value) );
 		const char* typeName = ae::GetTypeName< T >();
-		auto it = globals->typeNameMap.find( typeName );
+		auto it = globals->typeNameMap.find( ae::Name::Find( typeName ) );
 		if ( it != globals->typeNameMap.end() )
 		{
 			s_type = it->second;
@@ -10568,16 +11481,16 @@ const ae::Type* ae::GetType()
 }
 
 template < typename T >
-std::string ae::Enum::GetNameByValue( T value ) const
+ae::String ae::Enum::GetNameByValue( T value ) const
 {
-	return m_enumValueToName.Get( (int32_t)value, "" );
+	return m_enumValueToName.Get( (int32_t)value, ae::Name() ).c_str();
 }
 
 template < typename T >
 bool ae::Enum::GetValueFromString( const char* str, T* valueOut ) const
 {
 	int32_t value = 0;
-	if ( m_enumNameToValue.TryGet( str, &value ) ) // Set object var with named enum value
+	if ( m_enumNameToValue.TryGet( ae::Name::Find( str ), &value ) ) // Set object var with named enum value
 	{
 		*valueOut = (T)value;
 		return true;
@@ -10874,6 +11787,10 @@ T* ae::Cast( C* obj )
 	#include <unistd.h>
 	#include <pwd.h>
 	#include <dlfcn.h>
+	#include <spawn.h>
+	#include <signal.h>
+	#include <sys/wait.h>
+	#include <crt_externs.h>
 	#include <mach-o/dyld.h>
 	#ifdef AE_USE_MODULES
 		@import AppKit;
@@ -10896,11 +11813,17 @@ T* ae::Cast( C* obj )
 	#include <pwd.h>
 	#include <limits.h>
 	#include <sys/stat.h>
+	#include <dlfcn.h>
+	#include <spawn.h>
+	#include <signal.h>
+	#include <sys/wait.h>
+	extern char** environ;
 	#ifndef AE_USE_OPENAL
 		#define AE_USE_OPENAL 0
 	#endif
 #endif
 #include <inttypes.h>
+#include <mutex>
 #include <thread>
 #include <random>
 // Socket
@@ -12445,6 +13368,23 @@ bool Frustum::Intersects( const ae::Sphere& sphere ) const
 	return true;
 }
 
+bool Frustum::Intersects( const ae::AABB& aabb ) const
+{
+	const ae::Vec3 center = aabb.GetCenter();
+	const ae::Vec3 halfSize = aabb.GetHalfSize();
+	for( int i = 0; i < countof(m_planes); i++ )
+	{
+		// Distance from the center to the corner of the box furthest behind the plane
+		const ae::Vec3 normal = m_planes[ i ].GetNormal();
+		const float extent = halfSize.x * ae::Abs( normal.x ) + halfSize.y * ae::Abs( normal.y ) + halfSize.z * ae::Abs( normal.z );
+		if( m_planes[ i ].GetSignedDistance( center ) > extent )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 Plane Frustum::GetPlane( ae::Frustum::Plane plane ) const
 {
 	return m_planes[ (int)plane ];
@@ -12651,6 +13591,263 @@ std::ostream& operator<<( std::ostream& os, AABB aabb )
 	return os << "[" << aabb.GetMin() << ", " << aabb.GetMax() << "]";
 }
 
+//------------------------------------------------------------------------------
+// ae::AABBTree member functions
+//------------------------------------------------------------------------------
+static float _GetAABBTreeCost( const ae::AABB& aabb )
+{
+	// Surface area, the probability of a random ray hitting the aabb
+	const ae::Vec3 size = aabb.GetMax() - aabb.GetMin();
+	return 2.0f * ( size.x * size.y + size.y * size.z + size.z * size.x );
+}
+
+static ae::AABB _GetAABBTreeUnion( ae::AABB a, const ae::AABB& b )
+{
+	a.Expand( b );
+	return a;
+}
+
+AABBTree::AABBTree( const ae::Tag& tag, float margin ) :
+	m_margin( margin ),
+	m_nodes( tag )
+{}
+
+int32_t AABBTree::Add( const ae::AABB& aabb, void* userData )
+{
+	const int32_t proxy = m_AllocateNode();
+	Node& node = m_nodes[ proxy ];
+	node.aabb = aabb;
+	node.aabb.Expand( m_margin );
+	node.userData = userData;
+	m_InsertLeaf( proxy );
+	m_count++;
+	return proxy;
+}
+
+bool AABBTree::Set( int32_t proxy, const ae::AABB& aabb )
+{
+	AE_ASSERT( m_nodes[ proxy ].IsLeaf() && m_nodes[ proxy ].height == 0 );
+	const ae::AABB& fat = m_nodes[ proxy ].aabb;
+	const ae::Vec3 fatMin = fat.GetMin();
+	const ae::Vec3 fatMax = fat.GetMax();
+	const ae::Vec3 min = aabb.GetMin();
+	const ae::Vec3 max = aabb.GetMax();
+	if ( fatMin.x <= min.x && fatMin.y <= min.y && fatMin.z <= min.z
+		&& max.x <= fatMax.x && max.y <= fatMax.y && max.z <= fatMax.z )
+	{
+		return false;
+	}
+	m_RemoveLeaf( proxy );
+	m_nodes[ proxy ].aabb = aabb;
+	m_nodes[ proxy ].aabb.Expand( m_margin );
+	m_InsertLeaf( proxy );
+	return true;
+}
+
+void AABBTree::Remove( int32_t proxy )
+{
+	AE_ASSERT( m_nodes[ proxy ].IsLeaf() && m_nodes[ proxy ].height == 0 );
+	m_RemoveLeaf( proxy );
+	m_FreeNode( proxy );
+	m_count--;
+}
+
+void AABBTree::Clear()
+{
+	m_nodes.Clear();
+	m_root = -1;
+	m_free = -1;
+	m_count = 0;
+}
+
+int32_t AABBTree::m_AllocateNode()
+{
+	int32_t index;
+	if ( m_free >= 0 )
+	{
+		index = m_free;
+		m_free = m_nodes[ index ].parent;
+	}
+	else
+	{
+		index = m_nodes.Length();
+		m_nodes.Append( {} );
+	}
+	Node& node = m_nodes[ index ];
+	node.aabb = ae::AABB();
+	node.userData = nullptr;
+	node.parent = -1;
+	node.child0 = -1;
+	node.child1 = -1;
+	node.height = 0;
+	return index;
+}
+
+void AABBTree::m_FreeNode( int32_t index )
+{
+	Node& node = m_nodes[ index ];
+	node.userData = nullptr;
+	node.parent = m_free;
+	node.height = -1;
+	m_free = index;
+}
+
+void AABBTree::m_InsertLeaf( int32_t leaf )
+{
+	if ( m_root < 0 )
+	{
+		m_root = leaf;
+		m_nodes[ leaf ].parent = -1;
+		return;
+	}
+
+	// Descend to the sibling that results in the least total surface area
+	const ae::AABB leafAABB = m_nodes[ leaf ].aabb;
+	int32_t index = m_root;
+	while ( !m_nodes[ index ].IsLeaf() )
+	{
+		const Node& node = m_nodes[ index ];
+		const float area = _GetAABBTreeCost( node.aabb );
+		const float combinedArea = _GetAABBTreeCost( _GetAABBTreeUnion( node.aabb, leafAABB ) );
+		// Cost of creating a new parent for this node and the leaf
+		const float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * ( combinedArea - area );
+		auto getChildCost = [&]( int32_t child )
+		{
+			const Node& childNode = m_nodes[ child ];
+			const float childArea = _GetAABBTreeCost( _GetAABBTreeUnion( childNode.aabb, leafAABB ) );
+			return childNode.IsLeaf() ? ( childArea + inheritanceCost ) : ( childArea - _GetAABBTreeCost( childNode.aabb ) + inheritanceCost );
+		};
+		const float cost0 = getChildCost( node.child0 );
+		const float cost1 = getChildCost( node.child1 );
+		if ( cost < cost0 && cost < cost1 )
+		{
+			break;
+		}
+		index = ( cost0 < cost1 ) ? node.child0 : node.child1;
+	}
+	const int32_t sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	const int32_t oldParent = m_nodes[ sibling ].parent;
+	const int32_t newParent = m_AllocateNode(); // Invalidates node references
+	m_nodes[ newParent ].parent = oldParent;
+	m_nodes[ newParent ].aabb = _GetAABBTreeUnion( m_nodes[ sibling ].aabb, leafAABB );
+	m_nodes[ newParent ].height = m_nodes[ sibling ].height + 1;
+	m_nodes[ newParent ].child0 = sibling;
+	m_nodes[ newParent ].child1 = leaf;
+	m_nodes[ sibling ].parent = newParent;
+	m_nodes[ leaf ].parent = newParent;
+	if ( oldParent >= 0 )
+	{
+		Node& parentNode = m_nodes[ oldParent ];
+		( ( parentNode.child0 == sibling ) ? parentNode.child0 : parentNode.child1 ) = newParent;
+	}
+	else
+	{
+		m_root = newParent;
+	}
+
+	m_Refit( m_nodes[ leaf ].parent );
+}
+
+void AABBTree::m_RemoveLeaf( int32_t leaf )
+{
+	if ( leaf == m_root )
+	{
+		m_root = -1;
+		return;
+	}
+	const int32_t parent = m_nodes[ leaf ].parent;
+	const int32_t grandParent = m_nodes[ parent ].parent;
+	const int32_t sibling = ( m_nodes[ parent ].child0 == leaf ) ? m_nodes[ parent ].child1 : m_nodes[ parent ].child0;
+	m_nodes[ leaf ].parent = -1;
+	m_FreeNode( parent );
+	m_nodes[ sibling ].parent = grandParent;
+	if ( grandParent >= 0 )
+	{
+		Node& grandParentNode = m_nodes[ grandParent ];
+		( ( grandParentNode.child0 == parent ) ? grandParentNode.child0 : grandParentNode.child1 ) = sibling;
+		m_Refit( grandParent );
+	}
+	else
+	{
+		m_root = sibling;
+	}
+}
+
+void AABBTree::m_Refit( int32_t index )
+{
+	while ( index >= 0 )
+	{
+		index = m_Balance( index );
+		Node& node = m_nodes[ index ];
+		const Node& child0 = m_nodes[ node.child0 ];
+		const Node& child1 = m_nodes[ node.child1 ];
+		node.height = 1 + ae::Max( child0.height, child1.height );
+		node.aabb = _GetAABBTreeUnion( child0.aabb, child1.aabb );
+		index = node.parent;
+	}
+}
+
+int32_t AABBTree::m_Balance( int32_t iA )
+{
+	// Rotates the taller child of A up into A's place when the heights of A's
+	// children differ by more than one
+	Node& a = m_nodes[ iA ];
+	if ( a.IsLeaf() || a.height < 2 )
+	{
+		return iA;
+	}
+	const int32_t iB = a.child0;
+	const int32_t iC = a.child1;
+	Node& b = m_nodes[ iB ];
+	Node& c = m_nodes[ iC ];
+	const int32_t balance = c.height - b.height;
+	if ( balance > 1 || balance < -1 )
+	{
+		// 'up' is the taller child that replaces A, 'other' stays under A
+		const bool rotateC = ( balance > 1 );
+		const int32_t iUp = rotateC ? iC : iB;
+		Node& up = rotateC ? c : b;
+		const Node& other = rotateC ? b : c;
+		const int32_t iF = up.child0;
+		const int32_t iG = up.child1;
+		Node& f = m_nodes[ iF ];
+		Node& g = m_nodes[ iG ];
+
+		up.child0 = iA;
+		up.parent = a.parent;
+		a.parent = iUp;
+		if ( up.parent >= 0 )
+		{
+			Node& parentNode = m_nodes[ up.parent ];
+			( ( parentNode.child0 == iA ) ? parentNode.child0 : parentNode.child1 ) = iUp;
+		}
+		else
+		{
+			m_root = iUp;
+		}
+
+		// The taller grandchild stays with 'up', the other replaces 'up' in A
+		const bool keepF = ( f.height > g.height );
+		const int32_t iKeep = keepF ? iF : iG;
+		const int32_t iMove = keepF ? iG : iF;
+		Node& keep = m_nodes[ iKeep ];
+		Node& move = m_nodes[ iMove ];
+		up.child1 = iKeep;
+		( rotateC ? a.child1 : a.child0 ) = iMove;
+		move.parent = iA;
+		a.aabb = _GetAABBTreeUnion( other.aabb, move.aabb );
+		a.height = 1 + ae::Max( other.height, move.height );
+		up.aabb = _GetAABBTreeUnion( a.aabb, keep.aabb );
+		up.height = 1 + ae::Max( a.height, keep.height );
+		return iUp;
+	}
+	return iA;
+}
+
 //------------------------------------------------------------------------------
 // ae::OBB member functions
 //------------------------------------------------------------------------------
@@ -12994,28 +14191,7 @@ const char* LogLevelColors[] =
 //------------------------------------------------------------------------------
 bool _ae_logColors = false;
 
-#if _AE_WINDOWS_
-void LogInternal( std::stringstream& os, const char* message )
-{
-	static bool s_logStdOut = !ae::IsDebuggerAttached();
-	os << message << std::endl;
-	if ( s_logStdOut )
-	{
-		printf( os.str().c_str() ); // std out
-	}
-	else
-	{
-		OutputDebugStringA( os.str().c_str() ); // visual studio debug output
-	}
-}
-#else
-void LogInternal( std::stringstream& os, const char* message )
-{
-	std::cout << os.str() << message << std::endl;
-}
-#endif
-
-void LogFormat( std::stringstream& os, uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format )
+void _LogHeader( _FormatBuffer* out, uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, bool hasFormat )
 {
 	char timeBuf[ 16 ];
 	time_t t = time( nullptr );
@@ -13036,41 +14212,108 @@ void LogFormat( std::stringstream& os, uint32_t severity, const char* filePath,
 		fileName = filePath;
 	}
 
+	char buf[ 32 ];
 	if ( _ae_logColors )
 	{
-		os << "\x1b[90m" << timeBuf;
-		os << " [" << ae::GetPID() << "] ";
-		os << LogLevelColors[ severity ] << LogLevelNames[ severity ];
-		os << " \x1b[90m" << fileName << ":" << line;
+		out->Append( "\x1b[90m" );
+		out->Append( timeBuf );
+		out->Append( " [" );
+		out->Append( buf, ae::FormatUint( buf, sizeof(buf), ae::GetPID() ) );
+		out->Append( "] " );
+		out->Append( LogLevelColors[ severity ] );
+		out->Append( LogLevelNames[ severity ] );
+		out->Append( " \x1b[90m" );
 	}
 	else
 	{
-		os << timeBuf;
-		os << " [" << ae::GetPID() << "] ";
-		os << LogLevelNames[ severity ];
-		os << " " << fileName << ":" << line;
+		out->Append( timeBuf );
+		out->Append( " [" );
+		out->Append( buf, ae::FormatUint( buf, sizeof(buf), ae::GetPID() ) );
+		out->Append( "] " );
+		out->Append( LogLevelNames[ severity ] );
+		out->Append( " " );
 	}
+	out->Append( fileName );
+	out->Append( ":" );
+	out->Append( buf, ae::FormatUint( buf, sizeof(buf), line ) );
 
 	bool hasAssertInfo = ( assertInfo && assertInfo[ 0 ] );
-	bool hasFormat = ( format && format[ 0 ] );
 	if ( hasAssertInfo || hasFormat )
 	{
-		os << ": ";
+		out->Append( ": " );
 	}
 	if ( _ae_logColors )
 	{
-		os << "\x1b[0m";
+		out->Append( "\x1b[0m" );
 	}
 	if ( hasAssertInfo )
 	{
-		os << assertInfo;
+		out->Append( assertInfo );
 		if ( hasFormat )
 		{
-			os << " ";
+			out->Append( " " );
 		}
 	}
 }
 
+void _LogMessage( _FormatBuffer* out, const char* format, const _FormatArg* args, uint32_t argCount )
+{
+	if ( !format ) {}
+	else if ( argCount ) { _FormatArgs( out, format, args, argCount ); }
+	else { out->Append( format ); } // Messages without arguments are written as is, including any '#'
+}
+
+void _LogWrite( uint32_t severity, const char* msg )
+{
+#if _AE_WINDOWS_
+	static bool s_logStdOut = !ae::IsDebuggerAttached();
+	if ( s_logStdOut )
+	{
+		fputs( msg, stdout ); // std out
+	}
+	else
+	{
+		OutputDebugStringA( msg ); // visual studio debug output
+	}
+#else
+	fputs( msg, stdout );
+	fflush( stdout );
+#endif
+	if ( severity == _AE_LOG_FATAL_ && !ae::IsDebuggerAttached() )
+	{
+		ShowMessage( msg );
+	}
+}
+
+void _LogArgs( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* format, const _FormatArg* args, uint32_t argCount )
+{
+	// Almost all messages fit on the stack, longer ones are formatted again
+	// once their length is known
+	char stackBuf[ 1024 ];
+	_FormatBuffer out( stackBuf, sizeof(stackBuf) );
+	_LogHeader( &out, severity, filePath, line, assertInfo, format && format[ 0 ] );
+	_LogMessage( &out, format, args, argCount );
+	out.Append( "\n", 1 );
+	if ( out.length < sizeof(stackBuf) )
+	{
+		_LogWrite( severity, stackBuf );
+	}
+	else
+	{
+		ae::Array< char > heapBuf( ae::Tag( "aeLog" ), '\0', out.length + 1 );
+		_FormatBuffer heapOut( heapBuf.Data(), heapBuf.Length() );
+		_LogHeader( &heapOut, severity, filePath, line, assertInfo, format && format[ 0 ] );
+		_LogMessage( &heapOut, format, args, argCount );
+		heapOut.Append( "\n", 1 );
+		_LogWrite( severity, heapBuf.Data() );
+	}
+}
+
+void LogInternal( uint32_t severity, const char* filePath, uint32_t line, const char* assertInfo, const char* message )
+{
+	_LogArgs( severity, filePath, line, assertInfo, message, nullptr, 0 );
+}
+
 void SetLogColorsEnabled( bool enabled )
 {
 	_ae_logColors = enabled;
@@ -13251,144 +14494,1078 @@ void TimeStep::Tick()
 }
 
 //------------------------------------------------------------------------------
-// ae::Dict members
+// Number formatting and parsing functions
 //------------------------------------------------------------------------------
-// @TODO: These should use ToString and FromString
-Dict::Dict( ae::Tag tag ) :
-	m_entries( tag )
-{}
-
-void Dict::SetString( const char* key, const char* value )
-{
-	m_entries.Set( key, value );
-}
-
-void Dict::SetInt( const char* key, int32_t value )
-{
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%d", value );
-	SetString( key, buf );
-}
-
-void Dict::SetUint( const char* key, uint32_t value )
+const uint64_t _kPow10[] =
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%u", value );
-	SetString( key, buf );
-}
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+	100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+	1000000000000ull, 10000000000000ull, 100000000000000ull,
+	1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+	1000000000000000000ull, 10000000000000000000ull
+};
 
-void Dict::SetFloat( const char* key, float value )
+// Rounds a halfway remainder to even, as printf does with the exact binary value
+static uint64_t _RoundQuotient( uint64_t quotient, uint64_t remainder, uint64_t divisor )
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%f", value );
-	SetString( key, buf );
+	const uint64_t rest = divisor - remainder;
+	return ( remainder > rest || ( remainder == rest && ( quotient & 1 ) ) ) ? quotient + 1 : quotient;
 }
 
-void Dict::SetDouble( const char* key, double value )
+// Sets \p result to \p value * 10^exp10 rounded to the nearest integer. The
+// value of a double is exactly mantissa * 2^exp2, so this is exact as long as
+// the intermediate values fit in 64 bits. Otherwise returns false.
+static bool _ScaleToInteger( double value, int32_t exp10, uint64_t* result )
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%lf", value );
-	SetString( key, buf );
-}
+	AE_DEBUG_ASSERT( value > 0.0 && std::isfinite( value ) );
+	uint64_t bits;
+	memcpy( &bits, &value, sizeof(bits) );
+	const int32_t biasedExp = (int32_t)( ( bits >> 52 ) & 0x7FF );
+	uint64_t mantissa = bits & ( ( 1ull << 52 ) - 1 );
+	int32_t exp2 = -1074;
+	if ( biasedExp )
+	{
+		mantissa |= ( 1ull << 52 );
+		exp2 = biasedExp - 1075;
+	}
+	// Floats promoted to doubles have at least 29 trailing zero bits
+	while ( !( mantissa & 0xFF ) ) { mantissa >>= 8; exp2 += 8; }
+	while ( !( mantissa & 1 ) ) { mantissa >>= 1; exp2++; }
+
+	if ( exp10 >= 0 )
+	{
+		if ( exp10 >= (int32_t)countof( _kPow10 ) || mantissa > UINT64_MAX / _kPow10[ exp10 ] )
+		{
+			return false;
+		}
+		const uint64_t scaled = mantissa * _kPow10[ exp10 ];
+		if ( exp2 >= 0 )
+		{
+			if ( exp2 >= 64 || scaled > ( UINT64_MAX >> exp2 ) )
+			{
+				return false;
+			}
+			*result = scaled << exp2;
+		}
+		else if ( -exp2 >= 64 )
+		{
+			// Less than one half unless exactly 2^63 / 2^64, which rounds to even
+			*result = ( -exp2 == 64 && scaled > ( 1ull << 63 ) ) ? 1 : 0;
+		}
+		else
+		{
+			const uint64_t divisor = 1ull << -exp2;
+			*result = _RoundQuotient( scaled >> -exp2, scaled & ( divisor - 1 ), divisor );
+		}
+		return true;
+	}
+	if ( -exp10 >= (int32_t)countof( _kPow10 ) )
+	{
+		return false;
+	}
+	uint64_t divisor = _kPow10[ -exp10 ];
+	if ( exp2 >= 0 )
+	{
+		if ( exp2 >= 64 || mantissa > ( UINT64_MAX >> exp2 ) )
+		{
+			return false;
+		}
+		mantissa <<= exp2;
+	}
+	else
+	{
+		if ( -exp2 >= 64 || divisor > ( UINT64_MAX >> -exp2 ) )
+		{
+			return false;
+		}
+		divisor <<= -exp2;
+	}
+	*result = _RoundQuotient( mantissa / divisor, mantissa % divisor, divisor );
+	return true;
+}
+
+// Writes \p value with exactly \p digits digits (zero padded), or all of its
+// digits if \p digits is 0. Returns the number of characters written.
+static uint32_t _WriteDigits( char* buf, uint64_t value, uint32_t digits = 0 )
+{
+	char temp[ 20 ];
+	uint32_t count = 0;
+	do
+	{
+		temp[ count++ ] = '0' + (char)( value % 10 );
+		value /= 10;
+	} while ( value || count < digits );
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		buf[ i ] = temp[ count - i - 1 ];
+	}
+	return count;
+}
+
+static uint32_t _CopyFormatted( char* buf, uint32_t size, const char* str, uint32_t length )
+{
+	if ( size )
+	{
+		const uint32_t copyLength = ae::Min( length, size - 1 );
+		memcpy( buf, str, copyLength );
+		buf[ copyLength ] = 0;
+	}
+	return length;
+}
+
+uint32_t FormatFloatFixed( char* buf, uint32_t size, double value, uint32_t precision )
+{
+	uint64_t scaled = 0;
+	if ( !std::isfinite( value ) || precision >= countof( _kPow10 )
+		|| ( value != 0.0 && !_ScaleToInteger( fabs( value ), precision, &scaled ) ) )
+	{
+		return snprintf( buf, size, "%.*f", precision, value );
+	}
+	char result[ 64 ];
+	uint32_t length = 0;
+	if ( std::signbit( value ) )
+	{
+		result[ length++ ] = '-';
+	}
+	length += _WriteDigits( result + length, scaled / _kPow10[ precision ] );
+	if ( precision )
+	{
+		result[ length++ ] = '.';
+		length += _WriteDigits( result + length, scaled % _kPow10[ precision ], precision );
+	}
+	return _CopyFormatted( buf, size, result, length );
+}
+
+uint32_t FormatFloatGeneral( char* buf, uint32_t size, double value, uint32_t precision )
+{
+	const int32_t digits = precision ? (int32_t)precision : 1;
+	if ( !std::isfinite( value ) || digits > 15 )
+	{
+		return snprintf( buf, size, "%.*g", precision, value );
+	}
+	char result[ 64 ];
+	uint32_t length = 0;
+	if ( std::signbit( value ) )
+	{
+		result[ length++ ] = '-';
+	}
+	const double absValue = fabs( value );
+	if ( absValue == 0.0 )
+	{
+		result[ length++ ] = '0';
+		return _CopyFormatted( buf, size, result, length );
+	}
+
+	// Find the decimal exponent of the value after rounding to 'digits'
+	// significant digits. The log10 estimate can be off by one near powers of
+	// ten, and rounding up can carry into the next power.
+	int32_t exp10 = (int32_t)floor( log10( absValue ) );
+	uint64_t scaled = 0;
+	bool found = false;
+	for ( uint32_t i = 0; i < 3 && !found; i++ )
+	{
+		if ( !_ScaleToInteger( absValue, digits - 1 - exp10, &scaled ) )
+		{
+			break;
+		}
+		if ( scaled >= _kPow10[ digits ] ) { exp10++; }
+		else if ( scaled < _kPow10[ digits - 1 ] ) { exp10--; }
+		else { found = true; }
+	}
+	if ( !found )
+	{
+		return snprintf( buf, size, "%.*g", precision, value );
+	}
+
+	if ( exp10 >= -4 && exp10 < digits )
+	{
+		// Fixed notation with trailing zeros removed
+		uint32_t fracDigits = digits - 1 - exp10;
+		length += _WriteDigits( result + length, scaled / _kPow10[ fracDigits ] );
+		uint64_t frac = scaled % _kPow10[ fracDigits ];
+		while ( fracDigits && frac % 10 == 0 )
+		{
+			frac /= 10;
+			fracDigits--;
+		}
+		if ( fracDigits )
+		{
+			result[ length++ ] = '.';
+			length += _WriteDigits( result + length, frac, fracDigits );
+		}
+	}
+	else
+	{
+		// Scientific notation with trailing zeros removed
+		uint32_t fracDigits = digits - 1;
+		result[ length++ ] = '0' + (char)( scaled / _kPow10[ fracDigits ] );
+		uint64_t frac = scaled % _kPow10[ fracDigits ];
+		while ( fracDigits && frac % 10 == 0 )
+		{
+			frac /= 10;
+			fracDigits--;
+		}
+		if ( fracDigits )
+		{
+			result[ length++ ] = '.';
+			length += _WriteDigits( result + length, frac, fracDigits );
+		}
+		result[ length++ ] = 'e';
+		result[ length++ ] = ( exp10 < 0 ) ? '-' : '+';
+		length += _WriteDigits( result + length, ae::Abs( exp10 ), 2 );
+	}
+	return _CopyFormatted( buf, size, result, length );
+}
+
+uint32_t FormatInt( char* buf, uint32_t size, int64_t value )
+{
+	char result[ 24 ];
+	uint32_t length = 0;
+	uint64_t magnitude = (uint64_t)value;
+	if ( value < 0 )
+	{
+		result[ length++ ] = '-';
+		magnitude = 0 - magnitude;
+	}
+	length += _WriteDigits( result + length, magnitude );
+	return _CopyFormatted( buf, size, result, length );
+}
+
+uint32_t FormatUint( char* buf, uint32_t size, uint64_t value )
+{
+	char result[ 24 ];
+	const uint32_t length = _WriteDigits( result, value );
+	return _CopyFormatted( buf, size, result, length );
+}
+
+// Splits the common decimal forms into a sign, an integer mantissa and a power
+// of ten. Returns false for anything else (hexadecimal, inf, nan, or more than
+// 19 significant digits) so the caller can fall back to the standard library.
+static bool _ParseDecimal( const char* str, bool* negativeOut, uint64_t* mantissaOut, int32_t* exp10Out, const char** endOut )
+{
+	const char* s = str;
+	while ( isspace( (unsigned char)*s ) ) { s++; }
+	const bool negative = ( *s == '-' );
+	if ( *s == '-' || *s == '+' ) { s++; }
+	if ( s[ 0 ] == '0' && ( s[ 1 ] == 'x' || s[ 1 ] == 'X' ) )
+	{
+		return false;
+	}
+	uint64_t mantissa = 0;
+	int32_t exp10 = 0;
+	uint32_t digitCount = 0;
+	uint32_t significantDigits = 0;
+	for ( ; *s >= '0' && *s <= '9'; s++, digitCount++ )
+	{
+		if ( mantissa || *s != '0' ) { significantDigits++; }
+		mantissa = mantissa * 10 + (uint64_t)( *s - '0' );
+	}
+	if ( *s == '.' )
+	{
+		s++;
+		for ( ; *s >= '0' && *s <= '9'; s++, digitCount++ )
+		{
+			if ( mantissa || *s != '0' ) { significantDigits++; }
+			mantissa = mantissa * 10 + (uint64_t)( *s - '0' );
+			exp10--;
+		}
+	}
+	if ( !digitCount || significantDigits > 19 )
+	{
+		return false;
+	}
+	if ( *s == 'e' || *s == 'E' )
+	{
+		const char* e = s + 1;
+		const bool negativeExp = ( *e == '-' );
+		if ( *e == '-' || *e == '+' ) { e++; }
+		if ( *e >= '0' && *e <= '9' )
+		{
+			int32_t exp = 0;
+			for ( ; *e >= '0' && *e <= '9'; e++ )
+			{
+				exp = ae::Min( exp * 10 + ( *e - '0' ), 100000 );
+			}
+			exp10 += negativeExp ? -exp : exp;
+			s = e;
+		}
+	}
+	*negativeOut = negative;
+	*mantissaOut = mantissa;
+	*exp10Out = exp10;
+	*endOut = s;
+	return true;
+}
+
+// Clinger's fast path. When the mantissa and the power of ten are both exactly
+// representable in the target type, a single multiply or divide in that type
+// is correctly rounded.
+static const double _kExactPow10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Up to 7 significant digits (mantissa <= 2^24) are parsed in float. Longer
+// mantissas up to 2^53 are parsed in double and then rounded to float. That
+// second rounding only differs from strtof() when the double lands exactly on
+// a midpoint between two floats, because every float midpoint is also a
+// double, so those values and anything longer fall back to strtof().
+float ParseFloat( const char* str, const char** endOut )
+{
+	static const float kExactPow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	bool negative;
+	uint64_t mantissa;
+	int32_t exp10;
+	const char* end;
+	if ( _ParseDecimal( str, &negative, &mantissa, &exp10, &end ) )
+	{
+		if ( !mantissa || ( mantissa <= ( 1ull << 24 ) && exp10 >= -10 && exp10 <= 10 ) )
+		{
+			float value = (float)mantissa;
+			if ( mantissa )
+			{
+				value = ( exp10 < 0 ) ? value / kExactPow10[ -exp10 ] : value * kExactPow10[ exp10 ];
+			}
+			if ( endOut ) { *endOut = end; }
+			return negative ? -value : value;
+		}
+		if ( mantissa <= ( 1ull << 53 ) && exp10 >= -22 && exp10 <= 22 )
+		{
+			double value = (double)mantissa;
+			value = ( exp10 < 0 ) ? value / _kExactPow10[ -exp10 ] : value * _kExactPow10[ exp10 ];
+			uint64_t bits;
+			memcpy( &bits, &value, sizeof(bits) );
+			// The 29 low mantissa bits are below float precision
+			if ( ( bits & ( ( 1ull << 29 ) - 1 ) ) != ( 1ull << 28 ) )
+			{
+				if ( endOut ) { *endOut = end; }
+				return negative ? -(float)value : (float)value;
+			}
+		}
+	}
+	char* fallbackEnd = nullptr;
+	const float result = strtof( str, &fallbackEnd );
+	if ( endOut ) { *endOut = fallbackEnd; }
+	return result;
+}
+
+double ParseDouble( const char* str, const char** endOut )
+{
+	bool negative;
+	uint64_t mantissa;
+	int32_t exp10;
+	const char* end;
+	if ( _ParseDecimal( str, &negative, &mantissa, &exp10, &end )
+		&& ( !mantissa || ( mantissa <= ( 1ull << 53 ) && exp10 >= -22 && exp10 <= 22 ) ) )
+	{
+		double value = (double)mantissa;
+		if ( mantissa )
+		{
+			value = ( exp10 < 0 ) ? value / _kExactPow10[ -exp10 ] : value * _kExactPow10[ exp10 ];
+		}
+		if ( endOut ) { *endOut = end; }
+		return negative ? -value : value;
+	}
+	char* fallbackEnd = nullptr;
+	const double result = strtod( str, &fallbackEnd );
+	if ( endOut ) { *endOut = fallbackEnd; }
+	return result;
+}
+
+// Parses the digits of an integer with an optional sign and prefix, saturating
+// at UINT64_MAX. Returns false if there are no digits.
+static bool _ParseIntegerDigits( const char* str, uint32_t base, uint64_t* magnitudeOut, bool* negativeOut, bool* overflowOut, const char** endOut )
+{
+	const char* s = str;
+	while ( isspace( (unsigned char)*s ) ) { s++; }
+	*negativeOut = ( *s == '-' );
+	if ( *s == '-' || *s == '+' ) { s++; }
+	auto getDigit = []( char c ) -> uint32_t
+	{
+		if ( c >= '0' && c <= '9' ) { return c - '0'; }
+		if ( c >= 'a' && c <= 'z' ) { return c - 'a' + 10; }
+		if ( c >= 'A' && c <= 'Z' ) { return c - 'A' + 10; }
+		return ~0u;
+	};
+	if ( ( base == 0 || base == 16 ) && s[ 0 ] == '0' && ( s[ 1 ] == 'x' || s[ 1 ] == 'X' ) && getDigit( s[ 2 ] ) < 16 )
+	{
+		s += 2;
+		base = 16;
+	}
+	else if ( base == 0 )
+	{
+		base = ( s[ 0 ] == '0' ) ? 8 : 10;
+	}
+	AE_ASSERT_MSG( base >= 2 && base <= 36, "Invalid base '#'", base );
+	const char* digitsStart = s;
+	uint64_t magnitude = 0;
+	bool overflow = false;
+	for ( uint32_t digit = getDigit( *s ); digit < base; digit = getDigit( *++s ) )
+	{
+		if ( magnitude > ( UINT64_MAX - digit ) / base )
+		{
+			overflow = true;
+		}
+		magnitude = magnitude * base + digit;
+	}
+	if ( s == digitsStart )
+	{
+		return false;
+	}
+	*magnitudeOut = overflow ? UINT64_MAX : magnitude;
+	*overflowOut = overflow;
+	*endOut = s;
+	return true;
+}
+
+int64_t ParseInt( const char* str, const char** endOut, uint32_t base )
+{
+	uint64_t magnitude;
+	bool negative, overflow;
+	const char* end;
+	if ( !_ParseIntegerDigits( str, base, &magnitude, &negative, &overflow, &end ) )
+	{
+		if ( endOut ) { *endOut = str; }
+		return 0;
+	}
+	if ( endOut ) { *endOut = end; }
+	if ( negative )
+	{
+		return ( overflow || magnitude > (uint64_t)INT64_MAX + 1 ) ? INT64_MIN : (int64_t)( 0 - magnitude );
+	}
+	return ( magnitude > (uint64_t)INT64_MAX ) ? INT64_MAX : (int64_t)magnitude;
+}
+
+uint64_t ParseUint( const char* str, const char** endOut, uint32_t base )
+{
+	uint64_t magnitude;
+	bool negative, overflow;
+	const char* end;
+	if ( !_ParseIntegerDigits( str, base, &magnitude, &negative, &overflow, &end ) )
+	{
+		if ( endOut ) { *endOut = str; }
+		return 0;
+	}
+	if ( endOut ) { *endOut = end; }
+	// Negative values wrap, like strtoull()
+	return ( negative && !overflow ) ? 0 - magnitude : magnitude;
+}
+
+//------------------------------------------------------------------------------
+// ae::FormatTo internal implementation
+//------------------------------------------------------------------------------
+void _FormatBuffer::Append( const char* str, uint32_t len )
+{
+	if ( length + 1 < size )
+	{
+		const uint32_t copyLen = ae::Min( len, size - length - 1 );
+		memcpy( buf + length, str, copyLen );
+		buf[ length + copyLen ] = 0;
+	}
+	length += len;
+}
+
+uint32_t _FormatArgs( _FormatBuffer* out, const char* format, const _FormatArg* args, uint32_t argCount )
+{
+	AE_DEBUG_ASSERT_MSG( GetFormatArgCount( format ) == argCount, "Format string has # placeholders but # arguments were given", GetFormatArgCount( format ), argCount );
+	const uint32_t startLength = out->length;
+	uint32_t argIdx = 0;
+	const char* head = format;
+	while ( *head )
+	{
+		const char* start = head;
+		while ( *head && *head != '#' )
+		{
+			head++;
+		}
+		if ( head > start )
+		{
+			out->Append( start, (uint32_t)( head - start ) );
+		}
+		if ( *head == '#' )
+		{
+			// Extra placeholders are written as is and extra arguments are ignored
+			if ( argIdx < argCount ) { args[ argIdx ].fn( out, args[ argIdx ].value ); argIdx++; }
+			else { out->Append( "#", 1 ); }
+			head++;
+		}
+	}
+	return out->length - startLength;
+}
+
+//------------------------------------------------------------------------------
+// ae::String member functions
+//------------------------------------------------------------------------------
+// Tags are never freed, so each ae::String only needs a pointer to its tag. The
+// last tag used by each thread is checked first to avoid locking.
+static const ae::Tag* _InternStringTag( const ae::Tag& tag )
+{
+	static thread_local const ae::Tag* s_lastTag = nullptr;
+	if ( s_lastTag && *s_lastTag == tag )
+	{
+		return s_lastTag;
+	}
+	static std::mutex s_lock;
+	static std::vector< const ae::Tag* > s_tags;
+	std::lock_guard< std::mutex > lock( s_lock );
+	auto iter = std::find_if( s_tags.begin(), s_tags.end(), [&]( const ae::Tag* t ) { return *t == tag; } );
+	if ( iter == s_tags.end() )
+	{
+		iter = s_tags.insert( s_tags.end(), new ae::Tag( tag ) );
+	}
+	s_lastTag = *iter;
+	return s_lastTag;
+}
+
+static const ae::Tag* _GetDefaultStringTag()
+{
+	static const ae::Tag* s_tag = _InternStringTag( AE_ALLOC_TAG_STRING );
+	return s_tag;
+}
+
+String::String() :
+	String( _GetDefaultStringTag(), 0 )
+{}
+
+String::String( const char* str ) :
+	String()
+{
+	m_Assign( str, (uint32_t)strlen( str ) );
+}
+
+String::String( const ae::Tag& tag ) :
+	String( _InternStringTag( tag ), 0 )
+{}
+
+String::String( const ae::Tag* tag, int ) :
+	m_tag( tag ),
+	m_length( 0 ),
+	m_isHeap( 0 ),
+	m_hash( ae::Hash().Get() )
+{
+	m_inline[ 0 ] = 0;
+}
+
+String::String( const ae::Tag& tag, const char* str ) :
+	String( tag, str, (uint32_t)strlen( str ) )
+{}
+
+String::String( const ae::Tag& tag, const char* str, uint32_t length ) :
+	String( tag )
+{
+	m_Assign( str, length );
+}
+
+String::String( const String& other ) :
+	String( other.m_tag, 0 )
+{
+	*this = other;
+}
+
+String::String( String&& other ) noexcept :
+	String( other.m_tag, 0 )
+{
+	*this = std::move( other );
+}
+
+String::~String()
+{
+	if ( m_isHeap )
+	{
+		ae::Free( m_heap.data );
+	}
+}
+
+void String::operator =( const String& other )
+{
+	if ( this != &other )
+	{
+		m_Assign( other.c_str(), other.m_length );
+	}
+}
+
+void String::operator =( String&& other ) noexcept
+{
+	if ( this == &other )
+	{
+		return;
+	}
+	else if ( !other.m_isHeap || m_tag != other.m_tag )
+	{
+		*this = other; // Regular assignment (without std::move)
+	}
+	else
+	{
+		if ( m_isHeap )
+		{
+			ae::Free( m_heap.data );
+		}
+		m_heap = other.m_heap;
+		m_isHeap = 1;
+		m_length = other.m_length;
+		m_hash = other.m_hash;
+		
+		other.m_isHeap = 0;
+		other.m_inline[ 0 ] = 0;
+		other.m_length = 0;
+		other.m_hash = ae::Hash().Get();
+		// @NOTE: Don't reset tag. 'other' must remain in a valid state.
+	}
+}
+
+void String::operator =( const char* str )
+{
+	m_Assign( str, (uint32_t)strlen( str ) );
+}
+
+void String::operator +=( const String& str )
+{
+	Append( str.c_str(), str.m_length );
+}
+
+void String::operator +=( const char* str )
+{
+	Append( str, (uint32_t)strlen( str ) );
+}
+
+void String::Append( const char* str, uint32_t length )
+{
+	// 'str' may be part of this string, so find it again after reallocating
+	const char* data = m_Data();
+	const bool isSelf = ( str >= data && str < data + m_Size() );
+	const uint32_t offset = isSelf ? (uint32_t)( str - data ) : 0;
+	Reserve( m_length + length );
+	data = m_Data();
+	char* dest = m_Data() + m_length;
+	memmove( dest, isSelf ? data + offset : str, length );
+	m_length += length;
+	m_Data()[ m_length ] = 0;
+	// fnv1a can continue from the previous hash
+	m_hash = ae::Hash( m_hash ).HashString( dest, length ).Get();
+}
+
+bool String::operator ==( const String& str ) const
+{
+	if ( m_length != str.m_length || m_hash != str.m_hash )
+	{
+		return false;
+	}
+	return memcmp( c_str(), str.c_str(), m_length ) == 0;
+}
+
+bool String::operator !=( const String& str ) const
+{
+	return !( *this == str );
+}
+
+bool String::operator <( const String& str ) const
+{
+	return strcmp( c_str(), str.c_str() ) < 0;
+}
+
+bool String::operator ==( const char* str ) const
+{
+	return strcmp( c_str(), str ) == 0;
+}
+
+bool String::operator !=( const char* str ) const
+{
+	return strcmp( c_str(), str ) != 0;
+}
+
+bool operator ==( const char* str0, const String& str1 )
+{
+	return str1 == str0;
+}
+
+bool operator !=( const char* str0, const String& str1 )
+{
+	return str1 != str0;
+}
+
+std::ostream& operator<<( std::ostream& os, const String& str )
+{
+	return os << str.c_str();
+}
+
+char String::operator[]( uint32_t i ) const
+{
+	AE_DEBUG_ASSERT( i <= m_length ); // Allow null terminator to be accessed
+	return m_Data()[ i ];
+}
+
+const char* String::c_str() const
+{
+	return m_Data();
+}
+
+void String::Reserve( uint32_t length )
+{
+	if ( length < m_Size() )
+	{
+		return;
+	}
+	AE_ASSERT_MSG( length < ( 1u << 31 ) - 16u, "ae::String length # is too long", length );
+	// Rounded up since allocators hand out at least this much anyway
+	const uint32_t size = ( ae::Max( length + 1u, m_Size() * 2u ) + 15u ) & ~15u;
+	char* heap = (char*)ae::Allocate( *m_tag, size, 1 );
+	memcpy( heap, m_Data(), m_length + 1u );
+	if ( m_isHeap )
+	{
+		ae::Free( m_heap.data );
+	}
+	m_heap.data = heap;
+	m_heap.size = size;
+	m_isHeap = 1;
+}
+
+void String::Clear()
+{
+	m_length = 0;
+	m_Data()[ 0 ] = 0;
+	m_hash = ae::Hash().Get();
+}
+
+uint32_t String::Length() const
+{
+	return m_length;
+}
+
+uint32_t String::Size() const
+{
+	return m_Size() - 1u;
+}
+
+bool String::Empty() const
+{
+	return m_length == 0;
+}
+
+uint32_t String::GetHash() const
+{
+	return m_hash;
+}
+
+const ae::Tag& String::GetTag() const
+{
+	return *m_tag;
+}
+
+void String::m_Assign( const char* str, uint32_t length )
+{
+	if ( length >= m_Size() )
+	{
+		// 'str' can't be part of this string because it's too long
+		m_length = 0;
+		Reserve( length );
+	}
+	memmove( m_Data(), str, length );
+	m_length = length;
+	m_Data()[ m_length ] = 0;
+	m_hash = ae::Hash().HashString( m_Data(), length ).Get();
+}
+
+//------------------------------------------------------------------------------
+// ae::Name members
+//------------------------------------------------------------------------------
+// Uses malloc and std::map instead of ae::Allocate because names are commonly
+// created during static initialization, before the global allocator is set
+const uint32_t _kNamePageSize = 4096;
+struct _NameRegistry
+{
+	std::mutex lock;
+	std::map< uint32_t, const char* > strings;
+	char* page = nullptr;
+	uint32_t pageRemaining = 0;
+};
+static _NameRegistry& _GetNameRegistry()
+{
+	static _NameRegistry s_registry;
+	return s_registry;
+}
+
+// Returns the hash that \p str has in the table, or the hash it would be given
+// if it was added. The registry must be locked.
+static uint32_t _FindNameHash( _NameRegistry& registry, const char* str, uint32_t hash, bool* foundOut )
+{
+	const uint32_t emptyHash = ae::Hash().Get();
+	while ( true )
+	{
+		if ( hash != emptyHash ) // Reserved for the empty string
+		{
+			auto iter = registry.strings.find( hash );
+			if ( iter == registry.strings.end() || strcmp( iter->second, str ) == 0 )
+			{
+				*foundOut = ( iter != registry.strings.end() );
+				return hash;
+			}
+		}
+		hash++;
+	}
+}
+
+Name::Name( const char* str )
+{
+	AE_ASSERT( str );
+	m_hash = m_Hash( str );
+	if ( !str[ 0 ] )
+	{
+		return;
+	}
+	_NameRegistry& registry = _GetNameRegistry();
+	std::lock_guard< std::mutex > lock( registry.lock );
+	bool found = false;
+	const uint32_t hash = _FindNameHash( registry, str, m_hash, &found );
+	if ( found )
+	{
+		m_hash = hash;
+		return;
+	}
+	if ( hash != m_hash )
+	{
+		AE_WARN( "Name '#' has the same hash as another name, using # instead of #", str, hash, m_hash );
+		m_hash = hash;
+	}
+	// Strings are never freed, so they're packed into pages to avoid lots of
+	// small allocations. Long strings get their own allocation.
+	const uint32_t size = (uint32_t)strlen( str ) + 1;
+	char* dest;
+	if ( size > _kNamePageSize / 4 )
+	{
+		dest = (char*)malloc( size );
+	}
+	else
+	{
+		if ( size > registry.pageRemaining )
+		{
+			registry.page = (char*)malloc( _kNamePageSize );
+			registry.pageRemaining = _kNamePageSize;
+		}
+		dest = registry.page;
+		registry.page += size;
+		registry.pageRemaining -= size;
+	}
+	AE_ASSERT( dest );
+	memcpy( dest, str, size );
+	registry.strings.emplace( m_hash, dest );
+}
+
+Name Name::Find( const char* str )
+{
+	AE_ASSERT( str );
+	if ( !str[ 0 ] )
+	{
+		return Name();
+	}
+	_NameRegistry& registry = _GetNameRegistry();
+	std::lock_guard< std::mutex > lock( registry.lock );
+	bool found = false;
+	return Name( _FindNameHash( registry, str, m_Hash( str ), &found ), 0 );
+}
+
+const char* Name::c_str() const
+{
+	if ( m_hash == kEmptyHash )
+	{
+		return "";
+	}
+	_NameRegistry& registry = _GetNameRegistry();
+	std::lock_guard< std::mutex > lock( registry.lock );
+	auto iter = registry.strings.find( m_hash );
+	return ( iter != registry.strings.end() ) ? iter->second : "";
+}
+
+std::ostream& operator<<( std::ostream& os, ae::Name name )
+{
+	return os << name.c_str();
+}
+
+//------------------------------------------------------------------------------
+// ae::Dict members
+//------------------------------------------------------------------------------
+Dict::Dict( ae::Tag tag ) :
+	m_tag( tag ),
+	m_entries( tag ),
+	m_keys( tag )
+{}
+
+Dict::Dict( const Dict& other ) :
+	m_tag( other.m_tag ),
+	m_entries( other.m_entries ),
+	m_keys( other.m_keys )
+{
+	m_CopyStrings();
+}
+
+Dict& Dict::operator=( const Dict& other )
+{
+	if ( this != &other )
+	{
+		m_FreeStrings();
+		m_entries = other.m_entries;
+		m_keys = other.m_keys;
+		m_CopyStrings();
+	}
+	return *this;
+}
+
+Dict::~Dict()
+{
+	m_FreeStrings();
+}
+
+void Dict::SetString( const char* key, const char* value )
+{
+	m_SetString( *m_Set( key, Type::String ), value );
+}
+
+void Dict::SetInt( const char* key, int32_t value )
+{
+	m_Set( key, Type::Int )->i = value;
+}
+
+void Dict::SetUint( const char* key, uint32_t value )
+{
+	m_Set( key, Type::Uint )->u = value;
+}
+
+void Dict::SetFloat( const char* key, float value )
+{
+	m_Set( key, Type::Float )->f[ 0 ] = value;
+}
+
+void Dict::SetDouble( const char* key, double value )
+{
+	m_Set( key, Type::Double )->d = value;
+}
 
 void Dict::SetBool( const char* key, bool value )
 {
-	SetString( key, value ? "true" : "false" );
+	m_Set( key, Type::Bool )->b = value;
 }
 
 void Dict::SetVec2( const char* key, ae::Vec2 value )
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%.3f %.3f", value.x, value.y );
-	SetString( key, buf );
+	memcpy( m_Set( key, Type::Vec2 )->f, value.data, sizeof(float) * 2 );
 }
 
 void Dict::SetVec3( const char* key, ae::Vec3 value )
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%.3f %.3f %.3f", value.x, value.y, value.z );
-	SetString( key, buf );
+	memcpy( m_Set( key, Type::Vec3 )->f, value.data, sizeof(float) * 3 );
 }
 
 void Dict::SetVec4( const char* key, ae::Vec4 value )
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%.3f %.3f %.3f %.3f", value.x, value.y, value.z, value.w );
-	SetString( key, buf );
+	memcpy( m_Set( key, Type::Vec4 )->f, value.data, sizeof(float) * 4 );
 }
 
 void Dict::SetInt2( const char* key, ae::Int2 value )
 {
-	char buf[ 128 ];
-	snprintf( buf, sizeof(buf), "%d %d", value.x, value.y );
-	SetString( key, buf );
+	Entry* entry = m_Set( key, Type::Int2 );
+	entry->i2[ 0 ] = value.x;
+	entry->i2[ 1 ] = value.y;
 }
 
 void Dict::SetMatrix4( const char* key, const ae::Matrix4& value )
 {
-	auto str = ToString( value );
-	m_entries.Set( key, str.c_str() );
+	memcpy( m_Set( key, Type::Matrix4 )->f, value.data, sizeof(float) * 16 );
 }
 
 void Dict::Clear()
 {
+	m_FreeStrings();
 	m_entries.Clear();
+	m_keys.Clear();
 }
 
 const char* Dict::GetString( const char* key, const char* defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		return value->c_str();
+		return m_GetString( *entry );
 	}
 	return defaultValue;
 }
 
 int32_t Dict::GetInt( const char* key, int32_t defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		return atoi( value->c_str() );
+		switch ( entry->type )
+		{
+			case Type::Int: return entry->i;
+			case Type::Uint: return (int32_t)entry->u;
+			case Type::Float: return (int32_t)entry->f[ 0 ];
+			case Type::Double: return (int32_t)entry->d;
+			default: return (int32_t)ae::ParseInt( m_GetString( *entry ) );
+		}
 	}
 	return defaultValue;
 }
 
 uint32_t Dict::GetUint( const char* key, uint32_t defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		return strtoul( value->c_str(), nullptr, 10 );
+		switch ( entry->type )
+		{
+			case Type::Int: return (uint32_t)entry->i;
+			case Type::Uint: return entry->u;
+			case Type::Float: return (uint32_t)entry->f[ 0 ];
+			case Type::Double: return (uint32_t)entry->d;
+			default: return (uint32_t)ae::ParseUint( m_GetString( *entry ) );
+		}
 	}
 	return defaultValue;
 }
 
 float Dict::GetFloat( const char* key, float defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		return (float)atof( value->c_str() );
+		switch ( entry->type )
+		{
+			case Type::Int: return (float)entry->i;
+			case Type::Uint: return (float)entry->u;
+			case Type::Float: return entry->f[ 0 ];
+			case Type::Double: return (float)entry->d;
+			default: return ae::ParseFloat( m_GetString( *entry ) );
+		}
 	}
 	return defaultValue;
 }
 
 double Dict::GetDouble( const char* key, double defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		return (double)atof( value->c_str() );
+		switch ( entry->type )
+		{
+			case Type::Int: return (double)entry->i;
+			case Type::Uint: return (double)entry->u;
+			case Type::Float: return (double)entry->f[ 0 ];
+			case Type::Double: return entry->d;
+			default: return ae::ParseDouble( m_GetString( *entry ) );
+		}
 	}
 	return defaultValue;
 }
 
 bool Dict::GetBool( const char* key, bool defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		if ( *value == "true" )
+		if ( entry->type == Type::Bool )
+		{
+			return entry->b;
+		}
+		const char* value = m_GetString( *entry );
+		if ( strcmp( value, "true" ) == 0 )
 		{
 			return true;
 		}
-		else if ( *value == "false" )
+		else if ( strcmp( value, "false" ) == 0 )
 		{
 			return false;
 		}
@@ -13398,10 +15575,17 @@ bool Dict::GetBool( const char* key, bool defaultValue ) const
 
 ae::Vec2 Dict::GetVec2( const char* key, ae::Vec2 defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
 		ae::Vec2 result( 0.0f );
-		sscanf( value->c_str(), "%f %f", &result.x, &result.y );
+		if ( entry->type == Type::Vec2 )
+		{
+			memcpy( result.data, entry->f, sizeof(float) * 2 );
+		}
+		else
+		{
+			_FromStringFloats( m_GetString( *entry ), result.data, 2 );
+		}
 		return result;
 	}
 	return defaultValue;
@@ -13409,10 +15593,17 @@ ae::Vec2 Dict::GetVec2( const char* key, ae::Vec2 defaultValue ) const
 
 ae::Vec3 Dict::GetVec3( const char* key, ae::Vec3 defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
 		ae::Vec3 result( 0.0f );
-		sscanf( value->c_str(), "%f %f %f", &result.x, &result.y, &result.z );
+		if ( entry->type == Type::Vec3 )
+		{
+			memcpy( result.data, entry->f, sizeof(float) * 3 );
+		}
+		else
+		{
+			_FromStringFloats( m_GetString( *entry ), result.data, 3 );
+		}
 		return result;
 	}
 	return defaultValue;
@@ -13420,10 +15611,17 @@ ae::Vec3 Dict::GetVec3( const char* key, ae::Vec3 defaultValue ) const
 
 ae::Vec4 Dict::GetVec4( const char* key, ae::Vec4 defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
 		ae::Vec4 result( 0.0f );
-		sscanf( value->c_str(), "%f %f %f %f", &result.x, &result.y, &result.z, &result.w );
+		if ( entry->type == Type::Vec4 )
+		{
+			memcpy( result.data, entry->f, sizeof(float) * 4 );
+		}
+		else
+		{
+			_FromStringFloats( m_GetString( *entry ), result.data, 4 );
+		}
 		return result;
 	}
 	return defaultValue;
@@ -13431,10 +15629,17 @@ ae::Vec4 Dict::GetVec4( const char* key, ae::Vec4 defaultValue ) const
 
 ae::Int2 Dict::GetInt2( const char* key, ae::Int2 defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		ae::Int2 result( 0.0f );
-		sscanf( value->c_str(), "%d %d", &result.x, &result.y );
+		ae::Int2 result( 0 );
+		if ( entry->type == Type::Int2 )
+		{
+			result = ae::Int2( entry->i2[ 0 ], entry->i2[ 1 ] );
+		}
+		else
+		{
+			_FromStringInts( m_GetString( *entry ), result.data, 2 );
+		}
 		return result;
 	}
 	return defaultValue;
@@ -13442,26 +15647,155 @@ ae::Int2 Dict::GetInt2( const char* key, ae::Int2 defaultValue ) const
 
 ae::Matrix4 Dict::GetMatrix4( const char* key, const ae::Matrix4& defaultValue ) const
 {
-	if ( const ae::Str128* value = m_entries.TryGet( key ) )
+	if ( const Entry* entry = m_TryGet( key ) )
 	{
-		return ae::FromString< ae::Matrix4 >( value->c_str(), defaultValue );
+		if ( entry->type == Type::Matrix4 )
+		{
+			ae::Matrix4 result;
+			memcpy( result.data, entry->f, sizeof(float) * 16 );
+			return result;
+		}
+		return ae::FromString< ae::Matrix4 >( m_GetString( *entry ), defaultValue );
 	}
 	return defaultValue;
 }
 
 bool Dict::Has( const char* key ) const
 {
-	return m_entries.TryGet( key ) != nullptr;
+	return m_TryGet( key ) != nullptr;
 }
 
 const char* Dict::GetKey( uint32_t idx ) const
 {
-	return m_entries.GetKey( idx ).c_str();
+	return &m_keys[ m_entries.GetValue( idx ).key ];
 }
 
 const char* Dict::GetValue( uint32_t idx ) const
 {
-	return m_entries.GetValue( idx ).c_str();
+	return m_GetString( m_entries.GetValue( idx ) );
+}
+
+// Keys whose hashes collide are stored under the next unused hash, so lookups
+// continue until the key matches or an unused hash is found. This works because
+// entries are never removed individually.
+Dict::Entry* Dict::m_Set( const char* key, Type type )
+{
+	uint32_t hash = ae::Hash().HashString( key ).Get();
+	Entry* entry = m_entries.TryGet( hash );
+	while ( entry && strcmp( &m_keys[ entry->key ], key ) != 0 )
+	{
+		entry = m_entries.TryGet( ++hash );
+	}
+	if ( !entry )
+	{
+		Entry newEntry;
+		newEntry.key = m_keys.Length();
+		newEntry.string = nullptr;
+		newEntry.stringSize = 0;
+		m_keys.AppendArray( key, (uint32_t)strlen( key ) + 1 );
+		entry = &m_entries.Set( hash, newEntry );
+	}
+	// The string buffer is kept for reuse, it's only stale now
+	entry->type = type;
+	entry->hasString = false;
+	return entry;
+}
+
+const Dict::Entry* Dict::m_TryGet( const char* key ) const
+{
+	uint32_t hash = ae::Hash().HashString( key ).Get();
+	const Entry* entry = m_entries.TryGet( hash );
+	while ( entry && strcmp( &m_keys[ entry->key ], key ) != 0 )
+	{
+		entry = m_entries.TryGet( ++hash );
+	}
+	return entry;
+}
+
+const char* Dict::m_GetString( const Entry& entry ) const
+{
+	if ( !entry.hasString )
+	{
+		// @NOTE: Formats match what was previously stored, so existing files
+		// and string comparisons are unaffected
+		char buf[ 1024 ]; // Large enough for a Matrix4 of FLT_MAX
+		uint32_t length = 0;
+		auto appendFloats = [&]( const float* values, uint32_t count, uint32_t precision )
+		{
+			for ( uint32_t i = 0; i < count; i++ )
+			{
+				if ( i ) { buf[ length++ ] = ' '; }
+				length += ae::FormatFloatFixed( buf + length, sizeof(buf) - length, values[ i ], precision );
+			}
+		};
+		switch ( entry.type )
+		{
+			case Type::String: AE_FAIL(); break;
+			case Type::Int: ae::FormatInt( buf, sizeof(buf), entry.i ); break;
+			case Type::Uint: ae::FormatUint( buf, sizeof(buf), entry.u ); break;
+			case Type::Float: appendFloats( entry.f, 1, 6 ); break;
+			case Type::Double: ae::FormatFloatFixed( buf, sizeof(buf), entry.d, 6 ); break;
+			case Type::Bool: strcpy( buf, entry.b ? "true" : "false" ); break;
+			case Type::Vec2: appendFloats( entry.f, 2, 3 ); break;
+			case Type::Vec3: appendFloats( entry.f, 3, 3 ); break;
+			case Type::Vec4: appendFloats( entry.f, 4, 3 ); break;
+			case Type::Int2:
+				length = ae::FormatInt( buf, sizeof(buf), entry.i2[ 0 ] );
+				buf[ length++ ] = ' ';
+				ae::FormatInt( buf + length, sizeof(buf) - length, entry.i2[ 1 ] );
+				break;
+			case Type::Matrix4: appendFloats( entry.f, 16, 3 ); break;
+		}
+		m_SetString( entry, buf );
+	}
+	return entry.string;
+}
+
+void Dict::m_SetString( const Entry& entry, const char* str ) const
+{
+	const uint32_t size = (uint32_t)strlen( str ) + 1;
+	if ( size > entry.stringSize )
+	{
+		// Copy before freeing, \p str may point into the current string
+		const uint32_t newSize = ( size + 15 ) & ~15u;
+		char* string = (char*)ae::Allocate( m_tag, newSize, 1 );
+		memcpy( string, str, size );
+		ae::Free( entry.string );
+		entry.string = string;
+		entry.stringSize = newSize;
+	}
+	else
+	{
+		memmove( entry.string, str, size );
+	}
+	entry.hasString = true;
+}
+
+void Dict::m_FreeStrings()
+{
+	for ( uint32_t i = 0; i < m_entries.Length(); i++ )
+	{
+		Entry& entry = m_entries.GetValue( i );
+		ae::Free( entry.string );
+		entry.string = nullptr;
+		entry.stringSize = 0;
+		entry.hasString = false;
+	}
+}
+
+void Dict::m_CopyStrings()
+{
+	for ( uint32_t i = 0; i < m_entries.Length(); i++ )
+	{
+		Entry& entry = m_entries.GetValue( i );
+		const char* other = entry.string;
+		entry.string = nullptr;
+		entry.stringSize = 0;
+		if ( entry.hasString )
+		{
+			m_SetString( entry, other );
+		}
+	}
 }
 
 std::ostream& operator<<( std::ostream& os, const Dict& dict )
@@ -13889,6 +16223,19 @@ Hash& Hash::HashString( const char* str )
 	return *this;
 }
 
+Hash& Hash::HashString( const char* str, uint32_t length )
+{
+	// Hashes plain char like HashString( const char* ), which differs from
+	// HashData() for non-ASCII characters where char is signed
+	for ( uint32_t i = 0; i < length; i++ )
+	{
+		m_hash = m_hash ^ str[ i ];
+		m_hash *= 0x1000193;
+	}
+
+	return *this;
+}
+
 Hash& Hash::HashData( const void* _data, uint32_t length )
 {
 	const uint8_t* data = (const uint8_t*)_data;
@@ -13919,6 +16266,8 @@ template <> uint32_t GetHash( int32_t key ) { return (uint32_t)key; }
 template <> uint32_t GetHash( const char* key ) { return ae::Hash().HashString( key ).Get(); }
 template <> uint32_t GetHash( char* key ) { return ae::Hash().HashString( key ).Get(); }
 template <> uint32_t GetHash( std::string key ) { return ae::Hash().HashString( key.c_str() ).Get(); }
+uint32_t GetHash( const ae::String& key ) { return key.GetHash(); }
+template <> uint32_t GetHash( ae::Name key ) { return key.GetHash(); }
 template <> uint32_t GetHash( ae::Hash key ) { return key.Get(); }
 template <> uint32_t GetHash( ae::NetId key ) { return ae::Hash().HashBasicType( key.GetInternalId() ).Get(); }
 template <> uint32_t GetHash( ae::Int2 key )
@@ -13947,93 +16296,214 @@ template <> uint32_t GetHash( ae::Int3 key )
 //------------------------------------------------------------------------------
 HotLoader::~HotLoader()
 {
+	m_CancelBuild();
 	Close();
 }
 
 void HotLoader::Initialize( const char* buildCmd, const char* postBuildCmd, const char* libPath )
 {
+	m_CancelBuild();
 	m_fns.Clear();
 	Close();
 	m_buildCmd = buildCmd;
 	m_postBuildCmd = postBuildCmd;
 	m_libPath = libPath;
 	Reload();
+	while ( IsBuilding() )
+	{
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+		Update();
+	}
+	Update();
 }
 
 void HotLoader::Reload()
 {
-	bool reload = true;
-	if ( m_buildCmd.Length() )
+	if ( IsBuilding() )
+	{
+		m_reloadPending = true;
+		return;
+	}
+	m_reloadPending = false;
+	m_loadPending = false;
+	if ( m_buildCmd.Length() && m_StartCommand( m_buildCmd.c_str() ) )
+	{
+		m_buildStep = BuildStep::Build;
+	}
+	else if ( m_buildCmd.Length() )
+	{
+		AE_WARN( "Reload aborted" );
+	}
+	else if ( m_postBuildCmd.Length() && m_StartCommand( m_postBuildCmd.c_str() ) )
+	{
+		m_buildStep = BuildStep::PostBuild;
+	}
+	else if ( m_postBuildCmd.Length() )
+	{
+		AE_WARN( "Reload aborted" );
+	}
+	else
+	{
+		m_loadPending = true;
+	}
+}
+
+bool HotLoader::Update()
+{
+	bool success = false;
+	if ( IsBuilding() && !m_PollCommand( &success ) )
+	{
+		if ( success && m_buildStep == BuildStep::Build && m_postBuildCmd.Length() )
+		{
+			success = m_StartCommand( m_postBuildCmd.c_str() );
+			m_buildStep = success ? BuildStep::PostBuild : BuildStep::None;
+		}
+		else
+		{
+			m_buildStep = BuildStep::None;
+			m_loadPending = success;
+		}
+		if ( !success )
+		{
+			AE_WARN( "Reload aborted" );
+		}
+		if ( !IsBuilding() && m_reloadPending )
+		{
+			// Files changed during the build so the result is already stale
+			Reload();
+		}
+	}
+	
+	if ( m_loadPending )
+	{
+		m_loadPending = false;
+		m_Load();
+		return IsLoaded();
+	}
+	return false;
+}
+
+void HotLoader::Close()
+{
+	for ( auto& fn : m_fns )
 	{
-		AE_INFO( m_buildCmd.c_str() );
-		reload = reload && ( system( m_buildCmd.c_str() ) == 0 );
+		fn.value = nullptr;
 	}
-	if ( m_postBuildCmd.Length() )
+	if ( m_dylib )
 	{
-		AE_INFO( m_postBuildCmd.c_str() );
-		reload = reload && ( system( m_postBuildCmd.c_str() ) == 0 );
+		AE_INFO( "Closing '#'", m_libPath );
+#if _AE_APPLE_ || _AE_LINUX_
+		if ( dlclose( m_dylib ) )
+		{
+			AE_FAIL_MSG( "dlclose() failed: #", dlerror() );
+		}
+		const bool isLoaded = dlopen( m_loadedPath.c_str(), RTLD_NOLOAD | RTLD_LOCAL );
+		AE_ASSERT_MSG( !isLoaded, "Could not unload library '#'. See AE_EXPORT comments.", m_libPath );
+		unlink( m_loadedPath.c_str() );
+#endif
+		m_dylib = nullptr;
+		m_loadedPath = "";
 	}
+}
+
+void HotLoader::m_Load()
+{
+	Close();
 
-	if ( reload )
+	AE_INFO( "Loading: '#'", m_libPath );
+#if _AE_APPLE_ || _AE_LINUX_
+	// Load a copy so the linker can replace the original while it's loaded, and
+	// so a new version is never confused with the previous one by dlopen()
+	const uint32_t size = ae::FileSystem::GetSize( m_libPath.c_str() );
+	AE_ASSERT_MSG( size, "Could not read library '#'", m_libPath );
+	const char* fileName = ae::FileSystem::GetFileNameFromPath( m_libPath.c_str() );
+	ae::Str256 tempPath = ae::Str256::Format( "/tmp/ae_hotload_XXXXXX_#", fileName );
+	const int fd = mkstemps( &tempPath[ 0 ], (int)strlen( fileName ) + 1 );
+	AE_ASSERT_MSG( fd >= 0, "Could not create temporary file for library '#'", m_libPath );
+	close( fd );
+	uint8_t* data = ae::NewArray< uint8_t >( AE_ALLOC_TAG_FILE, size );
+	const bool copied = ( ae::FileSystem::Read( m_libPath.c_str(), data, size ) == size )
+		&& ( ae::FileSystem::Write( tempPath.c_str(), data, size, false ) == size );
+	ae::Delete( data );
+	AE_ASSERT_MSG( copied, "Could not copy library '#' to '#'", m_libPath, tempPath );
+	m_loadedPath = tempPath;
+	
+	m_dylib = dlopen( m_loadedPath.c_str(), RTLD_NOW | RTLD_LOCAL );
+	AE_ASSERT_MSG( m_dylib, "dlopen() failed: #", dlerror() );
+	for ( auto& fn : m_fns )
 	{
-		Close();
+		fn.value = dlsym( m_dylib, fn.key.c_str() );
+		AE_ASSERT_MSG( fn.value, "dlsym( \"#\" ) failed: #", fn.key, dlerror() );
+	}
+#else
+	AE_FAIL_MSG( "HotLoader not implemented for this platform" );
+#endif
+}
 
-		AE_INFO( "Loading: '#'", m_libPath );
-#if _AE_APPLE_
-		m_dylib = dlopen( m_libPath.c_str(), RTLD_NOW | RTLD_LOCAL );
-		AE_ASSERT_MSG( m_dylib, "dlopen() failed: #", dlerror() );
+void* HotLoader::m_LoadFn( const char* name )
+{
+#if _AE_APPLE_ || _AE_LINUX_
+	void* fn = m_fns.Set( name, dlsym( m_dylib, name ) );
+	AE_ASSERT_MSG( fn, "Could not load function '#'", name );
+	return fn;
 #else
-		AE_FAIL_MSG( "HotLoader not implemented for this platform" );
+	return nullptr;
 #endif
+}
 
-		for ( auto& fn : m_fns )
-		{
+bool HotLoader::m_StartCommand( const char* cmd )
+{
+	AE_INFO( cmd );
+#if _AE_APPLE_ || _AE_LINUX_
+	char* argv[] = { (char*)"sh", (char*)"-c", (char*)cmd, nullptr };
 #if _AE_APPLE_
-			fn.value = dlsym( m_dylib, fn.key.c_str() );
-			AE_ASSERT_MSG( fn.value, "dlsym( \"#\" ) failed: #", fn.key, dlerror() );
+	char** env = *_NSGetEnviron();
+#else
+	char** env = environ;
 #endif
-		}
-	}
-	else
+	pid_t pid = 0;
+	if ( posix_spawn( &pid, "/bin/sh", nullptr, nullptr, argv, env ) != 0 )
 	{
-		AE_WARN( "Reload aborted" );
+		return false;
 	}
+	m_buildPid = pid;
+#else
+	// @NOTE: Loading is only implemented on Apple platforms and Linux, so
+	// elsewhere the command simply blocks until it finishes
+	m_buildResult = system( cmd );
+#endif
+	return true;
 }
 
-void HotLoader::Close()
+bool HotLoader::m_PollCommand( bool* successOut )
 {
-	for ( auto& fn : m_fns )
+#if _AE_APPLE_ || _AE_LINUX_
+	int status = 0;
+	const pid_t result = waitpid( m_buildPid, &status, WNOHANG );
+	if ( result == 0 )
 	{
-		fn.value = nullptr;
+		return true;
 	}
-	if ( m_dylib )
-	{
-		AE_INFO( "Closing '#'", m_libPath );
-#if _AE_APPLE_
-		if ( dlclose( m_dylib ) )
-		{
-			AE_FAIL_MSG( "dlclose() failed: #", dlerror() );
-		}
-#endif
-		
-#if _AE_APPLE_
-		const bool isLoaded = dlopen( m_libPath.c_str(), RTLD_NOLOAD | RTLD_LOCAL );
-		AE_ASSERT_MSG( !isLoaded, "Could not unload library '#'. See AE_EXPORT comments.", m_libPath );
+	m_buildResult = ( result == m_buildPid && WIFEXITED( status ) ) ? WEXITSTATUS( status ) : -1;
+	m_buildPid = 0;
 #endif
-		
-		m_dylib = nullptr;
-	}
+	*successOut = ( m_buildResult == 0 );
+	return false;
 }
 
-void* HotLoader::m_LoadFn( const char* name )
+void HotLoader::m_CancelBuild()
 {
-#if _AE_APPLE_
-	void* fn = m_fns.Set( name, dlsym( m_dylib, name ) );
-	AE_ASSERT_MSG( fn, "Could not load function '#'", name );
-	return fn;
-#else
-	return nullptr;
+#if _AE_APPLE_ || _AE_LINUX_
+	if ( m_buildPid )
+	{
+		kill( m_buildPid, SIGTERM );
+		waitpid( m_buildPid, nullptr, 0 );
+		m_buildPid = 0;
+	}
 #endif
+	m_buildStep = BuildStep::None;
+	m_reloadPending = false;
+	m_loadPending = false;
 }
 
 bool HotLoader::GetCMakeBuildCommand( ae::Str256* buildCmdOut, const char* cmakeBuildDir, const char* cmakeTargetName )
@@ -17136,7 +19606,7 @@ ae::Array< char > CreateFilterString( const Array< FileFilter, 8 >& filters )
 	return result;
 }
 
-ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params )
+ae::Array< ae::String > FileSystem::OpenDialog( const FileDialogParams& params )
 {
 	ae::Array< char > filterStr = CreateFilterString( params.filters );
 
@@ -17167,7 +19637,7 @@ ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params
 	{
 		if ( !params.allowMultiselect )
 		{
-			return ae::Array< std::string >( AE_ALLOC_TAG_FILE, winParams.lpstrFile, 1 );
+			return ae::Array< ae::String >( AE_ALLOC_TAG_FILE, ae::String( AE_ALLOC_TAG_FILE, winParams.lpstrFile ), 1 );
 		}
 		else
 		{
@@ -17175,18 +19645,19 @@ ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params
 			uint32_t offset = (uint32_t)strlen( winParams.lpstrFile ) + 1; 
 			if ( winParams.lpstrFile[ offset ] == 0 ) // One result
 			{
-				return ae::Array< std::string >( AE_ALLOC_TAG_FILE, winParams.lpstrFile, 1 );
+				return ae::Array< ae::String >( AE_ALLOC_TAG_FILE, ae::String( AE_ALLOC_TAG_FILE, winParams.lpstrFile ), 1 );
 			}
 			else // Multiple results
 			{
 				const char* head = winParams.lpstrFile;
 				const char* directory = head;
 				head += offset; // Null separated
-				ae::Array< std::string > result = AE_ALLOC_TAG_FILE;
+				const char separator = AE_PATH_SEPARATOR;
+				ae::Array< ae::String > result = AE_ALLOC_TAG_FILE;
 				while ( *head )
 				{
-					auto&& r = result.Append( directory );
-					r += AE_PATH_SEPARATOR;
+					auto&& r = result.Append( ae::String( AE_ALLOC_TAG_FILE, directory ) );
+					r.Append( &separator, 1 );
 					r += head;
 
 					offset = (uint32_t)strlen( head ) + 1; // Double null terminated
@@ -17197,10 +19668,10 @@ ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params
 		}
 	}
 
-	return ae::Array< std::string >( AE_ALLOC_TAG_FILE );
+	return ae::Array< ae::String >( AE_ALLOC_TAG_FILE );
 }
 
-std::string FileSystem::SaveDialog( const FileDialogParams& params )
+ae::String FileSystem::SaveDialog( const FileDialogParams& params )
 {
 	ae::Array< char > filterStr = CreateFilterString( params.filters );
 
@@ -17232,10 +19703,10 @@ std::string FileSystem::SaveDialog( const FileDialogParams& params )
 			
 			FixPathExtension( ext, &result );
 		}
-		return result.string();
+		return ae::String( AE_ALLOC_TAG_FILE, result.string().c_str() );
 	}
 
-	return "";
+	return ae::String( AE_ALLOC_TAG_FILE );
 }
 
 #elif _AE_APPLE_
@@ -17243,7 +19714,7 @@ std::string FileSystem::SaveDialog( const FileDialogParams& params )
 //------------------------------------------------------------------------------
 // OpenDialog not implemented
 //------------------------------------------------------------------------------
-ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params )
+ae::Array< ae::String > FileSystem::OpenDialog( const FileDialogParams& params )
 {
 	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
 	NSWindow* window = (NSWindow*)( params.window ? params.window->window : nullptr );
@@ -17285,7 +19756,7 @@ ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params
 	
 	__block bool finished = false;
 	__block bool success = false;
-	ae::Array< std::string > result = AE_ALLOC_TAG_FILE;
+	ae::Array< ae::String > result = AE_ALLOC_TAG_FILE;
 	// Show
 	if ( window )
 	{
@@ -17313,12 +19784,12 @@ ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params
 		{
 			for (NSURL* url in dialog.URLs)
 			{
-				result.Append( url.fileSystemRepresentation );
+				result.Append( ae::String( AE_ALLOC_TAG_FILE, url.fileSystemRepresentation ) );
 			}
 		}
 		else if ( dialog.URL )
 		{
-			result.Append( dialog.URL.fileSystemRepresentation );
+			result.Append( ae::String( AE_ALLOC_TAG_FILE, dialog.URL.fileSystemRepresentation ) );
 		}
 	}
 	
@@ -17329,7 +19800,7 @@ ae::Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params
 //------------------------------------------------------------------------------
 // SaveDialog not implemented
 //------------------------------------------------------------------------------
-std::string FileSystem::SaveDialog( const FileDialogParams& params )
+ae::String FileSystem::SaveDialog( const FileDialogParams& params )
 {
 	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
 	NSWindow* window = (NSWindow*)( params.window ? params.window->window : nullptr );
@@ -17368,7 +19839,7 @@ std::string FileSystem::SaveDialog( const FileDialogParams& params )
 	
 	__block bool finished = false;
 	__block bool success = false;
-	std::string result;
+	ae::String result( AE_ALLOC_TAG_FILE );
 	// Show
 	if ( window )
 	{
@@ -17404,17 +19875,17 @@ std::string FileSystem::SaveDialog( const FileDialogParams& params )
 //------------------------------------------------------------------------------
 // OpenDialog not implemented
 //------------------------------------------------------------------------------
-Array< std::string > FileSystem::OpenDialog( const FileDialogParams& params )
+Array< ae::String > FileSystem::OpenDialog( const FileDialogParams& params )
 {
-	return Array< std::string >( AE_ALLOC_TAG_FILE );
+	return Array< ae::String >( AE_ALLOC_TAG_FILE );
 }
 
 //------------------------------------------------------------------------------
 // SaveDialog not implemented
 //------------------------------------------------------------------------------
-std::string FileSystem::SaveDialog( const FileDialogParams& params )
+ae::String FileSystem::SaveDialog( const FileDialogParams& params )
 {
-	return "";
+	return ae::String( AE_ALLOC_TAG_FILE );
 }
 
 #endif
@@ -18225,6 +20696,13 @@ namespace ae
 	uint32_t GLMinorVersion = 1;
 #endif
 bool ReverseZ = false;
+#ifndef AE_NULL_GRAPHICS
+	#define AE_NULL_GRAPHICS 0
+#endif
+bool NullGraphics = AE_NULL_GRAPHICS;
+GraphicsStats _graphicsStats;
+const GraphicsStats& GetGraphicsStats() { return _graphicsStats; }
+void ResetGraphicsStats() { _graphicsStats = GraphicsStats(); }
 }  // ae end
 
 #if _AE_WINDOWS_
@@ -18293,8 +20771,19 @@ typedef intptr_t GLintptr;
 #define GL_R16F                           0x822D
 #define GL_R32F                           0x822E
 #define GL_R16UI                          0x8234
+// GL_VERSION_3_1
+#define GL_COPY_READ_BUFFER               0x8F36
+#define GL_COPY_WRITE_BUFFER              0x8F37
 // GL_VERSION_3_2
+typedef struct __GLsync *GLsync;
+typedef uint64_t GLuint64;
 #define GL_FRAMEBUFFER_INCOMPLETE_LAYER_TARGETS 0x8DA8
+#define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+#define GL_ALREADY_SIGNALED               0x911A
+#define GL_TIMEOUT_EXPIRED                0x911B
+#define GL_CONDITION_SATISFIED            0x911C
+#define GL_WAIT_FAILED                    0x911D
+#define GL_SYNC_FLUSH_COMMANDS_BIT        0x00000001
 // GL_VERSION_4_3
 typedef void ( *GLDEBUGPROC )(GLenum source,GLenum type,GLuint id,GLenum severity,GLsizei length,const GLchar *message,const void *userParam);
 #define GL_DEBUG_SEVERITY_HIGH            0x9146
@@ -18347,11 +20836,16 @@ void ( *glBindBuffer ) ( GLenum target, GLuint buffer ) = nullptr;
 void ( *glGenBuffers ) ( GLsizei n, GLuint *buffers ) = nullptr;
 void ( *glBufferData ) ( GLenum target, GLsizeiptr size, const void *data, GLenum usage ) = nullptr;
 void ( *glBufferSubData ) ( GLenum target, GLintptr offset, GLsizeiptr size, const void *data ) = nullptr;
+void ( *glCopyBufferSubData ) ( GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size ) = nullptr;
 void ( *glEnableVertexAttribArray ) ( GLuint index ) = nullptr;
 void ( *glVertexAttribPointer ) ( GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer ) = nullptr;
 void ( *glVertexAttribDivisor )( GLuint index, GLuint divisor ) = nullptr;
 void ( *glDrawElementsInstanced )( GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount ) = nullptr;
 void ( *glDrawArraysInstanced )( GLenum mode, GLint first, GLsizei count, GLsizei instancecount ) = nullptr;
+// OpenGL Sync Functions
+GLsync ( *glFenceSync ) ( GLenum condition, GLbitfield flags ) = nullptr;
+GLenum ( *glClientWaitSync ) ( GLsync sync, GLbitfield flags, GLuint64 timeout ) = nullptr;
+void ( *glDeleteSync ) ( GLsync sync ) = nullptr;
 // Debug functions
 void ( *glDebugMessageCallback ) ( GLDEBUGPROC callback, const void* userParam ) = nullptr;
 #endif
@@ -18363,7 +20857,7 @@ void ( *glDebugMessageCallback ) ( GLDEBUGPROC callback, const void* userParam )
 // Helpers
 // clang-format off
 #if _AE_DEBUG_
-	#define AE_CHECK_GL_ERROR() do { if ( GLenum err = glGetError() ) { AE_FAIL_MSG( "GL Error: #", err ); } } while ( 0 )
+	#define AE_CHECK_GL_ERROR() do { if ( ae::NullGraphics ) { break; } if ( GLenum err = glGetError() ) { AE_FAIL_MSG( "GL Error: #", err ); } } while ( 0 )
 #else
 	#define AE_CHECK_GL_ERROR() do {} while ( 0 )
 #endif
@@ -18548,92 +21042,145 @@ const _kQuadIndex _kQuadIndices[ _kQuadIndexCount ] = {
 const uint32_t _kMaxFrameBufferAttachments = 16;
 
 //------------------------------------------------------------------------------
-// ae::UniformList member functions
+// ae::UniformId member functions
 //------------------------------------------------------------------------------
-void UniformList::Set( const char* name, float value )
+struct _UniformIdRegistry
+{
+	std::mutex lock;
+	ae::Map< Str32, uint32_t > ids = AE_ALLOC_TAG_RENDER;
+	ae::Array< Str32 > names = AE_ALLOC_TAG_RENDER;
+};
+static _UniformIdRegistry& _GetUniformIdRegistry()
+{
+	static _UniformIdRegistry s_registry;
+	return s_registry;
+}
+
+UniformId::UniformId( const char* name )
 {
 	AE_ASSERT( name );
 	AE_ASSERT( name[ 0 ] );
-	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( name ), "Max uniforms: #", m_uniforms.Size() );
-	Value& uniform = m_uniforms.Set( name, Value() );
+	AE_ASSERT_MSG( strlen( name ) <= Str32::MaxLength(), "Uniform name '#' is too long", name );
+	_UniformIdRegistry& registry = _GetUniformIdRegistry();
+	std::lock_guard< std::mutex > lock( registry.lock );
+	if ( const uint32_t* id = registry.ids.TryGet( name ) )
+	{
+		m_id = *id;
+	}
+	else
+	{
+		registry.names.Append( name );
+		m_id = registry.names.Length(); // 0 is invalid
+		registry.ids.Set( name, m_id );
+	}
+}
+
+Str32 UniformId::GetName() const
+{
+	if ( !m_id )
+	{
+		return "";
+	}
+	_UniformIdRegistry& registry = _GetUniformIdRegistry();
+	std::lock_guard< std::mutex > lock( registry.lock );
+	return registry.names[ m_id - 1 ];
+}
+
+template <> uint32_t GetHash( ae::UniformId key ) { return ae::Hash().HashBasicType( key.GetInternalId() ).Get(); }
+
+//------------------------------------------------------------------------------
+// ae::UniformList member functions
+//------------------------------------------------------------------------------
+UniformList::Value& UniformList::m_Set( UniformId id )
+{
+	AE_ASSERT( id );
+	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( id ), "Max uniforms: #", m_uniforms.Size() );
+	m_hash.HashBasicType( id.GetInternalId() );
+	return m_uniforms.Set( id, Value() );
+}
+
+void UniformList::Set( UniformId id, float value )
+{
+	Value& uniform = m_Set( id );
 	uniform.size = 1;
 	uniform.value.data[ 0 ] = value;
-	m_hash.HashString( name );
 	m_hash.HashBasicType( value );
 }
 
-void UniformList::Set( const char* name, Vec2 value )
+void UniformList::Set( UniformId id, Vec2 value )
 {
-	AE_ASSERT( name );
-	AE_ASSERT( name[ 0 ] );
-	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( name ), "Max uniforms: #", m_uniforms.Size() );
-	Value& uniform = m_uniforms.Set( name, Value() );
+	Value& uniform = m_Set( id );
 	uniform.size = 2;
 	uniform.value.data[ 0 ] = value.x;
 	uniform.value.data[ 1 ] = value.y;
-	m_hash.HashString( name );
 	m_hash.HashBasicType( value.data );
 }
 
-void UniformList::Set( const char* name, Vec3 value )
+void UniformList::Set( UniformId id, Vec3 value )
 {
-	AE_ASSERT( name );
-	AE_ASSERT( name[ 0 ] );
-	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( name ), "Max uniforms: #", m_uniforms.Size() );
-	Value& uniform = m_uniforms.Set( name, Value() );
+	Value& uniform = m_Set( id );
 	uniform.size = 3;
 	uniform.value.data[ 0 ] = value.x;
 	uniform.value.data[ 1 ] = value.y;
 	uniform.value.data[ 2 ] = value.z;
-	m_hash.HashString( name );
 	m_hash.HashBasicType( value.data );
 }
 
-void UniformList::Set( const char* name, Vec4 value )
+void UniformList::Set( UniformId id, Vec4 value )
 {
-	AE_ASSERT( name );
-	AE_ASSERT( name[ 0 ] );
-	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( name ), "Max uniforms: #", m_uniforms.Size() );
-	Value& uniform = m_uniforms.Set( name, Value() );
+	Value& uniform = m_Set( id );
 	uniform.size = 4;
 	uniform.value.data[ 0 ] = value.x;
 	uniform.value.data[ 1 ] = value.y;
 	uniform.value.data[ 2 ] = value.z;
 	uniform.value.data[ 3 ] = value.w;
-	m_hash.HashString( name );
 	m_hash.HashBasicType( value.data );
 }
 
-void UniformList::Set( const char* name, const Matrix4& value )
+void UniformList::Set( UniformId id, const Matrix4& value )
 {
-	AE_ASSERT( name );
-	AE_ASSERT( name[ 0 ] );
-	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( name ), "Max uniforms: #", m_uniforms.Size() );
-	Value& uniform = m_uniforms.Set( name, Value() );
+	Value& uniform = m_Set( id );
 	uniform.size = 16;
 	uniform.value = value;
-	m_hash.HashString( name );
 	m_hash.HashBasicType( value.data );
 }
 
-void UniformList::Set( const char* name, const Texture* tex )
+void UniformList::Set( UniformId id, const Texture* tex )
 {
-	AE_ASSERT( name );
-	AE_ASSERT( name[ 0 ] );
-	AE_ASSERT_MSG( tex, "Texture uniform value '#' is invalid", name );
-	AE_ASSERT_MSG( tex->GetTexture(), "Texture uniform value '#' is invalid", name );
-	AE_ASSERT_MSG( m_uniforms.Length() < m_uniforms.Size() || m_uniforms.TryGet( name ), "Max uniforms: #", m_uniforms.Size() );
-	Value& uniform = m_uniforms.Set( name, Value() );
+	AE_ASSERT_MSG( tex, "Texture uniform value '#' is invalid", id.GetName() );
+	AE_ASSERT_MSG( tex->GetTexture(), "Texture uniform value '#' is invalid", id.GetName() );
+	Value& uniform = m_Set( id );
 	uniform.sampler = tex->GetTexture();
 	uniform.target = tex->GetTarget();
-	m_hash.HashString( name );
 	m_hash.HashBasicType( tex->GetTexture() );
 	m_hash.HashBasicType( tex->GetTarget() );
 }
 
-const UniformList::Value* UniformList::Get( const char* name ) const
+const UniformList::Value* UniformList::Get( UniformId id ) const
+{
+	return m_uniforms.TryGet( id );
+}
+
+bool UniformList::operator ==( const UniformList& other ) const
 {
-	return m_uniforms.TryGet( name );
+	if ( m_uniforms.Length() != other.m_uniforms.Length() )
+	{
+		return false;
+	}
+	for ( uint32_t i = 0; i < m_uniforms.Length(); i++ )
+	{
+		const Value& value = m_uniforms.GetValue( i );
+		const Value* otherValue = other.m_uniforms.TryGet( m_uniforms.GetKey( i ) );
+		if ( !otherValue
+			|| value.sampler != otherValue->sampler
+			|| value.target != otherValue->target
+			|| value.size != otherValue->size
+			|| memcmp( value.value.data, otherValue->value.data, sizeof(float) * value.size ) != 0 )
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
 //------------------------------------------------------------------------------
@@ -18651,6 +21198,13 @@ void Shader::Initialize( const char* vertexStr, const char* fragStr, const char*
 {
 	Terminate();
 	AE_ASSERT( !m_program );
+
+	if ( ae::NullGraphics )
+	{
+		m_ReflectUniforms( vertexStr );
+		m_ReflectUniforms( fragStr );
+		return;
+	}
 	
 	m_program = glCreateProgram();
 
@@ -18743,10 +21297,11 @@ void Shader::Initialize( const char* vertexStr, const char* fragStr, const char*
 		}
 
 		uniform.name = name;
+		uniform.id = UniformId( name );
 		uniform.location = glGetUniformLocation( m_program, name );
 		AE_ASSERT( uniform.location != -1 );
 
-		m_uniforms.Set( name, uniform );
+		m_uniforms.Append( uniform );
 	}
 
 	AE_CHECK_GL_ERROR();
@@ -18794,7 +21349,10 @@ void Shader::m_Activate( const UniformList& uniforms ) const
 	if ( shaderDirty )
 	{
 		s_shaderHash = shaderHash;
-		
+		_graphicsStats.shaderChangeCount++;
+	}
+	if ( shaderDirty && !ae::NullGraphics )
+	{
 		AE_CHECK_GL_ERROR();
 
 		// Blending
@@ -18869,40 +21427,68 @@ void Shader::m_Activate( const UniformList& uniforms ) const
 	uint32_t textureIndex = 0;
 	for ( uint32_t i = 0; i < m_uniforms.Length(); i++ )
 	{
-		const char* uniformVarName = m_uniforms.GetKey( i ).c_str();
-		const _Uniform* uniformVar = &m_uniforms.GetValue( i );
-		const UniformList::Value* uniformValue = uniforms.Get( uniformVarName );
+		const _Uniform* uniformVar = &m_uniforms[ i ];
+		const char* uniformVarName = uniformVar->name.c_str();
+		const UniformList::Value* uniformValue = uniforms.Get( uniformVar->id );
 
 		// Validation
+		const int32_t typeSize = ae::_GLGetTypeCount( uniformVar->type );
 		{
 			if ( !uniformValue )
 			{
+				if ( ae::NullGraphics )
+				{
+					// Null shaders can't know which uniforms would be
+					// optimized out, so don't require them all to be set
+					continue;
+				}
 				AE_WARN( "Shader uniform '#' value is not set", uniformVarName );
 				missingUniforms = true;
 				continue;
 			}
-			const int32_t typeSize = ae::_GLGetTypeCount( uniformVar->type );
 			AE_ASSERT_MSG( typeSize >= 0, "Unsupported uniform '#' type #", uniformVarName, uniformVar->type );
 			AE_ASSERT_MSG( uniformValue->size == typeSize, "Uniform size mismatch '#' type:# var:# param:#", uniformVarName, uniformVar->type, typeSize, uniformValue->size );
 		}
 
-		if ( uniformVar->type == GL_SAMPLER_2D )
+		if ( uniformVar->type == GL_SAMPLER_2D || uniformVar->type == GL_SAMPLER_3D )
 		{
-			AE_ASSERT_MSG( uniformValue->sampler, "Uniform sampler 2d '#' value is invalid", uniformVarName );
-			glActiveTexture( GL_TEXTURE0 + textureIndex );
-			glBindTexture( uniformValue->target, uniformValue->sampler );
-			glUniform1i( uniformVar->location, textureIndex );
+			AE_ASSERT_MSG( uniformValue->sampler, "Uniform sampler '#' value is invalid", uniformVarName );
+			_graphicsStats.textureBindCount++;
+			if ( !ae::NullGraphics )
+			{
+				glActiveTexture( GL_TEXTURE0 + textureIndex );
+				glBindTexture( ( uniformVar->type == GL_SAMPLER_2D ) ? uniformValue->target : GL_TEXTURE_3D, uniformValue->sampler );
+			}
+			if ( !uniformVar->uploaded || uniformVar->value.data[ 0 ] != textureIndex )
+			{
+				_graphicsStats.uniformUploadCount++;
+				if ( !ae::NullGraphics )
+				{
+					glUniform1i( uniformVar->location, textureIndex );
+				}
+				uniformVar->value.data[ 0 ] = textureIndex;
+				uniformVar->uploaded = true;
+			}
 			textureIndex++;
+			AE_CHECK_GL_ERROR();
+			continue;
 		}
-		else if ( uniformVar->type == GL_SAMPLER_3D )
+
+		// The program keeps uniform values between draws, so only values that
+		// changed since this shader last uploaded them need to be sent
+		if ( uniformVar->uploaded && memcmp( uniformVar->value.data, uniformValue->value.data, typeSize * sizeof(float) ) == 0 )
 		{
-			AE_ASSERT_MSG( uniformValue->sampler, "Uniform sampler 2d '#' value is invalid", uniformVarName );
-			glActiveTexture( GL_TEXTURE0 + textureIndex );
-			glBindTexture( GL_TEXTURE_3D, uniformValue->sampler );
-			glUniform1i( uniformVar->location, textureIndex );
-			textureIndex++;
+			continue;
+		}
+		uniformVar->value = uniformValue->value;
+		uniformVar->uploaded = true;
+		_graphicsStats.uniformUploadCount++;
+		if ( ae::NullGraphics )
+		{
+			continue;
 		}
-		else if ( uniformVar->type == GL_FLOAT )
+
+		if ( uniformVar->type == GL_FLOAT )
 		{
 			glUniform1fv( uniformVar->location, 1, uniformValue->value.data );
 		}
@@ -18933,6 +21519,71 @@ void Shader::m_Activate( const UniformList& uniforms ) const
 	AE_ASSERT_MSG( !missingUniforms, "Missing shader uniform parameters" );
 }
 
+bool Shader::HasUniform( UniformId id ) const
+{
+	for ( const _Uniform& uniform : m_uniforms )
+	{
+		if ( uniform.id == id )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void Shader::m_ReflectUniforms( const char* shaderStr )
+{
+	// Without a graphics API uniforms are found by scanning for declarations
+	// like 'AE_UNIFORM_HIGHP mat4 u_worldToProj;' one line at a time
+	while ( *shaderStr )
+	{
+		const char* lineEnd = strchr( shaderStr, '\n' );
+		const uint32_t length = lineEnd ? (uint32_t)( lineEnd - shaderStr ) : (uint32_t)strlen( shaderStr );
+		char line[ 256 ];
+		const uint32_t copyLength = ae::Min( length, (uint32_t)sizeof(line) - 1 );
+		memcpy( line, shaderStr, copyLength );
+		line[ copyLength ] = 0;
+		shaderStr += lineEnd ? length + 1 : length;
+
+		char tokens[ 4 ][ 64 ];
+		const int32_t tokenCount = sscanf( line, "%63s %63s %63s %63s", tokens[ 0 ], tokens[ 1 ], tokens[ 2 ], tokens[ 3 ] );
+		if ( tokenCount < 3 || ( strcmp( tokens[ 0 ], "uniform" ) && strcmp( tokens[ 0 ], "AE_UNIFORM" ) && strcmp( tokens[ 0 ], "AE_UNIFORM_HIGHP" ) ) )
+		{
+			continue;
+		}
+		uint32_t typeIdx = 1;
+		if ( !strcmp( tokens[ 1 ], "highp" ) || !strcmp( tokens[ 1 ], "mediump" ) || !strcmp( tokens[ 1 ], "lowp" ) )
+		{
+			typeIdx = 2;
+		}
+		if ( tokenCount <= (int32_t)typeIdx + 1 )
+		{
+			continue;
+		}
+		const char* typeName = tokens[ typeIdx ];
+		char* name = tokens[ typeIdx + 1 ];
+		name[ strcspn( name, ";[" ) ] = 0;
+
+		_Uniform uniform;
+		if ( !strcmp( typeName, "float" ) ) { uniform.type = GL_FLOAT; }
+		else if ( !strcmp( typeName, "vec2" ) ) { uniform.type = GL_FLOAT_VEC2; }
+		else if ( !strcmp( typeName, "vec3" ) ) { uniform.type = GL_FLOAT_VEC3; }
+		else if ( !strcmp( typeName, "vec4" ) ) { uniform.type = GL_FLOAT_VEC4; }
+		else if ( !strcmp( typeName, "mat4" ) ) { uniform.type = GL_FLOAT_MAT4; }
+		else if ( !strcmp( typeName, "sampler2D" ) ) { uniform.type = GL_SAMPLER_2D; }
+		else if ( !strcmp( typeName, "sampler3D" ) ) { uniform.type = GL_SAMPLER_3D; }
+		else { continue; }
+		if ( !name[ 0 ] || m_uniforms.FindFn( [ name ]( const _Uniform& u ){ return u.name == name; } ) >= 0 )
+		{
+			continue; // Declared in both the vertex and fragment shader
+		}
+		uniform.name = name;
+		uniform.id = UniformId( name );
+		uniform.location = m_uniforms.Length();
+		m_uniforms.Append( uniform );
+	}
+}
+
 const ae::Shader::_Attribute* Shader::m_GetAttributeByIndex( uint32_t index ) const
 {
 	return &m_attributes[ index ];
@@ -19045,9 +21696,214 @@ int Shader::m_LoadShader( const char* shaderStr, Type type, const char* const* d
 	return shader;
 }
 
-//------------------------------------------------------------------------------
-// ae::VertexBuffer member functions
-//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ae::StreamRing member functions
+//------------------------------------------------------------------------------
+void StreamRing::Initialize( uint32_t size )
+{
+	AE_ASSERT( size );
+	m_size = size;
+	m_regions.Clear();
+}
+
+void StreamRing::Terminate()
+{
+	m_size = 0;
+	m_regions.Clear();
+}
+
+bool StreamRing::Begin( uint32_t count, uint64_t fence, uint32_t* offsetOut )
+{
+	AE_ASSERT_MSG( m_size, "Must call Initialize() before Begin()" );
+	AE_ASSERT( count );
+	AE_ASSERT_MSG( count <= m_size, "Region size # exceeds ring size #", count, m_size );
+	uint32_t offset = 0;
+	if ( m_regions.Length() > kMaxRegions || !m_Fit( count, &offset ) )
+	{
+		return false;
+	}
+	if ( m_regions.Length() )
+	{
+		m_regions[ m_regions.Length() - 1 ].fence = fence;
+	}
+	m_regions.Append( { offset, count, 0 } );
+	if ( offsetOut )
+	{
+		*offsetOut = offset;
+	}
+	return true;
+}
+
+bool StreamRing::Extend( uint32_t count )
+{
+	AE_ASSERT_MSG( m_regions.Length(), "Must call Begin() before Extend()" );
+	Region* current = &m_regions[ m_regions.Length() - 1 ];
+	const Region& oldest = m_regions[ 0 ];
+	const uint32_t limit = ( current->offset < oldest.offset ) ? oldest.offset : m_size;
+	if ( current->offset + current->count + count > limit )
+	{
+		return false;
+	}
+	current->count += count;
+	return true;
+}
+
+void StreamRing::Release()
+{
+	AE_ASSERT_MSG( GetRetiredCount(), "No retired regions to release" );
+	m_regions.Remove( 0 );
+}
+
+uint32_t StreamRing::GetOffset() const
+{
+	return m_regions.Length() ? m_regions[ m_regions.Length() - 1 ].offset : 0;
+}
+
+uint32_t StreamRing::GetCount() const
+{
+	return m_regions.Length() ? m_regions[ m_regions.Length() - 1 ].count : 0;
+}
+
+uint32_t StreamRing::GetRetiredCount() const
+{
+	return m_regions.Length() ? m_regions.Length() - 1 : 0;
+}
+
+uint64_t StreamRing::GetRetiredFence( uint32_t index ) const
+{
+	AE_ASSERT( index < GetRetiredCount() );
+	return m_regions[ index ].fence;
+}
+
+bool StreamRing::m_Fit( uint32_t count, uint32_t* offsetOut ) const
+{
+	if ( !m_regions.Length() )
+	{
+		*offsetOut = 0;
+		return ( count <= m_size );
+	}
+	// Regions are allocated in order, so the free space is after the newest
+	// region and before the oldest one
+	const Region& oldest = m_regions[ 0 ];
+	const Region& newest = m_regions[ m_regions.Length() - 1 ];
+	const uint32_t tail = oldest.offset;
+	const uint32_t head = newest.offset + newest.count;
+	if ( newest.offset < oldest.offset )
+	{
+		// Wrapped, only the space between the head and tail is free
+		*offsetOut = head;
+		return ( head + count <= tail );
+	}
+	if ( head + count <= m_size )
+	{
+		*offsetOut = head;
+		return true;
+	}
+	*offsetOut = 0;
+	return ( count <= tail );
+}
+
+//------------------------------------------------------------------------------
+// ae::VertexBuffer member functions
+//------------------------------------------------------------------------------
+// Dynamic vertex and index buffers have space for this many max size uploads
+const uint32_t _kStreamBufferCount = 3;
+
+uint64_t _StreamFence()
+{
+#if _AE_EMSCRIPTEN_
+	// WebGL can't wait on fences, it orders buffer updates itself
+	return 0;
+#else
+	return ae::NullGraphics ? 0 : (uint64_t)(uintptr_t)glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+#endif
+}
+
+// Returns true and deletes the fence if it has signaled. Waits for it if block is true.
+bool _StreamFenceWait( uint64_t fence, bool block )
+{
+#if !_AE_EMSCRIPTEN_
+	if ( fence )
+	{
+		GLsync sync = (GLsync)(uintptr_t)fence;
+		GLenum result = glClientWaitSync( sync, block ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, block ? 1000000000 : 0 );
+		while ( block && result == GL_TIMEOUT_EXPIRED )
+		{
+			result = glClientWaitSync( sync, 0, 1000000000 );
+		}
+		if ( result == GL_TIMEOUT_EXPIRED )
+		{
+			return false;
+		}
+		glDeleteSync( sync );
+		AE_CHECK_GL_ERROR();
+	}
+#endif
+	return true;
+}
+
+// Returns the offset of a new region of count elements, waiting for the gpu if needed
+uint32_t _StreamBegin( ae::StreamRing* ring, uint32_t count )
+{
+	while ( ring->GetRetiredCount() && _StreamFenceWait( ring->GetRetiredFence( 0 ), false ) )
+	{
+		ring->Release();
+	}
+	// The current region can be reused once the commands issued so far are done
+	const uint64_t fence = ring->GetCount() ? _StreamFence() : 0;
+	uint32_t offset = 0;
+	while ( !ring->Begin( count, fence, &offset ) )
+	{
+		AE_ASSERT( ring->GetRetiredCount() );
+		_graphicsStats.streamWaitCount++;
+		_StreamFenceWait( ring->GetRetiredFence( 0 ), true );
+		ring->Release();
+	}
+	return offset;
+}
+
+// Returns the offset in buffer where elements starting at startIdx should be
+// written. Appends are added to the current region if there is space, otherwise
+// the existing elements are copied to a new region.
+uint32_t _StreamWrite( ae::StreamRing* ring, uint32_t buffer, uint32_t elementSize, uint32_t startIdx, uint32_t count )
+{
+	const uint32_t currentCount = ring->GetCount();
+	const uint32_t endIdx = startIdx + count;
+	if ( !startIdx || !currentCount )
+	{
+		return _StreamBegin( ring, endIdx ) + startIdx;
+	}
+	if ( endIdx <= currentCount || ring->Extend( endIdx - currentCount ) )
+	{
+		return ring->GetOffset() + startIdx;
+	}
+	const uint32_t prevOffset = ring->GetOffset();
+	const uint32_t offset = _StreamBegin( ring, endIdx );
+	if ( !ae::NullGraphics )
+	{
+		// The previous region is retired but not released, so it's still intact
+		glBindBuffer( GL_COPY_READ_BUFFER, buffer );
+		glBindBuffer( GL_COPY_WRITE_BUFFER, buffer );
+		glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, prevOffset * elementSize, offset * elementSize, ae::Min( startIdx, currentCount ) * elementSize );
+		AE_CHECK_GL_ERROR();
+	}
+	return offset + startIdx;
+}
+
+void _StreamTerminate( ae::StreamRing* ring )
+{
+#if !_AE_EMSCRIPTEN_
+	for ( uint32_t i = 0; i < ring->GetRetiredCount(); i++ )
+	{
+		if ( uint64_t fence = ring->GetRetiredFence( i ) )
+		{
+			glDeleteSync( (GLsync)(uintptr_t)fence );
+		}
+	}
+#endif
+	ring->Terminate();
+}
+
 VertexBuffer::~VertexBuffer()
 {
 	Terminate();
@@ -19073,8 +21929,11 @@ void VertexBuffer::Initialize( uint32_t vertexSize, uint32_t indexSize, uint32_t
 	m_vertexSize = vertexSize;
 	m_indexSize = indexSize;
 	
-	glGenVertexArrays( 1, &m_array );
-	glBindVertexArray( m_array );
+	if ( !ae::NullGraphics )
+	{
+		glGenVertexArrays( 1, &m_array );
+		glBindVertexArray( m_array );
+	}
 	
 	AE_CHECK_GL_ERROR();
 }
@@ -19105,14 +21964,16 @@ void VertexBuffer::Terminate()
 	{
 		glDeleteVertexArrays( 1, &m_array );
 	}
-	if ( m_vertices != ~0 )
+	if ( m_vertices != ~0 && !ae::NullGraphics )
 	{
 		glDeleteBuffers( 1, &m_vertices );
 	}
-	if ( m_indices != ~0 )
+	if ( m_indices != ~0 && !ae::NullGraphics )
 	{
 		glDeleteBuffers( 1, &m_indices );
 	}
+	_StreamTerminate( &m_vertexRing );
+	_StreamTerminate( &m_indexRing );
 	
 	m_attributes.Clear();
 	
@@ -19151,6 +22012,12 @@ void VertexBuffer::UploadVertices( uint32_t startIdx, const void* vertices, uint
 		AE_ASSERT( m_vertices == ~0 );
 		AE_ASSERT( startIdx == 0 ); // @TODO: Remove this, shouldn't force verts to start from zero
 
+		_graphicsStats.uploadedBytes += count * m_vertexSize;
+		if ( ae::NullGraphics )
+		{
+			m_vertices = 0;
+			return;
+		}
 		glGenBuffers( 1, &m_vertices );
 		glBindVertexArray( m_array );
 		glBindBuffer( GL_ARRAY_BUFFER, m_vertices );
@@ -19164,20 +22031,56 @@ void VertexBuffer::UploadVertices( uint32_t startIdx, const void* vertices, uint
 		{
 			return;
 		}
+
+		_graphicsStats.uploadedBytes += count * m_vertexSize;
+		if( m_vertices == ~0 )
+		{
+			m_vertexRing.Initialize( m_maxVertexCount * _kStreamBufferCount );
+			if ( ae::NullGraphics )
+			{
+				m_vertices = 0;
+			}
+			else
+			{
+				glGenBuffers( 1, &m_vertices );
+				glBindVertexArray( m_array );
+				glBindBuffer( GL_ARRAY_BUFFER, m_vertices );
+				glBufferData( GL_ARRAY_BUFFER, m_vertexRing.GetSize() * m_vertexSize, nullptr, GL_DYNAMIC_DRAW );
+			}
+		}
 		
+		const uint32_t offset = _StreamWrite( &m_vertexRing, m_vertices, m_vertexSize, startIdx, count );
+		if ( ae::NullGraphics )
+		{
+			return;
+		}
+		glBindVertexArray( m_array );
+		glBindBuffer( GL_ARRAY_BUFFER, m_vertices );
+		glBufferSubData( GL_ARRAY_BUFFER, offset * m_vertexSize, count * m_vertexSize, vertices );
+		AE_CHECK_GL_ERROR();
+		return;
+	}
+	if( m_vertexUsage == Vertex::Usage::Retained )
+	{
+		if ( !count )
+		{
+			return;
+		}
+
+		_graphicsStats.uploadedBytes += count * m_vertexSize;
+		if ( ae::NullGraphics )
+		{
+			m_vertices = 0;
+			return;
+		}
+		glBindVertexArray( m_array );
 		if( m_vertices == ~0 )
 		{
 			glGenBuffers( 1, &m_vertices );
-			glBindVertexArray( m_array );
 			glBindBuffer( GL_ARRAY_BUFFER, m_vertices );
 			glBufferData( GL_ARRAY_BUFFER, m_maxVertexCount * m_vertexSize, nullptr, GL_DYNAMIC_DRAW );
 		}
-		else
-		{
-			glBindVertexArray( m_array );
-			glBindBuffer( GL_ARRAY_BUFFER, m_vertices );
-		}
-		
+		glBindBuffer( GL_ARRAY_BUFFER, m_vertices );
 		glBufferSubData( GL_ARRAY_BUFFER, startIdx * m_vertexSize, count * m_vertexSize, vertices );
 		AE_CHECK_GL_ERROR();
 		return;
@@ -19197,6 +22100,12 @@ void VertexBuffer::UploadIndices( uint32_t startIdx, const void* indices, uint32
 		AE_ASSERT( m_indices == ~0 );
 		AE_ASSERT( startIdx == 0 ); // @TODO: Remove this, shouldn't force indices to start from zero
 
+		_graphicsStats.uploadedBytes += count * m_indexSize;
+		if ( ae::NullGraphics )
+		{
+			m_indices = 0;
+			return;
+		}
 		glGenBuffers( 1, &m_indices );
 		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indices );
 		glBufferData( GL_ELEMENT_ARRAY_BUFFER, count * m_indexSize, indices, GL_STATIC_DRAW );
@@ -19209,18 +22118,53 @@ void VertexBuffer::UploadIndices( uint32_t startIdx, const void* indices, uint32
 		{
 			return;
 		}
+
+		_graphicsStats.uploadedBytes += count * m_indexSize;
+		if( m_indices == ~0 )
+		{
+			m_indexRing.Initialize( m_maxIndexCount * _kStreamBufferCount );
+			if ( ae::NullGraphics )
+			{
+				m_indices = 0;
+			}
+			else
+			{
+				glGenBuffers( 1, &m_indices );
+				glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indices );
+				glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indexRing.GetSize() * m_indexSize, nullptr, GL_DYNAMIC_DRAW );
+			}
+		}
 		
+		const uint32_t offset = _StreamWrite( &m_indexRing, m_indices, m_indexSize, startIdx, count );
+		if ( ae::NullGraphics )
+		{
+			return;
+		}
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indices );
+		glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, offset * m_indexSize, count * m_indexSize, indices );
+		AE_CHECK_GL_ERROR();
+		return;
+	}
+	if( m_indexUsage == Vertex::Usage::Retained )
+	{
+		if ( !count )
+		{
+			return;
+		}
+
+		_graphicsStats.uploadedBytes += count * m_indexSize;
+		if ( ae::NullGraphics )
+		{
+			m_indices = 0;
+			return;
+		}
 		if( m_indices == ~0 )
 		{
 			glGenBuffers( 1, &m_indices );
 			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indices );
 			glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_maxIndexCount * m_indexSize, nullptr, GL_DYNAMIC_DRAW );
 		}
-		else
-		{
-			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indices );
-		}
-		
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indices );
 		glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, startIdx * m_indexSize, count * m_indexSize, indices );
 		AE_CHECK_GL_ERROR();
 		return;
@@ -19253,6 +22197,11 @@ void VertexBuffer::Bind( const Shader* shader, const UniformList& uniforms, cons
 	else { AE_FAIL(); return; }
 
 	shader->m_Activate( uniforms );
+	_graphicsStats.bindCount++;
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
 
 	glBindVertexArray( m_array );
 	AE_CHECK_GL_ERROR();
@@ -19329,7 +22278,7 @@ void VertexBuffer::Bind( const Shader* shader, const UniformList& uniforms, cons
 			AE_CHECK_GL_ERROR();
 
 			uint32_t componentCount = vertexAttribute->componentCount;
-			uint64_t attribOffset = vertexAttribute->offset;
+			uint64_t attribOffset = vertexAttribute->offset + (uint64_t)m_vertexRing.GetOffset() * m_vertexSize; // Start of the current dynamic region
 			glVertexAttribPointer( location, componentCount, vertexAttribute->type, vertexAttribute->normalized, m_vertexSize, (void*)attribOffset );
 			AE_CHECK_GL_ERROR();
 		}
@@ -19395,11 +22344,18 @@ void VertexBuffer::m_Draw( uint32_t primitiveStartIdx, uint32_t primitiveCount,
 	else if ( m_primitive == Vertex::Primitive::Line ) { mode = GL_LINES; primitiveSize = 2; primitiveTypeName = "Line"; }
 	else if ( m_primitive == Vertex::Primitive::Point ) { mode = GL_POINTS; primitiveSize = 1; primitiveTypeName = "Point"; }
 	else { AE_FAIL(); return; }
+
+	_graphicsStats.drawCount++;
+	_graphicsStats.primitiveCount += (uint64_t)primitiveCount * ( ( instanceCount >= 0 ) ? instanceCount : 1 );
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
 	
 	if ( IsIndexed() && mode != GL_POINTS )
 	{
 		AE_ASSERT( primitiveStartIdx + primitiveCount <= m_maxIndexCount / primitiveSize );
-		int64_t start = primitiveStartIdx * primitiveSize * m_indexSize; // Byte offset into index buffer
+		int64_t start = ( (int64_t)primitiveStartIdx * primitiveSize + m_indexRing.GetOffset() ) * m_indexSize; // Byte offset into index buffer
 		int32_t count = primitiveCount * primitiveSize; // Number of indices to render
 		GLenum type = 0;
 		if ( m_indexSize == sizeof(uint8_t) ) { type = GL_UNSIGNED_BYTE; }
@@ -19476,6 +22432,8 @@ void VertexArray::Terminate()
 	m_indexCount = 0;
 	m_vertexDirty = false;
 	m_indexDirty = false;
+	m_vertexDirtyStart = 0;
+	m_indexDirtyStart = 0;
 }
 
 void VertexArray::SetVertices( const void* vertices, uint32_t count )
@@ -19505,6 +22463,7 @@ void VertexArray::SetVertices( const void* vertices, uint32_t count )
 	}
 	m_vertexCount = count;
 	m_vertexDirty = true;
+	m_vertexDirtyStart = 0;
 }
 
 void VertexArray::SetIndices( const void* indices, uint32_t count )
@@ -19591,6 +22550,7 @@ void VertexArray::SetIndices( const void* indices, uint32_t count )
 	}
 	m_indexCount = count;
 	m_indexDirty = true;
+	m_indexDirtyStart = 0;
 }
 
 void VertexArray::AppendVertices( const void* vertices, uint32_t count )
@@ -19617,6 +22577,10 @@ void VertexArray::AppendVertices( const void* vertices, uint32_t count )
 	// Append vertices
 	memcpy( (uint8_t*)m_vertexReadable + ( m_vertexCount * m_buffer.GetVertexSize() ), vertices, count * m_buffer.GetVertexSize() );
 
+	if ( !m_vertexDirty )
+	{
+		m_vertexDirtyStart = m_vertexCount;
+	}
 	m_vertexCount += count;
 	m_vertexDirty = true;
 }
@@ -19682,6 +22646,10 @@ void VertexArray::AppendIndices( const void* indices, uint32_t count, uint32_t _
 			AE_FAIL();
 	}
 	
+	if ( !m_indexDirty )
+	{
+		m_indexDirtyStart = m_indexCount;
+	}
 	m_indexCount += count;
 	m_indexDirty = true;
 }
@@ -19692,6 +22660,7 @@ void VertexArray::ClearVertices()
 	{
 		m_vertexCount = 0;
 		m_vertexDirty = true;
+		m_vertexDirtyStart = 0;
 	}
 }
 
@@ -19701,6 +22670,7 @@ void VertexArray::ClearIndices()
 	{
 		m_indexCount = 0;
 		m_indexDirty = true;
+		m_indexDirtyStart = 0;
 	}
 }
 
@@ -19720,12 +22690,15 @@ void VertexArray::Upload()
 {
 	if ( m_vertexDirty )
 	{
-		m_buffer.UploadVertices( 0, m_vertexReadable, m_vertexCount );
+		// Only appended vertices need to be sent
+		const uint8_t* vertices = (const uint8_t*)m_vertexReadable + m_vertexDirtyStart * m_buffer.GetVertexSize();
+		m_buffer.UploadVertices( m_vertexDirtyStart, vertices, m_vertexCount - m_vertexDirtyStart );
 		m_vertexDirty = false;
 	}
 	if ( m_indexDirty )
 	{
-		m_buffer.UploadIndices( 0, m_indexReadable, m_indexCount );
+		const uint8_t* indices = (const uint8_t*)m_indexReadable + m_indexDirtyStart * m_buffer.GetIndexSize();
+		m_buffer.UploadIndices( m_indexDirtyStart, indices, m_indexCount - m_indexDirtyStart );
 		m_indexDirty = false;
 	}
 }
@@ -19776,7 +22749,10 @@ void InstanceData::Terminate()
 {
 	if ( m_buffer != ~0 )
 	{
-		glDeleteBuffers( 1, &m_buffer );
+		if ( !ae::NullGraphics )
+		{
+			glDeleteBuffers( 1, &m_buffer );
+		}
 		m_buffer = ~0;
 	}
 	m_attributes.Clear();
@@ -19813,6 +22789,12 @@ void InstanceData::UploadData( uint32_t startIdx, const void* data, uint32_t cou
 		AE_ASSERT( m_buffer == ~0 );
 		AE_ASSERT( startIdx == 0 ); // @TODO: Remove this, shouldn't force data to start from zero
 
+		_graphicsStats.uploadedBytes += count * m_dataStride;
+		if ( ae::NullGraphics )
+		{
+			m_buffer = 0;
+			return;
+		}
 		glGenBuffers( 1, &m_buffer );
 		glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
 		glBufferData( GL_ARRAY_BUFFER, count * m_dataStride, data, GL_STATIC_DRAW );
@@ -19825,6 +22807,13 @@ void InstanceData::UploadData( uint32_t startIdx, const void* data, uint32_t cou
 		{
 			return;
 		}
+
+		_graphicsStats.uploadedBytes += count * m_dataStride;
+		if ( ae::NullGraphics )
+		{
+			m_buffer = 0;
+			return;
+		}
 		
 		if( m_buffer == ~0 )
 		{
@@ -19834,23 +22823,414 @@ void InstanceData::UploadData( uint32_t startIdx, const void* data, uint32_t cou
 		}
 		else
 		{
-			glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
+			glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
+		}
+		
+		glBufferSubData( GL_ARRAY_BUFFER, startIdx * m_dataStride, count * m_dataStride, data );
+		AE_CHECK_GL_ERROR();
+		return;
+	}
+	AE_FAIL();
+}
+
+const VertexBuffer::_Attribute* InstanceData::_GetAttribute( const char* n ) const
+{
+	int32_t idx = m_attributes.FindFn( [ n ]( const VertexBuffer::_Attribute& a )
+	{
+		return strcmp( a.name, n ) == 0;
+	} );
+	return ( idx >= 0 ) ? &m_attributes[ idx ] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+// ae::InstanceCuller member functions
+//------------------------------------------------------------------------------
+InstanceCuller::InstanceCuller( ae::Tag tag ) :
+	m_tag( tag ),
+	m_centerX( tag ),
+	m_centerY( tag ),
+	m_centerZ( tag ),
+	m_radius( tag ),
+	m_data( tag ),
+	m_lods( tag ),
+	m_visibleData( tag )
+{
+	Terminate();
+}
+
+void InstanceCuller::Initialize( uint32_t instanceSize, uint32_t lodCount )
+{
+	Terminate();
+	AE_ASSERT( instanceSize );
+	AE_ASSERT_MSG( lodCount && lodCount <= kMaxLods, "Invalid lod count #, max is #", lodCount, kMaxLods );
+	m_instanceSize = instanceSize;
+	m_lodCount = lodCount;
+}
+
+void InstanceCuller::Terminate()
+{
+	Clear();
+	m_instanceSize = 0;
+	m_lodCount = 0;
+	m_lods.Clear();
+	m_visibleData.Clear();
+	for ( uint32_t i = 0; i < kMaxLods; i++ )
+	{
+		m_lodScreenSizes[ i ] = 0.0f;
+	}
+	for ( uint32_t i = 0; i <= kMaxLods; i++ )
+	{
+		m_visibleStart[ i ] = 0;
+	}
+}
+
+void InstanceCuller::SetLodScreenSize( uint32_t lod, float minScreenSize )
+{
+	AE_ASSERT( lod < m_lodCount );
+	m_lodScreenSizes[ lod ] = minScreenSize;
+}
+
+uint32_t InstanceCuller::Add( const ae::Sphere& bounds, const void* data )
+{
+	AE_ASSERT_MSG( m_instanceSize, "Must call Initialize() before Add()" );
+	const uint32_t index = m_centerX.Length();
+	m_centerX.Append( bounds.center.x );
+	m_centerY.Append( bounds.center.y );
+	m_centerZ.Append( bounds.center.z );
+	m_radius.Append( bounds.radius );
+	m_data.AppendArray( (const uint8_t*)data, m_instanceSize );
+	return index;
+}
+
+void InstanceCuller::Set( uint32_t index, const ae::Sphere& bounds, const void* data )
+{
+	m_centerX[ index ] = bounds.center.x;
+	m_centerY[ index ] = bounds.center.y;
+	m_centerZ[ index ] = bounds.center.z;
+	m_radius[ index ] = bounds.radius;
+	if ( data )
+	{
+		memcpy( &m_data[ index * m_instanceSize ], data, m_instanceSize );
+	}
+}
+
+void InstanceCuller::Remove( uint32_t index )
+{
+	const uint32_t last = m_centerX.Length() - 1;
+	AE_ASSERT( index <= last );
+	if ( index != last )
+	{
+		m_centerX[ index ] = m_centerX[ last ];
+		m_centerY[ index ] = m_centerY[ last ];
+		m_centerZ[ index ] = m_centerZ[ last ];
+		m_radius[ index ] = m_radius[ last ];
+		memcpy( &m_data[ index * m_instanceSize ], &m_data[ last * m_instanceSize ], m_instanceSize );
+	}
+	m_centerX.Remove( last );
+	m_centerY.Remove( last );
+	m_centerZ.Remove( last );
+	m_radius.Remove( last );
+	m_data.Remove( last * m_instanceSize, m_instanceSize );
+}
+
+void InstanceCuller::Clear()
+{
+	m_centerX.Clear();
+	m_centerY.Clear();
+	m_centerZ.Clear();
+	m_radius.Clear();
+	m_data.Clear();
+	for ( uint32_t i = 0; i <= kMaxLods; i++ )
+	{
+		m_visibleStart[ i ] = 0;
+	}
+}
+
+void InstanceCuller::Cull( const ae::Frustum& frustum, ae::Vec3 cameraPos, float fov )
+{
+	AE_ASSERT_MSG( m_instanceSize, "Must call Initialize() before Cull()" );
+	const uint32_t count = GetInstanceCount();
+	if ( m_lods.Length() < count )
+	{
+		m_lods.Append( 0, count - m_lods.Length() );
+	}
+	
+	ae::Vec4 planes[ 6 ];
+	for ( uint32_t i = 0; i < countof( planes ); i++ )
+	{
+		planes[ i ] = (ae::Vec4)frustum.GetPlane( (ae::Frustum::Plane)i );
+	}
+	// Compare squared sizes to avoid a square root per instance
+	const float tanHalfFov = tanf( fov * 0.5f );
+	float lodDistanceScales[ kMaxLods ];
+	for ( uint32_t i = 0; i < m_lodCount; i++ )
+	{
+		const float s = m_lodScreenSizes[ i ] * tanHalfFov;
+		lodDistanceScales[ i ] = s * s;
+	}
+	
+	// Each instance is processed without branches, so this loop is vectorized
+	const float* centerX = m_centerX.Data();
+	const float* centerY = m_centerY.Data();
+	const float* centerZ = m_centerZ.Data();
+	const float* radius = m_radius.Data();
+	uint8_t* lods = m_lods.Data();
+	const uint32_t lodCount = m_lodCount;
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		const float x = centerX[ i ];
+		const float y = centerY[ i ];
+		const float z = centerZ[ i ];
+		const float r = radius[ i ];
+		// Outside when further than the radius in front of any plane, same as ae::Frustum::Intersects()
+		float outside = planes[ 0 ].x * x + planes[ 0 ].y * y + planes[ 0 ].z * z - planes[ 0 ].w - r;
+		for ( uint32_t j = 1; j < 6; j++ )
+		{
+			const float d = planes[ j ].x * x + planes[ j ].y * y + planes[ j ].z * z - planes[ j ].w - r;
+			outside = ( d > outside ) ? d : outside;
+		}
+		// Screen size is r / ( distance * tanHalfFov ), lods with a larger min size are skipped
+		const float dx = x - cameraPos.x;
+		const float dy = y - cameraPos.y;
+		const float dz = z - cameraPos.z;
+		const float distanceSq = dx * dx + dy * dy + dz * dz;
+		const float radiusSq = r * r;
+		uint32_t lod = 0;
+		for ( uint32_t j = 0; j < lodCount; j++ )
+		{
+			lod += ( radiusSq < lodDistanceScales[ j ] * distanceSq ) ? 1 : 0;
+		}
+		lods[ i ] = (uint8_t)( ( outside > 0.0f ) ? lodCount : lod );
+	}
+	
+	// Pack the data of visible instances by lod
+	uint32_t lodCounts[ kMaxLods + 1 ] = { 0 };
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		lodCounts[ lods[ i ] ]++;
+	}
+	m_visibleStart[ 0 ] = 0;
+	for ( uint32_t i = 0; i < m_lodCount; i++ )
+	{
+		m_visibleStart[ i + 1 ] = m_visibleStart[ i ] + lodCounts[ i ];
+	}
+	const uint32_t visibleSize = m_visibleStart[ m_lodCount ] * m_instanceSize;
+	if ( m_visibleData.Length() < visibleSize )
+	{
+		m_visibleData.Append( 0, visibleSize - m_visibleData.Length() );
+	}
+	uint32_t offsets[ kMaxLods + 1 ];
+	for ( uint32_t i = 0; i < m_lodCount; i++ )
+	{
+		offsets[ i ] = m_visibleStart[ i ] * m_instanceSize;
+	}
+	const uint8_t* data = m_data.Data();
+	uint8_t* visibleData = m_visibleData.Data();
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		const uint32_t lod = lods[ i ];
+		if ( lod < m_lodCount )
+		{
+			memcpy( visibleData + offsets[ lod ], data + i * m_instanceSize, m_instanceSize );
+			offsets[ lod ] += m_instanceSize;
+		}
+	}
+}
+
+uint32_t InstanceCuller::Upload( uint32_t lod, ae::InstanceData* instanceData ) const
+{
+	AE_ASSERT( instanceData->GetStride() == m_instanceSize );
+	const uint32_t count = GetVisibleCount( lod );
+	if ( count )
+	{
+		instanceData->UploadData( 0, GetVisibleData( lod ), count );
+	}
+	return count;
+}
+
+uint32_t InstanceCuller::GetVisibleCount( uint32_t lod ) const
+{
+	AE_ASSERT( lod < m_lodCount );
+	return m_visibleStart[ lod + 1 ] - m_visibleStart[ lod ];
+}
+
+const void* InstanceCuller::GetVisibleData( uint32_t lod ) const
+{
+	AE_ASSERT( lod < m_lodCount );
+	return m_visibleData.Data() + m_visibleStart[ lod ] * m_instanceSize;
+}
+
+//------------------------------------------------------------------------------
+// ae::CommandBuffer member functions
+//------------------------------------------------------------------------------
+CommandBuffer::CommandBuffer( ae::Tag tag ) :
+	m_commands( tag ),
+	m_uniforms( tag ),
+	m_uniformsLookup( tag ),
+	m_shaderIds( tag ),
+	m_vertexArrayIds( tag )
+{}
+
+void CommandBuffer::Draw( uint16_t layer, const VertexArray* vertexArray, const Shader* shader, const UniformList& uniforms )
+{
+	AE_ASSERT( vertexArray );
+	uint32_t primitiveSize = 0;
+	switch ( vertexArray->GetPrimitiveType() )
+	{
+		case Vertex::Primitive::Triangle: primitiveSize = 3; break;
+		case Vertex::Primitive::Line: primitiveSize = 2; break;
+		case Vertex::Primitive::Point: primitiveSize = 1; break;
+		default: AE_FAIL(); return;
+	}
+	const uint32_t count = vertexArray->IsIndexed() ? vertexArray->GetIndexCount() : vertexArray->GetVertexCount();
+	Draw( layer, vertexArray, shader, uniforms, 0, count / primitiveSize );
+}
+
+void CommandBuffer::Draw( uint16_t layer, const VertexArray* vertexArray, const Shader* shader, const UniformList& uniforms, uint32_t primitiveStart, uint32_t primitiveCount )
+{
+	AE_ASSERT( vertexArray );
+	AE_ASSERT( shader );
+	if ( !primitiveCount )
+	{
+		return;
+	}
+	Command& command = m_commands.Append( Command() );
+	command.vertexArray = vertexArray;
+	command.shader = shader;
+	command.instanceData = nullptr;
+	command.uniformsIndex = m_AddUniforms( uniforms );
+	command.primitiveStart = primitiveStart;
+	command.primitiveCount = primitiveCount;
+	command.instanceCount = 0;
+	command.layer = layer;
+	command.bind = true;
+	command.sortKey = 0;
+}
+
+void CommandBuffer::DrawInstanced( uint16_t layer, const VertexArray* vertexArray, const Shader* shader, const UniformList& uniforms, const InstanceData* instanceData, uint32_t primitiveStart, uint32_t primitiveCount, uint32_t instanceCount )
+{
+	AE_ASSERT( vertexArray );
+	AE_ASSERT( shader );
+	AE_ASSERT( instanceData );
+	if ( !primitiveCount || !instanceCount )
+	{
+		return;
+	}
+	Command& command = m_commands.Append( Command() );
+	command.vertexArray = vertexArray;
+	command.shader = shader;
+	command.instanceData = instanceData;
+	command.uniformsIndex = m_AddUniforms( uniforms );
+	command.primitiveStart = primitiveStart;
+	command.primitiveCount = primitiveCount;
+	command.instanceCount = instanceCount;
+	command.layer = layer;
+	command.bind = true;
+	command.sortKey = 0;
+}
+
+void CommandBuffer::Append( const CommandBuffer& other )
+{
+	AE_ASSERT( &other != this );
+	const uint32_t start = m_commands.Length();
+	m_commands.AppendArray( other.m_commands.Data(), other.m_commands.Length() );
+	for ( uint32_t i = start; i < m_commands.Length(); i++ )
+	{
+		Command& command = m_commands[ i ];
+		command.uniformsIndex = m_AddUniforms( other.m_uniforms[ command.uniformsIndex ] );
+	}
+}
+
+void CommandBuffer::Sort()
+{
+	// Replace pointers with small ids in the order they are first seen so the
+	// layer and all state fit in a single 64 bit key
+	m_shaderIds.Clear();
+	m_vertexArrayIds.Clear();
+	for ( Command& command : m_commands )
+	{
+		const uint32_t shaderId = m_shaderIds.Get( command.shader, m_shaderIds.Length() );
+		const uint32_t vertexArrayId = m_vertexArrayIds.Get( command.vertexArray, m_vertexArrayIds.Length() );
+		m_shaderIds.Set( command.shader, shaderId );
+		m_vertexArrayIds.Set( command.vertexArray, vertexArrayId );
+		AE_ASSERT_MSG( shaderId <= 0xFFFF && vertexArrayId <= 0xFFFF && command.uniformsIndex <= 0xFFFF, "Too many unique draw states in CommandBuffer" );
+		command.sortKey =
+			( (uint64_t)command.layer << 48 ) |
+			( (uint64_t)shaderId << 32 ) |
+			( (uint64_t)vertexArrayId << 16 ) |
+			(uint64_t)command.uniformsIndex;
+	}
+	std::stable_sort( m_commands.begin(), m_commands.end(), []( const Command& a, const Command& b )
+	{
+		return a.sortKey < b.sortKey;
+	} );
+
+	m_bindCount = 0;
+	const Command* prev = nullptr;
+	for ( Command& command : m_commands )
+	{
+		command.bind = !prev
+			|| prev->shader != command.shader
+			|| prev->vertexArray != command.vertexArray
+			|| prev->uniformsIndex != command.uniformsIndex
+			|| prev->instanceData != command.instanceData;
+		m_bindCount += command.bind;
+		prev = &command;
+	}
+}
+
+void CommandBuffer::Submit() const
+{
+	for ( const Command& command : m_commands )
+	{
+		VertexArray* vertexArray = const_cast< VertexArray* >( command.vertexArray );
+		const VertexBuffer* buffer = vertexArray->_GetVertexBuffer();
+		if ( command.bind )
+		{
+			vertexArray->Upload(); // Make sure latest vertex data has been sent to GPU
+			const InstanceData* instanceDatas[] = { command.instanceData };
+			buffer->Bind( command.shader, m_uniforms[ command.uniformsIndex ], instanceDatas, command.instanceData ? 1 : 0 );
+		}
+		if ( !vertexArray->GetVertexCount() || ( vertexArray->IsIndexed() && !vertexArray->GetIndexCount() ) )
+		{
+			continue;
+		}
+		if ( command.instanceData )
+		{
+			buffer->DrawInstanced( command.primitiveStart, command.primitiveCount, command.instanceCount );
+		}
+		else
+		{
+			buffer->Draw( command.primitiveStart, command.primitiveCount );
 		}
-		
-		glBufferSubData( GL_ARRAY_BUFFER, startIdx * m_dataStride, count * m_dataStride, data );
-		AE_CHECK_GL_ERROR();
-		return;
 	}
-	AE_FAIL();
 }
 
-const VertexBuffer::_Attribute* InstanceData::_GetAttribute( const char* n ) const
+void CommandBuffer::Clear()
 {
-	int32_t idx = m_attributes.FindFn( [ n ]( const VertexBuffer::_Attribute& a )
+	m_commands.Clear();
+	m_uniforms.Clear();
+	m_uniformsLookup.Clear();
+	m_bindCount = 0;
+}
+
+uint32_t CommandBuffer::m_AddUniforms( const UniformList& uniforms )
+{
+	// Different lists can have the same hash, so matches are compared in full
+	// and a colliding list is stored under the next unused hash
+	uint32_t hash = uniforms.GetHash().Get();
+	while ( const uint32_t* index = m_uniformsLookup.TryGet( hash ) )
 	{
-		return strcmp( a.name, n ) == 0;
-	} );
-	return ( idx >= 0 ) ? &m_attributes[ idx ] : nullptr;
+		if ( m_uniforms[ *index ] == uniforms )
+		{
+			return *index;
+		}
+		hash++;
+	}
+	const uint32_t index = m_uniforms.Length();
+	m_uniforms.Append( uniforms );
+	m_uniformsLookup.Set( hash, index );
+	return index;
 }
 
 //------------------------------------------------------------------------------
@@ -19871,13 +23251,20 @@ void Texture::Initialize( uint32_t target )
 
 	m_target = target;
 
+	if ( ae::NullGraphics )
+	{
+		// Textures need a unique non-zero handle to be set as uniforms
+		static uint32_t s_nullTexture = 0;
+		m_texture = ++s_nullTexture;
+		return;
+	}
 	glGenTextures( 1, &m_texture );
 	AE_ASSERT( m_texture );
 }
 
 void Texture::Terminate()
 {
-	if ( m_texture )
+	if ( m_texture && !ae::NullGraphics )
 	{
 		glDeleteTextures( 1, &m_texture );
 	}
@@ -19915,37 +23302,28 @@ void Texture2D::Initialize( const TextureParams& params )
 	m_width = params.width;
 	m_height = params.height;
 
-	glBindTexture( GetTarget(), GetTexture() );
-
 	const bool mipmapsEnabled = _AE_EMSCRIPTEN_ ? false : params.autoGenerateMipmaps;
-	if ( mipmapsEnabled )
-	{
-		glTexParameteri( GetTarget(), GL_TEXTURE_MIN_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR );
-		glTexParameteri( GetTarget(), GL_TEXTURE_MAG_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST : GL_LINEAR );
-	}
-	else
-	{
-		glTexParameteri( GetTarget(), GL_TEXTURE_MIN_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST : GL_LINEAR );
-		glTexParameteri( GetTarget(), GL_TEXTURE_MAG_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST : GL_LINEAR );
-	}
-	glTexParameteri( GetTarget(), GL_TEXTURE_WRAP_S, ( params.wrap == Wrap::Clamp ) ? GL_CLAMP_TO_EDGE : GL_REPEAT );
-	glTexParameteri( GetTarget(), GL_TEXTURE_WRAP_T, ( params.wrap == Wrap::Clamp ) ? GL_CLAMP_TO_EDGE : GL_REPEAT );
 
 	// this is the type of data passed in, conflating with internal format type
 	GLenum glType = 0;
+	uint32_t typeSize = 0;
 	switch ( params.type )
 	{
 		case Type::Uint8:
 			glType = GL_UNSIGNED_BYTE;
+			typeSize = 1;
 			break;
 		case Type::Uint16:
 			glType = GL_UNSIGNED_SHORT;
+			typeSize = 2;
 			break;
 		case Type::HalfFloat:
 			glType = GL_HALF_FLOAT;
+			typeSize = 2;
 			break;
 		case Type::Float:
 			glType = GL_FLOAT;
+			typeSize = 4;
 			break;
 		default:
 			AE_FAIL_MSG( "Invalid texture type #", (int)params.type );
@@ -20076,6 +23454,30 @@ void Texture2D::Initialize( const TextureParams& params )
 	}
 	AE_ASSERT( components );
 
+	if ( params.data )
+	{
+		_graphicsStats.uploadedBytes += params.width * params.height * components * typeSize;
+	}
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
+
+	glBindTexture( GetTarget(), GetTexture() );
+
+	if ( mipmapsEnabled )
+	{
+		glTexParameteri( GetTarget(), GL_TEXTURE_MIN_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR );
+		glTexParameteri( GetTarget(), GL_TEXTURE_MAG_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST : GL_LINEAR );
+	}
+	else
+	{
+		glTexParameteri( GetTarget(), GL_TEXTURE_MIN_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST : GL_LINEAR );
+		glTexParameteri( GetTarget(), GL_TEXTURE_MAG_FILTER, ( params.filter == Filter::Nearest ) ? GL_NEAREST : GL_LINEAR );
+	}
+	glTexParameteri( GetTarget(), GL_TEXTURE_WRAP_S, ( params.wrap == Wrap::Clamp ) ? GL_CLAMP_TO_EDGE : GL_REPEAT );
+	glTexParameteri( GetTarget(), GL_TEXTURE_WRAP_T, ( params.wrap == Wrap::Clamp ) ? GL_CLAMP_TO_EDGE : GL_REPEAT );
+
 	if ( params.data )
 	{
 		glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
@@ -20195,6 +23597,10 @@ void RenderTarget::Initialize( uint32_t width, uint32_t height )
 
 	m_width = width;
 	m_height = height;
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
 
 	glGenFramebuffers( 1, &m_fbo );
 	AE_CHECK_GL_ERROR();
@@ -20243,9 +23649,12 @@ void RenderTarget::AddTexture( Texture::Filter filter, Texture::Wrap wrap )
 	Texture2D* tex = ae::New< Texture2D >( AE_ALLOC_TAG_RENDER );
 	tex->Initialize( nullptr, m_width, m_height, format, type, filter, wrap, false );
 
-	GLenum attachement = GL_COLOR_ATTACHMENT0 + m_targets.Length();
-	glBindFramebuffer( GL_FRAMEBUFFER, m_fbo );
-	glFramebufferTexture2D( GL_FRAMEBUFFER, attachement, tex->GetTarget(), tex->GetTexture(), 0 );
+	if ( !ae::NullGraphics )
+	{
+		GLenum attachement = GL_COLOR_ATTACHMENT0 + m_targets.Length();
+		glBindFramebuffer( GL_FRAMEBUFFER, m_fbo );
+		glFramebufferTexture2D( GL_FRAMEBUFFER, attachement, tex->GetTarget(), tex->GetTexture(), 0 );
+	}
 
 	m_targets.Append( tex );
 	
@@ -20268,6 +23677,10 @@ void RenderTarget::AddDepth( Texture::Filter filter, Texture::Wrap wrap )
 	Texture::Type type = Texture::Type::Float;
 #endif
 	m_depth.Initialize( nullptr, m_width, m_height, format, type, filter, wrap, false );
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
 	glBindFramebuffer( GL_FRAMEBUFFER, m_fbo );
 	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depth.GetTarget(), m_depth.GetTexture(), 0 );
 
@@ -20278,6 +23691,10 @@ void RenderTarget::Activate()
 {
 	AE_ASSERT_MSG( GetWidth() && GetHeight(), "ae::RenderTarget is not initialized" );
 	AE_ASSERT_MSG( m_targets.Length(), "ae::RenderTarget is not complete. Call AddTexture() before Activate()." );
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
 	AE_CHECK_GL_ERROR();
 	
 	CheckFramebufferComplete( m_fbo );
@@ -20297,6 +23714,10 @@ void RenderTarget::Activate()
 void RenderTarget::Clear( Color color )
 {
 	Activate();
+	if ( ae::NullGraphics )
+	{
+		return;
+	}
 
 	Vec3 clearColor = color.GetLinearRGB();
 	glClearColor( clearColor.x, clearColor.y, clearColor.z, 1.0f );
@@ -20329,9 +23750,11 @@ void RenderTarget::Render2D( uint32_t textureIndex, Rect ndc, float z )
 	glBindFramebuffer( GL_READ_FRAMEBUFFER, m_fbo );
 	AE_CHECK_GL_ERROR();
 
+	static const UniformId u_localToNdc = "u_localToNdc";
+	static const UniformId u_tex = "u_tex";
 	UniformList uniforms;
-	uniforms.Set( "u_localToNdc", RenderTarget::GetQuadToNDCTransform( ndc, z ) );
-	uniforms.Set( "u_tex", GetTexture( textureIndex ) );
+	uniforms.Set( u_localToNdc, RenderTarget::GetQuadToNDCTransform( ndc, z ) );
+	uniforms.Set( u_tex, GetTexture( textureIndex ) );
 	Shader* shader = globals->graphicsDevice->m_rgbToSrgb
 		? &globals->graphicsDevice->m_renderShaderSRGB
 		: &globals->graphicsDevice->m_renderShaderRGB;
@@ -20525,11 +23948,16 @@ void GraphicsDevice::Initialize( class Window* window )
 	LOAD_OPENGL_FN( glGenBuffers );
 	LOAD_OPENGL_FN( glBufferData );
 	LOAD_OPENGL_FN( glBufferSubData );
+	LOAD_OPENGL_FN( glCopyBufferSubData );
 	LOAD_OPENGL_FN( glEnableVertexAttribArray );
 	LOAD_OPENGL_FN( glVertexAttribPointer );
 	LOAD_OPENGL_FN( glVertexAttribDivisor );
 	LOAD_OPENGL_FN( glDrawElementsInstanced );
 	LOAD_OPENGL_FN( glDrawArraysInstanced );
+	// Sync functions
+	LOAD_OPENGL_FN( glFenceSync );
+	LOAD_OPENGL_FN( glClientWaitSync );
+	LOAD_OPENGL_FN( glDeleteSync );
 	// Debug functions
 	LOAD_OPENGL_FN( glDebugMessageCallback );
 	AE_CHECK_GL_ERROR();
@@ -20770,7 +24198,9 @@ void GraphicsDevice::m_HandleResize( uint32_t width, uint32_t height )
 // ae::TextRender member functions
 //------------------------------------------------------------------------------
 TextRender::TextRender( const ae::Tag& tag ) :
-	m_tag( tag )
+	m_tag( tag ),
+	m_layouts( tag ),
+	m_layoutGlyphs( tag )
 {}
 
 TextRender::~TextRender()
@@ -20790,11 +24220,22 @@ void TextRender::Initialize( uint32_t maxStringCount, uint32_t maxGlyphCount, co
 	m_maxRectCount = maxStringCount;
 	m_maxGlyphCount = maxGlyphCount;
 
-	m_vertexData.Initialize( sizeof( Vertex ), sizeof( uint16_t ), m_maxGlyphCount * _kQuadVertCount, m_maxGlyphCount * _kQuadIndexCount, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Dynamic );
+	m_vertexData.Initialize( sizeof( Vertex ), sizeof( uint16_t ), m_maxGlyphCount * _kQuadVertCount, m_maxGlyphCount * _kQuadIndexCount, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Static );
 	m_vertexData.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, offsetof( Vertex, pos ) );
 	m_vertexData.AddAttribute( "a_uv", 2, ae::Vertex::Type::Float, offsetof( Vertex, uv ) );
 	m_vertexData.AddAttribute( "a_color", 4, ae::Vertex::Type::Float, offsetof( Vertex, color ) );
 
+	// Every glyph is a quad, so indices only need to be uploaded once
+	ae::Scratch< uint16_t > indices( m_vertexData.GetMaxIndexCount() );
+	for ( uint32_t i = 0; i < m_maxGlyphCount; i++ )
+	{
+		for ( uint32_t j = 0; j < _kQuadIndexCount; j++ )
+		{
+			indices[ i * _kQuadIndexCount + j ] = _kQuadIndices[ j ] + i * _kQuadVertCount;
+		}
+	}
+	m_vertexData.UploadIndices( 0, indices.Data(), indices.Length() );
+
 	// Load shader
 	const char* vertexStr = R"(
 		AE_UNIFORM_HIGHP mat4 u_uiToScreen;
@@ -20834,6 +24275,8 @@ void TextRender::Terminate()
 	m_allocatedStrings = 0;
 	m_stringData = nullptr;
 	m_strings = nullptr;
+	m_layouts.Clear();
+	m_layoutGlyphs.Clear();
 	m_shader.Terminate();
 	m_vertexData.Terminate();
 
@@ -20847,82 +24290,60 @@ void TextRender::Terminate()
 void TextRender::Render( const ae::Matrix4& uiToScreen )
 {
 	uint32_t vertCount = 0;
-	uint32_t indexCount = 0;
 	ae::Scratch< Vertex > verts( m_vertexData.GetMaxVertexCount() );
-	ae::Scratch< uint16_t > indices( m_vertexData.GetMaxIndexCount() );
-
-	uint32_t charCount = 0;
+	const float columns = (float)( m_texture->GetWidth() / m_fontSize ); // @HACK: Assume same number of columns and rows
 	for ( uint32_t i = 0; i < m_allocatedStrings; i++ )
 	{
 		const TextRect& rect = m_strings[ i ];
-		ae::Vec3 pos = rect.pos;
-		pos.y -= rect.size.y;
-
-		const char* start = rect.str;
-		const char* str = start;
-		while ( str[ 0 ] )
-		{
-			if ( !isspace( str[ 0 ] ) && charCount < m_maxGlyphCount )
-			{
-				int32_t index = str[ 0 ];
-				uint32_t columns = m_texture->GetWidth() / m_fontSize;
-				ae::Vec2 offset( index % columns, columns - index / columns - 1 ); // @HACK: Assume same number of columns and rows
-
-				for ( uint32_t j = 0; j < _kQuadIndexCount; j++ )
-				{
-					indices.GetSafe( indexCount ) = _kQuadIndices[ j ] + vertCount;
-					indexCount++;
-				}
-
-				AE_ASSERT( vertCount + _kQuadVertCount <= verts.Length() );
-				// Bottom Left
-				verts[ vertCount ].pos = pos;
-				verts[ vertCount ].uv = ( _kQuadVertUvs[ 0 ] + offset ) / columns;
-				verts[ vertCount ].color = rect.color.GetLinearRGBA();
-				vertCount++;
-				// Bottom Right
-				verts[ vertCount ].pos = pos + ae::Vec3( rect.size.x, 0.0f, 0.0f );
-				verts[ vertCount ].uv = ( _kQuadVertUvs[ 1 ] + offset ) / columns;
-				verts[ vertCount ].color = rect.color.GetLinearRGBA();
-				vertCount++;
-				// Top Right
-				verts[ vertCount ].pos = pos + ae::Vec3( rect.size.x, rect.size.y, 0.0f );
-				verts[ vertCount ].uv = ( _kQuadVertUvs[ 2 ] + offset ) / columns;
-				verts[ vertCount ].color = rect.color.GetLinearRGBA();
-				vertCount++;
-				// Top Left
-				verts[ vertCount ].pos = pos + ae::Vec3( 0.0f, rect.size.y, 0.0f );
-				verts[ vertCount ].uv = ( _kQuadVertUvs[ 3 ] + offset ) / columns;
-				verts[ vertCount ].color = rect.color.GetLinearRGBA();
-				vertCount++;
-
-				charCount++;
-			}
-
-			if ( str[ 0 ] == '\n' || str[ 0 ] == '\r' )
-			{
-				pos.x = rect.pos.x;
-				pos.y -= rect.size.y;
-			}
-			else
-			{
-				pos.x += rect.size.x * m_spacing;
-			}
-			str++;
+		const ae::Vec4 color = rect.color.GetLinearRGBA();
+		const Glyph* glyphs = m_layoutGlyphs.Data() + rect.glyphStart;
+		const uint32_t glyphCount = ae::Min( rect.glyphCount, ( verts.Length() - vertCount ) / _kQuadVertCount );
+		for ( uint32_t j = 0; j < glyphCount; j++ )
+		{
+			const Glyph& glyph = glyphs[ j ];
+			const ae::Vec3 pos = rect.pos + ae::Vec3( glyph.offset.x * rect.size.x, glyph.offset.y * rect.size.y, 0.0f );
+			// Bottom Left
+			verts[ vertCount ].pos = pos;
+			verts[ vertCount ].uv = ( _kQuadVertUvs[ 0 ] + glyph.cell ) / columns;
+			verts[ vertCount ].color = color;
+			vertCount++;
+			// Bottom Right
+			verts[ vertCount ].pos = pos + ae::Vec3( rect.size.x, 0.0f, 0.0f );
+			verts[ vertCount ].uv = ( _kQuadVertUvs[ 1 ] + glyph.cell ) / columns;
+			verts[ vertCount ].color = color;
+			vertCount++;
+			// Top Right
+			verts[ vertCount ].pos = pos + ae::Vec3( rect.size.x, rect.size.y, 0.0f );
+			verts[ vertCount ].uv = ( _kQuadVertUvs[ 2 ] + glyph.cell ) / columns;
+			verts[ vertCount ].color = color;
+			vertCount++;
+			// Top Left
+			verts[ vertCount ].pos = pos + ae::Vec3( 0.0f, rect.size.y, 0.0f );
+			verts[ vertCount ].uv = ( _kQuadVertUvs[ 3 ] + glyph.cell ) / columns;
+			verts[ vertCount ].color = color;
+			vertCount++;
 		}
 	}
 
 	m_vertexData.UploadVertices( 0, verts.Data(), vertCount );
-	m_vertexData.UploadIndices( 0, indices.Data(), indexCount );
 
+	static const ae::UniformId u_uiToScreen = "u_uiToScreen";
+	static const ae::UniformId u_tex = "u_tex";
 	ae::UniformList uniforms;
-	uniforms.Set( "u_uiToScreen", uiToScreen );
-	uniforms.Set( "u_tex", m_texture );
+	uniforms.Set( u_uiToScreen, uiToScreen );
+	uniforms.Set( u_tex, m_texture );
 	m_vertexData.Bind( &m_shader, uniforms );
-	m_vertexData.Draw( 0, indexCount / 3 );
+	m_vertexData.Draw( 0, vertCount / _kQuadVertCount * 2 );
 
 	m_allocatedStrings = 0;
 	m_allocatedChars = 0;
+	// Only keep layouts used this frame once the cache has grown well past
+	// what can be drawn at once
+	if ( m_layoutGlyphs.Length() > m_maxGlyphCount * 2 )
+	{
+		m_CompactLayouts();
+	}
+	m_frame++;
 }
 
 void TextRender::Add( ae::Vec3 pos, ae::Vec2 size, const char* str, ae::Color color, uint32_t lineLength, uint32_t charLimit )
@@ -20938,19 +24359,92 @@ void TextRender::Add( ae::Vec3 pos, ae::Vec2 size, const char* str, ae::Color co
 	{
 		return;
 	}
+	
+	// Strings shorter than the limit aren't truncated, so their layout doesn't
+	// depend on it. This lets the same text share a layout wherever it's added.
+	Layout params = {};
+	params.textLength = (uint32_t)strlen( str );
+	params.textCheck = ae::Hash( 0x9e3779b9 ).HashString( str ).Get();
+	params.lineLength = lineLength;
+	params.charLimit = ( params.textLength < charLimit ) ? 0 : charLimit;
+	const uint32_t key = ae::Hash().HashString( str ).HashBasicType( lineLength ).HashBasicType( params.charLimit ).Get();
+	Layout* layout = m_layouts.TryGet( key );
+	if ( !layout
+		|| layout->textLength != params.textLength
+		|| layout->textCheck != params.textCheck
+		|| layout->lineLength != params.lineLength
+		|| layout->charLimit != params.charLimit )
+	{
+		char* rectStr = m_stringData + m_allocatedChars;
+		if ( !m_ParseText( str, lineLength, params.charLimit, &rectStr, &params.parsedLength ) )
+		{
+			return;
+		}
+		layout = m_AddLayout( key, params, rectStr );
+	}
+	layout->frame = m_frame;
+	
+	m_allocatedChars += layout->parsedLength + 1; // Include null terminator
+	TextRect* rect = &m_strings[ m_allocatedStrings ];
+	m_allocatedStrings++;
+	rect->glyphStart = layout->glyphStart;
+	rect->glyphCount = layout->glyphCount;
+	rect->pos = pos;
+	rect->size = size;
+	rect->color = color;
+}
+
+TextRender::Layout* TextRender::m_AddLayout( uint32_t key, const Layout& params, const char* parsedStr )
+{
+	Layout layout = params;
+	layout.glyphStart = m_layoutGlyphs.Length();
+	layout.glyphCount = 0;
+	
+	const uint32_t columns = m_texture->GetWidth() / m_fontSize;
+	ae::Vec2 offset( 0.0f, -1.0f );
+	for ( const char* str = parsedStr; str[ 0 ]; str++ )
+	{
+		if ( !isspace( str[ 0 ] ) )
+		{
+			int32_t index = str[ 0 ];
+			Glyph* glyph = &m_layoutGlyphs.Append( Glyph() );
+			glyph->offset = offset;
+			glyph->cell = ae::Vec2( index % columns, columns - index / columns - 1 ); // @HACK: Assume same number of columns and rows
+			layout.glyphCount++;
+		}
+		
+		if ( str[ 0 ] == '\n' || str[ 0 ] == '\r' )
+		{
+			offset.x = 0.0f;
+			offset.y -= 1.0f;
+		}
+		else
+		{
+			offset.x += m_spacing;
+		}
+	}
+	
+	return &m_layouts.Set( key, layout );
+}
 
-	uint32_t len = 0;
-	char* rectStr = m_stringData + m_allocatedChars;
-	if ( m_ParseText( str, lineLength, charLimit, &rectStr, &len ) )
+void TextRender::m_CompactLayouts()
+{
+	ae::Array< Glyph > glyphs = m_tag;
+	for ( int32_t i = m_layouts.Length() - 1; i >= 0; i-- )
 	{
-		m_allocatedChars += len + 1; // Include null terminator
-		TextRect* rect = &m_strings[ m_allocatedStrings ];
-		m_allocatedStrings++;
-		rect->pos = pos;
-		rect->str = rectStr;
-		rect->size = size;
-		rect->color = color;
+		Layout& layout = m_layouts.GetValue( i );
+		if ( layout.frame != m_frame )
+		{
+			m_layouts.RemoveIndex( i );
+		}
+		else
+		{
+			const uint32_t glyphStart = glyphs.Length();
+			glyphs.AppendArray( m_layoutGlyphs.Data() + layout.glyphStart, layout.glyphCount );
+			layout.glyphStart = glyphStart;
+		}
 	}
+	m_layoutGlyphs = std::move( glyphs );
 }
 
 uint32_t TextRender::GetLineCount( const char* str, uint32_t lineLength, uint32_t charLimit ) const
@@ -21043,8 +24537,15 @@ uint32_t TextRender::m_ParseText( const char* str, uint32_t lineLength, uint32_t
 //------------------------------------------------------------------------------
 // ae::DebugLines member functions
 //------------------------------------------------------------------------------
+// Keys of the unit shapes in DebugLines::m_shapes. Circles use their point count.
+const uint32_t _kDebugRectKey = ~0u;
+const uint32_t _kDebugBoxKey = ~0u - 1;
+
 DebugLines::DebugLines( const ae::Tag& tag ) :
-	m_vertexArray( tag )
+	m_tag( tag ),
+	m_lines( tag ),
+	m_shapes( tag ),
+	m_shapeVerts( tag )
 {}
 
 DebugLines::~DebugLines()
@@ -21054,11 +24555,14 @@ DebugLines::~DebugLines()
 
 void DebugLines::Initialize( uint32_t maxVerts )
 {
-	m_vertexArray.Initialize( sizeof(DebugVertex), 0, maxVerts, 0, Vertex::Primitive::Line, Vertex::Usage::Dynamic, Vertex::Usage::Static );
-	m_vertexArray.AddAttribute( "a_position", 3, Vertex::Type::Float, offsetof(DebugVertex, pos) );
-	m_vertexArray.AddAttribute( "a_color", 4, Vertex::Type::Float, offsetof(DebugVertex, color) );
+	Terminate();
+	m_maxVertexCount = maxVerts;
+	m_lines.Reserve( maxVerts );
+	m_lineBuffer.Initialize( sizeof(DebugVertex), 0, maxVerts, 0, Vertex::Primitive::Line, Vertex::Usage::Dynamic, Vertex::Usage::Static );
+	m_lineBuffer.AddAttribute( "a_position", 3, Vertex::Type::Float, offsetof(DebugVertex, pos) );
+	m_lineBuffer.AddAttribute( "a_color", 4, Vertex::Type::Float, offsetof(DebugVertex, color) );
 
-	// Load shader
+	// Load shaders
 	const char* vertexStr = R"(
 		AE_UNIFORM_HIGHP mat4 u_worldToNdc;
 		AE_UNIFORM float u_saturation;
@@ -21071,6 +24575,19 @@ void DebugLines::Initialize( uint32_t maxVerts )
 			v_color = vec4( mix( vec3(bw), a_color.rgb, u_saturation ), a_color.a );
 			gl_Position = u_worldToNdc * vec4( a_position, 1.0 );
 		})";
+	const char* instanceVertexStr = R"(
+		AE_UNIFORM_HIGHP mat4 u_worldToNdc;
+		AE_UNIFORM float u_saturation;
+		AE_IN_HIGHP vec3 a_position;
+		AE_IN_HIGHP mat4 a_transform;
+		AE_IN_HIGHP vec4 a_color;
+		AE_OUT_HIGHP vec4 v_color;
+		void main()
+		{
+			float bw = ( min( a_color.r, min( a_color.g, a_color.b ) ) + max( a_color.r, max( a_color.g, a_color.b ) ) ) * 0.5;
+			v_color = vec4( mix( vec3(bw), a_color.rgb, u_saturation ), a_color.a );
+			gl_Position = u_worldToNdc * a_transform * vec4( a_position, 1.0 );
+		})";
 	const char* fragStr = R"(
 		AE_IN_HIGHP vec4 v_color;
 		void main()
@@ -21080,79 +24597,106 @@ void DebugLines::Initialize( uint32_t maxVerts )
 	m_shader.Initialize( vertexStr, fragStr, nullptr, 0 );
 	m_shader.SetBlending( true );
 	m_shader.SetDepthTest( true );
+	m_instanceShader.Initialize( instanceVertexStr, fragStr, nullptr, 0 );
+	m_instanceShader.SetBlending( true );
+	m_instanceShader.SetDepthTest( true );
 }
 
 void DebugLines::Terminate()
 {
+	for ( Shape& shape : m_shapes )
+	{
+		ae::Delete( shape.instanceData );
+	}
+	m_shapes.Clear();
+	m_shapeVerts.Clear();
+	m_lines.Clear();
 	m_shader.Terminate();
-	m_vertexArray.Terminate();
+	m_instanceShader.Terminate();
+	m_lineBuffer.Terminate();
+	m_shapeBuffer.Terminate();
+	m_vertexCount = 0;
+	m_maxVertexCount = 0;
+	m_shapesDirty = false;
 	m_xray = true;
+	m_grow = true;
 }
 
 void DebugLines::Render( const Matrix4& worldToNdc )
 {
-	m_vertexArray.Upload();
+	// Grow buffers to fit everything that was added
+	if ( m_lines.Length() > m_lineBuffer.GetMaxVertexCount() )
+	{
+		m_lineBuffer.Initialize( sizeof(DebugVertex), 0, ae::Max( m_lines.Length(), m_lineBuffer.GetMaxVertexCount() * 2 ), 0, Vertex::Primitive::Line, Vertex::Usage::Dynamic, Vertex::Usage::Static );
+		m_lineBuffer.AddAttribute( "a_position", 3, Vertex::Type::Float, offsetof(DebugVertex, pos) );
+		m_lineBuffer.AddAttribute( "a_color", 4, Vertex::Type::Float, offsetof(DebugVertex, color) );
+	}
+	m_lineBuffer.UploadVertices( 0, m_lines.Data(), m_lines.Length() );
+	m_UploadShapes();
 	
+	static const UniformId u_worldToNdc = "u_worldToNdc";
+	static const UniformId u_saturation = "u_saturation";
 	UniformList uniforms;
-	uniforms.Set( "u_worldToNdc", worldToNdc );
-
-	if ( m_xray )
-	{
-		m_shader.SetDepthTest( false );
-		m_shader.SetDepthWrite( false );
-		uniforms.Set( "u_saturation", 0.1f );
-		m_vertexArray.Draw( &m_shader, uniforms );
+	uniforms.Set( u_worldToNdc, worldToNdc );
+	for ( uint32_t pass = m_xray ? 0 : 1; pass < 2; pass++ )
+	{
+		// The first pass draws desaturated lines that fail the depth test
+		const bool xray = ( pass == 0 );
+		m_shader.SetDepthTest( !xray );
+		m_shader.SetDepthWrite( !xray );
+		m_instanceShader.SetDepthTest( !xray );
+		m_instanceShader.SetDepthWrite( !xray );
+		uniforms.Set( u_saturation, xray ? 0.1f : 1.0f );
+		
+		if ( m_lines.Length() )
+		{
+			m_lineBuffer.Bind( &m_shader, uniforms );
+			m_lineBuffer.Draw( 0, m_lines.Length() / 2 );
+		}
+		for ( const Shape& shape : m_shapes )
+		{
+			if ( shape.instances.Length() )
+			{
+				const ae::InstanceData* instanceData = shape.instanceData;
+				m_shapeBuffer.Bind( &m_instanceShader, uniforms, &instanceData, 1 );
+				m_shapeBuffer.DrawInstanced( shape.vertexStart / 2, shape.vertexCount / 2, shape.instances.Length() );
+			}
+		}
 	}
-
-	m_shader.SetDepthTest( true );
-	m_shader.SetDepthWrite( true );
-	uniforms.Set( "u_saturation", 1.0f );
-	m_vertexArray.Draw( &m_shader, uniforms );
 	
-	m_vertexArray.ClearVertices();
+	Clear();
 }
 
 void DebugLines::Clear()
 {
-	m_vertexArray.ClearVertices();
+	m_lines.Clear();
+	for ( Shape& shape : m_shapes )
+	{
+		shape.instances.Clear();
+	}
+	m_vertexCount = 0;
 }
 
 uint32_t DebugLines::AddLine( Vec3 p0, Vec3 p1, Color color )
 {
-	if ( m_vertexArray.GetVertexCount() + 2 > m_vertexArray.GetMaxVertexCount() )
+	if ( !m_Reserve( 2 ) )
 	{
 		return 0;
 	}
-	DebugVertex verts[] =
-	{
-		{ p0, color },
-		{ p1, color }
-	};
-	m_vertexArray.AppendVertices( verts, countof( verts ) );
-	return countof( verts );
+	m_lines.Append( { p0, color } );
+	m_lines.Append( { p1, color } );
+	return 2;
 }
 
 uint32_t DebugLines::AddDistanceCheck( Vec3 p0, Vec3 p1, float distance, ae::Color successColor, ae::Color failColor )
 {
-	if ( m_vertexArray.GetVertexCount() + 2 > m_vertexArray.GetMaxVertexCount() )
-	{
-		return 0;
-	}
 	ae::Color color = ( ( p1 - p0 ).Length() <= distance ) ? successColor : failColor;
-	DebugVertex verts[] =
-	{
-		{ p0, color },
-		{ p1, color }
-	};
-	m_vertexArray.AppendVertices( verts, countof( verts ) );
-	return countof( verts );
+	return AddLine( p0, p1, color );
 }
 
 uint32_t DebugLines::AddRect( Vec3 pos, Vec3 up, Vec3 normal, Vec2 size, Color color )
 {
-	if ( m_vertexArray.GetVertexCount() + 8 > m_vertexArray.GetMaxVertexCount()
-		|| up.LengthSquared() < 0.001f
-		|| normal.LengthSquared() < 0.001f )
+	if ( up.LengthSquared() < 0.001f || normal.LengthSquared() < 0.001f )
 	{
 		return 0;
 	}
@@ -21162,175 +24706,35 @@ uint32_t DebugLines::AddRect( Vec3 pos, Vec3 up, Vec3 normal, Vec2 size, Color c
 	{
 		return 0;
 	}
-	
-	size *= 0.5f;
 	ae::Quaternion rotation( normal, up );
-	ae::Vec3 positions[] =
-	{
-		pos + rotation.Rotate( Vec3( -size.x, 0.0f, -size.y ) ), // Bottom Left
-		pos + rotation.Rotate( Vec3( size.x, 0.0f, -size.y ) ), // Bottom Right
-		pos + rotation.Rotate( Vec3( size.x, 0.0f, size.y ) ), // Top Right
-		pos + rotation.Rotate( Vec3( -size.x, 0.0f, size.y ) ), // Top Left
-	};
-
-	DebugVertex verts[] =
-	{
-		{ positions[ 0 ], color },
-		{ positions[ 1 ], color },
-		{ positions[ 1 ], color },
-		{ positions[ 2 ], color },
-		{ positions[ 2 ], color },
-		{ positions[ 3 ], color },
-		{ positions[ 3 ], color },
-		{ positions[ 0 ], color },
-	};
-	m_vertexArray.AppendVertices( verts, countof( verts ) );
-	
-	return countof( verts );
+	return m_AddShape( _kDebugRectKey, Matrix4::Translation( pos ) * rotation.GetTransformMatrix() * Matrix4::Scaling( size.x, 1.0f, size.y ), color );
 }
 
 uint32_t DebugLines::AddCircle( Vec3 pos, Vec3 normal, float radius, Color color, uint32_t pointCount )
 {
-	uint32_t startVerts = m_vertexArray.GetVertexCount();
-	if ( startVerts + pointCount * 2 > m_vertexArray.GetMaxVertexCount()
-		|| normal.LengthSquared() < 0.001f )
+	if ( !pointCount || normal.LengthSquared() < 0.001f )
 	{
 		return 0;
 	}
-	
 	normal.Normalize();
 	float dot = normal.Dot( Vec3(0,0,1) );
 	ae::Quaternion rotation( normal, ( dot < 0.99f && dot > -0.99f ) ? Vec3(0,0,1) : Vec3(1,0,0) );
-	float angleInc = ae::PI * 2.0f / pointCount;
-	
-	for ( uint32_t i = 0; i < pointCount; i++ )
-	{
-		float angle0 = angleInc * i;
-		float angle1 = angleInc * ( i + 1 );
-		
-		DebugVertex verts[ 2 ];
-		verts[ 0 ].pos = Vec3( cosf( angle0 ) * radius, 0.0f, sinf( angle0 ) * radius );
-		verts[ 1 ].pos = Vec3( cosf( angle1 ) * radius, 0.0f, sinf( angle1 ) * radius );
-		verts[ 0 ].pos = rotation.Rotate( verts[ 0 ].pos );
-		verts[ 1 ].pos = rotation.Rotate( verts[ 1 ].pos );
-		verts[ 0 ].pos += pos;
-		verts[ 1 ].pos += pos;
-		verts[ 0 ].color = color;
-		verts[ 1 ].color = color;
-		m_vertexArray.AppendVertices( verts, countof( verts ) );
-	}
-	return m_vertexArray.GetVertexCount() - startVerts;
+	return m_AddShape( pointCount, Matrix4::Translation( pos ) * rotation.GetTransformMatrix() * Matrix4::Scaling( radius ), color );
 }
 
 uint32_t DebugLines::AddAABB( Vec3 pos, Vec3 halfSize, Color color )
 {
-	if ( m_vertexArray.GetVertexCount() + 24 > m_vertexArray.GetMaxVertexCount() )
-	{
-		return 0;
-	}
-	Vec3 c[] =
-	{
-		pos + Vec3( -halfSize.x, halfSize.y, halfSize.z ),
-		pos + halfSize,
-		pos + Vec3( halfSize.x, -halfSize.y, halfSize.z ),
-		pos + Vec3( -halfSize.x, -halfSize.y, halfSize.z ),
-		pos + Vec3( -halfSize.x, halfSize.y, -halfSize.z ),
-		pos + Vec3( halfSize.x, halfSize.y, -halfSize.z ),
-		pos + Vec3( halfSize.x, -halfSize.y, -halfSize.z ),
-		pos + Vec3( -halfSize.x, -halfSize.y, -halfSize.z ),
-	};
-	AE_STATIC_ASSERT( countof( c ) == 8 );
-	DebugVertex verts[] =
-	{
-		// Top
-		{ c[ 0 ], color },
-		{ c[ 1 ], color },
-		{ c[ 1 ], color },
-		{ c[ 2 ], color },
-		{ c[ 2 ], color },
-		{ c[ 3 ], color },
-		{ c[ 3 ], color },
-		{ c[ 0 ], color },
-		// Sides
-		{ c[ 0 ], color },
-		{ c[ 4 ], color },
-		{ c[ 1 ], color },
-		{ c[ 5 ], color },
-		{ c[ 2 ], color },
-		{ c[ 6 ], color },
-		{ c[ 3 ], color },
-		{ c[ 7 ], color },
-		//Bottom
-		{ c[ 4 ], color },
-		{ c[ 5 ], color },
-		{ c[ 5 ], color },
-		{ c[ 6 ], color },
-		{ c[ 6 ], color },
-		{ c[ 7 ], color },
-		{ c[ 7 ], color },
-		{ c[ 4 ], color },
-	};
-	AE_STATIC_ASSERT( countof( c ) * 3 == countof( verts ) );
-	m_vertexArray.AppendVertices( verts, countof( verts ) );
-	return countof( verts );
+	return m_AddShape( _kDebugBoxKey, Matrix4::Translation( pos ) * Matrix4::Scaling( halfSize * 2.0f ), color );
 }
 
 uint32_t DebugLines::AddOBB( Matrix4 transform, Color color )
 {
-	if ( m_vertexArray.GetVertexCount() + 24 > m_vertexArray.GetMaxVertexCount() )
-	{
-		return 0;
-	}
-	Vec3 c[] =
-	{
-		( transform * Vec4( -0.5f, 0.5f, 0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( 0.5f, 0.5f, 0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( 0.5f, -0.5f, 0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( -0.5f, -0.5f, 0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( -0.5f, 0.5f, -0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( 0.5f, 0.5f, -0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( 0.5f, -0.5f, -0.5f, 1.0f ) ).GetXYZ(),
-		( transform * Vec4( -0.5f, -0.5f, -0.5f, 1.0f ) ).GetXYZ(),
-	};
-	AE_STATIC_ASSERT( countof( c ) == 8 );
-	DebugVertex verts[] =
-	{
-		// Top
-		{ c[ 0 ], color },
-		{ c[ 1 ], color },
-		{ c[ 1 ], color },
-		{ c[ 2 ], color },
-		{ c[ 2 ], color },
-		{ c[ 3 ], color },
-		{ c[ 3 ], color },
-		{ c[ 0 ], color },
-		// Sides
-		{ c[ 0 ], color },
-		{ c[ 4 ], color },
-		{ c[ 1 ], color },
-		{ c[ 5 ], color },
-		{ c[ 2 ], color },
-		{ c[ 6 ], color },
-		{ c[ 3 ], color },
-		{ c[ 7 ], color },
-		//Bottom
-		{ c[ 4 ], color },
-		{ c[ 5 ], color },
-		{ c[ 5 ], color },
-		{ c[ 6 ], color },
-		{ c[ 6 ], color },
-		{ c[ 7 ], color },
-		{ c[ 7 ], color },
-		{ c[ 4 ], color },
-	};
-	AE_STATIC_ASSERT( countof( c ) * 3 == countof( verts ) );
-	m_vertexArray.AppendVertices( verts, countof( verts ) );
-	return countof( verts );
+	return m_AddShape( _kDebugBoxKey, transform, color );
 }
 
 uint32_t DebugLines::AddSphere( Vec3 pos, float radius, Color color, uint32_t pointCount )
 {
-	if ( m_vertexArray.GetVertexCount() + pointCount * 2 * 3 > m_vertexArray.GetMaxVertexCount() )
+	if ( !m_grow && m_vertexCount + pointCount * 2 * 3 > m_maxVertexCount )
 	{
 		return 0;
 	}
@@ -21341,12 +24745,13 @@ uint32_t DebugLines::AddSphere( Vec3 pos, float radius, Color color, uint32_t po
 
 uint32_t DebugLines::AddMesh( const Vec3* _vertices, uint32_t vertexStride, uint32_t count, Matrix4 transform, Color color )
 {
-	uint32_t startVerts = m_vertexArray.GetVertexCount();
-	if ( startVerts + count * 2 > m_vertexArray.GetMaxVertexCount()
-		|| count % 3 != 0 )
+	if ( count % 3 != 0 || !m_Reserve( count * 2 ) )
 	{
 		return 0;
 	}
+	const uint32_t startVerts = m_lines.Length();
+	m_lines.Append( { Vec3( 0.0f ), color }, count * 2 );
+	DebugVertex* verts = m_lines.Data() + startVerts;
 	const uint8_t* vertices = (const uint8_t*)_vertices;
 	bool identity = ( transform == ae::Matrix4::Identity() );
 	for ( uint32_t i = 0; i < count; i += 3 )
@@ -21363,29 +24768,28 @@ uint32_t DebugLines::AddMesh( const Vec3* _vertices, uint32_t vertexStride, uint
 			p[ 1 ] = ( transform * ae::Vec4( p[ 1 ], 1.0f ) ).GetXYZ();
 			p[ 2 ] = ( transform * ae::Vec4( p[ 2 ], 1.0f ) ).GetXYZ();
 		}
-		DebugVertex verts[] =
-		{
-			{ p[ 0 ], color },
-			{ p[ 1 ], color },
-			{ p[ 1 ], color },
-			{ p[ 2 ], color },
-			{ p[ 2 ], color },
-			{ p[ 0 ], color },
-		};
-		m_vertexArray.AppendVertices( verts, countof( verts ) ); // @TODO: AppendVertices() does a bunch of safety checks. This could be really slow for big meshes.
+		DebugVertex* v = verts + i * 2;
+		v[ 0 ].pos = p[ 0 ];
+		v[ 1 ].pos = p[ 1 ];
+		v[ 2 ].pos = p[ 1 ];
+		v[ 3 ].pos = p[ 2 ];
+		v[ 4 ].pos = p[ 2 ];
+		v[ 5 ].pos = p[ 0 ];
 	}
-	return m_vertexArray.GetVertexCount() - startVerts;
+	return count * 2;
 }
 
 uint32_t DebugLines::AddMesh( const Vec3* _vertices, uint32_t vertexStride, uint32_t vertexCount, const void* _indices, uint32_t indexSize, uint32_t indexCount, Matrix4 transform, Color color )
 {
-	uint32_t startVerts = m_vertexArray.GetVertexCount();
-	if ( startVerts + indexCount * 2 > m_vertexArray.GetMaxVertexCount()
-		|| indexCount % 3 != 0
-		|| ( indexSize != 2 && indexSize != 4 ) )
+	if ( indexCount % 3 != 0
+		|| ( indexSize != 2 && indexSize != 4 )
+		|| !m_Reserve( indexCount * 2 ) )
 	{
 		return 0;
 	}
+	const uint32_t startVerts = m_lines.Length();
+	m_lines.Append( { Vec3( 0.0f ), color }, indexCount * 2 );
+	DebugVertex* verts = m_lines.Data() + startVerts;
 	const uint8_t* vertices = (const uint8_t*)_vertices;
 	const uint16_t* indices16 = ( indexSize == 2 ) ? (const uint16_t*)_indices : nullptr;
 	const uint32_t* indices32 = ( indexSize == 4 ) ? (const uint32_t*)_indices : nullptr;
@@ -21410,28 +24814,114 @@ uint32_t DebugLines::AddMesh( const Vec3* _vertices, uint32_t vertexStride, uint
 			p[ 1 ] = ( transform * ae::Vec4( p[ 1 ], 1.0f ) ).GetXYZ();
 			p[ 2 ] = ( transform * ae::Vec4( p[ 2 ], 1.0f ) ).GetXYZ();
 		}
-		DebugVertex verts[] =
-		{
-			{ p[ 0 ], color },
-			{ p[ 1 ], color },
-			{ p[ 1 ], color },
-			{ p[ 2 ], color },
-			{ p[ 2 ], color },
-			{ p[ 0 ], color },
-		};
-		m_vertexArray.AppendVertices( verts, countof( verts ) ); // @TODO: AppendVertices() does a bunch of safety checks. This could be really slow for big meshes.
+		DebugVertex* v = verts + i * 2;
+		v[ 0 ].pos = p[ 0 ];
+		v[ 1 ].pos = p[ 1 ];
+		v[ 2 ].pos = p[ 1 ];
+		v[ 3 ].pos = p[ 2 ];
+		v[ 4 ].pos = p[ 2 ];
+		v[ 5 ].pos = p[ 0 ];
+	}
+	return indexCount * 2;
+}
+
+bool DebugLines::m_Reserve( uint32_t vertexCount )
+{
+	AE_ASSERT_MSG( m_lineBuffer.GetVertexSize(), "Must call Initialize() before Add...()" );
+	if ( !m_grow && m_vertexCount + vertexCount > m_maxVertexCount )
+	{
+		return false;
 	}
-	return m_vertexArray.GetVertexCount() - startVerts;
+	m_vertexCount += vertexCount;
+	return true;
 }
 
-uint32_t DebugLines::GetVertexCount() const
+uint32_t DebugLines::m_AddShape( uint32_t key, const Matrix4& transform, Color color )
 {
-	return m_vertexArray.GetVertexCount();
+	int32_t shapeIdx = m_shapes.FindFn( [ key ]( const Shape& s ){ return s.key == key; } );
+	if ( shapeIdx < 0 )
+	{
+		// Generate the unit shape once, it's reused by every instance
+		Shape* shape = &m_shapes.Append( { key, m_shapeVerts.Length(), 0, ae::Array< Instance >( m_tag ), nullptr } );
+		if ( key == _kDebugRectKey )
+		{
+			const Vec3 c[] = { Vec3( -0.5f, 0.0f, -0.5f ), Vec3( 0.5f, 0.0f, -0.5f ), Vec3( 0.5f, 0.0f, 0.5f ), Vec3( -0.5f, 0.0f, 0.5f ) };
+			const Vec3 verts[] = { c[ 0 ], c[ 1 ], c[ 1 ], c[ 2 ], c[ 2 ], c[ 3 ], c[ 3 ], c[ 0 ] };
+			m_shapeVerts.AppendArray( verts, countof( verts ) );
+		}
+		else if ( key == _kDebugBoxKey )
+		{
+			const Vec3 c[] =
+			{
+				Vec3( -0.5f, 0.5f, 0.5f ),
+				Vec3( 0.5f, 0.5f, 0.5f ),
+				Vec3( 0.5f, -0.5f, 0.5f ),
+				Vec3( -0.5f, -0.5f, 0.5f ),
+				Vec3( -0.5f, 0.5f, -0.5f ),
+				Vec3( 0.5f, 0.5f, -0.5f ),
+				Vec3( 0.5f, -0.5f, -0.5f ),
+				Vec3( -0.5f, -0.5f, -0.5f ),
+			};
+			const Vec3 verts[] =
+			{
+				c[ 0 ], c[ 1 ], c[ 1 ], c[ 2 ], c[ 2 ], c[ 3 ], c[ 3 ], c[ 0 ], // Top
+				c[ 0 ], c[ 4 ], c[ 1 ], c[ 5 ], c[ 2 ], c[ 6 ], c[ 3 ], c[ 7 ], // Sides
+				c[ 4 ], c[ 5 ], c[ 5 ], c[ 6 ], c[ 6 ], c[ 7 ], c[ 7 ], c[ 4 ], // Bottom
+			};
+			m_shapeVerts.AppendArray( verts, countof( verts ) );
+		}
+		else
+		{
+			const float angleInc = ae::PI * 2.0f / key;
+			for ( uint32_t i = 0; i < key; i++ )
+			{
+				m_shapeVerts.Append( Vec3( cosf( angleInc * i ), 0.0f, sinf( angleInc * i ) ) );
+				m_shapeVerts.Append( Vec3( cosf( angleInc * ( i + 1 ) ), 0.0f, sinf( angleInc * ( i + 1 ) ) ) );
+			}
+		}
+		shape->vertexCount = m_shapeVerts.Length() - shape->vertexStart;
+		m_shapesDirty = true;
+		shapeIdx = m_shapes.Length() - 1;
+	}
+	
+	Shape* shape = &m_shapes[ shapeIdx ];
+	if ( !m_Reserve( shape->vertexCount ) )
+	{
+		return 0;
+	}
+	shape->instances.Append( { transform, color.GetLinearRGBA() } );
+	return shape->vertexCount;
 }
 
-uint32_t DebugLines::GetMaxVertexCount() const
+void DebugLines::m_UploadShapes()
 {
-	return m_vertexArray.GetVertexCount();
+	if ( m_shapesDirty )
+	{
+		// Static buffers can only be uploaded once, so new shapes recreate the buffer
+		m_shapeBuffer.Initialize( sizeof(Vec3), 0, m_shapeVerts.Length(), 0, Vertex::Primitive::Line, Vertex::Usage::Static, Vertex::Usage::Static );
+		m_shapeBuffer.AddAttribute( "a_position", 3, Vertex::Type::Float, 0 );
+		m_shapeBuffer.UploadVertices( 0, m_shapeVerts.Data(), m_shapeVerts.Length() );
+		m_shapesDirty = false;
+	}
+	for ( Shape& shape : m_shapes )
+	{
+		const uint32_t instanceCount = shape.instances.Length();
+		if ( !instanceCount )
+		{
+			continue;
+		}
+		if ( !shape.instanceData )
+		{
+			shape.instanceData = ae::New< ae::InstanceData >( m_tag );
+		}
+		if ( instanceCount > shape.instanceData->GetMaxInstanceCount() )
+		{
+			shape.instanceData->Initialize( sizeof(Instance), ae::Max( instanceCount, shape.instanceData->GetMaxInstanceCount() * 2 ), Vertex::Usage::Dynamic );
+			shape.instanceData->AddAttribute( "a_transform", 16, Vertex::Type::Float, offsetof(Instance, transform) );
+			shape.instanceData->AddAttribute( "a_color", 4, Vertex::Type::Float, offsetof(Instance, color) );
+		}
+		shape.instanceData->UploadData( 0, shape.instances.Data(), instanceCount );
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -22113,12 +25603,12 @@ Keyframe Keyframe::Lerp( const Keyframe& target, float t ) const
 //------------------------------------------------------------------------------
 // ae::Animation member functions
 //------------------------------------------------------------------------------
-ae::Keyframe Animation::GetKeyframeByTime( const char* boneName, float time ) const
+ae::Keyframe Animation::GetKeyframeByTime( ae::Name boneName, float time ) const
 {
 	return GetKeyframeByPercent( boneName, ae::Delerp( 0.0f, duration, time ) );
 }
 
-ae::Keyframe Animation::GetKeyframeByPercent( const char* boneName, float percent ) const
+ae::Keyframe Animation::GetKeyframeByPercent( ae::Name boneName, float percent ) const
 {
 	const ae::Array< ae::Keyframe >* boneKeyframes = keyframes.TryGet( boneName );
 	if ( !boneKeyframes || !boneKeyframes->Length() )
@@ -22134,6 +25624,16 @@ ae::Keyframe Animation::GetKeyframeByPercent( const char* boneName, float percen
 	return (*boneKeyframes)[ f0 ].Lerp( (*boneKeyframes)[ f1 ], ae::Clip01( f - f0 ) );
 }
 
+ae::Keyframe Animation::GetKeyframeByTime( const char* boneName, float time ) const
+{
+	return GetKeyframeByTime( ae::Name::Find( boneName ), time );
+}
+
+ae::Keyframe Animation::GetKeyframeByPercent( const char* boneName, float percent ) const
+{
+	return GetKeyframeByPercent( ae::Name::Find( boneName ), percent );
+}
+
 void Animation::AnimateByTime( class Skeleton* target, float time, float strength, const ae::Bone** mask, uint32_t maskCount ) const
 {
 	AnimateByPercent( target, ae::Delerp( 0.0f, duration, time ), strength, mask, maskCount );
@@ -22163,7 +25663,7 @@ void Animation::AnimateByPercent( class Skeleton* target, float percent, float s
 		}
 		
 		tempBones.Append( bone );
-		ae::Keyframe keyframe = GetKeyframeByPercent( bone->name.c_str(), percent );
+		ae::Keyframe keyframe = GetKeyframeByPercent( bone->name, percent );
 		if ( keyStrength < 1.0f )
 		{
 			const ae::Matrix4 current = bone->localTransform;
@@ -22204,12 +25704,17 @@ void Skeleton::Initialize( const Skeleton* otherPose )
 	{
 		const ae::Bone& otherBone = otherPose->m_bones[ i ];
 		const ae::Bone* parent = &m_bones[ otherBone.parent->index ];
-		AddBone( parent, otherBone.name.c_str(), otherBone.localTransform );
+		AddBone( parent, otherBone.name, otherBone.localTransform );
 	}
 	AE_ASSERT( beginCheck == m_bones.Data() );
 }
 
-const Bone* Skeleton::AddBone( const Bone* _parent, const char* name, const ae::Matrix4& localTransform )
+const Bone* Skeleton::AddBone( const Bone* parent, const char* name, const ae::Matrix4& localTransform )
+{
+	return AddBone( parent, ae::Name( name ), localTransform );
+}
+
+const Bone* Skeleton::AddBone( const Bone* _parent, ae::Name name, const ae::Matrix4& localTransform )
 {
 	Bone* parent = const_cast< Bone* >( _parent );
 	AE_ASSERT_MSG( m_bones.Size(), "Must call ae::Skeleton::Initialize() before calling ae::Skeleton::AddBone()" );
@@ -22310,12 +25815,17 @@ const Bone* Skeleton::GetRoot() const
 	return m_bones.Data();
 }
 
-const Bone* Skeleton::GetBoneByName( const char* name ) const
+const Bone* Skeleton::GetBoneByName( ae::Name name ) const
 {
 	int32_t idx = m_bones.FindFn( [ name ]( const Bone& b ){ return b.name == name; } );
 	return ( idx >= 0 ) ? &m_bones[ idx ] : nullptr;
 }
 
+const Bone* Skeleton::GetBoneByName( const char* name ) const
+{
+	return GetBoneByName( ae::Name::Find( name ) );
+}
+
 const Bone* Skeleton::GetBoneByIndex( uint32_t index ) const
 {
 #if _AE_DEBUG_
@@ -22581,15 +26091,14 @@ bool OBJFile::Load( const uint8_t* _data, uint32_t length )
 			mode = Mode::None;
 		}
 		
-		// @NOTE: strtof() takes a non-const string but does not modify it
 		switch ( mode )
 		{
 			case Mode::Vertex:
 			{
 				ae::Vec4 p;
-				p.x = strtof( line, (char**)&line );
-				p.y = strtof( line, (char**)&line );
-				p.z = strtof( line, (char**)&line );
+				p.x = ae::ParseFloat( line, &line );
+				p.y = ae::ParseFloat( line, &line );
+				p.z = ae::ParseFloat( line, &line );
 				p.w = 1.0f;
 				// @TODO: Unofficially OBJ can list 3 extra (0-1) values here representing vertex R,G,B values
 				positions.Append( p );
@@ -22599,17 +26108,17 @@ bool OBJFile::Load( const uint8_t* _data, uint32_t length )
 			case Mode::Texture:
 			{
 				ae::Vec2 uv;
-				uv.x = strtof( line, (char**)&line );
-				uv.y = strtof( line, (char**)&line );
+				uv.x = ae::ParseFloat( line, &line );
+				uv.y = ae::ParseFloat( line, &line );
 				uvs.Append( uv );
 				break;
 			}
 			case Mode::Normal:
 			{
 				ae::Vec4 n;
-				n.x = strtof( line, (char**)&line );
-				n.y = strtof( line, (char**)&line );
-				n.z = strtof( line, (char**)&line );
+				n.x = ae::ParseFloat( line, &line );
+				n.y = ae::ParseFloat( line, &line );
+				n.z = ae::ParseFloat( line, &line );
 				n.w = 0.0f;
 				normals.Append( n.SafeNormalizeCopy() );
 				break;
@@ -22620,19 +26129,19 @@ bool OBJFile::Load( const uint8_t* _data, uint32_t length )
 				while ( line < lineEnd )
 				{
 					FaceIndex faceIndex;
-					faceIndex.position = strtoul( line, (char**)&line, 10 ) - 1;
+					faceIndex.position = (uint32_t)ae::ParseUint( line, &line ) - 1;
 					if ( line[ 0 ] == '/' )
 					{
 						line++;
 						if ( line[ 0 ] != '/' )
 						{
-							faceIndex.texture = strtoul( line, (char**)&line, 10 ) - 1;
+							faceIndex.texture = (uint32_t)ae::ParseUint( line, &line ) - 1;
 						}
 					}
 					if ( line[ 0 ] == '/' )
 					{
 						line++;
-						faceIndex.normal = strtoul( line, (char**)&line, 10 ) - 1;
+						faceIndex.normal = (uint32_t)ae::ParseUint( line, &line ) - 1;
 					}
 					if ( faceIndex.position < 0 )
 					{
@@ -24245,7 +27754,7 @@ const ae::Type* ae::GetTypeById( ae::TypeId id )
 const ae::Type* ae::GetTypeByName( const char* typeName )
 {
 	if ( !typeName[ 0 ] ) { return nullptr; }
-	auto it = _Globals::Get()->typeNameMap.find( typeName );
+	auto it = _Globals::Get()->typeNameMap.find( ae::Name::Find( typeName ) );
 	if ( it != _Globals::Get()->typeNameMap.end() ) { return it->second; }
 	else { return nullptr; }
 }
@@ -24306,6 +27815,18 @@ const char* ae::Var::GetTypeName() const { return m_typeName.c_str(); }
 uint32_t ae::Var::GetOffset() const { return m_offset; }
 uint32_t ae::Var::GetSize() const { return m_size; }
 
+// Like sscanf(), leaves the value unchanged when there is no number to parse
+template < typename T, typename P >
+static void _SetParsedValue( const char* str, P (*parseFn)( const char*, const char**, uint32_t ), uint32_t base, T* valueOut )
+{
+	const char* end;
+	const P parsed = parseFn( str, &end, base );
+	if ( end != str )
+	{
+		*valueOut = (T)parsed;
+	}
+}
+
 bool ae::Var::SetObjectValueFromString( ae::Object* obj, const char* value, int32_t arrayIdx ) const
 {
 	if ( !obj )
@@ -24347,7 +27868,7 @@ bool ae::Var::SetObjectValueFromString( ae::Object* obj, const char* value, int3
 		{
 			const ae::Type* subType = GetSubType();
 			AE_ASSERT( subType );
-			AE_ASSERT_MSG( "Can't set member '#' with string '#'", subType->GetName(), value );
+			AE_FAIL_MSG( "Can't set member '#' with string '#'", subType->GetName(), value );
 			return false;
 		}
 		case BasicType::String:
@@ -24380,56 +27901,56 @@ bool ae::Var::SetObjectValueFromString( ae::Object* obj, const char* value, int3
 		{
 			AE_ASSERT( m_size == sizeof(uint8_t) );
 			uint8_t* u8 = (uint8_t*)varData;
-			sscanf( value, "%" SCNu8, u8 );
+			_SetParsedValue( value, &ae::ParseUint, 10, u8 );
 			return true;
 		}
 		case BasicType::UInt16:
 		{
 			AE_ASSERT( m_size == sizeof(uint16_t) );
 			uint16_t* u16 = (uint16_t*)varData;
-			sscanf( value, "%" SCNu16, u16 );
+			_SetParsedValue( value, &ae::ParseUint, 10, u16 );
 			return true;
 		}
 		case BasicType::UInt32:
 		{
 			AE_ASSERT( m_size == sizeof(uint32_t) );
 			uint32_t* u32 = (uint32_t*)varData;
-			sscanf( value, "%" SCNu32, u32 );
+			_SetParsedValue( value, &ae::ParseUint, 10, u32 );
 			return true;
 		}
 		case BasicType::UInt64:
 		{
 			AE_ASSERT( m_size == sizeof(uint64_t) );
 			uint64_t* u64 = (uint64_t*)varData;
-			sscanf( value, "%" SCNu64, u64 );
+			_SetParsedValue( value, &ae::ParseUint, 10, u64 );
 			return true;
 		}
 		case BasicType::Int8:
 		{
 			AE_ASSERT( m_size == sizeof(int8_t) );
 			int8_t* i8 = (int8_t*)varData;
-			sscanf( value, "%" SCNi8, i8 );
+			_SetParsedValue( value, &ae::ParseInt, 0, i8 );
 			return true;
 		}
 		case BasicType::Int16:
 		{
 			AE_ASSERT( m_size == sizeof(int16_t) );
 			int16_t* i16 = (int16_t*)varData;
-			sscanf( value, "%" SCNi16, i16 );
+			_SetParsedValue( value, &ae::ParseInt, 0, i16 );
 			return true;
 		}
 		case BasicType::Int32:
 		{
 			AE_ASSERT( m_size == sizeof(int32_t) );
 			int32_t* i32 = (int32_t*)varData;
-			sscanf( value, "%" SCNi32, i32 );
+			_SetParsedValue( value, &ae::ParseInt, 0, i32 );
 			return true;
 		}
 		case BasicType::Int64:
 		{
 			AE_ASSERT( m_size == sizeof(int64_t) );
 			int64_t* i64 = (int64_t*)varData;
-			sscanf( value, "%" SCNi64, i64 );
+			_SetParsedValue( value, &ae::ParseInt, 0, i64 );
 			return true;
 		}
 		case BasicType::Int2:
@@ -24455,14 +27976,18 @@ bool ae::Var::SetObjectValueFromString( ae::Object* obj, const char* value, int3
 		{
 			AE_ASSERT( m_size == sizeof(float) );
 			float* f = (float*)varData;
-			sscanf( value, "%f", f );
+			const char* end;
+			const float parsed = ae::ParseFloat( value, &end );
+			if ( end != value ) { *f = parsed; }
 			return true;
 		}
 		case BasicType::Double:
 		{
 			AE_ASSERT( m_size == sizeof(double) );
 			double* f = (double*)varData;
-			sscanf( value, "%lf", f );
+			const char* end;
+			const double parsed = ae::ParseDouble( value, &end );
+			if ( end != value ) { *f = parsed; }
 			return true;
 		}
 		case BasicType::Vec2:
@@ -24759,7 +28284,7 @@ ae::TypeId ae::GetTypeIdFromName( const char* name )
 }
 
 int32_t ae::Enum::GetValueByIndex( int32_t index ) const { return m_enumValueToName.GetKey( index ); }
-std::string ae::Enum::GetNameByIndex( int32_t index ) const { return m_enumValueToName.GetValue( index ); }
+ae::String ae::Enum::GetNameByIndex( int32_t index ) const { return m_enumValueToName.GetValue( index ).c_str(); }
 uint32_t ae::Enum::Length() const { return m_enumValueToName.Length(); }
 
 ae::Enum::Enum( const char* name, uint32_t size, bool isSigned ) :
@@ -24770,8 +28295,9 @@ ae::Enum::Enum( const char* name, uint32_t size, bool isSigned ) :
 
 void ae::Enum::m_AddValue( const char* name, int32_t value )
 {
-	m_enumValueToName.Set( value, name );
-	m_enumNameToValue.Set( name, value );
+	const ae::Name key( name );
+	m_enumValueToName.Set( value, key );
+	m_enumNameToValue.Set( key, value );
 }
 
 ae::Enum* ae::Enum::s_Get( const char* enumName, bool create, uint32_t size, bool isSigned )
@@ -24789,8 +28315,7 @@ ae::Enum* ae::Enum::s_Get( const char* enumName, bool create, uint32_t size, boo
 	}
 }
 
-// @TODO: Replace return type with a dynamic ae::Str
-std::string ae::Var::GetObjectValueAsString( const ae::Object* obj, int32_t arrayIdx ) const
+ae::String ae::Var::GetObjectValueAsString( const ae::Object* obj, int32_t arrayIdx ) const
 {
 	if ( !obj )
 	{
@@ -24825,64 +28350,64 @@ std::string ae::Var::GetObjectValueAsString( const ae::Object* obj, int32_t arra
 		{
 			const ae::Type* subType = GetSubType();
 			AE_ASSERT( subType );
-			AE_ASSERT_MSG( "Can't get member '#' value as string", subType->GetName() );
+			AE_FAIL_MSG( "Can't get member '#' value as string", subType->GetName() );
 			return "";
 		}
 		case BasicType::String:
 			switch ( m_size )
 			{
 				case 16:
-					return reinterpret_cast< const ae::Str16* >( varData )->c_str();
+					return *reinterpret_cast< const ae::Str16* >( varData );
 				case 32:
-					return reinterpret_cast< const ae::Str32* >( varData )->c_str();
+					return *reinterpret_cast< const ae::Str32* >( varData );
 				case 64:
-					return reinterpret_cast< const ae::Str64* >( varData )->c_str();
+					return *reinterpret_cast< const ae::Str64* >( varData );
 				case 128:
-					return reinterpret_cast< const ae::Str128* >( varData )->c_str();
+					return *reinterpret_cast< const ae::Str128* >( varData );
 				case 256:
-					return reinterpret_cast< const ae::Str256* >( varData )->c_str();
+					return *reinterpret_cast< const ae::Str256* >( varData );
 				case 512:
-					return reinterpret_cast< const ae::Str512* >( varData )->c_str();
+					return *reinterpret_cast< const ae::Str512* >( varData );
 				default:
 					AE_FAIL_MSG( "Invalid string size '#'", m_size );
 					return "";
 			}
 		case BasicType::UInt8:
-			return ae::Str32::Format( "#", (uint32_t)*reinterpret_cast< const uint8_t* >( varData ) ).c_str(); // Prevent char formatting
+			return ae::Str32::Format( "#", (uint32_t)*reinterpret_cast< const uint8_t* >( varData ) ); // Prevent char formatting
 		case BasicType::UInt16:
-			return ae::Str32::Format( "#", *reinterpret_cast< const uint16_t* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const uint16_t* >( varData ) );
 		case BasicType::UInt32:
-			return ae::Str32::Format( "#", *reinterpret_cast< const uint32_t* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const uint32_t* >( varData ) );
 		case BasicType::UInt64:
-			return ae::Str32::Format( "#", *reinterpret_cast< const uint64_t* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const uint64_t* >( varData ) );
 		case BasicType::Int8:
-			return ae::Str32::Format( "#", (int32_t)*reinterpret_cast< const int8_t* >( varData ) ).c_str(); // Prevent char formatting
+			return ae::Str32::Format( "#", (int32_t)*reinterpret_cast< const int8_t* >( varData ) ); // Prevent char formatting
 		case BasicType::Int16:
-			return ae::Str32::Format( "#", *reinterpret_cast< const int16_t* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const int16_t* >( varData ) );
 		case BasicType::Int32:
-			return ae::Str32::Format( "#", *reinterpret_cast< const int32_t* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const int32_t* >( varData ) );
 		case BasicType::Int64:
-			return ae::Str32::Format( "#", *reinterpret_cast< const int64_t* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const int64_t* >( varData ) );
 		case BasicType::Int2:
-			return ae::Str256::Format( "#", *reinterpret_cast<const ae::Int2*>( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast<const ae::Int2*>( varData ) );
 		case BasicType::Int3:
-			return ae::Str256::Format( "#", *reinterpret_cast<const ae::Int3*>( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast<const ae::Int3*>( varData ) );
 		case BasicType::Bool:
-			return ae::Str32::Format( "#", *reinterpret_cast< const bool* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const bool* >( varData ) );
 		case BasicType::Float:
-			return ae::Str32::Format( "#", *reinterpret_cast< const float* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const float* >( varData ) );
 		case BasicType::Double:
-			return ae::Str32::Format( "#", *reinterpret_cast< const double* >( varData ) ).c_str();
+			return ae::Str32::Format( "#", *reinterpret_cast< const double* >( varData ) );
 		case BasicType::Vec2:
-			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Vec2* >( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Vec2* >( varData ) );
 		case BasicType::Vec3:
-			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Vec3* >( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Vec3* >( varData ) );
 		case BasicType::Vec4:
-			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Vec4* >( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Vec4* >( varData ) );
 		case BasicType::Matrix4:
-			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Matrix4* >( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Matrix4* >( varData ) );
 		case BasicType::Color:
-			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Color* >( varData ) ).c_str();
+			return ae::Str256::Format( "#", *reinterpret_cast< const ae::Color* >( varData ) );
 		case BasicType::Enum:
 		{
 			// @NOTE: Enums with very large or small values (outside the range of int32) are not currently supported
@@ -24940,7 +28465,7 @@ std::string ae::Var::GetObjectValueAsString( const ae::Object* obj, int32_t arra
 		}
 		case BasicType::CustomRef:
 		{
-			return m_varType->GetStringFromRef( varData );
+			return m_varType->GetStringFromRef( varData ).c_str();
 		}
 	}
 	
@@ -540,6 +540,7 @@ int main()
       ae::Color top = ae::Color::SRGB8( 46, 65, 35 );
       ae::Color side = ae::Color::SRGB8( 84, 84, 74 );
       ae::Color path = ae::Color::SRGB8( 64, 64, 54 );
+      const ae::Frustum frustum( worldToProj );
       ae::UniformList uniformList;
       uniformList.Set( "u_worldToProj", worldToProj );
       if ( wireframe )
@@ -550,7 +551,7 @@ int main()
         terrainShader.SetBlending( false );
         terrainShader.SetCulling( ae::Culling::None );
         terrainShader.SetWireframe( true );
-        terrain->Render( &terrainShader, uniformList );
+        terrain->Render( &terrainShader, uniformList, frustum, camera.GetPosition() );
 
         uniformList.Set( "u_topColor", top.SetA( 0.5f ).GetLinearRGBA() );
         uniformList.Set( "u_sideColor", side.SetA( 0.5f ).GetLinearRGBA() );
@@ -558,7 +559,7 @@ int main()
         terrainShader.SetBlending( true );
         terrainShader.SetCulling( ae::Culling::CounterclockwiseFront );
         terrainShader.SetWireframe( false );
-        terrain->Render( &terrainShader, uniformList );
+        terrain->Render( &terrainShader, uniformList, frustum, camera.GetPosition() );
       }
       else
       {
@@ -568,7 +569,7 @@ int main()
         terrainShader.SetBlending( false );
         terrainShader.SetCulling( ae::Culling::CounterclockwiseFront );
         terrainShader.SetWireframe( false );
-        terrain->Render( &terrainShader, uniformList );
+        terrain->Render( &terrainShader, uniformList, frustum, camera.GetPosition() );
       }
 
       ImGuizmo::SetRect( 0, 0, io.DisplaySize.x, io.DisplaySize.y );
@@ -76,7 +76,7 @@ int main()
       params.window = &window;
       params.windowTitle = "Open Some File To Do Things With";
       params.allowMultiselect = true;
-      ae::Array< std::string > result = fs.OpenDialog( params );
+      ae::Array< ae::String > result = fs.OpenDialog( params );
       if ( result.Length() )
       {
         AE_INFO( "Open dialog success" );
@@ -96,8 +96,8 @@ int main()
       ae::FileDialogParams params;
       params.window = &window;
       params.filters.Append( ae::FileFilter( "Text Files", "txt" ) );
-      std::string result = fs.SaveDialog( params );
-      if ( !result.empty() )
+      ae::String result = fs.SaveDialog( params );
+      if ( !result.Empty() )
       {
         AE_INFO( "Save dialog success #", result );
       }
@@ -51,7 +51,7 @@ const char* kFragShader = R"(
 //------------------------------------------------------------------------------
 // Cube
 //------------------------------------------------------------------------------
-const uint32_t kMaxInstancesDimm = 128;
+const uint32_t kMaxInstancesDimm = 100;
 const uint32_t kMaxInstances = kMaxInstancesDimm * kMaxInstancesDimm * kMaxInstancesDimm;
 
 struct Vertex
@@ -82,6 +82,15 @@ uint16_t kCubeIndices[] =
 	0, 1, 5, 0, 5, 4 // Front
 };
 
+// Low detail tetrahedron using every other corner of the cube
+uint16_t kTetrahedronIndices[] =
+{
+	0, 2, 5,
+	0, 5, 7,
+	0, 7, 2,
+	2, 7, 5
+};
+
 //------------------------------------------------------------------------------
 // Main
 //------------------------------------------------------------------------------
@@ -96,7 +105,9 @@ int main()
 	ae::DebugCamera camera = ae::Axis::Y;
 	ae::Shader shader;
 	ae::VertexBuffer vertexData;
-	ae::InstanceData instanceData;
+	ae::InstanceData instanceData[ 2 ]; // One per level of detail
+	ae::InstanceCuller culler( "instance" );
+	const float fov = 0.9f;
 
 	window.Initialize( 800, 600, false, true );
 	window.SetTitle( "instancing" );
@@ -112,13 +123,19 @@ int main()
 	shader.SetBlending( true );
 	shader.SetCulling( ae::Culling::CounterclockwiseFront );
 
-	vertexData.Initialize( sizeof( *kCubeVerts ), sizeof( *kCubeIndices ), countof( kCubeVerts ), countof( kCubeIndices ), ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Static, ae::Vertex::Usage::Static );
+	uint16_t indices[ countof( kCubeIndices ) + countof( kTetrahedronIndices ) ];
+	memcpy( indices, kCubeIndices, sizeof( kCubeIndices ) );
+	memcpy( indices + countof( kCubeIndices ), kTetrahedronIndices, sizeof( kTetrahedronIndices ) );
+	vertexData.Initialize( sizeof( *kCubeVerts ), sizeof( *indices ), countof( kCubeVerts ), countof( indices ), ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Static, ae::Vertex::Usage::Static );
 	vertexData.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, offsetof( Vertex, pos ) );
 	vertexData.AddAttribute( "a_color", 4, ae::Vertex::Type::Float, offsetof( Vertex, color ) );
 	vertexData.UploadVertices( 0, kCubeVerts, countof( kCubeVerts ) );
-	vertexData.UploadIndices( 0, kCubeIndices, countof( kCubeIndices ) );
+	vertexData.UploadIndices( 0, indices, countof( indices ) );
 
-	ae::Vec3* offsets = ae::NewArray< ae::Vec3 >( "instance", kMaxInstances );
+	// Only visible instances are uploaded each frame, sorted by level of detail
+	culler.Initialize( sizeof(ae::Vec3), countof( instanceData ) );
+	culler.SetLodScreenSize( 0, 0.02f );
+	culler.SetLodScreenSize( 1, 0.002f );
 	for ( uint32_t z = 0 ; z < kMaxInstancesDimm; z++ )
 	for ( uint32_t y = 0 ; y < kMaxInstancesDimm; y++ )
 	for ( uint32_t x = 0 ; x < kMaxInstancesDimm; x++ )
@@ -126,38 +143,57 @@ int main()
 		ae::Vec3 offset( x, y, z );
 		offset -= ae::Vec3( kMaxInstancesDimm / 2 );
 		offset *= 3.0f;
-		uint32_t idx = x + y * kMaxInstancesDimm + z * kMaxInstancesDimm * kMaxInstancesDimm;
-		offsets[ idx ] = offset;
+		culler.Add( ae::Sphere( offset, 0.87f ), &offset ); // Radius of the corners of the cube
+	}
+	for ( ae::InstanceData& data : instanceData )
+	{
+		data.Initialize( sizeof(ae::Vec3), kMaxInstances, ae::Vertex::Usage::Dynamic );
+		data.AddAttribute( "a_offset", 3, ae::Vertex::Type::Float, 0 );
 	}
-	instanceData.Initialize( sizeof(ae::Vec3), kMaxInstances, ae::Vertex::Usage::Static );
-	instanceData.AddAttribute( "a_offset", 3, ae::Vertex::Type::Float, 0 );
-	instanceData.UploadData( 0, offsets, kMaxInstances );
 	
-	float r0 = 0.0f;
-	float r1 = 0.0f;
+	double cullTime = 0.0;
+	uint32_t frameCount = 0;
 
 	AE_INFO( "Run" );
 	while ( !input.quit )
 	{
 		input.Pump();
 		camera.Update( &input, timeStep.GetDt() );
-		
-		r0 += timeStep.GetDt() * 0.6f;
-		r1 += timeStep.GetDt() * 0.75f;
 
 		render.Activate();
 		render.Clear( ae::Color::PicoDarkPurple() );
 		
 		ae::Matrix4 worldToView = ae::Matrix4::WorldToView( camera.GetPosition(), camera.GetForward(), ae::Vec3( 0.0f, 1.0f, 0.0f ) );
-		ae::Matrix4 viewToProj = ae::Matrix4::ViewToProjection( 0.9f, render.GetAspectRatio(), 0.5f, 1000.0f );
+		ae::Matrix4 viewToProj = ae::Matrix4::ViewToProjection( fov, render.GetAspectRatio(), 0.5f, 1000.0f );
+		ae::Matrix4 worldToProj = viewToProj * worldToView;
+		
+		double cullStart = ae::GetTime();
+		culler.Cull( ae::Frustum( worldToProj ), camera.GetPosition(), fov );
+		cullTime += ae::GetTime() - cullStart;
 		
 		ae::UniformList uniformList;
-		uniformList.Set( "u_worldToProj", viewToProj * worldToView );
+		uniformList.Set( "u_worldToProj", worldToProj );
 		uniformList.Set( "u_color", ae::Color::White().GetLinearRGBA() );
-
-		const ae::InstanceData* datas[] = { &instanceData };
-		vertexData.Bind( &shader, uniformList, datas, 1 );
-		vertexData.DrawInstanced( 0, countof( kCubeIndices ) / 3, kMaxInstances );
+		
+		const uint32_t lodPrimitiveStart[] = { 0, countof( kCubeIndices ) / 3 };
+		const uint32_t lodPrimitiveCount[] = { countof( kCubeIndices ) / 3, countof( kTetrahedronIndices ) / 3 };
+		for ( uint32_t lod = 0; lod < countof( instanceData ); lod++ )
+		{
+			if ( uint32_t instanceCount = culler.Upload( lod, &instanceData[ lod ] ) )
+			{
+				const ae::InstanceData* datas[] = { &instanceData[ lod ] };
+				vertexData.Bind( &shader, uniformList, datas, 1 );
+				vertexData.DrawInstanced( lodPrimitiveStart[ lod ], lodPrimitiveCount[ lod ], instanceCount );
+			}
+		}
+		
+		frameCount++;
+		if ( frameCount == 60 )
+		{
+			AE_INFO( "Cull: #ms Visible: # + # / #", cullTime / frameCount * 1000.0, culler.GetVisibleCount( 0 ), culler.GetVisibleCount( 1 ), culler.GetInstanceCount() );
+			cullTime = 0.0;
+			frameCount = 0;
+		}
 		
 		render.Present();
 
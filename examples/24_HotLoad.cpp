@@ -35,7 +35,11 @@ int main()
 
 	// Lib path
 	ae::Str256 libResourcePath;
+#if _AE_APPLE_
 	ae::Str64 fileName = "HotLoadable.dylib";
+#else
+	ae::Str64 fileName = "HotLoadable.so";
+#endif
 	fileSystem.GetAbsolutePath( ae::FileSystem::Root::Data, fileName.c_str(), &libResourcePath );
 
 	ae::Str256 buildCmd;
@@ -55,8 +59,9 @@ int main()
 		if ( game.input.GetPress( ae::Key::R ) )
 		{
 			AE_INFO( "Reloading" );
-			hotLoader.Reload();
+			hotLoader.Reload(); // Builds in the background, the game keeps running
 		}
+		hotLoader.Update(); // Swaps the library between frames once the build is done
 	};
 
 	return 0;
@@ -77,10 +77,41 @@ const float kEditorViewDistance = 1000.0f;
 enum class EditorMsg : uint8_t
 {
 	None,
-	Modification,
+	Delta,
 	Load
 };
 
+//------------------------------------------------------------------------------
+// EditorDelta
+//------------------------------------------------------------------------------
+//! Each EditorMsg::Delta message is a batch of these, each followed by its
+//! data, until the end of the message. Only objects, components and vars that
+//! changed since the last batch are sent. Components are identified by
+//! ae::TypeId and vars by their index in ae::Type::GetVarByIndex( i, true ).
+enum class EditorDelta : uint8_t
+{
+	AddObject, // id, name, transform
+	RemoveObject, // id
+	Name, // id, name
+	Transform, // id, transform
+	AddComponent, // id, type id
+	RemoveComponent, // id, type id
+	ArrayLength, // id, type id, var index, length
+	Var // id, type id, var index, array index (or -1), value length, value
+};
+
+struct EditorVarKey
+{
+	bool operator == ( const EditorVarKey& other ) const { return id == other.id && typeId == other.typeId && varIdx == other.varIdx; }
+	EditorObjectId id;
+	ae::TypeId typeId;
+	uint32_t varIdx;
+};
+template <> uint32_t GetHash( EditorVarKey key )
+{
+	return ae::Hash().HashBasicType( key.id ).HashBasicType( key.typeId ).HashBasicType( key.varIdx ).Get();
+}
+
 //------------------------------------------------------------------------------
 // EditorServerMesh class
 //------------------------------------------------------------------------------
@@ -126,6 +157,7 @@ public:
 	
 	EditorServerMesh* mesh = nullptr;
 	bool opaque = true;
+	int32_t proxy = -1; // EditorServer::m_objectTree
 	
 private:
 	ae::Matrix4 m_transform = ae::Matrix4::Identity();
@@ -160,7 +192,10 @@ public:
 		m_meshVisibleVars( tag ),
 		m_typeMesh( tag ),
 		m_typeInvisible( tag ),
-		connections( tag )
+		connections( tag ),
+		m_pendingDeltas( tag ),
+		m_pendingVars( tag ),
+		m_objectTree( tag )
 	{}
 	void Initialize( class EditorProgram* program );
 	void Terminate( class EditorProgram* program );
@@ -175,7 +210,7 @@ public:
 	
 	bool GetShowInvisible() const { return m_showInvisible; }
 	
-	EditorServerObject* CreateObject( EditorObjectId id, const ae::Matrix4& transform );
+	EditorServerObject* CreateObject( class EditorProgram* program, EditorObjectId id, const ae::Matrix4& transform );
 	void DestroyObject( EditorObjectId id );
 	ae::Object* AddComponent( class EditorProgram* program, EditorServerObject* obj, const char* typeName );
 	void RemoveComponent( class EditorProgram* program, EditorServerObject* obj, ae::Object* component );
@@ -187,6 +222,10 @@ public:
 	const ae::Var* GetMeshResourceVar( const ae::Type* componentType );
 	const ae::Var* GetMeshVisibleVar( const ae::Type* componentType );
 	ae::AABB GetSelectedAABB( class EditorProgram* program ) const;
+	//! Sends the new value of \p var to connected clients with the next batch
+	void QueueVarChange( EditorObjectId entity, const ae::Object* component, const ae::Var* var );
+	//! Refits the picking bounds of \p obj after its transform or mesh changes
+	void UpdateObjectBounds( class EditorProgram* program, EditorServerObject* obj );
 	
 	ae::ListenerSocket sock;
 	
@@ -200,6 +239,9 @@ private:
 	EditorObjectId m_PickObject( class EditorProgram* program, ae::Color color, ae::Vec3* hitOut, ae::Vec3* normalOut );
 	void m_ShowEditorObject( EditorProgram* program, EditorObjectId entity, ae::Color color );
 	ae::Color m_GetColor( EditorObjectId entity, bool lines ) const;
+	void m_QueueDelta( EditorDelta delta, EditorObjectId entity, const ae::Type* type = nullptr );
+	void m_SendDeltas( class EditorProgram* program );
+	void m_WriteDelta( ae::BinaryStream* msgStream, const ae::BinaryStream& entry );
 	
 	const ae::Tag m_tag;
 	bool m_first = true;
@@ -228,6 +270,18 @@ private:
 	ae::Array< EditorConnection* > connections;
 	uint8_t m_msgBuffer[ kMaxEditorMessageSize ];
 	
+	struct PendingDelta
+	{
+		EditorDelta delta;
+		EditorObjectId entity;
+		ae::TypeId typeId;
+	};
+	ae::Array< PendingDelta > m_pendingDeltas;
+	ae::Map< EditorVarKey, bool > m_pendingVars; // Coalesced until sent
+	
+	// Picking broadphase, the bounds of every object including its pick sphere
+	ae::AABBTree m_objectTree;
+	
 	struct SelectRef
 	{
 		bool enabled = false;
@@ -717,6 +771,7 @@ void ae::EditorMesh::Load( const ae::OBJFile& file )
 Editor::Editor( const ae::Tag& tag ) :
 	m_tag( tag ),
 	m_level( tag ),
+	m_modifications( tag ),
 	m_sock( tag )
 {}
 
@@ -798,26 +853,29 @@ void Editor::Update()
 	}
 	m_Connect();
 	
+	m_modifications.Clear();
 	uint32_t msgLength = 0;
 	while ( ( msgLength = m_sock.ReceiveMsg( m_msgBuffer, sizeof(m_msgBuffer) ) ) )
 	{
+		if ( msgLength > sizeof(m_msgBuffer) )
+		{
+			// Not copied to m_msgBuffer, so skip it once it has fully arrived
+			if ( !m_sock.DiscardMsg() )
+			{
+				break;
+			}
+			AE_WARN( "Discarded # byte editor message, the max is # bytes", msgLength, sizeof(m_msgBuffer) );
+			continue;
+		}
 		EditorMsg msgType = EditorMsg::None;
-		ae::BinaryStream rStream = ae::BinaryStream::Reader( m_msgBuffer, sizeof(m_msgBuffer) );
+		ae::BinaryStream rStream = ae::BinaryStream::Reader( m_msgBuffer, msgLength );
 		rStream.SerializeRaw( msgType );
 		switch ( msgType )
 		{
-			case EditorMsg::Modification:
+			case EditorMsg::Delta:
 			{
-				EditorObjectId entity;
-				ae::Matrix4 transform;
-				rStream.SerializeUint32( entity );
-				rStream.SerializeRaw( transform );
+				m_ReceiveDeltas( &rStream );
 				AE_ASSERT( rStream.IsValid() );
-				EditorObject* levelObj = m_level.objects.TryGet( entity );
-				if ( levelObj )
-				{
-					levelObj->transform = transform;
-				}
 				break;
 			}
 			case EditorMsg::Load:
@@ -884,14 +942,15 @@ bool Editor::Write() const
 								ae::Str32 key = ae::Str32::Format( "#::#", var->GetName(), arrIdx );
 								const char* value = levelComponent.members.GetString( key.c_str(), nullptr );
 								AE_ASSERT( value );
-								jsonArray.PushBack( rapidjson::StringRef( value ), allocator );
+								// Copied, because Dict strings only live until its next call
+								jsonArray.PushBack( rapidjson::Value( value, allocator ), allocator );
 							}
 							jsonComponent.AddMember( k, jsonArray, allocator );
 						}
 					}
 					else if ( const char* value = levelComponent.members.GetString( var->GetName(), nullptr ) )
 					{
-						jsonComponent.AddMember( k, rapidjson::StringRef( value ), allocator );
+						jsonComponent.AddMember( k, rapidjson::Value( value, allocator ), allocator );
 					}
 				}
 				jsonComponents.AddMember( rapidjson::StringRef( levelComponent.type.c_str() ), jsonComponent, allocator );
@@ -1019,6 +1078,146 @@ void Editor::m_Read()
 	m_levelSeq++;
 }
 
+void Editor::m_ReceiveDeltas( ae::BinaryStream* rStream )
+{
+	while ( rStream->IsValid() && rStream->GetRemaining() )
+	{
+		EditorDelta delta;
+		EditorObjectId entity = kInvalidEditorObjectId;
+		rStream->SerializeRaw( delta );
+		rStream->SerializeUint32( entity );
+		EditorModification modification;
+		modification.id = entity;
+		EditorObject* levelObj = m_level.objects.TryGet( entity );
+		switch ( delta )
+		{
+			case EditorDelta::AddObject:
+			{
+				EditorObject newObj = m_tag;
+				newObj.id = entity;
+				rStream->SerializeString( newObj.name );
+				rStream->SerializeRaw( newObj.transform );
+				if ( !levelObj )
+				{
+					m_level.objects.Set( entity, newObj );
+					modification.type = EditorModification::Type::AddObject;
+				}
+				break;
+			}
+			case EditorDelta::RemoveObject:
+			{
+				if ( m_level.objects.Remove( entity ) )
+				{
+					modification.type = EditorModification::Type::RemoveObject;
+				}
+				break;
+			}
+			case EditorDelta::Name:
+			{
+				ae::Str16 name;
+				rStream->SerializeString( name );
+				if ( levelObj )
+				{
+					levelObj->name = name;
+					modification.type = EditorModification::Type::Name;
+				}
+				break;
+			}
+			case EditorDelta::Transform:
+			{
+				ae::Matrix4 transform;
+				rStream->SerializeRaw( transform );
+				if ( levelObj )
+				{
+					levelObj->transform = transform;
+					modification.type = EditorModification::Type::Transform;
+				}
+				break;
+			}
+			case EditorDelta::AddComponent:
+			case EditorDelta::RemoveComponent:
+			case EditorDelta::ArrayLength:
+			case EditorDelta::Var:
+			{
+				ae::TypeId typeId = ae::kInvalidTypeId;
+				rStream->SerializeUint32( typeId );
+				const ae::Type* type = ae::GetTypeById( typeId );
+				modification.componentType = type;
+				int32_t componentIdx = -1;
+				if ( levelObj && type )
+				{
+					componentIdx = levelObj->components.FindFn( [ type ]( const EditorComponent& c ){ return c.type == type->GetName(); } );
+				}
+				if ( delta == EditorDelta::AddComponent )
+				{
+					if ( levelObj && type && componentIdx < 0 )
+					{
+						levelObj->components.Append( m_tag ).type = type->GetName();
+						modification.type = EditorModification::Type::AddComponent;
+					}
+					break;
+				}
+				else if ( delta == EditorDelta::RemoveComponent )
+				{
+					if ( componentIdx >= 0 )
+					{
+						levelObj->components.Remove( componentIdx );
+						modification.type = EditorModification::Type::RemoveComponent;
+					}
+					break;
+				}
+				
+				uint32_t varIdx = 0;
+				rStream->SerializeUint32( varIdx );
+				const ae::Var* var = ( type && varIdx < type->GetVarCount( true ) ) ? type->GetVarByIndex( varIdx, true ) : nullptr;
+				ae::Dict* members = ( componentIdx >= 0 && var ) ? &levelObj->components[ componentIdx ].members : nullptr;
+				modification.var = var;
+				if ( delta == EditorDelta::ArrayLength )
+				{
+					uint32_t length = 0;
+					rStream->SerializeUint32( length );
+					if ( members )
+					{
+						members->SetUint( var->GetName(), length );
+						modification.type = EditorModification::Type::Var;
+					}
+				}
+				else
+				{
+					int32_t arrayIdx = -1;
+					uint16_t valueLength = 0;
+					rStream->SerializeInt32( arrayIdx );
+					rStream->SerializeUint16( valueLength );
+					if ( members && valueLength <= rStream->GetRemaining() )
+					{
+						std::string value( (const char*)rStream->PeekData(), valueLength );
+						if ( arrayIdx >= 0 )
+						{
+							ae::Str32 key = ae::Str32::Format( "#::#", var->GetName(), arrayIdx );
+							members->SetString( key.c_str(), value.c_str() );
+						}
+						else
+						{
+							members->SetString( var->GetName(), value.c_str() );
+						}
+						modification.type = EditorModification::Type::Var;
+						modification.arrayIdx = arrayIdx;
+					}
+					rStream->Discard( valueLength );
+				}
+				break;
+			}
+			default:
+				AE_FAIL_MSG( "Invalid editor delta" );
+				return;
+		}
+		if ( modification.type != EditorModification::Type::None )
+		{
+			m_modifications.Append( modification );
+		}
+	}
+}
+
 void Editor::m_Connect()
 {
 #if !_AE_EMSCRIPTEN_
@@ -1051,6 +1250,7 @@ void EditorServerObject::SetTransform( const ae::Matrix4& transform, EditorProgr
 	{
 		m_transform = transform;
 		m_dirty = true;
+		program->editor.UpdateObjectBounds( program, this );
 	}
 }
 
@@ -1064,6 +1264,7 @@ const ae::Matrix4& EditorServerObject::GetTransform( const EditorProgram* progra
 
 void EditorServerObject::HandleVarChange( EditorProgram* program, ae::Object* component, const ae::Type* type, const ae::Var* var )
 {
+	program->editor.QueueVarChange( entity, component, var );
 	if ( var == program->editor.GetMeshResourceVar( type ) )
 	{
 		auto varStr = var->GetObjectValueAsString( component );
@@ -1075,6 +1276,7 @@ void EditorServerObject::HandleVarChange( EditorProgram* program, ae::Object* co
 		{
 			mesh = nullptr;
 		}
+		program->editor.UpdateObjectBounds( program, this );
 	}
 	else if ( var == program->editor.GetMeshVisibleVar( type ) )
 	{
@@ -1121,7 +1323,7 @@ void EditorServer::Initialize( EditorProgram* program )
 		int32_t resourcePropIdx = type->GetPropertyIndex( "ae_mesh_resource" );
 		if ( resourcePropIdx >= 0 )
 		{
-			const char* mustRegisterErr = "Must register a mesh resource member variable with AE_REGISTER_CLASS_PROPERTY_VALUE( #, ae_mesh_resource, memberVar );";
+			constexpr const char* mustRegisterErr = "Must register a mesh resource member variable with AE_REGISTER_CLASS_PROPERTY_VALUE( #, ae_mesh_resource, memberVar );";
 			AE_ASSERT_MSG( type->GetPropertyValueCount( resourcePropIdx ), mustRegisterErr, type->GetName() );
 			const char* varName = type->GetPropertyValue( resourcePropIdx, 0 );
 			AE_ASSERT_MSG( varName[ 0 ], mustRegisterErr, type->GetName() );
@@ -1133,7 +1335,7 @@ void EditorServer::Initialize( EditorProgram* program )
 		int32_t visiblePropIdx = type->GetPropertyIndex( "ae_mesh_visible" );
 		if ( visiblePropIdx >= 0 )
 		{
-			const char* mustRegisterErr = "Must register a mesh resource member variable with AE_REGISTER_CLASS_PROPERTY_VALUE( #, ae_mesh_visible, memberVar );";
+			constexpr const char* mustRegisterErr = "Must register a mesh resource member variable with AE_REGISTER_CLASS_PROPERTY_VALUE( #, ae_mesh_visible, memberVar );";
 			AE_ASSERT_MSG( type->GetPropertyValueCount( visiblePropIdx ), mustRegisterErr, type->GetName() );
 			const char* varName = type->GetPropertyValue( visiblePropIdx, 0 );
 			AE_ASSERT_MSG( varName[ 0 ], mustRegisterErr, type->GetName() );
@@ -1195,24 +1397,7 @@ void EditorServer::Update( EditorProgram* program )
 	}
 	AE_ASSERT( connections.Length() == sock.GetConnectionCount() );
 	
-	for ( uint32_t i = 0; i < m_objects.Length(); i++ )
-	{
-		EditorServerObject* editorObj = m_objects.GetValue( i );
-		if ( editorObj->IsDirty() )
-		{
-			ae::Matrix4 transform = editorObj->GetTransform( program );
-			ae::BinaryStream wStream = ae::BinaryStream::Writer( m_msgBuffer, sizeof(m_msgBuffer) );
-			wStream.SerializeRaw( EditorMsg::Modification );
-			wStream.SerializeUint32( editorObj->entity );
-			wStream.SerializeRaw( transform );
-			AE_ASSERT( wStream.IsValid() );
-			for ( EditorConnection* conn : connections )
-			{
-				conn->sock->QueueMsg( wStream.GetData(), wStream.GetOffset() );
-			}
-			editorObj->ClearDirty();
-		}
-	}
+	m_SendDeltas( program );
 	
 	for ( EditorConnection* (&conn) : connections )
 	{
@@ -1391,6 +1576,10 @@ void EditorServer::ShowUI( EditorProgram* program )
 				else if ( matchCount == 1 )
 				{
 					m_selectRef.componentVar->SetObjectValue( m_selectRef.component, lastMatch, m_selectRef.varIdx );
+					if ( const EditorServerObject* obj = GetObjectFromComponent( m_selectRef.component ) )
+					{
+						QueueVarChange( obj->entity, m_selectRef.component, m_selectRef.componentVar );
+					}
 					m_selectRef = SelectRef();
 				}
 				else
@@ -1423,6 +1612,10 @@ void EditorServer::ShowUI( EditorProgram* program )
 			if ( otherType->IsType( refType ) && ImGui::Selectable( otherType->GetName(), false ) )
 			{
 				m_selectRef.componentVar->SetObjectValue( m_selectRef.component, otherComp, m_selectRef.varIdx );
+				if ( const EditorServerObject* obj = GetObjectFromComponent( m_selectRef.component ) )
+				{
+					QueueVarChange( obj->entity, m_selectRef.component, m_selectRef.componentVar );
+				}
 				m_selectRef = SelectRef();
 			}
 		}
@@ -1720,7 +1913,7 @@ void EditorServer::ShowUI( EditorProgram* program )
 		if ( ImGui::Button( "Create" ) )
 		{
 			ae::Matrix4 transform = ae::Matrix4::Translation( program->camera.GetFocus() );
-			EditorServerObject* editorObject = CreateObject( m_nextEntityId, transform );
+			EditorServerObject* editorObject = CreateObject( program, m_nextEntityId, transform );
 			selected.Clear();
 			selected.Append( editorObject->entity );
 		}
@@ -1778,6 +1971,7 @@ void EditorServer::ShowUI( EditorProgram* program )
 			{
 				AE_INFO( "Set object name: #", name );
 				selectedObject->name = name;
+				m_QueueDelta( EditorDelta::Name, selectedObject->entity );
 			}
 			{
 				bool changed = false;
@@ -1982,13 +2176,15 @@ void EditorServer::ShowUI( EditorProgram* program )
 	m_first = false;
 }
 
-EditorServerObject* EditorServer::CreateObject( EditorObjectId id, const ae::Matrix4& transform )
+EditorServerObject* EditorServer::CreateObject( EditorProgram* program, EditorObjectId id, const ae::Matrix4& transform )
 {
 	AE_ASSERT( !GetObject( id ) );
 	EditorServerObject* editorObject = ae::New< EditorServerObject >( m_tag, m_tag );
 	editorObject->Initialize( id, transform );
 	m_objects.Set( id, editorObject );
+	UpdateObjectBounds( program, editorObject );
 	m_nextEntityId = ae::Max( m_nextEntityId, id + 1 );
+	m_QueueDelta( EditorDelta::AddObject, id );
 	return editorObject;
 }
 
@@ -2008,8 +2204,10 @@ void EditorServer::DestroyObject( EditorObjectId id )
 			ae::Free( component );
 		}
 		editorObject->components.Clear();
+		m_objectTree.Remove( editorObject->proxy );
 		editorObject->Terminate();
 		ae::Delete( editorObject );
+		m_QueueDelta( EditorDelta::RemoveObject, id );
 	}
 }
 
@@ -2058,11 +2256,13 @@ ae::Object* EditorServer::AddComponent( EditorProgram* program, EditorServerObje
 		typeComponents = &m_components.Set( type->GetId(), m_tag );
 	}
 	typeComponents->Set( obj->entity, component );
+	m_QueueDelta( EditorDelta::AddComponent, obj->entity, type );
 	
 	const auto& meshName = m_typeMesh.Get( type, "" );
 	if ( meshName.Length() )
 	{
 		obj->mesh = program->GetMesh( meshName.c_str() );
+		UpdateObjectBounds( program, obj );
 	}
 	if ( m_typeInvisible.Get( type, false ) )
 	{
@@ -2092,6 +2292,7 @@ void EditorServer::RemoveComponent( EditorProgram* program, EditorServerObject*
 		{
 			m_components.Remove( type->GetId() );
 		}
+		m_QueueDelta( EditorDelta::RemoveComponent, obj->entity, type );
 
 		component->~Object();
 		ae::Free( component );
@@ -2134,6 +2335,177 @@ const EditorServerObject* EditorServer::GetObjectFromComponent( const ae::Object
 	return nullptr;
 }
 
+void EditorServer::QueueVarChange( EditorObjectId entity, const ae::Object* component, const ae::Var* var )
+{
+	const ae::Type* type = ae::GetTypeFromObject( component );
+	const uint32_t varCount = type->GetVarCount( true );
+	for ( uint32_t i = 0; i < varCount; i++ )
+	{
+		if ( type->GetVarByIndex( i, true ) == var )
+		{
+			m_pendingVars.Set( { entity, type->GetId(), i }, true );
+			return;
+		}
+	}
+}
+
+void EditorServer::m_QueueDelta( EditorDelta delta, EditorObjectId entity, const ae::Type* type )
+{
+	m_pendingDeltas.Append( { delta, entity, type ? type->GetId() : ae::kInvalidTypeId } );
+}
+
+void EditorServer::m_SendDeltas( EditorProgram* program )
+{
+	for ( uint32_t i = 0; i < m_objects.Length(); i++ )
+	{
+		EditorServerObject* editorObj = m_objects.GetValue( i );
+		if ( editorObj->IsDirty() )
+		{
+			m_QueueDelta( EditorDelta::Transform, editorObj->entity );
+			editorObj->ClearDirty();
+		}
+	}
+	if ( !connections.Length() )
+	{
+		m_pendingDeltas.Clear();
+		m_pendingVars.Clear();
+		return;
+	}
+	
+	// Entries are written to a small buffer first so they can be moved to the
+	// next message when they don't fit in the current one
+	uint8_t entryBuffer[ 1024 ];
+	ae::BinaryStream msgStream = ae::BinaryStream::Writer( m_msgBuffer, sizeof(m_msgBuffer) );
+	msgStream.SerializeRaw( EditorMsg::Delta );
+	// Current values are sent, so objects and components that no longer exist
+	// are skipped
+	for ( const PendingDelta& pending : m_pendingDeltas )
+	{
+		const EditorServerObject* editorObj = GetObject( pending.entity );
+		const ae::Type* type = ae::GetTypeById( pending.typeId );
+		ae::BinaryStream entry = ae::BinaryStream::Writer( entryBuffer, sizeof(entryBuffer) );
+		entry.SerializeRaw( pending.delta );
+		entry.SerializeUint32( pending.entity );
+		switch ( pending.delta )
+		{
+			case EditorDelta::AddObject:
+				if ( !editorObj )
+				{
+					continue;
+				}
+				entry.SerializeString( editorObj->name );
+				entry.SerializeRaw( editorObj->GetTransform( program ) );
+				break;
+			case EditorDelta::RemoveObject:
+				break;
+			case EditorDelta::Name:
+				if ( !editorObj )
+				{
+					continue;
+				}
+				entry.SerializeString( editorObj->name );
+				break;
+			case EditorDelta::Transform:
+				if ( !editorObj )
+				{
+					continue;
+				}
+				entry.SerializeRaw( editorObj->GetTransform( program ) );
+				break;
+			case EditorDelta::AddComponent:
+				if ( !editorObj || !type || !GetComponent( editorObj, type->GetName() ) )
+				{
+					continue;
+				}
+				entry.SerializeUint32( pending.typeId );
+				break;
+			case EditorDelta::RemoveComponent:
+				entry.SerializeUint32( pending.typeId );
+				break;
+			default:
+				AE_FAIL();
+				break;
+		}
+		m_WriteDelta( &msgStream, entry );
+	}
+	for ( uint32_t i = 0; i < m_pendingVars.Length(); i++ )
+	{
+		const EditorVarKey& key = m_pendingVars.GetKey( i );
+		const EditorServerObject* editorObj = GetObject( key.id );
+		const ae::Type* type = ae::GetTypeById( key.typeId );
+		const ae::Object* component = ( editorObj && type ) ? GetComponent( editorObj, type->GetName() ) : nullptr;
+		if ( !component )
+		{
+			continue;
+		}
+		const ae::Var* var = type->GetVarByIndex( key.varIdx, true );
+		auto writeValue = [&]( int32_t arrayIdx )
+		{
+			const ae::String value = var->GetObjectValueAsString( component, arrayIdx );
+			uint16_t valueLength = (uint16_t)value.Length();
+			ae::BinaryStream entry = ae::BinaryStream::Writer( entryBuffer, sizeof(entryBuffer) );
+			entry.SerializeRaw( EditorDelta::Var );
+			entry.SerializeUint32( key.id );
+			entry.SerializeUint32( key.typeId );
+			entry.SerializeUint32( key.varIdx );
+			entry.SerializeInt32( arrayIdx );
+			entry.SerializeUint16( valueLength );
+			entry.SerializeRaw( value.c_str(), valueLength );
+			if ( entry.IsValid() )
+			{
+				m_WriteDelta( &msgStream, entry );
+			}
+			else
+			{
+				AE_WARN( "Value of '#::#' is too long to send to clients", type->GetName(), var->GetName() );
+			}
+		};
+		if ( var->IsArray() )
+		{
+			const uint32_t length = var->GetArrayLength( component );
+			ae::BinaryStream entry = ae::BinaryStream::Writer( entryBuffer, sizeof(entryBuffer) );
+			entry.SerializeRaw( EditorDelta::ArrayLength );
+			entry.SerializeUint32( key.id );
+			entry.SerializeUint32( key.typeId );
+			entry.SerializeUint32( key.varIdx );
+			entry.SerializeUint32( length );
+			m_WriteDelta( &msgStream, entry );
+			for ( uint32_t arrIdx = 0; arrIdx < length; arrIdx++ )
+			{
+				writeValue( arrIdx );
+			}
+		}
+		else
+		{
+			writeValue( -1 );
+		}
+	}
+	if ( msgStream.GetOffset() > sizeof(EditorMsg) )
+	{
+		for ( EditorConnection* conn : connections )
+		{
+			conn->sock->QueueMsg( msgStream.GetData(), msgStream.GetOffset() );
+		}
+	}
+	m_pendingDeltas.Clear();
+	m_pendingVars.Clear();
+}
+
+void EditorServer::m_WriteDelta( ae::BinaryStream* msgStream, const ae::BinaryStream& entry )
+{
+	AE_ASSERT( entry.IsValid() );
+	if ( msgStream->GetRemaining() < entry.GetOffset() )
+	{
+		for ( EditorConnection* conn : connections )
+		{
+			conn->sock->QueueMsg( msgStream->GetData(), msgStream->GetOffset() );
+		}
+		*msgStream = ae::BinaryStream::Writer( m_msgBuffer, sizeof(m_msgBuffer) );
+		msgStream->SerializeRaw( EditorMsg::Delta );
+	}
+	msgStream->SerializeRaw( entry.GetData(), entry.GetOffset() );
+}
+
 const ae::Var* EditorServer::GetMeshResourceVar( const ae::Type* componentType )
 {
 	return m_meshResourceVars.Get( componentType, nullptr );
@@ -2144,6 +2516,21 @@ const ae::Var* EditorServer::GetMeshVisibleVar( const ae::Type* componentType )
 	return m_meshVisibleVars.Get( componentType, nullptr );
 }
 
+void EditorServer::UpdateObjectBounds( EditorProgram* program, EditorServerObject* obj )
+{
+	// Include the pick sphere used for objects without a visible mesh
+	ae::AABB aabb = obj->GetAABB( program );
+	aabb.Expand( ae::AABB( ae::Sphere( obj->GetTransform( program ).GetTranslation(), 0.5f ) ) );
+	if ( obj->proxy < 0 )
+	{
+		obj->proxy = m_objectTree.Add( aabb, obj );
+	}
+	else
+	{
+		m_objectTree.Set( obj->proxy, aabb );
+	}
+}
+
 ae::AABB EditorServer::GetSelectedAABB( EditorProgram* program ) const
 {
 	ae::AABB aabb;
@@ -2245,6 +2632,9 @@ void EditorServer::Unload()
 	}
 	AE_ASSERT( m_objects.Length() == 0 );
 	m_components.Clear();
+	// Clients read the whole level when it changes
+	m_pendingDeltas.Clear();
+	m_pendingVars.Clear();
 }
 
 void EditorServer::m_SelectWithModifiers( EditorProgram* program, EditorObjectId entity )
@@ -2386,7 +2776,7 @@ bool EditorServer::m_Load( EditorProgram* program )
 	for ( uint32_t i = 0; i < objectCount; i++ )
 	{
 		const EditorObject& levelObject = level->objects.GetValue( i );
-		EditorServerObject* editorObj = CreateObject( levelObject.id, levelObject.transform );
+		EditorServerObject* editorObj = CreateObject( program, levelObject.id, levelObject.transform );
 		editorObj->name = levelObject.name;
 		for ( const EditorComponent& levelComponent : levelObject.components )
 		{
@@ -2442,6 +2832,13 @@ bool EditorServer::m_Load( EditorProgram* program )
 			}
 		}
 	}
+	// Clients read the whole level when it changes
+	m_pendingDeltas.Clear();
+	m_pendingVars.Clear();
+	for ( auto& object : m_objects )
+	{
+		object.value->ClearDirty();
+	}
 	return true;
 }
 
@@ -2612,11 +3009,11 @@ bool EditorServer::m_ShowRefVar( EditorProgram* program, ae::Object* component,
 			ImGui::SameLine();
 			if ( ImGui::Button( "Clear" ) )
 			{
-				var->SetObjectValueFromString( component, "NULL", idx );
+				return var->SetObjectValueFromString( component, "NULL", idx );
 			}
 		}
 	}
-	return false; // @TODO: Handle ref vars changing
+	return false;
 }
 
 std::string EditorProgram::Serializer::ObjectPointerToString( const ae::Object* obj ) const
@@ -2670,10 +3067,9 @@ EditorObjectId EditorServer::m_PickObject( EditorProgram* program, ae::Color col
 	raycastParams.hitCounterclockwise = true;
 	//raycastParams.debug = &program->debugLines;
 	ae::RaycastResult result;
-	uint32_t editorObjectCount = m_objects.Length();
-	for ( uint32_t i = 0; i < editorObjectCount; i++ )
+	m_objectTree.Raycast( mouseRaySrc, raycastParams.ray, [&]( int32_t proxy, void* userData ) -> float
 	{
-		const EditorServerObject* editorObj = m_objects.GetValue( i );
+		const EditorServerObject* editorObj = (const EditorServerObject*)userData;
 		if( !editorObj->hidden )
 		{
 			if ( editorObj->mesh && ( editorObj->opaque || GetShowInvisible() ) )
@@ -2701,7 +3097,9 @@ EditorObjectId EditorServer::m_PickObject( EditorProgram* program, ae::Color col
 				}
 			}
 		}
-	}
+		// Objects farther than the closest hit so far are skipped
+		return result.hits.Length() ? ( result.hits[ 0 ].distance / kEditorViewDistance ) : 1.0f;
+	} );
 	if ( result.hits.Length() )
 	{
 		*hitOut = result.hits[ 0 ].position;
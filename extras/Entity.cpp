@@ -8,6 +8,7 @@
 //------------------------------------------------------------------------------
 #include "ae/Entity.h"
 #include "ae/Editor.h"
+#include "ctpl_stl.h"
 
 //------------------------------------------------------------------------------
 // Registration
@@ -164,7 +165,7 @@ Component* Registry::TryGetComponent( Entity entity, const char* typeName )
 Component& Registry::GetComponent( Entity entity, const char* typeName )
 {
 	Component* component = TryGetComponent( entity, typeName );
-	AE_ASSERT_MSG( component, "Entity '#' has no compoent '#'", entity );
+	AE_ASSERT_MSG( component, "Entity '#' has no compoent '#'", entity, typeName );
 	return *component;
 }
 
@@ -172,7 +173,7 @@ Component& Registry::GetComponent( const char* name, const char* typeName )
 {
 	AE_ASSERT_MSG( name && name[ 0 ], "No name specified" );
 	Component* component = TryGetComponent( name, typeName );
-	AE_ASSERT_MSG( component, "Entity '#' has no compoent '#'", name );
+	AE_ASSERT_MSG( component, "Entity '#' has no compoent '#'", name, typeName );
 	return *component;
 }
 
@@ -369,6 +370,212 @@ bool Registry::Load( const ae::EditorLevel* level, CreateObjectFn fn )
 	return true;
 }
 
+bool Registry::Load( const ae::CompiledLevel* level, CreateCompiledObjectFn fn )
+{
+	if ( !level || !level->GetLength() )
+	{
+		return false;
+	}
+	Clear();
+	if ( !m_Load( level, nullptr, fn ) )
+	{
+		// Don't leave a partially loaded level behind
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+bool Registry::LoadAdditive( const ae::CompiledLevel* level, ae::Array< Entity >* entitiesOut, CreateCompiledObjectFn fn )
+{
+	if ( !level || !level->GetLength() )
+	{
+		return false;
+	}
+	ae::Array< Entity > entities = m_tag;
+	if ( !m_Load( level, &entities, fn ) )
+	{
+		// Only destroy the entities created by this load
+		for ( Entity entity : entities )
+		{
+			Destroy( entity );
+		}
+		return false;
+	}
+	if ( entitiesOut )
+	{
+		entitiesOut->AppendArray( entities.Data(), entities.Length() );
+	}
+	return true;
+}
+
+bool Registry::m_Load( const ae::CompiledLevel* level, ae::Array< Entity >* entitiesOut, CreateCompiledObjectFn fn )
+{
+	ae::BinaryStream rStream = ae::BinaryStream::Reader( level->GetData(), level->GetLength() );
+	uint32_t magic = 0, version = 0, objectCount = 0, componentCount = 0, stringsLength = 0;
+	rStream.SerializeUint32( magic );
+	rStream.SerializeUint32( version );
+	rStream.SerializeUint32( objectCount );
+	rStream.SerializeUint32( componentCount );
+	rStream.SerializeUint32( stringsLength );
+	if ( !rStream.IsValid() || magic != CompiledLevel::kMagic || version != CompiledLevel::kVersion || stringsLength > rStream.GetRemaining() )
+	{
+		return false;
+	}
+	const char* strings = (const char*)rStream.PeekData();
+	// Strings are looked up by offset below, so the table must be terminated
+	if ( stringsLength && strings[ stringsLength - 1 ] )
+	{
+		return false;
+	}
+	rStream.Discard( stringsLength );
+	
+	// Match the stored types and vars with the registered ones once, instead
+	// of looking them up for every component
+	struct LoadVar
+	{
+		const ae::Var* var;
+		uint32_t packedSize;
+		bool isArray;
+		bool isString;
+	};
+	ae::Array< const ae::Type* > types = m_tag;
+	ae::Array< uint32_t > typeVarStarts = m_tag;
+	ae::Array< LoadVar > vars = m_tag;
+	uint32_t typeCount = 0;
+	rStream.SerializeUint32( typeCount );
+	for ( uint32_t i = 0; i < typeCount && rStream.IsValid(); i++ )
+	{
+		uint32_t typeName = 0, varCount = 0;
+		rStream.SerializeUint32( typeName );
+		rStream.SerializeUint32( varCount );
+		const ae::Type* type = ( typeName < stringsLength ) ? ae::GetTypeByName( strings + typeName ) : nullptr;
+		if ( type && ( !type->IsType< ae::Component >() || type->IsAbstract() || !type->IsDefaultConstructible() ) )
+		{
+			type = nullptr;
+		}
+		types.Append( type );
+		typeVarStarts.Append( vars.Length() );
+		for ( uint32_t j = 0; j < varCount && rStream.IsValid(); j++ )
+		{
+			uint32_t varName = 0, basicType = 0, packedSize = 0, isArray = 0;
+			rStream.SerializeUint32( varName );
+			rStream.SerializeUint32( basicType );
+			rStream.SerializeUint32( packedSize );
+			rStream.SerializeUint32( isArray );
+			const ae::Var* var = ( type && varName < stringsLength ) ? type->GetVarByName( strings + varName, true ) : nullptr;
+			if ( var && ( (uint32_t)var->GetType() != basicType
+				|| CompiledLevel::m_GetPackedSize( var->GetType() ) != packedSize
+				|| var->IsArray() != (bool)isArray ) )
+			{
+				AE_WARN( "Skipping compiled level var '#::#' because its type has changed", type->GetName(), var->GetName() );
+				var = nullptr;
+			}
+			vars.Append( { var, packedSize, (bool)isArray, CompiledLevel::m_IsStringPacked( (ae::BasicType)basicType ) } );
+		}
+	}
+	typeVarStarts.Append( vars.Length() );
+	if ( !rStream.IsValid() )
+	{
+		return false;
+	}
+	
+	// Create all entities and components
+	ae::Array< Component* > components = m_tag;
+	ae::Array< uint32_t > componentTypes = m_tag;
+	// Each component is stored as at least a uint32_t type index, so don't
+	// trust counts that couldn't fit in the rest of the level
+	const uint32_t maxComponentCount = ae::Min( componentCount, rStream.GetRemaining() / (uint32_t)sizeof(uint32_t) );
+	components.Reserve( maxComponentCount );
+	componentTypes.Reserve( maxComponentCount );
+	for ( uint32_t i = 0; i < objectCount && rStream.IsValid(); i++ )
+	{
+		uint32_t id = 0, name = 0, objectComponentCount = 0;
+		ae::Matrix4 transform;
+		rStream.SerializeUint32( id );
+		rStream.SerializeUint32( name );
+		rStream.SerializeRaw( transform );
+		rStream.SerializeUint32( objectComponentCount );
+		if ( name >= stringsLength )
+		{
+			return false;
+		}
+		Entity entity = CreateEntity( id, strings + name );
+		if ( entitiesOut )
+		{
+			entitiesOut->Append( entity );
+		}
+		if ( fn )
+		{
+			fn( entity, strings + name, transform, this );
+		}
+		for ( uint32_t j = 0; j < objectComponentCount; j++ )
+		{
+			uint32_t typeIndex = 0;
+			rStream.SerializeUint32( typeIndex );
+			if ( typeIndex >= typeCount )
+			{
+				return false;
+			}
+			const ae::Type* type = types[ typeIndex ];
+			components.Append( type ? m_AddComponent( entity, type ) : nullptr );
+			componentTypes.Append( typeIndex );
+		}
+	}
+	
+	// Set all values (second phase to handle references)
+	uint32_t valuesLength = 0;
+	rStream.SerializeUint32( valuesLength );
+	if ( !rStream.IsValid() || valuesLength != rStream.GetRemaining() )
+	{
+		return false;
+	}
+	for ( uint32_t i = 0; i < components.Length() && rStream.IsValid(); i++ )
+	{
+		Component* component = components[ i ];
+		const uint32_t typeIndex = componentTypes[ i ];
+		for ( uint32_t j = typeVarStarts[ typeIndex ]; j < typeVarStarts[ typeIndex + 1 ]; j++ )
+		{
+			const LoadVar& loadVar = vars[ j ];
+			uint32_t count = 0;
+			rStream.SerializeUint32( count );
+			if ( !component || !loadVar.var )
+			{
+				rStream.Discard( count * loadVar.packedSize );
+				continue;
+			}
+			const ae::Var* var = loadVar.var;
+			uint32_t setCount = count;
+			if ( loadVar.isArray )
+			{
+				setCount = var->SetArrayLength( component, count );
+			}
+			for ( uint32_t k = 0; k < count && rStream.IsValid(); k++ )
+			{
+				const int32_t arrayIdx = loadVar.isArray ? k : -1;
+				if ( k >= setCount )
+				{
+					rStream.Discard( loadVar.packedSize );
+				}
+				else if ( loadVar.isString )
+				{
+					uint32_t value = 0;
+					rStream.SerializeUint32( value );
+					if ( value < stringsLength )
+					{
+						var->SetObjectValueFromString( component, strings + value, arrayIdx );
+					}
+				}
+				else
+				{
+					rStream.SerializeRaw( var->GetPointer< uint8_t >( component, arrayIdx ), loadVar.packedSize );
+				}
+			}
+		}
+	}
+	return rStream.IsValid();
+}
+
 Component* Registry::m_AddComponent( Entity entity, const ae::Type* type )
 {
 	Component* component = (Component*)ae::Allocate( m_tag, type->GetSize(), type->GetAlignment() );
@@ -390,4 +597,708 @@ Component* Registry::m_AddComponent( Entity entity, const ae::Type* type )
 	return component;
 }
 
+//------------------------------------------------------------------------------
+// ae::CompiledLevel member functions
+//------------------------------------------------------------------------------
+// All values are uint32_t unless noted:
+// Header: magic, version, object count, component count
+// Strings: byte length, then null terminated strings referenced by byte offset
+// Types: count, then for each: name, var count, then for each var: name,
+//   ae::BasicType, packed size of one element, is array
+// Objects: for each: id, name, ae::Matrix4 transform, component count, then
+//   the type index of each component
+// Values: byte length, then for each component and each var of its type: the
+//   element count followed by the packed elements. Strings, enums and
+//   references are packed as string offsets, kNoValue when unset.
+class _CompiledLevelStrings
+{
+public:
+	_CompiledLevelStrings( const ae::Tag& tag ) : chars( tag ), offsets( tag )
+	{
+		chars.Append( '\0' ); // Offset 0 is the empty string
+	}
+	uint32_t Add( const char* str )
+	{
+		if ( !str[ 0 ] )
+		{
+			return 0;
+		}
+		const uint32_t hash = ae::Hash().HashString( str ).Get();
+		const uint32_t* existing = offsets.TryGet( hash );
+		if ( existing && strcmp( &chars[ *existing ], str ) == 0 )
+		{
+			return *existing;
+		}
+		const uint32_t offset = chars.Length();
+		chars.AppendArray( str, (uint32_t)strlen( str ) + 1 );
+		offsets.Set( hash, offset );
+		return offset;
+	}
+	ae::Array< char > chars;
+	ae::Map< uint32_t, uint32_t > offsets;
+};
+
+CompiledLevel::CompiledLevel( const ae::Tag& tag ) :
+	m_tag( tag ),
+	m_data( tag )
+{}
+
+void CompiledLevel::Compile( const ae::EditorLevel& level )
+{
+	m_Compile( level, nullptr, level.objects.Length() );
+}
+
+void CompiledLevel::Compile( const ae::EditorLevel& level, const ae::EditorObjectId* ids, uint32_t count )
+{
+	m_Compile( level, ids, count );
+}
+
+void CompiledLevel::m_Compile( const ae::EditorLevel& level, const ae::EditorObjectId* ids, uint32_t count )
+{
+	Clear();
+	const ae::Tag& tag = m_tag;
+	_CompiledLevelStrings strings = tag;
+	
+	struct CompileType
+	{
+		const ae::Type* type;
+		uint32_t varStart;
+		uint32_t varCount;
+		ae::Object* scratch; // Values are parsed into this before being packed
+	};
+	ae::Array< CompileType > types = tag;
+	ae::Array< const ae::Var* > vars = tag;
+	ae::Map< ae::TypeId, uint32_t > typeIndices = tag;
+	auto getTypeIndex = [&]( const ae::Type* type ) -> uint32_t
+	{
+		if ( const uint32_t* index = typeIndices.TryGet( type->GetId() ) )
+		{
+			return *index;
+		}
+		CompileType compileType;
+		compileType.type = type;
+		compileType.varStart = vars.Length();
+		const uint32_t varCount = type->GetVarCount( true );
+		for ( uint32_t i = 0; i < varCount; i++ )
+		{
+			const ae::Var* var = type->GetVarByIndex( i, true );
+			if ( m_GetPackedSize( var->GetType() ) )
+			{
+				vars.Append( var );
+			}
+		}
+		compileType.varCount = vars.Length() - compileType.varStart;
+		compileType.scratch = (ae::Object*)ae::Allocate( tag, type->GetSize(), type->GetAlignment() );
+		type->New( compileType.scratch );
+		types.Append( compileType );
+		return typeIndices.Set( type->GetId(), types.Length() - 1 );
+	};
+	
+	ae::Array< uint8_t > objectData = tag;
+	ae::Array< uint8_t > valueData = tag;
+	ae::BinaryStream objectStream = ae::BinaryStream::Writer( &objectData );
+	ae::BinaryStream valueStream = ae::BinaryStream::Writer( &valueData );
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		const ae::EditorObject* levelObjectPtr = ids ? level.objects.TryGet( ids[ i ] ) : &level.objects.GetValue( i );
+		if ( !levelObjectPtr )
+		{
+			continue;
+		}
+		const ae::EditorObject& levelObject = *levelObjectPtr;
+		objectStream.SerializeUint32( levelObject.id );
+		objectStream.SerializeUint32( strings.Add( levelObject.name.c_str() ) );
+		objectStream.SerializeRaw( levelObject.transform );
+		uint32_t componentCount = 0;
+		for ( const ae::EditorComponent& levelComponent : levelObject.components )
+		{
+			const ae::Type* type = ae::GetTypeByName( levelComponent.type.c_str() );
+			componentCount += ( type && type->IsType< ae::Component >() && !type->IsAbstract() && type->IsDefaultConstructible() );
+		}
+		objectStream.SerializeUint32( componentCount );
+		m_objectCount++;
+		m_componentCount += componentCount;
+		
+		for ( const ae::EditorComponent& levelComponent : levelObject.components )
+		{
+			const ae::Type* type = ae::GetTypeByName( levelComponent.type.c_str() );
+			if ( !type || !type->IsType< ae::Component >() || type->IsAbstract() || !type->IsDefaultConstructible() )
+			{
+				continue;
+			}
+			const uint32_t typeIndex = getTypeIndex( type );
+			objectStream.SerializeUint32( typeIndex );
+			
+			// Reset the scratch object so missing values are packed as defaults
+			const CompileType& compileType = types[ typeIndex ];
+			ae::Object* scratch = compileType.scratch;
+			scratch->~Object();
+			type->New( scratch );
+			const ae::Dict& props = levelComponent.members;
+			for ( uint32_t j = 0; j < compileType.varCount; j++ )
+			{
+				const ae::Var* var = vars[ compileType.varStart + j ];
+				const uint32_t packedSize = m_GetPackedSize( var->GetType() );
+				const bool isString = m_IsStringPacked( var->GetType() );
+				if ( var->IsArray() )
+				{
+					const uint32_t length = var->SetArrayLength( scratch, props.GetInt( var->GetName(), 0 ) );
+					valueStream.SerializeUint32( length );
+					for ( uint32_t arrIdx = 0; arrIdx < length; arrIdx++ )
+					{
+						ae::Str32 key = ae::Str32::Format( "#::#", var->GetName(), arrIdx );
+						const char* value = props.GetString( key.c_str(), nullptr );
+						if ( isString )
+						{
+							valueStream.SerializeUint32( value ? strings.Add( value ) : kNoValue );
+							continue;
+						}
+						if ( value )
+						{
+							var->SetObjectValueFromString( scratch, value, arrIdx );
+						}
+						valueStream.SerializeRaw( var->GetPointer< uint8_t >( scratch, arrIdx ), packedSize );
+					}
+				}
+				else if ( const char* value = props.GetString( var->GetName(), nullptr ) )
+				{
+					valueStream.SerializeUint32( 1u );
+					if ( isString )
+					{
+						valueStream.SerializeUint32( strings.Add( value ) );
+					}
+					else
+					{
+						var->SetObjectValueFromString( scratch, value );
+						valueStream.SerializeRaw( var->GetPointer< uint8_t >( scratch ), packedSize );
+					}
+				}
+				else
+				{
+					valueStream.SerializeUint32( 0u );
+				}
+			}
+		}
+	}
+	
+	ae::Array< uint8_t > typeData = tag;
+	ae::BinaryStream typeStream = ae::BinaryStream::Writer( &typeData );
+	typeStream.SerializeUint32( types.Length() );
+	for ( const CompileType& compileType : types )
+	{
+		typeStream.SerializeUint32( strings.Add( compileType.type->GetName() ) );
+		typeStream.SerializeUint32( compileType.varCount );
+		for ( uint32_t i = 0; i < compileType.varCount; i++ )
+		{
+			const ae::Var* var = vars[ compileType.varStart + i ];
+			typeStream.SerializeUint32( strings.Add( var->GetName() ) );
+			typeStream.SerializeUint32( (uint32_t)var->GetType() );
+			typeStream.SerializeUint32( m_GetPackedSize( var->GetType() ) );
+			typeStream.SerializeUint32( (uint32_t)var->IsArray() );
+		}
+		compileType.scratch->~Object();
+		ae::Free( compileType.scratch );
+	}
+	
+	const uint32_t magic = kMagic;
+	const uint32_t version = kVersion;
+	ae::BinaryStream wStream = ae::BinaryStream::Writer( &m_data );
+	wStream.SerializeUint32( magic );
+	wStream.SerializeUint32( version );
+	wStream.SerializeUint32( m_objectCount );
+	wStream.SerializeUint32( m_componentCount );
+	wStream.SerializeUint32( strings.chars.Length() );
+	wStream.SerializeRaw( strings.chars.Data(), strings.chars.Length() );
+	wStream.SerializeRaw( typeStream.GetData(), typeStream.GetOffset() );
+	wStream.SerializeRaw( objectStream.GetData(), objectStream.GetOffset() );
+	wStream.SerializeUint32( valueStream.GetOffset() );
+	wStream.SerializeRaw( valueStream.GetData(), valueStream.GetOffset() );
+	AE_ASSERT( wStream.IsValid() );
+}
+
+bool CompiledLevel::Read( const void* data, uint32_t length )
+{
+	Clear();
+	ae::BinaryStream rStream = ae::BinaryStream::Reader( (const uint8_t*)data, length );
+	uint32_t magic = 0, version = 0, objectCount = 0, componentCount = 0;
+	rStream.SerializeUint32( magic );
+	rStream.SerializeUint32( version );
+	rStream.SerializeUint32( objectCount );
+	rStream.SerializeUint32( componentCount );
+	if ( !rStream.IsValid() || magic != kMagic || version != kVersion )
+	{
+		return false;
+	}
+	m_data.AppendArray( (const uint8_t*)data, length );
+	m_objectCount = objectCount;
+	m_componentCount = componentCount;
+	return true;
+}
+
+void CompiledLevel::Clear()
+{
+	m_data.Clear();
+	m_objectCount = 0;
+	m_componentCount = 0;
+}
+
+uint32_t CompiledLevel::m_GetPackedSize( ae::BasicType type )
+{
+	switch ( type )
+	{
+		case ae::BasicType::UInt8: return sizeof(uint8_t);
+		case ae::BasicType::UInt16: return sizeof(uint16_t);
+		case ae::BasicType::UInt32: return sizeof(uint32_t);
+		case ae::BasicType::UInt64: return sizeof(uint64_t);
+		case ae::BasicType::Int8: return sizeof(int8_t);
+		case ae::BasicType::Int16: return sizeof(int16_t);
+		case ae::BasicType::Int32: return sizeof(int32_t);
+		case ae::BasicType::Int64: return sizeof(int64_t);
+		case ae::BasicType::Int2: return sizeof(ae::Int2);
+		case ae::BasicType::Int3: return sizeof(ae::Int3);
+		case ae::BasicType::Bool: return sizeof(bool);
+		case ae::BasicType::Float: return sizeof(float);
+		case ae::BasicType::Double: return sizeof(double);
+		case ae::BasicType::Vec2: return sizeof(ae::Vec2);
+		case ae::BasicType::Vec3: return sizeof(ae::Vec3);
+		case ae::BasicType::Vec4: return sizeof(ae::Vec4);
+		case ae::BasicType::Matrix4: return sizeof(ae::Matrix4);
+		case ae::BasicType::Color: return sizeof(ae::Color);
+		// String offsets
+		case ae::BasicType::String:
+		case ae::BasicType::Enum:
+		case ae::BasicType::Pointer:
+		case ae::BasicType::CustomRef:
+			return sizeof(uint32_t);
+		// Can't be set from a string so not saved in levels
+		case ae::BasicType::Class:
+			return 0;
+	}
+	return 0;
+}
+
+bool CompiledLevel::m_IsStringPacked( ae::BasicType type )
+{
+	return type == ae::BasicType::String
+		|| type == ae::BasicType::Enum
+		|| type == ae::BasicType::Pointer
+		|| type == ae::BasicType::CustomRef;
+}
+
+//------------------------------------------------------------------------------
+// ae::StreamedLevel member functions
+//------------------------------------------------------------------------------
+// Index file: magic, version, cell size (float), cell count, then for each
+// cell: coord (3 int32_t), object count. Each cell is a separate
+// ae::CompiledLevel file named by its coord.
+StreamedLevel::StreamedLevel( const ae::Tag& tag ) :
+	m_tag( tag ),
+	m_cells( tag )
+{}
+
+StreamedLevel::~StreamedLevel()
+{
+	Clear();
+}
+
+void StreamedLevel::Compile( const ae::EditorLevel& level, float cellSize )
+{
+	AE_ASSERT_MSG( cellSize > 0.0f, "Invalid cell size '#'", cellSize );
+	Clear();
+	m_cellSize = cellSize;
+	
+	ae::Map< ae::Int3, uint32_t > cellIndices = m_tag;
+	ae::Array< ae::Array< ae::EditorObjectId > > cellObjects = m_tag;
+	for ( uint32_t i = 0; i < level.objects.Length(); i++ )
+	{
+		const ae::EditorObject& levelObject = level.objects.GetValue( i );
+		const ae::Int3 coord = ( levelObject.transform.GetTranslation() / cellSize ).FloorCopy();
+		const uint32_t* cellIndex = cellIndices.TryGet( coord );
+		if ( !cellIndex )
+		{
+			cellIndex = &cellIndices.Set( coord, cellObjects.Length() );
+			cellObjects.Append( m_tag );
+		}
+		cellObjects[ *cellIndex ].Append( levelObject.id );
+	}
+	
+	m_cells.Reserve( cellObjects.Length() );
+	for ( uint32_t i = 0; i < cellObjects.Length(); i++ )
+	{
+		const ae::Array< ae::EditorObjectId >& ids = cellObjects[ i ];
+		Cell cell;
+		cell.coord = cellIndices.GetKey( i );
+		cell.objectCount = ids.Length();
+		cell.level = ae::New< ae::CompiledLevel >( m_tag, m_tag );
+		cell.level->Compile( level, ids.Data(), ids.Length() );
+		m_cells.Append( cell );
+	}
+}
+
+bool StreamedLevel::Write( const char* directory ) const
+{
+	ae::Array< uint8_t > data = m_tag;
+	ae::BinaryStream wStream = ae::BinaryStream::Writer( &data );
+	const uint32_t magic = kMagic;
+	const uint32_t version = kVersion;
+	wStream.SerializeUint32( magic );
+	wStream.SerializeUint32( version );
+	wStream.SerializeFloat( m_cellSize );
+	wStream.SerializeUint32( m_cells.Length() );
+	for ( const Cell& cell : m_cells )
+	{
+		if ( !cell.level )
+		{
+			AE_WARN( "Can't write streamed level that wasn't compiled" );
+			return false;
+		}
+		wStream.SerializeInt32( cell.coord.x );
+		wStream.SerializeInt32( cell.coord.y );
+		wStream.SerializeInt32( cell.coord.z );
+		wStream.SerializeUint32( cell.objectCount );
+	}
+	
+	ae::Str256 indexPath = directory;
+	ae::FileSystem::AppendToPath( &indexPath, "level.aeli" );
+	if ( !ae::FileSystem::Write( indexPath.c_str(), data.Data(), data.Length(), true ) )
+	{
+		return false;
+	}
+	for ( uint32_t i = 0; i < m_cells.Length(); i++ )
+	{
+		const ae::CompiledLevel* level = m_cells[ i ].level;
+		if ( !ae::FileSystem::Write( GetCellPath( directory, i ).c_str(), level->GetData(), level->GetLength(), true ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool StreamedLevel::Read( const char* directory )
+{
+	Clear();
+	ae::Str256 indexPath = directory;
+	ae::FileSystem::AppendToPath( &indexPath, "level.aeli" );
+	const uint32_t length = ae::FileSystem::GetSize( indexPath.c_str() );
+	if ( !length )
+	{
+		return false;
+	}
+	ae::Array< uint8_t > data( m_tag, 0, length );
+	if ( ae::FileSystem::Read( indexPath.c_str(), data.Data(), length ) != length )
+	{
+		return false;
+	}
+	
+	ae::BinaryStream rStream = ae::BinaryStream::Reader( data.Data(), length );
+	uint32_t magic = 0, version = 0, cellCount = 0;
+	rStream.SerializeUint32( magic );
+	rStream.SerializeUint32( version );
+	rStream.SerializeFloat( m_cellSize );
+	rStream.SerializeUint32( cellCount );
+	if ( !rStream.IsValid() || magic != kMagic || version != kVersion || !( m_cellSize > 0.0f ) )
+	{
+		Clear();
+		return false;
+	}
+	m_cells.Reserve( cellCount );
+	for ( uint32_t i = 0; i < cellCount && rStream.IsValid(); i++ )
+	{
+		Cell cell;
+		rStream.SerializeInt32( cell.coord.x );
+		rStream.SerializeInt32( cell.coord.y );
+		rStream.SerializeInt32( cell.coord.z );
+		rStream.SerializeUint32( cell.objectCount );
+		cell.level = nullptr;
+		m_cells.Append( cell );
+	}
+	if ( !rStream.IsValid() )
+	{
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+void StreamedLevel::Clear()
+{
+	for ( const Cell& cell : m_cells )
+	{
+		if ( cell.level )
+		{
+			ae::Delete( cell.level );
+		}
+	}
+	m_cells.Clear();
+	m_cellSize = 0.0f;
+}
+
+ae::AABB StreamedLevel::GetCellBounds( uint32_t index ) const
+{
+	const ae::Vec3 min = ae::Vec3( m_cells[ index ].coord ) * m_cellSize;
+	return ae::AABB( min, min + ae::Vec3( m_cellSize ) );
+}
+
+ae::Str256 StreamedLevel::GetCellPath( const char* directory, uint32_t index ) const
+{
+	const ae::Int3 coord = m_cells[ index ].coord;
+	ae::Str256 path = directory;
+	ae::FileSystem::AppendToPath( &path, ae::Str64::Format( "cell_#_#_#.aelv", coord.x, coord.y, coord.z ).c_str() );
+	return path;
+}
+
+//------------------------------------------------------------------------------
+// ae::LevelStreamer member functions
+//------------------------------------------------------------------------------
+LevelStreamer::LevelStreamer( const ae::Tag& tag ) :
+	m_tag( tag ),
+	m_cells( tag ),
+	m_sorted( tag ),
+	m_readDone( tag ),
+	m_readDoneTemp( tag )
+{}
+
+LevelStreamer::~LevelStreamer()
+{
+	Terminate();
+}
+
+void LevelStreamer::Initialize( const ae::StreamedLevel* level, ae::Registry* registry, const char* directory, uint32_t threadCount )
+{
+	AE_ASSERT( level );
+	AE_ASSERT( registry );
+	Terminate();
+	m_level = level;
+	m_registry = registry;
+	m_directory = directory ? directory : "";
+	m_cells.Reserve( level->GetCellCount() );
+	for ( uint32_t i = 0; i < level->GetCellCount(); i++ )
+	{
+		m_cells.Append( Cell( m_tag ) );
+	}
+	if ( threadCount )
+	{
+		m_threadPool = ae::New< ctpl::thread_pool >( m_tag, threadCount );
+	}
+}
+
+void LevelStreamer::Terminate()
+{
+	if ( m_threadPool )
+	{
+		// Wait for pending reads so they can be freed below
+		m_threadPool->stop( true );
+		ae::Delete( m_threadPool );
+		m_threadPool = nullptr;
+	}
+	for ( Cell& cell : m_cells )
+	{
+		for ( int32_t i = cell.entities.Length() - 1; i >= 0; i-- )
+		{
+			m_registry->Destroy( cell.entities[ i ] );
+		}
+		m_FreeRead( &cell );
+	}
+	m_cells.Clear();
+	m_sorted.Clear();
+	m_readDone.Clear();
+	m_readDoneTemp.Clear();
+	m_level = nullptr;
+	m_registry = nullptr;
+}
+
+void LevelStreamer::Update( ae::Vec3 focus, float loadRadius, float unloadRadius )
+{
+	AE_ASSERT_MSG( m_level, "Must call ae::LevelStreamer::Initialize() before Update()" );
+	
+	// Start reading cells in range
+	for ( uint32_t i = 0; i < m_cells.Length(); i++ )
+	{
+		Cell& cell = m_cells[ i ];
+		cell.distance = m_level->GetCellBounds( i ).GetSignedDistanceFromSurface( focus );
+		if ( cell.distance <= loadRadius )
+		{
+			cell.wanted = true;
+		}
+		else if ( cell.distance > unloadRadius )
+		{
+			cell.wanted = false;
+		}
+		if ( !cell.wanted || cell.failed || cell.state != CellState::Unloaded )
+		{
+			continue;
+		}
+		if ( const ae::CompiledLevel* level = m_level->GetCellLevel( i ) )
+		{
+			cell.level = level;
+			cell.state = CellState::Ready;
+		}
+		else
+		{
+			cell.state = CellState::Reading;
+			if ( m_threadPool )
+			{
+				m_threadPool->push( [ this, i ]( int ){ m_Read( i ); } );
+			}
+			else
+			{
+				m_Read( i );
+			}
+		}
+	}
+	
+	// Finish reads
+	{
+		std::lock_guard< std::mutex > lock( m_readMutex );
+		m_readDoneTemp.AppendArray( m_readDone.Data(), m_readDone.Length() );
+		m_readDone.Clear();
+	}
+	for ( uint32_t index : m_readDoneTemp )
+	{
+		Cell& cell = m_cells[ index ];
+		AE_ASSERT( cell.state == CellState::Reading );
+		if ( !cell.readLevel )
+		{
+			AE_WARN( "Failed to read level cell '#'", m_level->GetCellPath( m_directory.c_str(), index ) );
+			cell.failed = true;
+			cell.state = CellState::Unloaded;
+		}
+		else if ( cell.wanted )
+		{
+			cell.level = cell.readLevel;
+			cell.state = CellState::Ready;
+		}
+		else
+		{
+			m_FreeRead( &cell );
+			cell.state = CellState::Unloaded;
+		}
+	}
+	m_readDoneTemp.Clear();
+	
+	// Unload first so names of moved objects are free before loading
+	const uint32_t budget = m_objectBudget ? m_objectBudget : ~0u;
+	uint32_t objectCount = 0;
+	m_sorted.Clear();
+	for ( uint32_t i = 0; i < m_cells.Length(); i++ )
+	{
+		Cell& cell = m_cells[ i ];
+		// Cells wanted again while unloading finish unloading first and are
+		// read again by a later Update(), so they are never left half loaded
+		if ( cell.wanted && cell.state != CellState::Unloading )
+		{
+			if ( cell.state == CellState::Ready )
+			{
+				m_sorted.Append( i );
+			}
+			continue;
+		}
+		if ( cell.state == CellState::Ready )
+		{
+			m_FreeRead( &cell );
+			cell.state = CellState::Unloaded;
+		}
+		else if ( cell.state == CellState::Loaded )
+		{
+			cell.state = CellState::Unloading;
+		}
+		while ( cell.state == CellState::Unloading && objectCount < budget )
+		{
+			if ( !cell.entities.Length() )
+			{
+				cell.state = CellState::Unloaded;
+				break;
+			}
+			m_registry->Destroy( cell.entities[ cell.entities.Length() - 1 ] );
+			cell.entities.Remove( cell.entities.Length() - 1 );
+			objectCount++;
+		}
+	}
+	
+	// Load nearest cells first. Cells are added whole so references between
+	// objects in the same cell are resolved.
+	std::sort( m_sorted.begin(), m_sorted.end(), [ this ]( uint32_t a, uint32_t b )
+	{
+		return m_cells[ a ].distance < m_cells[ b ].distance;
+	} );
+	for ( uint32_t i = 0; i < m_sorted.Length(); i++ )
+	{
+		if ( i && objectCount >= budget )
+		{
+			break;
+		}
+		Cell& cell = m_cells[ m_sorted[ i ] ];
+		AE_ASSERT( !cell.entities.Length() );
+		if ( !m_registry->LoadAdditive( cell.level, &cell.entities, m_createObjectFn ) )
+		{
+			AE_WARN( "Failed to load level cell '#'", m_level->GetCellCoord( m_sorted[ i ] ) );
+			cell.failed = true;
+			m_FreeRead( &cell );
+			cell.state = CellState::Unloaded;
+			continue;
+		}
+		objectCount += cell.entities.Length();
+		// Compiled data isn't needed after loading
+		m_FreeRead( &cell );
+		cell.state = CellState::Loaded;
+	}
+}
+
+bool LevelStreamer::IsCellLoaded( uint32_t index ) const
+{
+	return m_cells[ index ].state == CellState::Loaded;
+}
+
+uint32_t LevelStreamer::GetLoadedCellCount() const
+{
+	uint32_t count = 0;
+	for ( const Cell& cell : m_cells )
+	{
+		count += ( cell.state == CellState::Loaded );
+	}
+	return count;
+}
+
+uint32_t LevelStreamer::GetPendingCellCount() const
+{
+	uint32_t count = 0;
+	for ( const Cell& cell : m_cells )
+	{
+		count += ( cell.state == CellState::Reading || cell.state == CellState::Ready );
+	}
+	return count;
+}
+
+void LevelStreamer::m_Read( uint32_t index )
+{
+	// Called on a worker thread when m_threadPool is set
+	const ae::Str256 path = m_level->GetCellPath( m_directory.c_str(), index );
+	const uint32_t length = ae::FileSystem::GetSize( path.c_str() );
+	ae::CompiledLevel* level = nullptr;
+	if ( length )
+	{
+		ae::Array< uint8_t > data( m_tag, 0, length );
+		level = ae::New< ae::CompiledLevel >( m_tag, m_tag );
+		if ( ae::FileSystem::Read( path.c_str(), data.Data(), length ) != length || !level->Read( data.Data(), length ) )
+		{
+			ae::Delete( level );
+			level = nullptr;
+		}
+	}
+	std::lock_guard< std::mutex > lock( m_readMutex );
+	m_cells[ index ].readLevel = level;
+	m_readDone.Append( index );
+}
+
+void LevelStreamer::m_FreeRead( Cell* cell )
+{
+	if ( cell->readLevel )
+	{
+		ae::Delete( cell->readLevel );
+		cell->readLevel = nullptr;
+	}
+	cell->level = nullptr;
+}
+
 } // End ae namespace
@@ -69,7 +69,7 @@ bool ae::ResourceManager::Add( const char* type, const char* name, const char* f
 
 ae::Resource* ae::ResourceManager::m_Add( const char* type, const char* name )
 {
-	ae::Str64 key( name );
+	const ae::Name key( name );
 	if ( m_resources.Get( key, nullptr ) )
 	{
 		AE_FAIL_MSG( "Resource '#' already exists", name );
@@ -29,12 +29,6 @@ namespace ae {
 //------------------------------------------------------------------------------
 // Types
 //------------------------------------------------------------------------------
-struct _SpriteVertex
-{
-	ae::Vec4 pos;
-	ae::Vec4 color;
-	ae::Vec2 uv;
-};
 using _SpriteIndex = uint16_t;
 
 //------------------------------------------------------------------------------
@@ -90,29 +84,389 @@ float SpriteFont::GetTextWidth( const char* text, float uiSize ) const
 	return std::max( width, advance );
 }
 
+//------------------------------------------------------------------------------
+// ae::SpriteBatcher member functions
+//------------------------------------------------------------------------------
+SpriteBatcher::SpriteBatcher( const ae::Tag& tag ) :
+	m_keys( tag ),
+	m_indices( tag ),
+	m_tempKeys( tag ),
+	m_tempIndices( tag ),
+	m_batches( tag )
+{}
+
+void SpriteBatcher::Reserve( uint32_t count )
+{
+	m_keys.Reserve( count );
+	m_indices.Reserve( count );
+	m_tempKeys.Reserve( count );
+	m_tempIndices.Reserve( count );
+}
+
+void SpriteBatcher::Add( uint32_t group, float depth )
+{
+	m_indices.Append( m_keys.Length() );
+	m_keys.Append( GetSortKey( group, depth ) );
+}
+
+void SpriteBatcher::Sort()
+{
+	const uint32_t count = m_keys.Length();
+	m_batches.Clear();
+	if ( !count )
+	{
+		return;
+	}
+
+	// Least significant digit radix sort, 8 bits per pass. Each pass is
+	// stable so sprites with equal keys stay in the order they were added.
+	m_tempKeys.Clear();
+	m_tempIndices.Clear();
+	m_tempKeys.Append( 0, count );
+	m_tempIndices.Append( 0, count );
+	uint64_t* keys = m_keys.Data();
+	uint32_t* indices = m_indices.Data();
+	uint64_t* tempKeys = m_tempKeys.Data();
+	uint32_t* tempIndices = m_tempIndices.Data();
+	for ( uint32_t shift = 0; shift < 64; shift += 8 )
+	{
+		uint32_t offsets[ 256 ] = { 0 };
+		for ( uint32_t i = 0; i < count; i++ )
+		{
+			offsets[ ( keys[ i ] >> shift ) & 0xFF ]++;
+		}
+		// Skip passes where every key has the same digit. Usually only a few
+		// groups are used and most sprites share a depth, so most passes are
+		// skipped.
+		if ( offsets[ ( keys[ 0 ] >> shift ) & 0xFF ] == count )
+		{
+			continue;
+		}
+		uint32_t total = 0;
+		for ( uint32_t i = 0; i < 256; i++ )
+		{
+			const uint32_t digitCount = offsets[ i ];
+			offsets[ i ] = total;
+			total += digitCount;
+		}
+		for ( uint32_t i = 0; i < count; i++ )
+		{
+			const uint32_t dest = offsets[ ( keys[ i ] >> shift ) & 0xFF ]++;
+			tempKeys[ dest ] = keys[ i ];
+			tempIndices[ dest ] = indices[ i ];
+		}
+		std::swap( keys, tempKeys );
+		std::swap( indices, tempIndices );
+	}
+	if ( keys != m_keys.Data() )
+	{
+		memcpy( m_keys.Data(), keys, count * sizeof(*keys) );
+		memcpy( m_indices.Data(), indices, count * sizeof(*indices) );
+	}
+
+	// Merge consecutive sprites of the same group
+	Batch batch = { (uint32_t)( m_keys[ 0 ] >> 32 ), 0, 0 };
+	for ( uint32_t i = 0; i < count; i++ )
+	{
+		const uint32_t group = (uint32_t)( m_keys[ i ] >> 32 );
+		if ( group != batch.group )
+		{
+			m_batches.Append( batch );
+			batch = { group, i, 0 };
+		}
+		batch.count++;
+	}
+	m_batches.Append( batch );
+}
+
+void SpriteBatcher::Clear()
+{
+	m_keys.Clear();
+	m_indices.Clear();
+	m_batches.Clear();
+}
+
+uint64_t SpriteBatcher::GetSortKey( uint32_t group, float depth )
+{
+	// Flip all bits of negative floats and only the sign bit of positive
+	// floats so they compare correctly as unsigned ints
+	uint32_t depthBits;
+	memcpy( &depthBits, &depth, sizeof(depthBits) );
+	depthBits ^= ( depthBits & 0x80000000 ) ? 0xFFFFFFFF : 0x80000000;
+	return ( (uint64_t)group << 32 ) | depthBits;
+}
+
+//------------------------------------------------------------------------------
+// ae::AtlasPacker member functions
+//------------------------------------------------------------------------------
+AtlasPacker::AtlasPacker( const ae::Tag& tag ) :
+	m_entries( tag ),
+	m_free( tag ),
+	m_temp( tag )
+{}
+
+void AtlasPacker::Initialize( uint32_t width, uint32_t height, uint32_t padding, uint32_t border, uint32_t alignment )
+{
+	AE_ASSERT( width && height );
+	AE_ASSERT_MSG( alignment && !( alignment & ( alignment - 1 ) ), "Atlas alignment must be a power of two: #", alignment );
+	m_width = width;
+	m_height = height;
+	m_padding = padding;
+	m_border = border;
+	m_alignment = alignment;
+	Clear();
+}
+
+void AtlasPacker::Clear()
+{
+	m_entries.Clear();
+	m_usedArea = 0;
+	// Padding and alignment are only needed between entries, so let them hang
+	// off the right and bottom edges of the atlas. Insert() checks that the
+	// texels of each entry are inside the atlas.
+	const uint32_t mask = m_alignment - 1;
+	m_free.Clear();
+	m_free.Append( { 0, 0, (int32_t)( ( m_width + m_padding + mask ) & ~mask ), (int32_t)( ( m_height + m_padding + mask ) & ~mask ) } );
+}
+
+uint32_t AtlasPacker::Insert( uint32_t width, uint32_t height )
+{
+	AE_ASSERT_MSG( m_width, "AtlasPacker is not initialized" );
+	if ( !width || !height )
+	{
+		return 0;
+	}
+	const uint32_t mask = m_alignment - 1;
+	const int32_t texelWidth = (int32_t)( width + m_border * 2 );
+	const int32_t texelHeight = (int32_t)( height + m_border * 2 );
+	const int32_t w = (int32_t)( ( texelWidth + m_padding + mask ) & ~mask );
+	const int32_t h = (int32_t)( ( texelHeight + m_padding + mask ) & ~mask );
+
+	// Best short side fit, ties broken by long side
+	int32_t bestIndex = -1;
+	int32_t bestShort = INT32_MAX;
+	int32_t bestLong = INT32_MAX;
+	for ( uint32_t i = 0; i < m_free.Length(); i++ )
+	{
+		const Space& f = m_free[ i ];
+		if ( f.w < w || f.h < h
+			|| f.x + texelWidth > (int32_t)m_width || f.y + texelHeight > (int32_t)m_height )
+		{
+			continue;
+		}
+		const int32_t shortSide = ae::Min( f.w - w, f.h - h );
+		const int32_t longSide = ae::Max( f.w - w, f.h - h );
+		if ( shortSide < bestShort || ( shortSide == bestShort && longSide < bestLong ) )
+		{
+			bestIndex = i;
+			bestShort = shortSide;
+			bestLong = longSide;
+		}
+	}
+	if ( bestIndex < 0 )
+	{
+		return 0;
+	}
+
+	Entry entry;
+	entry.space = { m_free[ bestIndex ].x, m_free[ bestIndex ].y, w, h };
+	entry.width = width;
+	entry.height = height;
+	m_Split( entry.space );
+	m_Prune();
+
+	const uint32_t id = m_nextId++;
+	if ( !m_nextId )
+	{
+		m_nextId = 1;
+	}
+	m_entries.Set( id, entry );
+	m_usedArea += (uint64_t)w * (uint64_t)h;
+	return id;
+}
+
+void AtlasPacker::Remove( uint32_t id )
+{
+	Entry entry;
+	const bool removed = m_entries.Remove( id, &entry );
+	AE_ASSERT_MSG( removed, "Invalid atlas entry id: #", id );
+	m_usedArea -= (uint64_t)entry.space.w * (uint64_t)entry.space.h;
+	if ( !m_entries.Length() )
+	{
+		Clear();
+		return;
+	}
+	const uint32_t first = m_free.Length();
+	m_free.Append( entry.space );
+	m_Merge( first );
+}
+
+ae::RectInt AtlasPacker::GetRect( uint32_t id ) const
+{
+	const Entry& entry = m_GetEntry( id );
+	return ae::RectInt::FromPointAndSize( entry.space.x + m_border, entry.space.y + m_border, entry.width, entry.height );
+}
+
+ae::RectInt AtlasPacker::GetBorderRect( uint32_t id ) const
+{
+	const Entry& entry = m_GetEntry( id );
+	return ae::RectInt::FromPointAndSize( entry.space.x, entry.space.y, entry.width + m_border * 2, entry.height + m_border * 2 );
+}
+
+ae::Rect AtlasPacker::GetUVs( uint32_t id ) const
+{
+	const Entry& entry = m_GetEntry( id );
+	const ae::Vec2 size( m_width, m_height );
+	const ae::Vec2 min( entry.space.x + m_border, entry.space.y + m_border );
+	const ae::Vec2 max = min + ae::Vec2( entry.width, entry.height );
+	return ae::Rect::FromPoints( min / size, max / size );
+}
+
+void AtlasPacker::m_Split( const Space& used )
+{
+	// Replace each free space overlapping the new entry with the (up to four)
+	// maximal spaces around it
+	m_temp.Clear();
+	for ( const Space& f : m_free )
+	{
+		if ( used.x >= f.x + f.w || used.x + used.w <= f.x
+			|| used.y >= f.y + f.h || used.y + used.h <= f.y )
+		{
+			m_temp.Append( f );
+			continue;
+		}
+		if ( used.x > f.x )
+		{
+			m_temp.Append( { f.x, f.y, used.x - f.x, f.h } );
+		}
+		if ( used.x + used.w < f.x + f.w )
+		{
+			m_temp.Append( { used.x + used.w, f.y, f.x + f.w - ( used.x + used.w ), f.h } );
+		}
+		if ( used.y > f.y )
+		{
+			m_temp.Append( { f.x, f.y, f.w, used.y - f.y } );
+		}
+		if ( used.y + used.h < f.y + f.h )
+		{
+			m_temp.Append( { f.x, used.y + used.h, f.w, f.y + f.h - ( used.y + used.h ) } );
+		}
+	}
+	m_free.Clear();
+	m_free.AppendArray( m_temp.Data(), m_temp.Length() );
+}
+
+void AtlasPacker::m_Merge( uint32_t first )
+{
+	// Spaces freed by Remove() are combined with touching or overlapping free
+	// spaces so later inserts can use the whole area. The new combined spaces
+	// are appended and combined again until nothing new is found. Skipping
+	// spaces already covered by another keeps this finite.
+	auto tryAppend = [ this ]( const Space& s )
+	{
+		for ( const Space& f : m_free )
+		{
+			if ( f.Contains( s ) )
+			{
+				return;
+			}
+		}
+		m_free.Append( s );
+	};
+	for ( uint32_t i = first; i < m_free.Length(); i++ )
+	{
+		for ( uint32_t j = 0; j < m_free.Length(); j++ )
+		{
+			if ( i == j )
+			{
+				continue;
+			}
+			// Copies because appending can reallocate
+			const Space a = m_free[ i ];
+			const Space b = m_free[ j ];
+			const int32_t y0 = ae::Max( a.y, b.y );
+			const int32_t y1 = ae::Min( a.y + a.h, b.y + b.h );
+			if ( y1 > y0 && a.x <= b.x + b.w && b.x <= a.x + a.w )
+			{
+				const int32_t x0 = ae::Min( a.x, b.x );
+				tryAppend( { x0, y0, ae::Max( a.x + a.w, b.x + b.w ) - x0, y1 - y0 } );
+			}
+			const int32_t x0 = ae::Max( a.x, b.x );
+			const int32_t x1 = ae::Min( a.x + a.w, b.x + b.w );
+			if ( x1 > x0 && a.y <= b.y + b.h && b.y <= a.y + a.h )
+			{
+				const int32_t y0 = ae::Min( a.y, b.y );
+				tryAppend( { x0, y0, x1 - x0, ae::Max( a.y + a.h, b.y + b.h ) - y0 } );
+			}
+		}
+	}
+	m_Prune();
+}
+
+void AtlasPacker::m_Prune()
+{
+	// Remove free spaces completely covered by another free space
+	for ( int32_t i = 0; i < (int32_t)m_free.Length(); i++ )
+	{
+		for ( int32_t j = i + 1; j < (int32_t)m_free.Length(); j++ )
+		{
+			if ( m_free[ j ].Contains( m_free[ i ] ) )
+			{
+				m_free.Remove( i );
+				i--;
+				break;
+			}
+			if ( m_free[ i ].Contains( m_free[ j ] ) )
+			{
+				m_free.Remove( j );
+				j--;
+			}
+		}
+	}
+}
+
+bool AtlasPacker::Space::Contains( const Space& other ) const
+{
+	return other.x >= x && other.y >= y
+		&& other.x + other.w <= x + w
+		&& other.y + other.h <= y + h;
+}
+
+const AtlasPacker::Entry& AtlasPacker::m_GetEntry( uint32_t id ) const
+{
+	const Entry* entry = m_entries.TryGet( id );
+	AE_ASSERT_MSG( entry, "Invalid atlas entry id: #", id );
+	return *entry;
+}
+
 //------------------------------------------------------------------------------
 // ae::SpriteRenderer member functions
 //------------------------------------------------------------------------------
 SpriteRenderer::SpriteRenderer( const ae::Tag& tag ) :
 	m_params( tag ),
-	m_spriteGroups( tag ),
+	m_vertices( tag ),
+	m_sortedVertices( tag ),
+	m_batcher( tag ),
 	m_vertexArray( tag )
 {}
 
 void SpriteRenderer::Initialize( uint32_t maxGroups, uint32_t maxCount )
 {
+	m_maxCount = maxCount;
 	m_params.Append( {}, maxGroups );
-	m_spriteGroups.Reserve( maxCount );
+	m_vertices.Reserve( 4 * maxCount );
+	m_sortedVertices.Reserve( 4 * maxCount );
+	m_batcher.Reserve( maxCount );
 
 	m_vertexArray.Initialize(
-		sizeof(_SpriteVertex), sizeof(_SpriteIndex),
+		sizeof(Vertex), sizeof(_SpriteIndex),
 		4 * maxCount, 6 * maxCount,
 		ae::Vertex::Primitive::Triangle,
 		ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Static
 	);
-	m_vertexArray.AddAttribute( "a_position", 4, ae::Vertex::Type::Float, offsetof(_SpriteVertex, pos) );
-	m_vertexArray.AddAttribute( "a_color", 4, ae::Vertex::Type::Float, offsetof(_SpriteVertex, color) );
-	m_vertexArray.AddAttribute( "a_uv", 2, ae::Vertex::Type::Float, offsetof(_SpriteVertex, uv) );
+	m_vertexArray.AddAttribute( "a_position", 4, ae::Vertex::Type::Float, offsetof(Vertex, pos) );
+	m_vertexArray.AddAttribute( "a_color", 4, ae::Vertex::Type::Float, offsetof(Vertex, color) );
+	m_vertexArray.AddAttribute( "a_uv", 2, ae::Vertex::Type::Float, offsetof(Vertex, uv) );
 
 	const uint16_t indices[] = { 3, 0, 1, 3, 1, 2 };
 	ae::Scratch< _SpriteIndex > indexBuffer( 6 * maxCount );
@@ -133,8 +487,11 @@ void SpriteRenderer::Terminate()
 {
 	m_vertexArray.Terminate();
 	m_vertexArray.Terminate();
-	m_spriteGroups.Clear();
+	m_batcher.Clear();
+	m_sortedVertices.Clear();
+	m_vertices.Clear();
 	m_params.Clear();
+	m_maxCount = 0;
 }
 
 void SpriteRenderer::AddSprite( uint32_t group, ae::Vec2 pos, ae::Vec2 size, ae::Rect uvs, ae::Color color )
@@ -153,22 +510,22 @@ void SpriteRenderer::AddSprite( uint32_t group, ae::Rect quad, ae::Rect uvs, ae:
 
 void SpriteRenderer::AddSprite( uint32_t group, const ae::Matrix4& transform, ae::Rect uvs, ae::Color color )
 {
-	if ( m_vertexArray.GetVertexCount() >= m_vertexArray.GetMaxVertexCount() )
+	if ( m_batcher.GetSpriteCount() >= m_maxCount )
 	{
 		return;
 	}
 	
 	ae::Vec2 min = uvs.GetMin();
 	ae::Vec2 max = uvs.GetMax();
-	_SpriteVertex verts[] =
+	Vertex verts[] =
 	{
 		{ transform * ae::Vec4( -0.5f, -0.5f, 0.0f, 1.0f ), color.GetLinearRGBA(), ae::Vec2( min.x, min.y ) },
 		{ transform * ae::Vec4( 0.5f, -0.5f, 0.0f, 1.0f ), color.GetLinearRGBA(), ae::Vec2( max.x, min.y ) },
 		{ transform * ae::Vec4( 0.5f, 0.5f, 0.0f, 1.0f ), color.GetLinearRGBA(), ae::Vec2( max.x, max.y ) },
 		{ transform * ae::Vec4( -0.5f, 0.5f, 0.0f, 1.0f ), color.GetLinearRGBA(), ae::Vec2( min.x, max.y ) }
 	};
-	m_vertexArray.AppendVertices( verts, countof(verts) );
-	m_spriteGroups.Append( group );
+	m_vertices.AppendArray( verts, countof(verts) );
+	m_batcher.Add( group, transform.GetTranslation().z );
 }
 
 void SpriteRenderer::AddText( uint32_t group, const char* text, const SpriteFont* font, ae::Rect region, float fontSize, float lineHeight, ae::Color color )
@@ -224,17 +581,30 @@ void SpriteRenderer::SetParams( uint32_t group, const ae::Shader* shader, const
 
 void SpriteRenderer::Render()
 {
-	m_vertexArray.Upload();
-
-	const uint32_t spriteCount = m_spriteGroups.Length();
-	for ( uint32_t i = 0; i < spriteCount; i++ )
+	m_drawCount = 0;
+	m_batcher.Sort();
+	const uint32_t spriteCount = m_batcher.GetSpriteCount();
+	if ( spriteCount )
 	{
-		const uint32_t group = m_spriteGroups[ i ];
-		const GroupParams& params = m_params[ group ];
-		// @TODO: Combine draw calls when consecutive sprites are the same group
-		if ( params.shader )
+		m_sortedVertices.Clear();
+		for ( uint32_t i = 0; i < spriteCount; i++ )
+		{
+			const uint32_t index = m_batcher.GetSpriteIndex( i );
+			m_sortedVertices.AppendArray( &m_vertices[ index * 4 ], 4 );
+		}
+		m_vertexArray.SetVertices( m_sortedVertices.Data(), m_sortedVertices.Length() );
+		m_vertexArray.Upload();
+
+		const uint32_t batchCount = m_batcher.GetBatchCount();
+		for ( uint32_t i = 0; i < batchCount; i++ )
 		{
-			m_vertexArray.Draw( params.shader, params.uniforms, i * 2, 2 );
+			const SpriteBatcher::Batch& batch = m_batcher.GetBatch( i );
+			const GroupParams& params = m_params[ batch.group ];
+			if ( params.shader )
+			{
+				m_vertexArray.Draw( params.shader, params.uniforms, batch.start * 2, batch.count * 2 );
+				m_drawCount++;
+			}
 		}
 	}
 
@@ -244,7 +614,8 @@ void SpriteRenderer::Render()
 void SpriteRenderer::Clear()
 {
 	m_vertexArray.ClearVertices();
-	m_spriteGroups.Clear();
+	m_vertices.Clear();
+	m_batcher.Clear();
 	for ( auto& p : m_params )
 	{
 		p = {};
@@ -41,27 +41,34 @@ aeCompactingAllocator::aeCompactingAllocator( uint32_t bytes )
 
 void aeCompactingAllocator::Expand( uint32_t totalBytes )
 {
+  std::lock_guard< std::mutex > lock( m_lock );
   if ( totalBytes <= m_size )
   {
     return;
   }
 
-  if ( !m_data )
+  uint8_t* data = (uint8_t*)ae::Allocate( AE_ALLOC_TAG_FIXME, totalBytes, kAlignment );
+  if ( m_data )
   {
-    m_size = totalBytes;
-    m_data = (uint8_t*)ae::Allocate( AE_ALLOC_TAG_FIXME, totalBytes, kAlignment );
-    return;
+    memcpy( data, m_data, m_used );
+    ae::Free( m_data );
   }
+  m_data = data;
+  m_size = totalBytes;
 
-  m_Compact();
-
-  // @TODO: Actually do move
-  AE_FAIL_MSG( "Not implemented" );
+  // Block offsets don't change, so only external pointers need updating
+  for ( Header* current = m_used ? m_At( 0 ) : nullptr; current; current = m_Next( current ) )
+  {
+    if ( !m_IsFree( current ) )
+    {
+      *(void**)current->external = current + 1;
+    }
+  }
 }
 
 aeCompactingAllocator::~aeCompactingAllocator()
 {
-  AE_ASSERT_MSG( !m_tail, "Cannot be safely destroyed with existing allocations" );
+  AE_ASSERT_MSG( !m_used, "Cannot be safely destroyed with existing allocations" );
 
   if ( m_data )
   {
@@ -69,108 +76,257 @@ aeCompactingAllocator::~aeCompactingAllocator()
   }
 }
 
-void aeCompactingAllocator::m_Compact()
+bool aeCompactingAllocator::Compact( uint32_t maxBytes )
+{
+  std::lock_guard< std::mutex > lock( m_lock );
+  return m_Compact( maxBytes );
+}
+
+void aeCompactingAllocator::m_Allocate( void** p, uint32_t size, uint32_t typeId )
 {
+  std::lock_guard< std::mutex > lock( m_lock );
   AE_ASSERT( m_data );
+  AE_ASSERT( p );
+  size = ae::Max( ( size + kAlignment - 1 ) & ~( kAlignment - 1 ), (intptr_t)kAlignment );
 
-  if ( m_isCompact )
+  // Reuse the smallest free block that fits
+  Header* header = nullptr;
+  for ( uint32_t offset : m_freeList )
   {
-    return;
+    Header* current = m_At( offset );
+    if ( current->size >= size && ( !header || current->size < header->size ) )
+    {
+      header = current;
+      if ( header->size == size )
+      {
+        break;
+      }
+    }
   }
 
-  //AE_LOG( "compact" );
-
-  // Get first
-  Header* first = m_tail;
-  AE_ASSERT( first->check == 0xABABABAB );
-  while ( first->prev )
+  if ( header )
   {
-    AE_ASSERT( first->prev->check == 0xABABABAB );
-    first = first->prev;
+    m_RemoveFree( header );
+    const uint32_t remaining = header->size - size;
+    if ( remaining >= sizeof( Header ) )
+    {
+      // Split off the end of the block as a new free block
+      header->size = size;
+      Header* split = m_Next( header );
+      split->size = remaining - sizeof( Header );
+      split->prevSize = size;
+      m_AddFree( split );
+      m_Next( split )->prevSize = split->size; // Free blocks are never last
+    }
   }
+  else
+  {
+    // Append to the end, moving all allocations to the front if needed
+    if ( m_used + sizeof( Header ) + size > m_size )
+    {
+      m_Compact( ~0u );
+    }
+    if ( m_used + sizeof( Header ) + size > m_size )
+    {
+      AE_FAIL_MSG( "aeCompactingAllocator out of memory. Size: # Used: # Requested: #", m_size, m_used, size ); // @TODO: Should return null
+      *p = nullptr;
+      return;
+    }
+    header = m_At( m_used );
+    header->size = size;
+    header->prevSize = m_lastSize;
+    m_used += sizeof( Header ) + size;
+    m_lastSize = size;
+  }
+
+  header->external = (uintptr_t)p;
+#if _AE_DEBUG_
+  header->typeId = typeId;
+#endif
+  *p = header + 1;
+
+  m_Verify();
+}
+
+void aeCompactingAllocator::m_Free( void** p, uint32_t typeId )
+{
+  std::lock_guard< std::mutex > lock( m_lock );
+  AE_ASSERT( m_data );
+  AE_ASSERT( m_data < (uint8_t*)*p );
+  AE_ASSERT( (uint8_t*)*p < m_data + m_size );
 
-  m_tail = nullptr;
+  Header* header = m_GetHeader( *p );
+#if _AE_DEBUG_
+  AE_ASSERT_MSG( header->typeId == typeId, "Type mismatch between allocation and free" );
+#endif
+  *p = nullptr;
+  header->external = 1; // Temporarily free so neighbors don't merge into it
 
-  uint8_t* open = m_data;
-  for ( Header* current = first; current; current = current->next )
+  // Merge with adjacent free blocks
+  if ( Header* next = m_Next( header ) )
   {
-    // Only compact current allocations. Freed headers will be squashed in Compact()
-    if ( !current->external )
+    if ( m_IsFree( next ) )
     {
-      Header* prev = current->prev;
-      Header* next = current->next;
-      if ( prev )
-      {
-        prev->next = next;
-      }
-      if ( next )
-      {
-        next->prev = prev;
-      }
-      continue;
+      m_RemoveFree( next );
+      header->size += sizeof( Header ) + next->size;
     }
-
-    // Check if already compact
-    if ( open != (uint8_t*)current )
+  }
+  if ( Header* prev = m_Prev( header ) )
+  {
+    if ( m_IsFree( prev ) )
     {
-      // Move entry to front of open
-      AE_ASSERT( open >= m_data );
-      AE_ASSERT( open < m_data + m_size );
-      AE_ASSERT( open + current->size < m_data + m_size );
-      memmove( open, current, sizeof( Header ) + current->size );
-      current = (Header*)open;
-      
-      // Update linked list
-      current->prev = m_tail;
-      if ( current->prev )
-      {
-        current->prev->next = current;
-      }
-      current->next = nullptr;
-
-      // Update external pointer value
-      *( current->external ) = open + sizeof( Header );
+      m_RemoveFree( prev );
+      prev->size += sizeof( Header ) + header->size;
+      header = prev;
     }
+  }
 
-    // Increment open offset based on current link in list
-    open += sizeof( Header ) + current->size;
-    AE_ASSERT( open == (uint8_t*)current + sizeof( Header ) + current->size );
-
-    // Tail is always latest allocation
-    m_tail = current;
+  const uint32_t offset = m_Offset( header );
+  if ( Header* next = m_Next( header ) )
+  {
+    next->prevSize = header->size;
+    m_AddFree( header );
+    m_compactOffset = ae::Min( m_compactOffset, offset );
+  }
+  else
+  {
+    // Last block, so just shrink the used range
+    m_used = offset;
+    m_lastSize = offset ? header->prevSize : 0;
+    m_compactOffset = ae::Min( m_compactOffset, m_used );
   }
-  
-  m_isCompact = true;
 
-  if ( !m_tail )
+  m_Verify();
+}
+
+bool aeCompactingAllocator::m_Compact( uint32_t maxBytes )
+{
+  uint32_t moved = 0;
+  while ( m_freeList.Length() )
   {
-    return;
+    // Find the first free block
+    Header* hole = m_At( m_compactOffset );
+    while ( !m_IsFree( hole ) )
+    {
+      hole = m_Next( hole );
+      AE_ASSERT( hole );
+    }
+    m_compactOffset = m_Offset( hole );
+
+    // Free blocks are never adjacent or last, so the next block is allocated
+    Header* block = m_Next( hole );
+    AE_ASSERT( block && !m_IsFree( block ) );
+    const uint32_t blockBytes = sizeof( Header ) + block->size;
+    if ( moved >= maxBytes || ( moved && moved + blockBytes > maxBytes ) )
+    {
+      return false;
+    }
+
+    // Swap the hole and the block
+    const uint32_t holeSize = hole->size;
+    const uint32_t holePrevSize = hole->prevSize;
+    m_RemoveFree( hole );
+    memmove( hole, block, blockBytes );
+    block = hole;
+    block->prevSize = holePrevSize;
+    *(void**)block->external = block + 1;
+    moved += blockBytes;
+    m_compactOffset += blockBytes;
+
+    hole = m_Next( block );
+    hole->external = 1;
+    hole->size = holeSize;
+    hole->prevSize = block->size;
+    Header* next = m_Next( hole );
+    if ( next && m_IsFree( next ) )
+    {
+      m_RemoveFree( next );
+      hole->size += sizeof( Header ) + next->size;
+      next = m_Next( hole );
+      AE_ASSERT( next );
+    }
+    if ( next )
+    {
+      next->prevSize = hole->size;
+      m_AddFree( hole );
+    }
+    else
+    {
+      m_used = m_Offset( hole );
+      m_lastSize = block->size;
+    }
   }
 
+  m_compactOffset = m_used;
   m_Verify();
+  return true;
 }
 
 aeCompactingAllocator::Header* aeCompactingAllocator::m_GetHeader( void* p )
 {
-  Header* header = (Header*)( (uint8_t*)p - sizeof( Header ) );
-  AE_ASSERT( header->check == 0xABABABAB );
-  AE_ASSERT( *header->external == p );
+  Header* header = (Header*)p - 1;
+  AE_ASSERT( !m_IsFree( header ) );
+  AE_ASSERT( *(void**)header->external == p );
   return header;
 }
 
-void aeCompactingAllocator::m_Verify()
+aeCompactingAllocator::Header* aeCompactingAllocator::m_Next( Header* header )
+{
+  uint8_t* next = (uint8_t*)( header + 1 ) + header->size;
+  return ( next < m_data + m_used ) ? (Header*)next : nullptr;
+}
+
+aeCompactingAllocator::Header* aeCompactingAllocator::m_Prev( Header* header )
+{
+  return ( (uint8_t*)header > m_data ) ? (Header*)( (uint8_t*)header - header->prevSize - sizeof( Header ) ) : nullptr;
+}
+
+void aeCompactingAllocator::m_AddFree( Header* header )
 {
-  AE_ASSERT( m_tail->check == 0xABABABAB );
+  header->external = ( (uintptr_t)m_freeList.Length() << 1 ) | 1;
+  m_freeList.Append( m_Offset( header ) );
+}
 
-  Header* first = m_tail;
-  while ( first->prev )
+void aeCompactingAllocator::m_RemoveFree( Header* header )
+{
+  AE_ASSERT( m_IsFree( header ) );
+  const uint32_t index = (uint32_t)( header->external >> 1 );
+  const uint32_t last = m_freeList.Length() - 1;
+  AE_ASSERT( m_freeList[ index ] == m_Offset( header ) );
+  if ( index != last )
   {
-    AE_ASSERT( first->prev->check == 0xABABABAB );
-    first = first->prev;
+    m_freeList[ index ] = m_freeList[ last ];
+    m_At( m_freeList[ index ] )->external = ( (uintptr_t)index << 1 ) | 1;
   }
+  m_freeList.Remove( last );
+  header->external = 0;
+}
 
-  for ( Header* current = first; current; current = current->next )
+void aeCompactingAllocator::m_Verify()
+{
+#if _AE_DEBUG_
+  uint32_t freeCount = 0;
+  uint32_t prevSize = 0;
+  bool prevFree = false;
+  for ( Header* current = m_used ? m_At( 0 ) : nullptr; current; current = m_Next( current ) )
   {
-    AE_ASSERT( current->check == 0xABABABAB );
+    AE_ASSERT( current->prevSize == prevSize );
+    AE_ASSERT( current->size % kAlignment == 0 );
+    if ( m_IsFree( current ) )
+    {
+      AE_ASSERT_MSG( !prevFree, "Adjacent free blocks" );
+      AE_ASSERT( m_freeList[ (uint32_t)( current->external >> 1 ) ] == m_Offset( current ) );
+      freeCount++;
+    }
+    else
+    {
+      AE_ASSERT( *(void**)current->external == current + 1 );
+    }
+    AE_ASSERT( m_Next( current ) || !m_IsFree( current ) );
+    prevSize = current->size;
+    prevFree = m_IsFree( current );
   }
+  AE_ASSERT( freeCount == m_freeList.Length() );
+  AE_ASSERT( prevSize == m_lastSize );
+#endif
 }
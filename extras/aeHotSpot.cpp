@@ -24,20 +24,49 @@
 // Headers
 //------------------------------------------------------------------------------
 #include "ae/aeHotSpot.h"
+#include "ctpl_stl.h"
 
 //------------------------------------------------------------------------------
 // Constants
 //------------------------------------------------------------------------------
 const float kGroundDistanceEpsilon = 0.01f;
+const uint32_t kMinObjectsPerThread = 64;
 
 //------------------------------------------------------------------------------
 // HotSpotWorld member functions
 //------------------------------------------------------------------------------
-void HotSpotWorld::Initialize( float timeStep )
+HotSpotWorld::~HotSpotWorld()
+{
+  if ( m_threadPool )
+  {
+    m_threadPool->stop( true );
+    ae::Delete( m_threadPool );
+    m_threadPool = nullptr;
+  }
+
+  for ( uint32_t i = 0; i < m_objects.Length(); i++ )
+  {
+    ae::Delete( m_objects[ i ] );
+  }
+}
+
+void HotSpotWorld::Initialize( float timeStep, uint32_t threadCount )
 {
   AE_ASSERT( timeStep > 0.0f );
   m_timeStep = timeStep;
   m_timeAccumulator = 0.0f;
+
+  if ( m_threadPool )
+  {
+    m_threadPool->stop( true );
+    ae::Delete( m_threadPool );
+    m_threadPool = nullptr;
+  }
+  if ( threadCount > 1 )
+  {
+    // The calling thread also steps objects
+    m_threadPool = ae::New< ctpl::thread_pool >( AE_ALLOC_TAG_HOTSPOT, threadCount - 1 );
+  }
 }
 
 void HotSpotWorld::Update( float dt )
@@ -46,21 +75,52 @@ void HotSpotWorld::Update( float dt )
 
   while ( m_timeAccumulator >= m_timeStep )
   {
-    for ( uint32_t i = 0; i < m_objects.Length(); i++ )
+    // Read each step because collision callbacks can create objects
+    const uint32_t objectCount = m_objects.Length();
+    const uint32_t threadCount = m_threadPool ? m_threadPool->size() + 1 : 1;
+    const uint32_t jobCount = ae::Clip( objectCount / kMinObjectsPerThread, 1u, threadCount );
+    if ( jobCount > 1 )
+    {
+      // Objects only read tiles and write their own state while stepping, so
+      // ranges of objects can be stepped independently
+      std::future< void > jobs[ 64 ];
+      const uint32_t rangeCount = ae::Min( jobCount, countof( jobs ) + 1 );
+      const uint32_t rangeSize = ( objectCount + rangeCount - 1 ) / rangeCount;
+      for ( uint32_t i = 1; i < rangeCount; i++ )
+      {
+        const uint32_t start = i * rangeSize;
+        const uint32_t end = ae::Min( start + rangeSize, objectCount );
+        float timeStep = m_timeStep;
+        jobs[ i - 1 ] = m_threadPool->push( [ this, start, end, timeStep ]( int )
+        {
+          m_StepObjects( start, end, timeStep );
+        } );
+      }
+      m_StepObjects( 0, ae::Min( rangeSize, objectCount ), m_timeStep );
+      for ( uint32_t i = 1; i < rangeCount; i++ )
+      {
+        jobs[ i - 1 ].wait();
+      }
+    }
+    else
+    {
+      m_StepObjects( 0, objectCount, m_timeStep );
+    }
+
+    if ( m_objectCollision )
     {
-      HotSpotObject* object = m_objects[ i ];
-      object->Update( this, m_timeStep );
+      m_CollideObjects();
     }
+    m_SendCollisions();
 
     m_timeAccumulator -= m_timeStep;
   }
 
+  // @NOTE: Reset user forces for next frame after all simulation steps
   for ( uint32_t i = 0; i < m_objects.Length(); i++ )
   {
-    // @NOTE: Reset user forces for next frame after all simulation steps
-    HotSpotObject* object = m_objects[ i ];
-    object->m_forces = ae::Vec2( 0.0f );
-    object->m_gravity = ae::Vec2( 0.0f );
+    m_forces[ i ] = ae::Vec2( 0.0f );
+    m_gravities[ i ] = ae::Vec2( 0.0f );
   }
 }
 
@@ -122,7 +182,20 @@ uint32_t HotSpotWorld::GetTile( ae::Int2 pos ) const
 HotSpotObject* HotSpotWorld::CreateObject()
 {
   HotSpotObject* obj = ae::New< HotSpotObject >( AE_ALLOC_TAG_HOTSPOT );
+  obj->m_world = this;
+  obj->m_index = m_objects.Length();
   m_objects.Append( obj );
+  m_positions.Append( ae::Vec2( 0.0f ) );
+  m_velocities.Append( ae::Vec2( 0.0f ) );
+  m_forces.Append( ae::Vec2( 0.0f ) );
+  m_gravities.Append( ae::Vec2( 0.0f ) );
+  m_masses.Append( 1.0f );
+  m_groundRestitutions.Append( 0.0f );
+  m_wallRestitutions.Append( 0.3f );
+  m_volumes.Append( 1.0f );
+  m_airTimers.Append( 0.0f );
+  m_tileCollisionCounts.Append( 0 );
+  m_tileCollisions.Append( HotSpotCollisionInfo(), 2 );
   return obj;
 }
 
@@ -136,81 +209,41 @@ uint32_t HotSpotWorld::GetObjectCount() const
   return m_objects.Length();
 }
 
-ae::Int2 HotSpotWorld::_GetTilePos( ae::Vec2 pos )
-{
-  return ae::Int2( ae::Round( pos.x ), ae::Round( pos.y ) );
-}
-
-//------------------------------------------------------------------------------
-// HotSpotObject member functions
-//------------------------------------------------------------------------------
-void HotSpotObject::SetMass( float kilograms )
-{
-  m_mass = kilograms;
-}
-
-void HotSpotObject::SetRestitution( float groundPercent, float wallPercent )
+void HotSpotWorld::SetObjectCollisionEnabled( bool enabled )
 {
-  m_groundRestitution = groundPercent;
-  m_wallRestitution = wallPercent;
+  m_objectCollision = enabled;
 }
 
-void HotSpotObject::SetVolume( float meters )
+bool HotSpotWorld::GetObjectCollisionEnabled() const
 {
-  m_volume = meters;
+  return m_objectCollision;
 }
 
-float HotSpotObject::GetMass() const
-{
-  return m_mass;
-}
-
-void HotSpotObject::Warp( ae::Vec2 meters )
-{
-  m_position = meters;
-}
-
-void HotSpotObject::SetVelocity( ae::Vec2 metersPerSecond )
-{
-  m_velocity = metersPerSecond;
-}
-
-void HotSpotObject::AddForce( ae::Vec2 newtons )
-{
-  m_forces += newtons;
-}
-
-void HotSpotObject::AddImpulse( ae::Vec2 newtons )
-{
-  m_velocity += newtons / m_mass; // @TODO: Do these units match up?
-}
-
-void HotSpotObject::AddGravity( ae::Vec2 acceleration )
+ae::Int2 HotSpotWorld::_GetTilePos( ae::Vec2 pos )
 {
-  m_gravity += acceleration;
-  m_forces += acceleration * m_mass;
+  return ae::Int2( ae::Round( pos.x ), ae::Round( pos.y ) );
 }
 
-ae::Vec2 HotSpotObject::GetPosition() const
+void HotSpotWorld::m_StepObjects( uint32_t start, uint32_t end, float dt )
 {
-  return m_position;
+  for ( uint32_t i = start; i < end; i++ )
+  {
+    m_StepObject( i, dt );
+  }
 }
 
-ae::Vec2 HotSpotObject::GetVelocity() const
+void HotSpotWorld::m_StepObject( uint32_t index, float dt )
 {
-  return m_velocity;
-}
+  ae::Vec2& position = m_positions[ index ];
+  ae::Vec2& velocity = m_velocities[ index ];
+  float& airTimer = m_airTimers[ index ];
+  const float mass = m_masses[ index ];
+  const ae::Vec2 gravity = m_gravities[ index ];
+  m_tileCollisionCounts[ index ] = 0;
 
-bool HotSpotObject::IsOnGround() const
-{
-  return m_airTimer < 0.1f;
-}
-
-void HotSpotObject::Update( HotSpotWorld* world, float dt )
-{
   // @NOTE: Apply derived forces (drag etc) to a temporary value to
   //        allow multiple simulation steps per frame.
-  ae::Vec2 forces = m_forces;
+  ae::Vec2 forces = m_forces[ index ];
 
   // @HACK: Shouldn't assume side-on platformer with gravity pointing -y
   {
@@ -218,29 +251,29 @@ void HotSpotObject::Update( HotSpotWorld* world, float dt )
     uint32_t tileType;
     uint32_t tileProperties;
 
-    tilePos = HotSpotWorld::_GetTilePos( ae::Vec2( m_position.x, m_position.y - 0.5f - kGroundDistanceEpsilon ) );
-    tileType = world->GetTile( tilePos );
-    tileProperties = world->GetTileProperties( tileType );
-    if ( tileProperties & world->GetCollisionMask() )
+    tilePos = _GetTilePos( ae::Vec2( position.x, position.y - 0.5f - kGroundDistanceEpsilon ) );
+    tileType = GetTile( tilePos );
+    tileProperties = GetTileProperties( tileType );
+    if ( tileProperties & m_collisionMask )
     {
-      m_airTimer = 0.0f;
+      airTimer = 0.0f;
     }
     else
     {
-      m_airTimer += dt;
+      airTimer += dt;
     }
 
     const float kFrictionCoefficient = 0.2f;
-    if ( IsOnGround() && forces.y < 0.0f && kFrictionCoefficient > 0.0f )
+    if ( airTimer < 0.1f && forces.y < 0.0f && kFrictionCoefficient > 0.0f ) // On ground
     {
       float friction = -forces.y * kFrictionCoefficient;
       AE_ASSERT( friction >= 0.0f );
-      friction *= ae::Delerp01( 0.0f, 0.1f, ae::Abs( m_velocity.x ) );
-      if ( m_velocity.x > 0.0f )
+      friction *= ae::Delerp01( 0.0f, 0.1f, ae::Abs( velocity.x ) );
+      if ( velocity.x > 0.0f )
       {
         forces.x -= friction;
       }
-      else if ( m_velocity.x < 0.0f )
+      else if ( velocity.x < 0.0f )
       {
         forces.x += friction;
       }
@@ -248,30 +281,30 @@ void HotSpotObject::Update( HotSpotWorld* world, float dt )
   }
 
   // Drag: Fd = Surface Coeffiecient * Area * Density * V^2 * 0.5
-  ae::Int2 tilePos = HotSpotWorld::_GetTilePos( m_position );
-  uint32_t tileType = world->GetTile( tilePos );
-  float density = world->GetTileFluidDensity( tileType );
+  ae::Int2 tilePos = _GetTilePos( position );
+  uint32_t tileType = GetTile( tilePos );
+  float density = GetTileFluidDensity( tileType );
   if ( density > 0.0f )
   {
     // Assume surface coefficient and area of 1.0
-    float speed2 = m_velocity.LengthSquared();
-    ae::Vec2 velDir = m_velocity.SafeNormalizeCopy();
+    float speed2 = velocity.LengthSquared();
+    ae::Vec2 velDir = velocity.SafeNormalizeCopy();
     forces -= velDir * ( speed2 * density * 0.5f );
   }
 
   {
     ae::Map< ae::Int2, int32_t, 5 > intersections;
-    intersections.Set( HotSpotWorld::_GetTilePos( m_position ), 1 );
-    intersections.Set( HotSpotWorld::_GetTilePos( m_position + ae::Vec2( -0.5f ) ), 1 );
-    intersections.Set( HotSpotWorld::_GetTilePos( m_position + ae::Vec2( 0.5f ) ), 1 );
-    intersections.Set( HotSpotWorld::_GetTilePos( m_position + ae::Vec2( -0.5f, 0.5f ) ), 1 );
-    intersections.Set( HotSpotWorld::_GetTilePos( m_position + ae::Vec2( 0.5f, -0.5f ) ), 1 );
-    ae::Rect objRect = ae::Rect::FromCenterAndSize( m_position, ae::Vec2( 1.0f ) );
+    intersections.Set( _GetTilePos( position ), 1 );
+    intersections.Set( _GetTilePos( position + ae::Vec2( -0.5f ) ), 1 );
+    intersections.Set( _GetTilePos( position + ae::Vec2( 0.5f ) ), 1 );
+    intersections.Set( _GetTilePos( position + ae::Vec2( -0.5f, 0.5f ) ), 1 );
+    intersections.Set( _GetTilePos( position + ae::Vec2( 0.5f, -0.5f ) ), 1 );
+    ae::Rect objRect = ae::Rect::FromCenterAndSize( position, ae::Vec2( 1.0f ) );
     for ( uint32_t i = 0; i < intersections.Length(); i++ )
     {
       ae::Int2 tilePos = intersections.GetKey( i );
-      uint32_t tileType = world->GetTile( tilePos );
-      float density = world->GetTileFluidDensity( tileType );
+      uint32_t tileType = GetTile( tilePos );
+      float density = GetTileFluidDensity( tileType );
       if ( density > 0.0f )
       {
         ae::Rect intersection;
@@ -280,46 +313,48 @@ void HotSpotObject::Update( HotSpotWorld* world, float dt )
         {
           // Buoyant force = (density of liquid(kg/m3))*(gravitational acceleration(m/s2))*(volume of liquid(m3))
           ae::Vec2 intersectionSize = intersection.GetSize();
-          float displaced = intersectionSize.x * intersectionSize.y * m_volume;
-          forces -= m_gravity * ( density * displaced );
+          float displaced = intersectionSize.x * intersectionSize.y * m_volumes[ index ];
+          forces -= gravity * ( density * displaced );
         }
       }
     }
   }
 
   // F = ma
-  ae::Vec2 acceleration = forces / m_mass;
-  m_velocity += acceleration * dt;
-  m_position += m_velocity * dt;
+  ae::Vec2 acceleration = forces / mass;
+  velocity += acceleration * dt;
+  position += velocity * dt;
 
   // @HACK: Shouldn't assume side-on platformer with gravity pointing -y
-  if ( m_airTimer == 0.0f && m_velocity.y > 0.0f )
+  if ( airTimer == 0.0f && velocity.y > 0.0f )
   {
-    m_airTimer += dt;
+    airTimer += dt;
   }
 
-  if ( !m_CheckCollision( world, ae::Int2( 0, -1 ) ) )
+  if ( !m_CheckCollision( index, ae::Int2( 0, -1 ) ) )
   {
-    m_CheckCollision( world, ae::Int2( 0, 1 ) );
+    m_CheckCollision( index, ae::Int2( 0, 1 ) );
   }
 
-  if ( !m_CheckCollision( world, ae::Int2( -1, 0 ) ) )
+  if ( !m_CheckCollision( index, ae::Int2( -1, 0 ) ) )
   {
-    m_CheckCollision( world, ae::Int2( 1, 0 ) );
+    m_CheckCollision( index, ae::Int2( 1, 0 ) );
   }
 }
 
-bool HotSpotObject::m_CheckCollision( const HotSpotWorld* world, ae::Int2 _dir )
+bool HotSpotWorld::m_CheckCollision( uint32_t index, ae::Int2 _dir )
 {
   AE_ASSERT( _dir.x + _dir.y == -1 || _dir.x + _dir.y == 1 );
+  ae::Vec2& position = m_positions[ index ];
+  ae::Vec2& velocity = m_velocities[ index ];
 
   // @HACK: Shouldn't assume side-on platformer with gravity pointing -y
   float hotSpotOffset = _dir.y ? 0.4f : 0.3f;
 
   const ae::Vec2 dir( _dir );
   ae::Vec2 collisionPos;
-  ae::Vec2 b0 = m_position + ( ae::Vec2( dir ) * 0.5f ) + ( ae::Vec2( -dir.y, dir.x ) * hotSpotOffset );
-  ae::Vec2 b1 = m_position + ( ae::Vec2( dir ) * 0.5f ) + ( ae::Vec2( dir.y, -dir.x ) * hotSpotOffset );
+  ae::Vec2 b0 = position + ( ae::Vec2( dir ) * 0.5f ) + ( ae::Vec2( -dir.y, dir.x ) * hotSpotOffset );
+  ae::Vec2 b1 = position + ( ae::Vec2( dir ) * 0.5f ) + ( ae::Vec2( dir.y, -dir.x ) * hotSpotOffset );
 
   if ( dir.x )
   {
@@ -329,35 +364,37 @@ bool HotSpotObject::m_CheckCollision( const HotSpotWorld* world, ae::Int2 _dir )
     b1.y += 0.05f;
   }
 
-  if ( m_TestSide( world, b0, b1, &collisionPos ) )
+  if ( m_TestSide( b0, b1, &collisionPos ) )
   {
-    ae::Int2 tilePos = HotSpotWorld::_GetTilePos( collisionPos );
+    ae::Int2 tilePos = _GetTilePos( collisionPos );
 
     if ( dir.y > 0 )
     {
-      m_position.y = tilePos.y - dir.y;
+      position.y = tilePos.y - dir.y;
       // @HACK: Shouldn't assume side-on platformer with gravity pointing -y
-      m_velocity.y *= -m_groundRestitution;
+      velocity.y *= -m_groundRestitutions[ index ];
     }
     else if ( dir.y < 0 )
     {
-      m_position.y = tilePos.y - dir.y;
-      m_velocity.y *= -m_wallRestitution;
+      position.y = tilePos.y - dir.y;
+      velocity.y *= -m_wallRestitutions[ index ];
     }
     else
     {
-      m_position.x = tilePos.x - dir.x;
-      m_velocity.x *= -m_wallRestitution;
+      position.x = tilePos.x - dir.x;
+      velocity.x *= -m_wallRestitutions[ index ];
     }
 
-
-    CollisionInfo info;
+    uint32_t& count = m_tileCollisionCounts[ index ];
+    AE_ASSERT( count < 2 );
+    HotSpotCollisionInfo& info = m_tileCollisions[ index * 2 + count ];
+    count++;
     info.position = tilePos;
     info.normal = -_dir;
-    info.tile = world->GetTile( tilePos );
-    info.properties = world->GetTileProperties( info.tile );
-    AE_ASSERT( info.properties & world->GetCollisionMask() );
-    onCollision.Send( &info );
+    info.tile = GetTile( tilePos );
+    info.properties = GetTileProperties( info.tile );
+    info.object = nullptr;
+    AE_ASSERT( info.properties & m_collisionMask );
 
     return true;
   }
@@ -365,17 +402,17 @@ bool HotSpotObject::m_CheckCollision( const HotSpotWorld* world, ae::Int2 _dir )
   return false;
 }
 
-bool HotSpotObject::m_TestSide( const HotSpotWorld* world, ae::Vec2 p0, ae::Vec2 p1, ae::Vec2* pOut )
+bool HotSpotWorld::m_TestSide( ae::Vec2 p0, ae::Vec2 p1, ae::Vec2* pOut ) const
 {
-  ae::Int2 tilePos = HotSpotWorld::_GetTilePos( p0 );
-  uint32_t tileType = world->GetTile( tilePos );
-  uint32_t tileProperties = world->GetTileProperties( tileType );
-  bool c0 = ( tileProperties & world->GetCollisionMask() );
+  ae::Int2 tilePos = _GetTilePos( p0 );
+  uint32_t tileType = GetTile( tilePos );
+  uint32_t tileProperties = GetTileProperties( tileType );
+  bool c0 = ( tileProperties & m_collisionMask );
 
-  tilePos = HotSpotWorld::_GetTilePos( p1 );
-  tileType = world->GetTile( tilePos );
-  tileProperties = world->GetTileProperties( tileType );
-  bool c1 = ( tileProperties & world->GetCollisionMask() );
+  tilePos = _GetTilePos( p1 );
+  tileType = GetTile( tilePos );
+  tileProperties = GetTileProperties( tileType );
+  bool c1 = ( tileProperties & m_collisionMask );
 
   if ( c0 && c1 )
   {
@@ -397,3 +434,182 @@ bool HotSpotObject::m_TestSide( const HotSpotWorld* world, ae::Vec2 p0, ae::Vec2
     return false;
   }
 }
+
+void HotSpotWorld::m_CollideObjects()
+{
+  // Objects are one tile in size, so bucket them by tile and only test
+  // objects in neighboring tiles
+  const uint32_t objectCount = m_objects.Length();
+  m_cellFirst.Clear();
+  m_cellNext.Clear();
+  m_objectPairs.Clear();
+  for ( uint32_t i = 0; i < objectCount; i++ )
+  {
+    const ae::Int2 cell = _GetTilePos( m_positions[ i ] );
+    int32_t* first = m_cellFirst.TryGet( cell );
+    m_cellNext.Append( first ? *first : -1 );
+    m_cellFirst.Set( cell, i );
+  }
+
+  for ( uint32_t i = 0; i < objectCount; i++ )
+  {
+    const ae::Vec2 p = m_positions[ i ];
+    const ae::Int2 cell = _GetTilePos( p );
+    for ( int32_t y = -1; y <= 1; y++ )
+    for ( int32_t x = -1; x <= 1; x++ )
+    {
+      int32_t j = m_cellFirst.Get( cell + ae::Int2( x, y ), -1 );
+      for ( ; j >= 0; j = m_cellNext[ j ] )
+      {
+        const ae::Vec2 d = m_positions[ j ] - p;
+        if ( (uint32_t)j > i && ae::Abs( d.x ) < 1.0f && ae::Abs( d.y ) < 1.0f )
+        {
+          m_objectPairs.Append( ae::Pair< uint32_t, uint32_t >( i, j ) );
+        }
+      }
+    }
+  }
+
+  // Pairs are resolved in a fixed order on the calling thread so results are
+  // deterministic. Objects are separated along the axis of least penetration
+  // based on their masses, and their relative velocity along it is removed.
+  // Only resolved pairs are kept so m_SendCollisions() can report them.
+  uint32_t resolvedCount = 0;
+  for ( uint32_t pairIdx = 0; pairIdx < m_objectPairs.Length(); pairIdx++ )
+  {
+    const ae::Pair< uint32_t, uint32_t > pair = m_objectPairs[ pairIdx ];
+    const uint32_t i = pair.key;
+    const uint32_t j = pair.value;
+    const ae::Vec2 d = m_positions[ j ] - m_positions[ i ];
+    const float overlapX = 1.0f - ae::Abs( d.x );
+    const float overlapY = 1.0f - ae::Abs( d.y );
+    if ( overlapX <= 0.0f || overlapY <= 0.0f )
+    {
+      continue; // Separated by an earlier pair
+    }
+    m_objectPairs[ resolvedCount++ ] = pair;
+    const ae::Int2 normal = ( overlapX < overlapY ) ? ae::Int2( d.x < 0.0f ? -1 : 1, 0 ) : ae::Int2( 0, d.y < 0.0f ? -1 : 1 );
+    const ae::Vec2 n( normal );
+    const float overlap = ae::Min( overlapX, overlapY );
+    const float invMassI = 1.0f / m_masses[ i ];
+    const float invMassJ = 1.0f / m_masses[ j ];
+    const float invMassTotal = invMassI + invMassJ;
+    m_positions[ i ] -= n * ( overlap * invMassI / invMassTotal );
+    m_positions[ j ] += n * ( overlap * invMassJ / invMassTotal );
+
+    const float approach = ( m_velocities[ j ] - m_velocities[ i ] ).Dot( n );
+    if ( approach < 0.0f )
+    {
+      const float impulse = -approach / invMassTotal;
+      m_velocities[ i ] -= n * ( impulse * invMassI );
+      m_velocities[ j ] += n * ( impulse * invMassJ );
+    }
+  }
+  if ( resolvedCount < m_objectPairs.Length() )
+  {
+    m_objectPairs.Remove( resolvedCount, m_objectPairs.Length() - resolvedCount );
+  }
+}
+
+void HotSpotWorld::m_SendCollisions()
+{
+  // Callbacks can create objects, which grows the arrays below, so nothing is
+  // referenced across a call to Send(). New objects have no collisions yet.
+  for ( uint32_t i = 0; i < m_objects.Length(); i++ )
+  {
+    const uint32_t count = m_tileCollisionCounts[ i ];
+    for ( uint32_t j = 0; j < count; j++ )
+    {
+      HotSpotCollisionInfo info = m_tileCollisions[ i * 2 + j ];
+      m_objects[ i ]->onCollision.Send( &info );
+    }
+  }
+
+  for ( uint32_t i = 0; i < m_objectPairs.Length(); i++ )
+  {
+    const ae::Pair< uint32_t, uint32_t > pair = m_objectPairs[ i ];
+    HotSpotObject* objI = m_objects[ pair.key ];
+    HotSpotObject* objJ = m_objects[ pair.value ];
+    const ae::Vec2 d = m_positions[ pair.value ] - m_positions[ pair.key ];
+    const ae::Int2 normal = ( ae::Abs( d.x ) > ae::Abs( d.y ) ) ? ae::Int2( d.x < 0.0f ? -1 : 1, 0 ) : ae::Int2( 0, d.y < 0.0f ? -1 : 1 );
+    HotSpotCollisionInfo info;
+    info.tile = 0;
+    info.properties = 0;
+
+    info.position = _GetTilePos( m_positions[ pair.value ] );
+    info.normal = -normal;
+    info.object = objJ;
+    objI->onCollision.Send( &info );
+
+    info.position = _GetTilePos( m_positions[ pair.key ] );
+    info.normal = normal;
+    info.object = objI;
+    objJ->onCollision.Send( &info );
+  }
+  m_objectPairs.Clear();
+}
+
+//------------------------------------------------------------------------------
+// HotSpotObject member functions
+//------------------------------------------------------------------------------
+void HotSpotObject::SetMass( float kilograms )
+{
+  m_world->m_masses[ m_index ] = kilograms;
+}
+
+void HotSpotObject::SetRestitution( float groundPercent, float wallPercent )
+{
+  m_world->m_groundRestitutions[ m_index ] = groundPercent;
+  m_world->m_wallRestitutions[ m_index ] = wallPercent;
+}
+
+void HotSpotObject::SetVolume( float meters )
+{
+  m_world->m_volumes[ m_index ] = meters;
+}
+
+float HotSpotObject::GetMass() const
+{
+  return m_world->m_masses[ m_index ];
+}
+
+void HotSpotObject::Warp( ae::Vec2 meters )
+{
+  m_world->m_positions[ m_index ] = meters;
+}
+
+void HotSpotObject::SetVelocity( ae::Vec2 metersPerSecond )
+{
+  m_world->m_velocities[ m_index ] = metersPerSecond;
+}
+
+void HotSpotObject::AddForce( ae::Vec2 newtons )
+{
+  m_world->m_forces[ m_index ] += newtons;
+}
+
+void HotSpotObject::AddImpulse( ae::Vec2 newtons )
+{
+  m_world->m_velocities[ m_index ] += newtons / GetMass(); // @TODO: Do these units match up?
+}
+
+void HotSpotObject::AddGravity( ae::Vec2 acceleration )
+{
+  m_world->m_gravities[ m_index ] += acceleration;
+  m_world->m_forces[ m_index ] += acceleration * GetMass();
+}
+
+ae::Vec2 HotSpotObject::GetPosition() const
+{
+  return m_world->m_positions[ m_index ];
+}
+
+ae::Vec2 HotSpotObject::GetVelocity() const
+{
+  return m_world->m_velocities[ m_index ];
+}
+
+bool HotSpotObject::IsOnGround() const
+{
+  return m_world->m_airTimers[ m_index ] < 0.1f;
+}
@@ -1142,25 +1142,6 @@ ae::AABB TerrainChunk::GetAABB( ae::Int3 chunkPos )
   return ae::AABB( min, max );
 }
 
-void TerrainChunk::m_SetVertexData( const TerrainVertex* verts, const TerrainIndex* indices, VertexCount vertexCount, uint32_t indexCount )
-{
-  // (Re)Initialize ae::VertexArray here only when needed
-  if ( !m_data.GetMaxVertexCount() // Not initialized
-    || VertexCount( m_data.GetMaxVertexCount() ) < vertexCount // Too little storage for verts
-    || m_data.GetMaxIndexCount() < indexCount ) // Too little storage for t_chunkIndices
-  {
-    m_data.Initialize( sizeof( TerrainVertex ), sizeof( TerrainIndex ), (uint32_t)vertexCount, indexCount, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Dynamic );
-    m_data.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, offsetof( TerrainVertex, position ) );
-    m_data.AddAttribute( "a_normal", 3, ae::Vertex::Type::Float, offsetof( TerrainVertex, normal ) );
-    m_data.AddAttribute( "a_info", 4, ae::Vertex::Type::UInt8, offsetof( TerrainVertex, info ) );
-    m_data.AddAttribute( "a_materials", 4, ae::Vertex::Type::NormalizedUInt8, offsetof( TerrainVertex, materials ) );
-  }
-
-  // Set vertices
-  m_data.UploadVertices( 0, verts, (uint32_t)vertexCount );
-  m_data.UploadIndices( 0, indices, indexCount );
-}
-
 //------------------------------------------------------------------------------
 // TerrainMember functions
 //------------------------------------------------------------------------------
@@ -1229,11 +1210,129 @@ void Terrain::FreeChunk( TerrainChunk* chunk )
   }
   
   chunk->m_mesh.Clear();
+  m_FreeVertexData( chunk );
 
   // @NOTE: This has to be done last because CompactingAllocator keeps a pointer to m_vertices
   m_chunkPool.Delete( chunk );
 }
 
+void Terrain::m_SetVertexData( TerrainChunk* chunk, const TerrainVertex* verts, const TerrainIndex* indices, VertexCount vertexCount, uint32_t indexCount )
+{
+  m_FreeVertexData( chunk );
+
+  // Find a page with room for both the vertices and indices of the chunk
+  int32_t pageIndex = -1;
+  int32_t vertexStart = -1;
+  int32_t indexStart = -1;
+  for ( uint32_t i = 0; i < m_pages.Length() && pageIndex < 0; i++ )
+  {
+    Page* page = m_pages[ i ];
+    vertexStart = m_AllocRange( &page->freeVertices, (uint32_t)vertexCount );
+    if ( vertexStart < 0 )
+    {
+      continue;
+    }
+    indexStart = m_AllocRange( &page->freeIndices, indexCount );
+    if ( indexStart < 0 )
+    {
+      m_FreeRange( &page->freeVertices, vertexStart, (uint32_t)vertexCount );
+      continue;
+    }
+    pageIndex = i;
+  }
+  if ( pageIndex < 0 )
+  {
+    Page* page = ae::New< Page >( AE_ALLOC_TAG_TERRAIN );
+    page->data.Initialize( sizeof( TerrainVertex ), sizeof( uint32_t ), kPageVertexCount, kPageIndexCount, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Retained, ae::Vertex::Usage::Retained );
+    page->data.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, offsetof( TerrainVertex, position ) );
+    page->data.AddAttribute( "a_normal", 3, ae::Vertex::Type::Float, offsetof( TerrainVertex, normal ) );
+    page->data.AddAttribute( "a_info", 4, ae::Vertex::Type::UInt8, offsetof( TerrainVertex, info ) );
+    page->data.AddAttribute( "a_materials", 4, ae::Vertex::Type::NormalizedUInt8, offsetof( TerrainVertex, materials ) );
+    page->freeVertices.Append( { 0, kPageVertexCount } );
+    page->freeIndices.Append( { 0, kPageIndexCount } );
+    pageIndex = m_pages.Length();
+    m_pages.Append( page );
+    vertexStart = m_AllocRange( &page->freeVertices, (uint32_t)vertexCount );
+    indexStart = m_AllocRange( &page->freeIndices, indexCount );
+    AE_ASSERT( vertexStart >= 0 && indexStart >= 0 );
+  }
+
+  // Chunk indices start from zero, so offset them to the chunks vertices in the page
+  m_pageIndices.Clear();
+  m_pageIndices.Reserve( indexCount );
+  for ( uint32_t i = 0; i < indexCount; i++ )
+  {
+    m_pageIndices.Append( indices[ i ] + vertexStart );
+  }
+
+  Page* page = m_pages[ pageIndex ];
+  page->data.UploadVertices( vertexStart, verts, (uint32_t)vertexCount );
+  page->data.UploadIndices( indexStart, m_pageIndices.Data(), indexCount );
+  chunk->m_page = pageIndex;
+  chunk->m_vertexStart = vertexStart;
+  chunk->m_vertexCount = (uint32_t)vertexCount;
+  chunk->m_indexStart = indexStart;
+  chunk->m_indexCount = indexCount;
+}
+
+void Terrain::m_FreeVertexData( TerrainChunk* chunk )
+{
+  if ( chunk->m_page < 0 )
+  {
+    return;
+  }
+  Page* page = m_pages[ chunk->m_page ];
+  m_FreeRange( &page->freeVertices, chunk->m_vertexStart, chunk->m_vertexCount );
+  m_FreeRange( &page->freeIndices, chunk->m_indexStart, chunk->m_indexCount );
+  chunk->m_page = -1;
+  chunk->m_vertexStart = 0;
+  chunk->m_vertexCount = 0;
+  chunk->m_indexStart = 0;
+  chunk->m_indexCount = 0;
+}
+
+int32_t Terrain::m_AllocRange( ae::Array< PageRange >* ranges, uint32_t count )
+{
+  // First fit
+  for ( uint32_t i = 0; i < ranges->Length(); i++ )
+  {
+    PageRange* range = &(*ranges)[ i ];
+    if ( range->count >= count )
+    {
+      const uint32_t start = range->start;
+      range->start += count;
+      range->count -= count;
+      if ( !range->count )
+      {
+        ranges->Remove( i );
+      }
+      return start;
+    }
+  }
+  return -1;
+}
+
+void Terrain::m_FreeRange( ae::Array< PageRange >* ranges, uint32_t start, uint32_t count )
+{
+  // Free ranges are kept sorted so neighbors can be merged
+  uint32_t i = 0;
+  while ( i < ranges->Length() && (*ranges)[ i ].start < start )
+  {
+    i++;
+  }
+  ranges->Insert( i, { start, count } );
+  if ( i + 1 < ranges->Length() && start + count == (*ranges)[ i + 1 ].start )
+  {
+    (*ranges)[ i ].count += (*ranges)[ i + 1 ].count;
+    ranges->Remove( i + 1 );
+  }
+  if ( i > 0 && (*ranges)[ i - 1 ].start + (*ranges)[ i - 1 ].count == start )
+  {
+    (*ranges)[ i - 1 ].count += (*ranges)[ i ].count;
+    ranges->Remove( i );
+  }
+}
+
 void Terrain::m_SetVertexCount( uint32_t chunkIndex, VertexCount count )
 {
   AE_ASSERT( count == kChunkCountDirty
@@ -1467,11 +1566,17 @@ void Terrain::Terminate()
   }
   m_terrainJobs.Clear();
 
-  for ( TerrainChunk* chunk = m_chunkPool.GetFirst(); chunk; chunk = m_chunkPool.GetNext( chunk ) )
+  while ( TerrainChunk* chunk = m_chunkPool.GetFirst() )
   {
     FreeChunk( chunk );
   }
   AE_ASSERT( m_chunkPool.Length() == 0 );
+
+  for ( Page* page : m_pages )
+  {
+    ae::Delete( page );
+  }
+  m_pages.Clear();
 }
 
 void Terrain::Update( ae::Vec3 center, float radius )
@@ -1677,7 +1782,7 @@ void Terrain::Update( ae::Vec3 center, float radius )
     {
       if ( m_render )
       {
-        newChunk->m_SetVertexData( job->GetVertices(), job->GetIndices(), vertexCount, job->GetIndexCount() );
+        m_SetVertexData( newChunk, job->GetVertices(), job->GetIndices(), vertexCount, job->GetIndexCount() );
       }
 
       // Ready for lighting
@@ -1748,8 +1853,7 @@ void Terrain::Update( ae::Vec3 center, float radius )
       //AE_ASSERT( chunk->m_mesh.GetVertexCount() );
       if ( m_render )
       {
-        AE_ASSERT( chunk->m_data.GetMaxVertexCount() );
-        AE_ASSERT( chunk->m_data.GetVertexSize() );
+        AE_ASSERT( chunk->m_page >= 0 );
       }
     }
     else
@@ -1870,39 +1974,80 @@ void Terrain::Update( ae::Vec3 center, float radius )
 
 void Terrain::Render( const ae::Shader* shader, const ae::UniformList& shaderParams )
 {
+  m_Render( shader, shaderParams, nullptr, m_center );
+}
+
+void Terrain::Render( const ae::Shader* shader, const ae::UniformList& shaderParams, const ae::Frustum& frustum, ae::Vec3 viewPos )
+{
+  m_Render( shader, shaderParams, &frustum, viewPos );
+}
+
+void Terrain::m_Render( const ae::Shader* shader, const ae::UniformList& shaderParams, const ae::Frustum* frustum, ae::Vec3 viewPos )
+{
+  m_renderedChunkCount = 0;
   if ( !m_render )
   {
     return;
   }
 
-  //aeFrustum frustum;
-  uint32_t activeCount = 0;
-  for( uint32_t i = 0; i < t_chunkSorts.Length() && activeCount < kMaxActiveChunks; i++ )
+  m_chunkDraws.Clear();
+  for( uint32_t i = 0; i < t_chunkSorts.Length() && m_chunkDraws.Length() < kMaxActiveChunks; i++ )
   {
-    TerrainChunk* chunk = t_chunkSorts[ i ].c;
+    const TerrainChunk* chunk = t_chunkSorts[ i ].c;
     if ( !chunk )
     {
       continue;
     }
-    uint32_t index = chunk->GetIndex();
-    VertexCount vertexCount = GetVertexCount( index );
     AE_ASSERT( chunk->m_check == 0xCDCDCDCD );
-    AE_ASSERT_MSG( vertexCount > kChunkCountEmpty, "vertex count: # index: #", vertexCount, index );
-    AE_ASSERT( chunk->m_data.GetMaxVertexCount() );
-    AE_ASSERT( chunk->m_data.GetVertexSize() );
+    AE_ASSERT_MSG( GetVertexCount( chunk->GetIndex() ) > kChunkCountEmpty, "vertex count: # index: #", GetVertexCount( chunk->GetIndex() ), chunk->GetIndex() );
+    AE_ASSERT( chunk->m_page >= 0 );
     
     // Only render the visible chunks
-    //if( frustum.TestChunk( chunk ) ) // @TODO: Should make sure chunk is visible
+    const ae::AABB aabb = chunk->GetAABB();
+    if ( frustum && !frustum->Intersects( aabb ) )
     {
-      chunk->m_data.Bind( shader, shaderParams );
-      chunk->m_data.Draw();
-      activeCount++;
+      continue;
+    }
+    // Sort by page so each page is only bound once, and then front to back
+    // within each page. Positive floats sort correctly as unsigned ints.
+    const float distanceSq = ( aabb.GetCenter() - viewPos ).LengthSquared();
+    uint32_t distanceBits;
+    memcpy( &distanceBits, &distanceSq, sizeof(distanceBits) );
+    m_chunkDraws.Append( { ( (uint64_t)chunk->m_page << 32 ) | distanceBits, chunk } );
+  }
+  std::sort( m_chunkDraws.begin(), m_chunkDraws.end(), []( const ChunkDraw& a, const ChunkDraw& b )
+  {
+    return a.key < b.key;
+  } );
+
+  for ( uint32_t i = 0; i < m_chunkDraws.Length(); )
+  {
+    const int32_t pageIndex = m_chunkDraws[ i ].chunk->m_page;
+    const ae::VertexBuffer& data = m_pages[ pageIndex ]->data;
+    data.Bind( shader, shaderParams );
+    // Draw each chunk as a range of the page, combining chunks that happen to
+    // be next to each other in the page
+    uint32_t indexStart = m_chunkDraws[ i ].chunk->m_indexStart;
+    uint32_t indexEnd = indexStart + m_chunkDraws[ i ].chunk->m_indexCount;
+    for ( i++; i < m_chunkDraws.Length() && m_chunkDraws[ i ].chunk->m_page == pageIndex; i++ )
+    {
+      const TerrainChunk* chunk = m_chunkDraws[ i ].chunk;
+      if ( chunk->m_indexStart == indexEnd )
+      {
+        indexEnd += chunk->m_indexCount;
+        continue;
+      }
+      data.Draw( indexStart / 3, ( indexEnd - indexStart ) / 3 );
+      indexStart = chunk->m_indexStart;
+      indexEnd = indexStart + chunk->m_indexCount;
     }
+    data.Draw( indexStart / 3, ( indexEnd - indexStart ) / 3 );
   }
+  m_renderedChunkCount = m_chunkDraws.Length();
 
   if ( AE_TERRAIN_LOG )
   {
-    AE_LOG( "chunks active:# allocated:#", activeCount, m_chunkPool.Length() );
+    AE_LOG( "chunks rendered:# allocated:# pages:#", m_renderedChunkCount, m_chunkPool.Length(), m_pages.Length() );
   }
 }
 
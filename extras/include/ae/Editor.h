@@ -17,7 +17,7 @@
 //------------------------------------------------------------------------------
 namespace ae {
 
-const uint32_t kMaxEditorMessageSize = 1024;
+const uint32_t kMaxEditorMessageSize = 16 * 1024;
 
 typedef uint32_t EditorObjectId;
 const EditorObjectId kInvalidEditorObjectId = 0;
@@ -57,6 +57,35 @@ public:
 	ae::Map< EditorObjectId, EditorObject > objects;
 };
 
+//------------------------------------------------------------------------------
+// ae::EditorModification class
+//------------------------------------------------------------------------------
+//! A change made in the editor while connected, see
+//! ae::Editor::GetModification(). Modifications are already applied to
+//! ae::Editor::GetLevel() when they are available.
+struct EditorModification
+{
+	enum class Type : uint8_t
+	{
+		None,
+		AddObject,
+		RemoveObject,
+		Name,
+		Transform,
+		AddComponent,
+		RemoveComponent,
+		Var
+	};
+	Type type = Type::None;
+	EditorObjectId id = kInvalidEditorObjectId;
+	//! Set for component and var modifications
+	const ae::Type* componentType = nullptr;
+	//! Set for var modifications
+	const ae::Var* var = nullptr;
+	//! Array element that changed, or -1 for the whole var
+	int32_t arrayIdx = -1;
+};
+
 //------------------------------------------------------------------------------
 // ae::EditorMesh class
 //------------------------------------------------------------------------------
@@ -116,6 +145,10 @@ public:
 	ae::EditorLevel* GetWritableLevel() { return m_file ? nullptr : &m_level; }
 	const ae::EditorLevel* GetLevel() const { return &m_level; }
 	uint32_t GetLevelChangeSeq() const { return m_levelSeq; }
+	//! Changes received from the editor during the last call to Update(), in
+	//! the order they were made. Cleared each Update().
+	uint32_t GetModificationCount() const { return m_modifications.Length(); }
+	const ae::EditorModification& GetModification( uint32_t index ) const { return m_modifications[ index ]; }
 	void SetFunctionPointers( LoadEditorMeshFn loadMeshFn, void* loadMeshUserData );
 
 private:
@@ -123,12 +156,14 @@ private:
 	void m_Fork();
 	void m_Connect();
 	void m_Read();
+	void m_ReceiveDeltas( ae::BinaryStream* rStream );
 	const ae::Tag m_tag;
 	EditorParams m_params;
 	ae::FileSystem m_fileSystem;
 	const ae::File* m_file = nullptr;
 	ae::EditorLevel m_level;
 	uint32_t m_levelSeq = 0;
+	ae::Array< EditorModification > m_modifications;
 	ae::Socket m_sock;
 	uint8_t m_msgBuffer[ kMaxEditorMessageSize ];
 };
@@ -11,6 +11,13 @@
 // Headers
 //------------------------------------------------------------------------------
 #include "aether.h"
+#include <mutex>
+
+namespace ctpl
+{
+	class thread_pool;
+}
+
 namespace ae {
 
 //------------------------------------------------------------------------------
@@ -19,6 +26,7 @@ namespace ae {
 typedef uint32_t Entity;
 const Entity kInvalidEntity = 0;
 class EditorLevel;
+typedef uint32_t EditorObjectId;
 
 //------------------------------------------------------------------------------
 // ae::Component
@@ -46,6 +54,50 @@ private:
 };
 
 typedef std::function< void( const class EditorObject& levelObject, Entity entity, class Registry* registry ) > CreateObjectFn;
+typedef std::function< void( Entity entity, const char* name, const ae::Matrix4& transform, class Registry* registry ) > CreateCompiledObjectFn;
+
+//------------------------------------------------------------------------------
+// ae::CompiledLevel
+//------------------------------------------------------------------------------
+//! A binary version of an ae::EditorLevel for loading with ae::Registry::Load().
+//! Values are converted from strings once by Compile(), so loading copies them
+//! straight into components. The types and vars used are stored by name, so
+//! compiled levels still load after vars are added, removed or reordered. Vars
+//! whose type has changed are skipped.
+class CompiledLevel
+{
+public:
+	CompiledLevel( const ae::Tag& tag );
+	//! Components and vars that aren't registered are skipped
+	void Compile( const ae::EditorLevel& level );
+	//! Only compiles the objects of \p level with the given ids
+	void Compile( const ae::EditorLevel& level, const ae::EditorObjectId* ids, uint32_t count );
+	//! Returns false if \p data is not a compiled level of the current version
+	bool Read( const void* data, uint32_t length );
+	void Clear();
+	
+	//! Data to save to disk and later pass to Read()
+	const uint8_t* GetData() const { return m_data.Data(); }
+	uint32_t GetLength() const { return m_data.Length(); }
+	uint32_t GetObjectCount() const { return m_objectCount; }
+	uint32_t GetComponentCount() const { return m_componentCount; }
+	
+	static const uint32_t kMagic = 0x564C4541; // 'AELV'
+	static const uint32_t kVersion = 1;
+	static const uint32_t kNoValue = ~0u;
+	
+private:
+	friend class Registry;
+	//! Size of one element of \p type in compiled levels, 0 if not supported
+	static uint32_t m_GetPackedSize( ae::BasicType type );
+	//! Strings, enums and references are packed as offsets into the string table
+	static bool m_IsStringPacked( ae::BasicType type );
+	void m_Compile( const ae::EditorLevel& level, const ae::EditorObjectId* ids, uint32_t count );
+	const ae::Tag m_tag;
+	ae::Array< uint8_t > m_data;
+	uint32_t m_objectCount = 0;
+	uint32_t m_componentCount = 0;
+};
 
 //------------------------------------------------------------------------------
 // ae::Registry
@@ -65,6 +117,13 @@ public:
 	//! Loads object from the given level. If fn is not null, it will be called
 	//! for each object in the level before components are added.
 	bool Load( const ae::EditorLevel* level, CreateObjectFn fn = nullptr );
+	//! Much faster than loading an ae::EditorLevel, see ae::CompiledLevel.
+	//! Returns false and leaves the registry empty if \p level is invalid.
+	bool Load( const ae::CompiledLevel* level, CreateCompiledObjectFn fn = nullptr );
+	//! Like Load() but existing entities are kept. All entities created are
+	//! appended to \p entitiesOut (if not null) so they can be destroyed later.
+	//! If \p level is invalid no entities are added and false is returned.
+	bool LoadAdditive( const ae::CompiledLevel* level, ae::Array< Entity >* entitiesOut, CreateCompiledObjectFn fn = nullptr );
 	
 	// Get reference
 	Component& GetComponent( Entity entity, const char* typeName );
@@ -105,6 +164,7 @@ public:
 	void Clear();
 	
 private:
+	bool m_Load( const ae::CompiledLevel* level, ae::Array< Entity >* entitiesOut, CreateCompiledObjectFn fn );
 	Component* m_AddComponent( Entity entity, const ae::Type* type );
 	const ae::Tag m_tag;
 	Entity m_lastEntity = kInvalidEntity;
@@ -115,6 +175,122 @@ private:
 	bool m_destroying = false;
 };
 
+//------------------------------------------------------------------------------
+// ae::StreamedLevel
+//------------------------------------------------------------------------------
+//! An ae::EditorLevel split into a grid of cells by object position, where each
+//! cell is a separate ae::CompiledLevel. Write() saves a small index file and
+//! one file per cell, so only the index needs to be read before play. Cells are
+//! loaded and unloaded at runtime with ae::LevelStreamer.
+class StreamedLevel
+{
+public:
+	StreamedLevel( const ae::Tag& tag );
+	~StreamedLevel();
+	//! Cells are cubes of \p cellSize, with each object placed in the cell that
+	//! contains its translation. Cell data stays in memory until Clear().
+	void Compile( const ae::EditorLevel& level, float cellSize );
+	//! Writes the index and all cells to \p directory. Must be compiled first.
+	bool Write( const char* directory ) const;
+	//! Only reads the index from \p directory, cells are read by ae::LevelStreamer
+	bool Read( const char* directory );
+	void Clear();
+	
+	float GetCellSize() const { return m_cellSize; }
+	uint32_t GetCellCount() const { return m_cells.Length(); }
+	ae::Int3 GetCellCoord( uint32_t index ) const { return m_cells[ index ].coord; }
+	ae::AABB GetCellBounds( uint32_t index ) const;
+	uint32_t GetCellObjectCount( uint32_t index ) const { return m_cells[ index ].objectCount; }
+	//! Null unless the level was compiled (and not read from disk)
+	const ae::CompiledLevel* GetCellLevel( uint32_t index ) const { return m_cells[ index ].level; }
+	//! Returns the file path of the cell at \p index in \p directory
+	ae::Str256 GetCellPath( const char* directory, uint32_t index ) const;
+	
+	static const uint32_t kMagic = 0x494C4541; // 'AELI'
+	static const uint32_t kVersion = 1;
+	
+private:
+	struct Cell
+	{
+		ae::Int3 coord;
+		uint32_t objectCount;
+		ae::CompiledLevel* level;
+	};
+	const ae::Tag m_tag;
+	float m_cellSize = 0.0f;
+	ae::Array< Cell > m_cells;
+};
+
+//------------------------------------------------------------------------------
+// ae::LevelStreamer
+//------------------------------------------------------------------------------
+//! Loads and unloads the cells of an ae::StreamedLevel around a focus point.
+//! Cell files are read and validated on background threads, then entities are
+//! added to and removed from an ae::Registry in Update(). References to objects
+//! in cells that aren't loaded are not resolved.
+class LevelStreamer
+{
+public:
+	LevelStreamer( const ae::Tag& tag );
+	~LevelStreamer();
+	//! Cells not in memory are read from \p directory (see
+	//! ae::StreamedLevel::Write()). Reads happen on Update() if \p threadCount
+	//! is 0. \p level and \p registry must outlive this ae::LevelStreamer.
+	void Initialize( const ae::StreamedLevel* level, ae::Registry* registry, const char* directory, uint32_t threadCount = 1 );
+	//! Destroys all streamed entities
+	void Terminate();
+	//! Called for each object as it is loaded, see ae::Registry::LoadAdditive()
+	void SetCreateObjectFn( CreateCompiledObjectFn fn ) { m_createObjectFn = fn; }
+	//! Limits the number of objects added and removed by each call to Update().
+	//! At least one cell is always loaded per Update(), so use smaller cells
+	//! to reduce spikes. 0 means unlimited.
+	void SetObjectBudget( uint32_t maxObjectsPerUpdate ) { m_objectBudget = maxObjectsPerUpdate; }
+	//! Cells within \p loadRadius of \p focus are loaded, nearest first. Cells
+	//! further than \p unloadRadius are unloaded. \p unloadRadius should be
+	//! larger than \p loadRadius to avoid repeatedly loading the same cells.
+	void Update( ae::Vec3 focus, float loadRadius, float unloadRadius );
+	
+	bool IsCellLoaded( uint32_t index ) const;
+	uint32_t GetLoadedCellCount() const;
+	//! Cells waiting to be read or to be added to the ae::Registry
+	uint32_t GetPendingCellCount() const;
+	
+private:
+	enum class CellState : uint8_t
+	{
+		Unloaded,
+		Reading,
+		Ready,
+		Loaded,
+		Unloading
+	};
+	struct Cell
+	{
+		Cell( const ae::Tag& tag ) : entities( tag ) {}
+		CellState state = CellState::Unloaded;
+		bool wanted = false;
+		bool failed = false;
+		float distance = 0.0f;
+		const ae::CompiledLevel* level = nullptr;
+		ae::CompiledLevel* readLevel = nullptr; // Owned, read from disk
+		ae::Array< Entity > entities;
+	};
+	void m_Read( uint32_t index );
+	void m_FreeRead( Cell* cell );
+	const ae::Tag m_tag;
+	const ae::StreamedLevel* m_level = nullptr;
+	ae::Registry* m_registry = nullptr;
+	ae::Str256 m_directory;
+	CreateCompiledObjectFn m_createObjectFn;
+	uint32_t m_objectBudget = 0;
+	ae::Array< Cell > m_cells;
+	ae::Array< uint32_t > m_sorted;
+	ctpl::thread_pool* m_threadPool = nullptr;
+	std::mutex m_readMutex;
+	ae::Array< uint32_t > m_readDone; // Guarded by m_readMutex
+	ae::Array< uint32_t > m_readDoneTemp;
+};
+
 //------------------------------------------------------------------------------
 // ae::Component member functions
 //------------------------------------------------------------------------------
@@ -74,7 +74,7 @@ private:
 	Resource* m_Add( const char* type, const char* name );
 	const ae::Tag m_tag;
 	ae::FileSystem* m_fs = nullptr;
-	ae::Map< ae::Str64, Resource* > m_resources;
+	ae::Map< ae::Name, Resource* > m_resources;
 };
 
 //------------------------------------------------------------------------------
@@ -89,7 +89,7 @@ T* ResourceManager::Add( const char* name )
 template < typename T >
 const T* ResourceManager::TryGet( const char* name ) const
 {
-	const Resource* resource = m_resources.Get( name, nullptr );
+	const Resource* resource = m_resources.Get( ae::Name::Find( name ), nullptr );
 	if ( !resource )
 	{
 		return nullptr;
@@ -51,6 +51,120 @@ private:
 	GlyphData m_glyphs[ 96 ];
 };
 
+//------------------------------------------------------------------------------
+// ae::SpriteBatcher
+//------------------------------------------------------------------------------
+//! The CPU side of ae::SpriteRenderer::Render(). Sprites are added with a group
+//! and a depth, then Sort() orders them by group and then depth (lowest first)
+//! and merges consecutive sprites of the same group into batches. Sprites with
+//! the same key keep the order they were added in. Has no graphics
+//! dependencies so it can be used and profiled headless.
+class SpriteBatcher
+{
+public:
+	struct Batch
+	{
+		uint32_t group;
+		uint32_t start; //!< First sprite of the batch in sorted order
+		uint32_t count;
+	};
+
+	SpriteBatcher( const ae::Tag& tag );
+	void Reserve( uint32_t count );
+	void Add( uint32_t group, float depth );
+	//! Sorts all added sprites and rebuilds the batch list
+	void Sort();
+	void Clear();
+
+	uint32_t GetSpriteCount() const { return m_keys.Length(); }
+	//! Returns the index (in the order added) of the sprite at \p sortedIndex.
+	//! Only valid after Sort().
+	uint32_t GetSpriteIndex( uint32_t sortedIndex ) const { return m_indices[ sortedIndex ]; }
+	uint32_t GetBatchCount() const { return m_batches.Length(); }
+	const Batch& GetBatch( uint32_t index ) const { return m_batches[ index ]; }
+
+	//! Group in the high 32 bits, depth as an order preserving unsigned int in
+	//! the low 32 bits
+	static uint64_t GetSortKey( uint32_t group, float depth );
+
+private:
+	ae::Array< uint64_t > m_keys;
+	ae::Array< uint32_t > m_indices;
+	ae::Array< uint64_t > m_tempKeys;
+	ae::Array< uint32_t > m_tempIndices;
+	ae::Array< Batch > m_batches;
+};
+
+//------------------------------------------------------------------------------
+// ae::AtlasPacker
+//------------------------------------------------------------------------------
+//! Allocates rectangles from a fixed size texture atlas at runtime, for
+//! content that comes and goes like glyphs or UI icons. Uses maxrects packing
+//! (best short side fit) and entries can be removed at any time, returning
+//! their space for later inserts. Only tracks space, so the caller is
+//! responsible for uploading texels to the returned rects. Has no graphics
+//! dependencies so it can be used headless.
+class AtlasPacker
+{
+public:
+	AtlasPacker( const ae::Tag& tag );
+	//! \p padding is the number of empty texels between entries. \p border is
+	//! the number of texels reserved around each entry which the caller should
+	//! fill by extending the entries edge texels, so filtering doesn't sample
+	//! neighboring entries. \p alignment (a power of two) keeps each entry in
+	//! its own blocks of texels, so with an alignment of 2^N the first N mip
+	//! levels never blend neighboring entries together.
+	void Initialize( uint32_t width, uint32_t height, uint32_t padding = 1, uint32_t border = 0, uint32_t alignment = 1 );
+	//! Removes all entries. Settings from Initialize() are kept.
+	void Clear();
+
+	//! Returns a non-zero id on success, or 0 if there is no space left
+	uint32_t Insert( uint32_t width, uint32_t height );
+	//! Returns the space used by \p id to the atlas
+	void Remove( uint32_t id );
+
+	//! Texels of the entry, not including its border
+	ae::RectInt GetRect( uint32_t id ) const;
+	//! Texels of the entry including its border, for uploading the border
+	ae::RectInt GetBorderRect( uint32_t id ) const;
+	//! Normalized texture coordinates of the entry, for
+	//! ae::SpriteRenderer::AddSprite()
+	ae::Rect GetUVs( uint32_t id ) const;
+
+	uint32_t GetWidth() const { return m_width; }
+	uint32_t GetHeight() const { return m_height; }
+	uint32_t GetCount() const { return m_entries.Length(); }
+	//! Texels allocated by all entries, including borders, padding and alignment
+	uint64_t GetUsedArea() const { return m_usedArea; }
+
+private:
+	struct Space
+	{
+		bool Contains( const Space& other ) const;
+		int32_t x, y, w, h;
+	};
+	struct Entry
+	{
+		Space space; // Allocated texels, includes border, padding and alignment
+		uint32_t width;
+		uint32_t height;
+	};
+	void m_Split( const Space& used );
+	void m_Merge( uint32_t first );
+	void m_Prune();
+	const Entry& m_GetEntry( uint32_t id ) const;
+	uint32_t m_width = 0;
+	uint32_t m_height = 0;
+	uint32_t m_padding = 0;
+	uint32_t m_border = 0;
+	uint32_t m_alignment = 1;
+	uint32_t m_nextId = 1;
+	uint64_t m_usedArea = 0;
+	ae::Map< uint32_t, Entry > m_entries;
+	ae::Array< Space > m_free;
+	ae::Array< Space > m_temp;
+};
+
 //------------------------------------------------------------------------------
 // ae::SpriteRenderer utility
 //------------------------------------------------------------------------------
@@ -97,17 +211,33 @@ public:
 		}
 	*/
 	void SetParams( uint32_t group, const ae::Shader* shader, const ae::UniformList& uniforms );
+	//! Sprites are drawn ordered by group, then by the z position of their
+	//! center (lowest first), then in the order they were added. Consecutive
+	//! sprites of the same group are drawn with a single draw call.
 	void Render();
 	void Clear();
 
+	//! The number of draw calls issued by the last call to Render()
+	uint32_t GetDrawCount() const { return m_drawCount; }
+
 private:
+	struct Vertex
+	{
+		ae::Vec4 pos;
+		ae::Vec4 color;
+		ae::Vec2 uv;
+	};
 	struct GroupParams
 	{
 		const ae::Shader* shader = nullptr;
 		ae::UniformList uniforms;
 	};
+	uint32_t m_maxCount = 0;
+	uint32_t m_drawCount = 0;
 	ae::Array< GroupParams > m_params;
-	ae::Array< uint32_t > m_spriteGroups;
+	ae::Array< Vertex > m_vertices;
+	ae::Array< Vertex > m_sortedVertices;
+	SpriteBatcher m_batcher;
 	ae::VertexArray m_vertexArray;
 };
 
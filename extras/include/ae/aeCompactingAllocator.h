@@ -28,11 +28,17 @@
 // Headers
 //------------------------------------------------------------------------------
 #include "aether.h"
+#include <mutex>
 
 //------------------------------------------------------------------------------
 // aeCompactingAllocator class
 // @NOTE: 'p's must remain valid and writable until Free() is called.
-//        'p's will be rewritten to maintain zero internal fragmentation.
+//        'p's will be rewritten when allocations are moved by Compact(), by
+//        Expand(), or by Allocate() when there isn't enough contiguous space.
+//        Freed space is reused by later allocations of the same size or
+//        smaller (best fit) without moving any other allocations.
+//        All functions are thread safe, but allocations must not be accessed
+//        while another thread could be moving them.
 //------------------------------------------------------------------------------
 class aeCompactingAllocator
 {
@@ -45,111 +51,64 @@ public:
   template < typename T >
   void Allocate( T** p, uint32_t size );
   
-  //template < typename T >
-  //void Reallocate( T** p, uint32_t size );
-  
   template < typename T >
   void Free( T** p );
+
+  // Moves allocations towards the front of the buffer to merge free space.
+  // Stops once maxBytes have been moved, but always moves at least one
+  // allocation if maxBytes is non-zero so repeated calls make progress.
+  // Returns true when there is no free space between allocations.
+  bool Compact( uint32_t maxBytes = ~0u );
   
 private:
   const static intptr_t kAlignment = 16; // @TODO: Should be configurable
 
-  struct Header
+  struct alignas( kAlignment ) Header
   {
-    uint32_t check;
-    uint16_t size;
-    Header* next;
-    Header* prev;
-    void** external;
-    uint32_t dbgTypeId;
-
-    uint8_t pad[ 24 ];
+    // Address of the users pointer for allocations. For free blocks the low
+    // bit is set and the remaining bits are the blocks index in m_freeList.
+    uintptr_t external;
+    uint32_t size; // Bytes following the header, a multiple of kAlignment
+    uint32_t prevSize; // Size of the previous adjacent block, for coalescing
+#if _AE_DEBUG_
+    uint32_t typeId; // Checked on Free()
+#endif
   };
 
-  void m_Compact();
+  template < typename T > static uint32_t m_GetTypeId() { static uint32_t s_typeId = ae::Hash().HashString( ae::GetTypeName< T >() ).Get(); return s_typeId; }
+  void m_Allocate( void** p, uint32_t size, uint32_t typeId );
+  void m_Free( void** p, uint32_t typeId );
+  bool m_Compact( uint32_t maxBytes );
   Header* m_GetHeader( void* p );
+  Header* m_At( uint32_t offset ) { return (Header*)( m_data + offset ); }
+  uint32_t m_Offset( const Header* header ) const { return (uint32_t)( (const uint8_t*)header - m_data ); }
+  Header* m_Next( Header* header );
+  Header* m_Prev( Header* header );
+  static bool m_IsFree( const Header* header ) { return header->external & 1; }
+  void m_AddFree( Header* header );
+  void m_RemoveFree( Header* header );
   void m_Verify();
 
-  bool m_isCompact = true;
+  std::mutex m_lock;
   uint8_t* m_data = nullptr;
-  Header* m_tail = nullptr;
   uint32_t m_size = 0;
+  uint32_t m_used = 0; // End of the last block
+  uint32_t m_lastSize = 0; // Size of the last block, for appending
+  uint32_t m_compactOffset = 0; // All blocks before this offset are allocated
+  ae::Array< uint32_t > m_freeList = AE_ALLOC_TAG_FIXME; // Offsets of free blocks
 };
 
 //------------------------------------------------------------------------------
 // aeCompactingAllocator templated member functions
 //------------------------------------------------------------------------------
 template < typename T >
-void aeCompactingAllocator::Allocate( T** _p, uint32_t size )
+void aeCompactingAllocator::Allocate( T** p, uint32_t size )
 {
-  AE_ASSERT( m_data );
   AE_STATIC_ASSERT( std::is_pod< T >::value );
   AE_STATIC_ASSERT( alignof( T ) <= kAlignment );
-  void** p = (void**)_p;
-
-  // Move all allocations to front of m_data
-  m_Compact();
-
-  // Always append newest allocation to end
-  if ( m_tail )
-  {
-    Header* next = (Header*)( (uint8_t*)m_tail + sizeof( Header ) + m_tail->size );
-    AE_ASSERT( (uint8_t*)next - m_data + size + sizeof( Header ) < m_size ); // @TODO: Should return null
-    next->size = size;
-    next->next = nullptr;
-    next->external = p;
-    next->dbgTypeId = ae::Hash().HashString( ae::GetTypeName< T >() ).Get();
-    next->check = 0xABABABAB;
-    *p = (uint8_t*)next + sizeof( Header );
-    next->prev = m_tail;
-    m_tail->next = next;
-    m_tail = next;
-  }
-  else
-  {
-    m_tail = (Header*)m_data;
-    m_tail->size = size;
-    m_tail->next = nullptr;
-    m_tail->prev = nullptr;
-    m_tail->external = p;
-    m_tail->dbgTypeId = ae::Hash().HashString( ae::GetTypeName< T >() ).Get();
-    m_tail->check = 0xABABABAB;
-    *p = (uint8_t*)m_tail + sizeof( Header );
-  }
-
-  //AE_LOG( "sizeof(Header):#", sizeof( Header ) );
-  //AE_ASSERT_MSG( (intptr_t)*p % kAlignment == 0, "Allocation alignment: #", (intptr_t)*p % kAlignment );
-
-  m_Verify();
-
-  //AE_LOG( "Allocate #", *p );
+  m_Allocate( (void**)p, size, m_GetTypeId< T >() );
 }
 
-//void aeCompactingAllocator::Reallocate( void** p, uint32_t size )
-//{
-//  AE_ASSERT( m_data );
-//
-//  m_Compact();
-//
-//  Header* oldHeader = m_GetHeader( p );
-//  if ( oldHeader->size > size )
-//  {
-//    oldHeader->size = size;
-//  }
-//  else if ( oldHeader->size < size )
-//  {
-//    Header* newHeader = (Header*)( (uint8_t*)m_tail + sizeof( Header ) + m_tail->size );
-//    AE_ASSERT( (uint8_t*)newHeader - m_data + size + sizeof( Header ) < m_size );
-//    memmove( newHeader, oldHeader, sizeof( Header ) + oldHeader->size );
-//    *( newHeader->external ) = (uint8_t*)newHeader + sizeof( Header );
-//    newHeader->size = size;
-//    newHeader->next = nullptr;
-//    newHeader->prev = m_tail;
-//    m_tail->next = newHeader;
-//    m_tail = newHeader;
-//  }
-//}
-
 template < typename T >
 void aeCompactingAllocator::Free( T** p )
 {
@@ -158,23 +117,7 @@ void aeCompactingAllocator::Free( T** p )
   {
     return;
   }
-
-  //AE_LOG( "Free #", *p );
-
-  AE_ASSERT( m_data );
-  AE_ASSERT( m_data < (uint8_t*)*p );
-  AE_ASSERT( (uint8_t*)*p < m_data + m_size );
-
-  Header* header = m_GetHeader( (void*)*p );
-  uint32_t typeHash = ae::Hash().HashString( ae::GetTypeName< T >() ).Get();
-  AE_ASSERT_MSG( header->dbgTypeId == typeHash, "Type mismatch between allocation and free" );
-  *(header->external) = nullptr;
-  header->external = nullptr;
-
-  // Always flag for compaction, even if only to reclaim empty tail headers
-  m_isCompact = false;
-
-  m_Verify();
+  m_Free( (void**)p, m_GetTypeId< T >() );
 }
 
 #endif
@@ -31,13 +31,34 @@
 #include "aeSignal.h"
 #include "aeSparseGrid.h"
 
+namespace ctpl
+{
+  class thread_pool;
+}
+
+//------------------------------------------------------------------------------
+// HotSpotCollisionInfo struct
+//------------------------------------------------------------------------------
+struct HotSpotCollisionInfo
+{
+  ae::Int2 position;
+  ae::Int2 normal;
+  uint32_t tile;
+  uint32_t properties;
+  class HotSpotObject* object = nullptr; // Set for object collisions, null for tile collisions
+};
+
 //------------------------------------------------------------------------------
 // HotSpotWorld class
 //------------------------------------------------------------------------------
 class HotSpotWorld
 {
 public:
-  void Initialize( float timeStep );
+  ~HotSpotWorld();
+  // Objects are stepped on threadCount threads (including the calling thread)
+  // when there are enough of them. The result of each step is the same
+  // regardless of threadCount.
+  void Initialize( float timeStep, uint32_t threadCount = 1 );
   void Update( float dt );
   uint32_t GetWidth() const { return m_width; }
   uint32_t GetHeight() const { return m_height; }
@@ -60,7 +81,20 @@ public:
   class HotSpotObject* GetObject( uint32_t index );
   uint32_t GetObjectCount() const;
 
+  // 4) Object collision - Optionally push overlapping objects apart. Objects
+  // are bucketed by tile each step so only nearby objects are tested.
+  void SetObjectCollisionEnabled( bool enabled );
+  bool GetObjectCollisionEnabled() const;
+
 private:
+  friend class HotSpotObject;
+  void m_StepObjects( uint32_t start, uint32_t end, float dt );
+  void m_StepObject( uint32_t index, float dt );
+  bool m_CheckCollision( uint32_t index, ae::Int2 dir );
+  bool m_TestSide( ae::Vec2 p0, ae::Vec2 p1, ae::Vec2* pOut ) const;
+  void m_CollideObjects();
+  void m_SendCollisions();
+
   float m_timeStep = 0.0f;
   float m_timeAccumulator = 0.0f;
   uint32_t m_width = 0;
@@ -72,7 +106,29 @@ private:
   ae::Map< uint32_t, float > m_tileDensity = AE_ALLOC_TAG_HOTSPOT;
   uint32_t m_collisionMask = 0;
 
+  // Object state is stored by component and indexed by HotSpotObject::m_index
   ae::Array< class HotSpotObject* > m_objects = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< ae::Vec2 > m_positions = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< ae::Vec2 > m_velocities = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< ae::Vec2 > m_forces = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< ae::Vec2 > m_gravities = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< float > m_masses = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< float > m_groundRestitutions = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< float > m_wallRestitutions = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< float > m_volumes = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< float > m_airTimers = AE_ALLOC_TAG_HOTSPOT;
+  // Tile collisions are recorded per object while stepping (at most one
+  // vertical and one horizontal) and sent on the calling thread afterwards
+  ae::Array< uint32_t > m_tileCollisionCounts = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< HotSpotCollisionInfo > m_tileCollisions = AE_ALLOC_TAG_HOTSPOT;
+
+  // Object collision broadphase. Each tile stores a linked list of objects.
+  bool m_objectCollision = false;
+  ae::Map< ae::Int2, int32_t > m_cellFirst = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< int32_t > m_cellNext = AE_ALLOC_TAG_HOTSPOT;
+  ae::Array< ae::Pair< uint32_t, uint32_t > > m_objectPairs = AE_ALLOC_TAG_HOTSPOT;
+
+  ctpl::thread_pool* m_threadPool = nullptr;
 
 public:
   static ae::Int2 _GetTilePos( ae::Vec2 pos );
@@ -81,6 +137,8 @@ public:
 //------------------------------------------------------------------------------
 // HotSpotObject class
 //------------------------------------------------------------------------------
+// Objects are handles to state stored in their HotSpotWorld, so pointers
+// returned by HotSpotWorld::CreateObject() stay valid as objects are added.
 class HotSpotObject
 {
 public:
@@ -101,30 +159,13 @@ public:
   ae::Vec2 GetVelocity() const;
   bool IsOnGround() const;
 
-  struct CollisionInfo
-  {
-    ae::Int2 position;
-    ae::Int2 normal;
-    uint32_t tile;
-    uint32_t properties;
-  };
+  typedef HotSpotCollisionInfo CollisionInfo;
   aeSignalList< const CollisionInfo* > onCollision;
 
 private:
   friend HotSpotWorld;
-  void Update( HotSpotWorld* world, float dt );
-  bool m_CheckCollision( const HotSpotWorld* world, ae::Int2 dir );
-  bool m_TestSide( const HotSpotWorld* world, ae::Vec2 p0, ae::Vec2 p1, ae::Vec2* pOut );
-
-  ae::Vec2 m_position = ae::Vec2( 0.0f );
-  ae::Vec2 m_velocity = ae::Vec2( 0.0f );
-  ae::Vec2 m_forces = ae::Vec2( 0.0f );
-  ae::Vec2 m_gravity = ae::Vec2( 0.0f );
-  float m_mass = 1.0f;
-  float m_groundRestitution = 0.0f;
-  float m_wallRestitution = 0.3f;
-  float m_volume = 1.0f;
-  float m_airTimer = 0.0f;
+  HotSpotWorld* m_world = nullptr;
+  uint32_t m_index = 0;
 };
 
 #endif
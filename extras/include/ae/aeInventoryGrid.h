@@ -33,6 +33,8 @@
 //------------------------------------------------------------------------------
 // aeInventoryGrid class
 //------------------------------------------------------------------------------
+// Each occupied cell is indexed, so lookups and placement checks take constant
+// time per cell regardless of the number of stored shapes.
 template < typename T >
 class aeInventoryGrid
 {
@@ -46,6 +48,14 @@ public:
   T* TryGet( ae::Int2 pos );
   bool TryGet( ae::Int2 pos, T* valueOut );
   const T* TryGet( ae::Int2 pos ) const;
+  bool IsFree( ae::Int2 pos ) const;
+
+  // Searches bounds row by row (y then x) for the first position where a
+  // rectangle of the given size fits. Returns true and sets posOut on success.
+  bool FindFirstFit( ae::RectInt bounds, ae::Int2 size, ae::Int2* posOut ) const;
+  // Same as above for an arbitrary shape. The cells of the shape must be added
+  // to offsetOut before calling Set().
+  bool FindFirstFit( ae::RectInt bounds, const ae::Int2* cells, uint32_t cellCount, ae::Int2* offsetOut ) const;
 
   void Remove( ae::Int2 pos );
   void Remove( const T& value );
@@ -55,20 +65,23 @@ public:
 private:
   struct Shape
   {
-    Shape() : node( this ) {}
+    Shape( ae::Tag pool ) : node( this ), cells( pool ) {}
 
     ae::ListNode< Shape > node;
     ae::Array< ae::Int2 > cells;
     T value;
   };
+  void m_Remove( Shape* shape );
   
   ae::Tag m_pool;
   ae::List< Shape > m_shapeList;
+  ae::Map< ae::Int2, Shape* > m_cells;
 };
 
 template < typename T >
 aeInventoryGrid< T >::aeInventoryGrid( ae::Tag pool ) :
-  m_pool( pool )
+  m_pool( pool ),
+  m_cells( pool )
 {}
 
 template < typename T >
@@ -83,15 +96,17 @@ aeInventoryGrid< T >::~aeInventoryGrid()
 template < typename T >
 void aeInventoryGrid< T >::Set( T& value, ae::RectInt rect )
 {
-  ae::Array< ae::Int2 > cells( m_pool, rect.w * rect.h );
-  for ( uint32_t y = 0; y < rect.h; y++ )
+  const ae::Int2 pos = rect.GetPos();
+  const ae::Int2 size = rect.GetSize();
+  ae::Array< ae::Int2 > cells( m_pool, size.x * size.y );
+  for ( int32_t y = 0; y < size.y; y++ )
   {
-    for ( uint32_t x = 0; x < rect.w; x++ )
+    for ( int32_t x = 0; x < size.x; x++ )
     {
-      cells.Append( ae::Int2( rect.x + x, rect.y + y ) );
+      cells.Append( ae::Int2( pos.x + x, pos.y + y ) );
     }
   }
-  Set( value, &( cells[ 0 ] ), cells.Length() );
+  Set( value, cells.Data(), cells.Length() );
 }
 
 template < typename T >
@@ -99,16 +114,20 @@ void aeInventoryGrid< T >::Set( T& value, ae::Int2* cells, uint32_t cellCount )
 {
   for ( uint32_t i = 0; i < cellCount; i++ )
   {
-    T* other = TryGet( cells[ i ] );
+    const T* other = TryGet( cells[ i ] );
     AE_ASSERT_MSG( !other, "Cell # already occupied by #", cells[ i ], other );
   }
 
-  Shape* shape = ae::New< Shape >( AE_ALLOC_TAG_FIXME );
+  Shape* shape = ae::New< Shape >( m_pool, m_pool );
   AE_ASSERT( shape );
 
   shape->value = value;
-  shape->cells.Append( cells, cellCount );
+  shape->cells.AppendArray( cells, cellCount );
   m_shapeList.Append( shape->node );
+  for ( uint32_t i = 0; i < cellCount; i++ )
+  {
+    m_cells.Set( cells[ i ], shape );
+  }
 }
 
 template < typename T >
@@ -132,35 +151,96 @@ bool aeInventoryGrid< T >::TryGet( ae::Int2 pos, T* valueOut )
 template < typename T >
 const T* aeInventoryGrid< T >::TryGet( ae::Int2 pos ) const
 {
-  const Shape* shape = m_shapeList.GetFirst();
-  while ( shape )
+  Shape* shape = m_cells.Get( pos, nullptr );
+  return shape ? &shape->value : nullptr;
+}
+
+template < typename T >
+bool aeInventoryGrid< T >::IsFree( ae::Int2 pos ) const
+{
+  return m_cells.GetIndex( pos ) < 0;
+}
+
+template < typename T >
+bool aeInventoryGrid< T >::FindFirstFit( ae::RectInt bounds, ae::Int2 size, ae::Int2* posOut ) const
+{
+  if ( size.x <= 0 || size.y <= 0 )
   {
-    if ( shape->cells.Find( pos ) >= 0 )
+    return false;
+  }
+  const ae::Int2 boundsPos = bounds.GetPos();
+  const ae::Int2 boundsMax = boundsPos + bounds.GetSize() - size; // Inclusive
+  for ( int32_t y = boundsPos.y; y <= boundsMax.y; y++ )
+  {
+    int32_t x = boundsPos.x;
+    while ( x <= boundsMax.x )
     {
-      return &shape->value;
+      // Any occupied cell rules out every position to the left of it on this
+      // row, so skip past the right-most occupied cell found
+      int32_t skip = x;
+      for ( int32_t cy = y; cy < y + size.y; cy++ )
+      {
+        for ( int32_t cx = x + size.x - 1; cx >= skip; cx-- )
+        {
+          if ( !IsFree( ae::Int2( cx, cy ) ) )
+          {
+            skip = cx + 1;
+            break;
+          }
+        }
+      }
+      if ( skip == x )
+      {
+        *posOut = ae::Int2( x, y );
+        return true;
+      }
+      x = skip;
     }
-    shape = shape->node.GetNext();
   }
-
-  return nullptr;
+  return false;
 }
 
 template < typename T >
-void aeInventoryGrid< T >::Remove( ae::Int2 pos )
+bool aeInventoryGrid< T >::FindFirstFit( ae::RectInt bounds, const ae::Int2* cells, uint32_t cellCount, ae::Int2* offsetOut ) const
 {
-  if ( m_shapeList.Length() == 0 )
+  if ( !cellCount )
   {
-    return;
+    return false;
   }
-
-  auto fn = [ pos ]( Shape* shape )
+  ae::RectInt shapeBounds = ae::RectInt::FromPoints( cells[ 0 ], cells[ 0 ] );
+  for ( uint32_t i = 1; i < cellCount; i++ )
   {
-    return ( shape->cells.Find( pos ) >= 0 );
-  };
-  Shape* shape = m_shapeList.FindFn( fn );
-  if ( shape )
+    shapeBounds.Expand( cells[ i ] );
+  }
+  // Range of offsets that keep every cell of the shape within bounds
+  const ae::Int2 offsetMin = bounds.GetPos() - shapeBounds.GetPos();
+  const ae::Int2 offsetMax = offsetMin + bounds.GetSize() - shapeBounds.GetSize(); // Inclusive
+  for ( int32_t y = offsetMin.y; y <= offsetMax.y; y++ )
   {
-    ae::Delete( shape );
+    for ( int32_t x = offsetMin.x; x <= offsetMax.x; x++ )
+    {
+      const ae::Int2 offset( x, y );
+      uint32_t i = 0;
+      while ( i < cellCount && IsFree( cells[ i ] + offset ) )
+      {
+        i++;
+      }
+      if ( i == cellCount )
+      {
+        *offsetOut = offset;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template < typename T >
+void aeInventoryGrid< T >::Remove( ae::Int2 pos )
+{
+  if ( Shape* shape = m_cells.Get( pos, nullptr ) )
+  {
+    m_Remove( shape );
   }
 }
 
@@ -169,13 +249,13 @@ void aeInventoryGrid< T >::Remove( const T& value )
 {
   AE_ASSERT( m_shapeList.Length() );
 
-  auto fn = [ value ]( Shape* shape )
+  auto fn = [ &value ]( Shape* shape )
   {
     return ( shape->value == value );
   };
   Shape* shape = m_shapeList.FindFn( fn );
   AE_ASSERT( shape );
-  ae::Delete( shape );
+  m_Remove( shape );
 }
 
 template < typename T >
@@ -184,4 +264,14 @@ uint32_t aeInventoryGrid< T >::Length() const
   return m_shapeList.Length();
 }
 
+template < typename T >
+void aeInventoryGrid< T >::m_Remove( Shape* shape )
+{
+  for ( const ae::Int2& cell : shape->cells )
+  {
+    m_cells.Remove( cell );
+  }
+  ae::Delete( shape );
+}
+
 #endif
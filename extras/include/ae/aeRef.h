@@ -89,6 +89,16 @@ inline std::ostream& operator<<( std::ostream& os, const aeId< T >& id )
   return os << id.m_id;
 }
 
+//------------------------------------------------------------------------------
+// aeRefable sequence
+//------------------------------------------------------------------------------
+// Incremented whenever any aeRefable is destroyed. aeRef uses this to validate
+// its cached pointer without a map lookup. It's shared by all types so that
+// refs to base classes (which use their own aeRefable) are invalidated too.
+// Zero is skipped on wrap around because aeRef uses it to mean 'not cached'.
+inline uint32_t& aeRefableSequence() { static uint32_t s_sequence = 1; return s_sequence; }
+inline void aeRefableInvalidate() { uint32_t& s = aeRefableSequence(); if ( !++s ) { s = 1; } }
+
 //------------------------------------------------------------------------------
 // aeRefable class
 //------------------------------------------------------------------------------
@@ -97,7 +107,7 @@ class aeRefable
 {
 public:
   aeRefable( T* owner ) : m_id( aeId< T >::CreateNew() ) { s_GetMap()->Set( m_id, owner ); }
-  ~aeRefable() { s_GetMap()->Remove( m_id ); }
+  ~aeRefable() { s_GetMap()->Remove( m_id ); aeRefableInvalidate(); }
 
   aeId< T > GetId() const { return m_id; }
   static T* GetById( aeId< T > id ) { return s_GetMap()->Get( id, nullptr ); }
@@ -106,7 +116,6 @@ private:
   //aeRefable( const aeRefable& ) = delete; // @HACK: Disabled this to support automatic 'this' assignment with AE_REFABLE
   aeRefable& operator= ( const aeRefable& ) = delete;
 
-  // uint32_t s_sequence = 1; @TODO: Increment a 'dirty' sequence number whenever a T is destroyed so aeRef can keep a pointer to the referenced object and avoid a lookup
   typedef ae::Map< aeId< T >, T* > RefMap;
   static RefMap* s_GetMap() { static RefMap s_map = AE_ALLOC_TAG_FIXME; return &s_map; }
 
@@ -116,6 +125,9 @@ private:
 //------------------------------------------------------------------------------
 // aeRef class
 //------------------------------------------------------------------------------
+// Not thread-safe. Even const access updates the cached pointer, so an aeRef
+// must not be read from multiple threads at once, and refables should only be
+// created and destroyed on the thread that uses their refs.
 template < typename T >
 class aeRef
 {
@@ -153,8 +165,9 @@ private:
   U* m_Get( ... );
 
   aeId< T > m_id;
-  // uint32_t m_sequence = 0; @TODO: Keep a pointer to the referenced object and a local copy aeRef< T >::s_sequence so sequential lookups are fast
-  // T* m_cached = nullptr;
+  // Pointer to the referenced object, valid while m_sequence matches aeRefableSequence()
+  mutable uint32_t m_sequence = 0;
+  mutable T* m_cached = nullptr;
 };
 
 //------------------------------------------------------------------------------
@@ -262,14 +275,27 @@ template < typename T >
 template < typename U, bool >
 const U* aeRef< T >::m_Get( int ) const
 {
-  return m_id ? ae::Cast< T >( T::GetById( m_id ) ) : nullptr;
+  if ( !m_id )
+  {
+    return nullptr;
+  }
+  uint32_t sequence = aeRefableSequence();
+  if ( m_sequence != sequence )
+  {
+    // Objects are only ever unregistered on destruction, so a lookup is only
+    // needed after any refable object has been destroyed. Misses aren't
+    // cached in case an object with this id is registered later.
+    m_cached = ae::Cast< T >( T::GetById( m_id ) );
+    m_sequence = m_cached ? sequence : 0;
+  }
+  return m_cached;
 }
 
 template < typename T >
 template < typename U, bool >
 U* aeRef< T >::m_Get( int )
 {
-  return m_id ? ae::Cast< T >( T::GetById( m_id ) ) : nullptr;
+  return const_cast< U* >( const_cast< const aeRef< T >* >( this )->m_Get< U >( 0 ) );
 }
 
 template < typename T >
@@ -31,272 +31,191 @@
 #include "aeRef.h"
 
 //------------------------------------------------------------------------------
-// aeSignalBase class
+// ae::Delegate class
 //------------------------------------------------------------------------------
-class aeSignalBase
-{
-public:
-  aeSignalBase() {}
-  virtual ~aeSignalBase() {}
-
-  virtual bool Send() = 0;
-
-public:
-  // Internal use
-  virtual void* GetObj() = 0;
-};
-
-//------------------------------------------------------------------------------
-// aeSignalValue class
-//------------------------------------------------------------------------------
-template < typename V >
-class aeSignalValue : public aeSignalBase
-{
-public:
-  aeSignalValue();
-  aeSignalValue( const V& val );
-  virtual ~aeSignalValue() {}
-
-  virtual bool Send( const V& value ) = 0;
-
-protected:
-  bool m_valSet;
-  V m_val;
-
-public:
-  // Internal use
-  bool HasValue();
-};
+namespace ae {
 
-//------------------------------------------------------------------------------
-// aeSignal class
-//------------------------------------------------------------------------------
-template < typename T, typename V = int32_t >
-class aeSignal : public aeSignalValue< V >
+//! A callable bound to an object pointer or aeRef and either a member function
+//! or a small lambda. Bound functions can take no arguments or a single V.
+//! Everything is stored inline so delegates never allocate and can be copied
+//! with memcpy. Lambdas must be trivially copyable and fit in kStorageSize.
+template < typename V = int32_t >
+class Delegate
 {
 public:
-  aeSignal();
-  ~aeSignal();
-  
-  aeSignal( T* obj, void ( T::* fn ) () );
-  aeSignal( T* obj, void ( T::* fn ) ( V ) );
-  aeSignal( T* obj, void ( T::* fn ) ( V ), const V& value );
-
-  aeSignal( aeRef< T >& ref, void ( T::* fn ) () );
-  aeSignal( aeRef< T >& ref, void ( T::* fn ) ( V ) );
-  aeSignal( aeRef< T >& ref, void ( T::* fn ) ( V ), const V& value );
-
-  bool Send() override;
-  bool Send( const V& value ) override;
+  static const uint32_t kStorageSize = 48;
+
+  Delegate() = default;
+  //! Binds a member function of \p obj. \p fn can be a member function
+  //! pointer or a lambda, in which case \p obj is only used to identify the
+  //! delegate (see GetObj()).
+  template < typename T, typename Fn > Delegate( T* obj, Fn fn );
+  //! Same as above, but the referenced object is looked up on each call and
+  //! the delegate does nothing once the object is destroyed.
+  template < typename T, typename Fn > Delegate( aeRef< T > ref, Fn fn );
+
+  //! Calls the bound function if it takes no arguments. Returns false if
+  //! nothing was called.
+  bool Call() const;
+  //! Calls the bound function with \p value, or without arguments if the bound
+  //! function doesn't take any. Returns false if nothing was called.
+  bool Call( const V& value ) const;
+
+  //! Returns the bound object, or null if the delegate is empty or its
+  //! referenced object has been destroyed.
+  void* GetObj() const;
+  //! Returns true if a function has been bound
+  explicit operator bool() const { return m_invoke != nullptr; }
 
 private:
-  T* m_obj;
-  aeRef< T > m_ref;
-  
-  void ( T::* m_fn )();
-  void ( T::* m_fnVal )( V );
-
-  bool m_isCalled;
-
-public:
-  // Internal use
-  void* GetObj() override;
+  template < typename O, typename Fn > struct Binding { O obj; Fn fn; };
+  template < typename T > static T* m_Resolve( T* obj ) { return obj; }
+  template < typename T > static T* m_Resolve( const aeRef< T >& ref ) { return const_cast< T* >( (const T*)ref ); }
+  template < typename O, typename Fn > void m_Bind( const O& obj, Fn fn );
+  template < typename O, typename Fn > static bool m_Invoke( const void* storage, const V* value );
+  template < typename O, typename Fn > static void* m_GetObj( const void* storage );
+
+  bool ( *m_invoke )( const void*, const V* ) = nullptr;
+  void* ( *m_getObj )( const void* ) = nullptr;
+  alignas( void* ) uint8_t m_storage[ kStorageSize ];
 };
 
+} // ae end
+
 //------------------------------------------------------------------------------
 // aeSignalList class
 //------------------------------------------------------------------------------
+//! A list of ae::Delegates called in the order they were added. Delegates are
+//! stored contiguously so adding, removing, and sending don't allocate once
+//! the list has grown. It's safe to add or remove delegates while sending,
+//! delegates added during a send won't be called until the next send.
 template < typename V = int32_t >
 class aeSignalList
 {
 public:
-  ~aeSignalList();
-
+  //! Adding the same object more than once replaces its existing delegate
   template < typename T, typename Fn > void Add( T* obj, Fn fn );
   template < typename T, typename Fn > void Add( aeRef< T > ref, Fn fn );
 
   void Remove( void* obj );
   
   void Send();
-  template < typename T > void Send( const T& value );
+  void Send( const V& value );
 
   uint32_t Length() const;
 
 private:
-  ae::Array< aeSignalValue< V >* > m_signals = AE_ALLOC_TAG_FIXME;
+  int32_t m_Find( void* obj ) const;
+  void m_Add( void* obj, const ae::Delegate< V >& delegate );
+  void m_RemoveInvalid();
+
+  ae::Array< ae::Delegate< V > > m_delegates = AE_ALLOC_TAG_FIXME;
+  uint32_t m_sendDepth = 0;
 };
 
 //------------------------------------------------------------------------------
-// aeSignalValue member functions
+// ae::Delegate member functions
 //------------------------------------------------------------------------------
 template < typename V >
-aeSignalValue< V >::aeSignalValue() :
-  m_valSet( false ),
-  m_val( V() )
-{}
+template < typename T, typename Fn >
+ae::Delegate< V >::Delegate( T* obj, Fn fn )
+{
+  m_Bind( obj, fn );
+}
 
 template < typename V >
-aeSignalValue< V >::aeSignalValue( const V& val ) :
-  m_valSet( true ),
-  m_val( val )
-{}
+template < typename T, typename Fn >
+ae::Delegate< V >::Delegate( aeRef< T > ref, Fn fn )
+{
+  m_Bind( ref, fn );
+}
 
-// @TODO: Const
 template < typename V >
-bool aeSignalValue< V >::HasValue()
+bool ae::Delegate< V >::Call() const
 {
-  return m_valSet;
+  return m_invoke ? m_invoke( m_storage, nullptr ) : false;
 }
 
-//------------------------------------------------------------------------------
-// aeSignal member functions
-//------------------------------------------------------------------------------
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal() :
-  m_obj( nullptr ),
-  m_fn( nullptr ),
-  m_fnVal( nullptr ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal( T* obj, void ( T::* fn ) () ) :
-  m_obj( obj ),
-  m_fn( fn ),
-  m_fnVal( nullptr ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal( T* obj, void ( T::* fn ) ( V ) ) :
-  m_obj( obj ),
-  m_fn( nullptr ),
-  m_fnVal( fn ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal( T* obj, void ( T::* fn ) ( V ), const V& value ) :
-  aeSignalValue< V >( value ),
-  m_obj( obj ),
-  m_fn( nullptr ),
-  m_fnVal( fn ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal( aeRef< T >& ref, void ( T::* fn ) () ) :
-  m_obj( nullptr ),
-  m_ref( ref ),
-  m_fn( fn ),
-  m_fnVal( nullptr ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal( aeRef< T >& ref, void ( T::* fn ) ( V ) ) :
-  m_obj( nullptr ),
-  m_ref( ref ),
-  m_fn( nullptr ),
-  m_fnVal( fn ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::aeSignal( aeRef< T >& ref, void ( T::* fn ) ( V ), const V& value ) :
-  aeSignalValue< V >( value ),
-  m_obj( nullptr ),
-  m_ref( ref ),
-  m_fn( nullptr ),
-  m_fnVal( fn ),
-  m_isCalled( false )
-{}
-
-template < typename T, typename V >
-aeSignal< T, V >::~aeSignal()
+template < typename V >
+bool ae::Delegate< V >::Call( const V& value ) const
 {
-  AE_ASSERT_MSG( !m_isCalled, "Signal call destroyed itself" );
+  return m_invoke ? m_invoke( m_storage, &value ) : false;
 }
 
-template < typename T, typename V >
-bool aeSignal< T, V >::Send()
+template < typename V >
+void* ae::Delegate< V >::GetObj() const
 {
-  AE_ASSERT_MSG( !m_isCalled, "aeSignal::Send() called recursively" );
+  return m_getObj ? m_getObj( m_storage ) : nullptr;
+}
 
-  T* obj = m_obj;
-  obj = obj ? obj : (T*)m_ref;
+template < typename V >
+template < typename O, typename Fn >
+void ae::Delegate< V >::m_Bind( const O& obj, Fn fn )
+{
+  typedef Binding< O, Fn > B;
+  static_assert( sizeof( B ) <= kStorageSize, "Bound function is too large for ae::Delegate storage" );
+  static_assert( alignof( B ) <= alignof( void* ), "Bound function alignment is too large for ae::Delegate storage" );
+  static_assert( std::is_trivially_copyable< Fn >::value, "ae::Delegate lambda captures must be trivially copyable" );
+  static_assert( std::is_trivially_copyable< B >::value, "ae::Delegate bindings must be trivially copyable" );
+  new ( m_storage ) B{ obj, fn };
+  m_invoke = &m_Invoke< O, Fn >;
+  m_getObj = &m_GetObj< O, Fn >;
+}
 
+template < typename V >
+template < typename O, typename Fn >
+bool ae::Delegate< V >::m_Invoke( const void* storage, const V* value )
+{
+  const Binding< O, Fn >* binding = (const Binding< O, Fn >*)storage;
+  auto* obj = m_Resolve( binding->obj );
   if ( !obj )
   {
     return false;
   }
-
-  if ( m_fn )
+  if constexpr ( std::is_member_function_pointer< Fn >::value )
   {
-    m_isCalled = true;
-
-    ( obj->*m_fn )();
-
-    m_isCalled = false;
-    return true;
-  }
-  else if ( m_fnVal && aeSignalValue< V >::m_valSet )
-  {
-    m_isCalled = true;
-
-    ( obj->*m_fnVal )( aeSignalValue< V >::m_val );
-
-    m_isCalled = false;
-    return true;
+    if constexpr ( std::is_invocable< Fn, decltype( obj ), V >::value )
+    {
+      if ( !value )
+      {
+        return false;
+      }
+      ( obj->*binding->fn )( *value );
+    }
+    else
+    {
+      ( obj->*binding->fn )();
+    }
   }
   else
   {
-    return false;
-  }
-}
-
-template < typename T, typename V >
-bool aeSignal< T, V >::Send( const V& value )
-{
-  AE_ASSERT_MSG( !m_isCalled, "aeSignal::Send() called recursively" );
-
-  T* obj = m_obj;
-  obj = obj ? obj : (T*)m_ref;
-  
-  if ( !obj || !m_fnVal )
-  {
-    return false;
+    Fn fn = binding->fn; // Lambdas are called on a copy, so they can't be const
+    if constexpr ( std::is_invocable< Fn, V >::value )
+    {
+      if ( !value )
+      {
+        return false;
+      }
+      fn( *value );
+    }
+    else
+    {
+      fn();
+    }
   }
-
-  m_isCalled = true;
-
-  ( obj->*m_fnVal )( value );
-
-  m_isCalled = false;
   return true;
 }
 
-// @TODO: Const
-template < typename T, typename V >
-void* aeSignal< T, V >::GetObj()
+template < typename V >
+template < typename O, typename Fn >
+void* ae::Delegate< V >::m_GetObj( const void* storage )
 {
-  T* obj = m_obj;
-  obj = obj ? obj : (T*)m_ref;
-  return obj;
+  return m_Resolve( ( (const Binding< O, Fn >*)storage )->obj );
 }
 
 //------------------------------------------------------------------------------
 // aeSignalList member functions
 //------------------------------------------------------------------------------
-template < typename V >
-aeSignalList< V >::~aeSignalList()
-{
-  for ( uint32_t i = 0; i < m_signals.Length(); i++ )
-  {
-    ae::Delete( m_signals[ i ] );
-  }
-}
-
 template < typename V >
 template < typename T, typename Fn >
 void aeSignalList< V >::Add( T* obj, Fn fn )
@@ -305,20 +224,7 @@ void aeSignalList< V >::Add( T* obj, Fn fn )
   {
     return;
   }
-
-  auto findFn = [ obj ]( aeSignalBase* signal )
-  {
-    // @HACK: Should also check fn, so an object can register multiple functions at a time
-    return signal->GetObj() == obj;
-  };
-  int32_t signalIndex = m_signals.FindFn( findFn );
-  if ( signalIndex >= 0 )
-  {
-    *m_signals[ signalIndex ] = aeSignal< T, V >( obj, fn );
-    return;
-  }
-
-  m_signals.Append( ae::New< aeSignal< T, V > >( AE_ALLOC_TAG_FIXME, obj, fn ) );
+  m_Add( obj, ae::Delegate< V >( obj, fn ) );
 }
 
 template < typename V >
@@ -330,91 +236,95 @@ void aeSignalList< V >::Add( aeRef< T > ref, Fn fn )
   {
     return;
   }
-
-  auto findFn = [ obj ]( aeSignalBase* signal )
-  {
-    // @HACK: Should also check fn, so an object can register multiple functions at a time
-    return signal->GetObj() == obj;
-  };
-  int32_t signalIndex = m_signals.FindFn( findFn );
-  if ( signalIndex >= 0 )
-  {
-    *m_signals[ signalIndex ] = aeSignal< T, V >( ref, fn );
-    return;
-  }
-
-  m_signals.Append( ae::New< aeSignal< T, V > >( AE_ALLOC_TAG_FIXME, ref, fn ) );
+  m_Add( obj, ae::Delegate< V >( ref, fn ) );
 }
 
 template < typename V >
 void aeSignalList< V >::Remove( void* obj )
 {
-  auto fn = [ obj ]( aeSignalBase* base )
-  {
-    void* o = base->GetObj();
-    return !o || ( o == obj );
-  };
-
-  int32_t index = 0;
-  while ( ( index = m_signals.FindFn( fn ) ) >= 0 )
+  for ( uint32_t i = 0; i < m_delegates.Length(); i++ )
   {
-    ae::Delete( m_signals[ index ] );
-    m_signals.Remove( index ); // Remove signals for the given obj and any signals with null references
+    void* o = m_delegates[ i ].GetObj();
+    if ( !o || ( o == obj ) )
+    {
+      // Remove signals for the given obj and any signals with null references
+      m_delegates[ i ] = ae::Delegate< V >();
+    }
   }
+  m_RemoveInvalid();
 }
 
 template < typename V >
 void aeSignalList< V >::Send()
 {
-  auto fn = []( aeSignalBase* signal )
+  m_RemoveInvalid();
+  m_sendDepth++;
+  // Only send to delegates that existed at the start of this send. Delegates
+  // are copied before calling because the array can grow during the call.
+  const uint32_t length = m_delegates.Length();
+  for ( uint32_t i = 0; i < length; i++ )
   {
-    return !signal->GetObj();
-  };
-
-  int32_t index = 0;
-  while ( ( index = m_signals.FindFn( fn ) ) >= 0 )
-  {
-    ae::Delete( m_signals[ index ] );
-    m_signals.Remove( index ); // Remove null references before send
+    ae::Delegate< V > delegate = m_delegates[ i ];
+    delegate.Call();
   }
+  m_sendDepth--;
+  m_RemoveInvalid();
+}
 
-  for ( uint32_t i = 0; i < m_signals.Length(); i++ )
+template < typename V >
+void aeSignalList< V >::Send( const V& value )
+{
+  m_RemoveInvalid();
+  m_sendDepth++;
+  const uint32_t length = m_delegates.Length();
+  for ( uint32_t i = 0; i < length; i++ )
   {
-    aeSignalValue< V >* signal = m_signals[ i ];
-    ((aeSignalBase*)signal)->Send();
+    ae::Delegate< V > delegate = m_delegates[ i ];
+    delegate.Call( value );
   }
+  m_sendDepth--;
+  m_RemoveInvalid();
 }
 
 template < typename V >
-template < typename T >
-void aeSignalList< V >::Send( const T& value )
+uint32_t aeSignalList< V >::Length() const
 {
-  auto fn = []( aeSignalBase* signal )
-  {
-    return !signal->GetObj();
-  };
+  return m_delegates.Length();
+}
 
-  int32_t index = -1;
-  while ( ( index = m_signals.FindFn( fn ) ) >= 0 )
+template < typename V >
+int32_t aeSignalList< V >::m_Find( void* obj ) const
+{
+  // @HACK: Should also check fn, so an object can register multiple functions at a time
+  return m_delegates.FindFn( [ obj ]( const ae::Delegate< V >& d ){ return d.GetObj() == obj; } );
+}
+
+template < typename V >
+void aeSignalList< V >::m_Add( void* obj, const ae::Delegate< V >& delegate )
+{
+  int32_t index = m_Find( obj );
+  if ( index >= 0 )
   {
-    ae::Delete( m_signals[ index ] );
-    m_signals.Remove( index ); // Remove null references before send
+    m_delegates[ index ] = delegate;
   }
-
-  for ( uint32_t i = 0; i < m_signals.Length(); i++ )
+  else
   {
-    aeSignalValue< V >* signal = m_signals[ i ];
-    if ( !signal->Send( value ) )
-    {
-      ((aeSignalBase*)signal)->Send();
-    }
+    m_delegates.Append( delegate );
   }
 }
 
 template < typename V >
-uint32_t aeSignalList< V >::Length() const
+void aeSignalList< V >::m_RemoveInvalid()
 {
-  return m_signals.Length();
+  if ( m_sendDepth )
+  {
+    // Delegates removed during a send are left empty until the send completes
+    // so indices and call order stay stable
+    return;
+  }
+  // Removes cleared delegates and delegates whose referenced objects have been
+  // destroyed. RemoveAllFn() preserves order.
+  m_delegates.RemoveAllFn( []( const ae::Delegate< V >& d ){ return !d.GetObj(); } );
 }
 
 #endif
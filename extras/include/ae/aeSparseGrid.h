@@ -58,8 +58,8 @@ template < typename Z >
 class aeSparseGrid
 {
 public:
-  aeSparseGrid() {}
-  aeSparseGrid( aeInitInfo< Z > initInfo ) : m_initInfo( initInfo ) {}
+  aeSparseGrid() { m_InitSize(); }
+  aeSparseGrid( aeInitInfo< Z > initInfo ) : m_initInfo( initInfo ) { m_InitSize(); }
   ~aeSparseGrid() { Clear(); }
 
   void Reset( const aeInitInfo< Z >& initInfo ) { Clear(); m_initInfo = initInfo; }
@@ -69,6 +69,13 @@ public:
   typename Z::GridType* TryGet( ae::Int3 pos );
   const typename Z::GridType* TryGet( ae::Int3 pos ) const;
 
+  // Calls fn( ae::Int3 pos, GridType& value ) for each cell within the inclusive
+  // range min to max. Each zone is looked up once. Cells in zones that haven't
+  // been created with Set() are skipped. Cells are visited zone by zone, and
+  // then z, y, x order within each zone.
+  template < typename Fn > void ForEachInBox( ae::Int3 min, ae::Int3 max, Fn fn );
+  template < typename Fn > void ForEachInBox( ae::Int3 min, ae::Int3 max, Fn fn ) const;
+
   uint32_t Length() const;
   Z* GetZone( uint32_t i );
   const Z* GetZone( uint32_t i ) const;
@@ -79,36 +86,103 @@ private:
   aeSparseGrid( const aeSparseGrid& ) = delete;
   aeSparseGrid& operator=( const aeSparseGrid& ) = delete;
 
+  void m_InitSize();
   ae::Int3 m_GetSlot( ae::Int3 pos ) const;
   ae::Int3 m_GetLocal( ae::Int3 pos ) const;
+  aeInitializer< Z >* m_FindZone( ae::Int3 slot ) const;
+  aeInitializer< Z >* m_FindZoneCached( ae::Int3 slot );
+  template < typename G, typename Fn > static void m_ForEachInBox( G* grid, ae::Int3 min, ae::Int3 max, Fn& fn );
 
   aeInitInfo< Z > m_initInfo;
   ae::Map< ae::Int3, aeInitializer< Z >* > m_zones = AE_ALLOC_TAG_FIXME;
+  // Zone dimensions are cached. Shifts and masks are used for power of two
+  // sizes, otherwise m_shift is -1 and integer division is used.
+  ae::Int3 m_size;
+  ae::Int3 m_shift;
+  ae::Int3 m_mask;
+  // The most recently accessed zone by non-const functions. Const functions
+  // don't update this so they can be called from multiple threads.
+  ae::Int3 m_lastSlot = ae::Int3( 0 );
+  aeInitializer< Z >* m_lastZone = nullptr;
 };
 
 //------------------------------------------------------------------------------
 // aeSparseGrid member functions
 //------------------------------------------------------------------------------
+template < typename Z >
+void aeSparseGrid< Z >::m_InitSize()
+{
+  m_size = Z::GetSize();
+  for ( uint32_t i = 0; i < 3; i++ )
+  {
+    const int32_t size = m_size[ i ];
+    AE_ASSERT( size > 0 );
+    m_shift[ i ] = -1;
+    m_mask[ i ] = 0;
+    if ( ( size & ( size - 1 ) ) == 0 )
+    {
+      int32_t shift = 0;
+      while ( ( 1 << shift ) < size ) { shift++; }
+      m_shift[ i ] = shift;
+      m_mask[ i ] = size - 1;
+    }
+  }
+}
+
 template < typename Z >
 ae::Int3 aeSparseGrid< Z >::m_GetSlot( ae::Int3 pos ) const
 {
-  const ae::Int3 size = Z::GetSize();
-  return ae::Int3(
-    ae::Floor( (float)pos.x / size.x ),
-    ae::Floor( (float)pos.y / size.y ),
-    ae::Floor( (float)pos.z / size.z )
-  );
+  ae::Int3 slot;
+  for ( uint32_t i = 0; i < 3; i++ )
+  {
+    const int32_t v = pos[ i ];
+    if ( m_shift[ i ] >= 0 )
+    {
+      slot[ i ] = v >> m_shift[ i ]; // Arithmetic shift rounds towards negative infinity
+    }
+    else
+    {
+      const int32_t size = m_size[ i ];
+      const int32_t q = v / size;
+      slot[ i ] = ( q * size != v && v < 0 ) ? q - 1 : q; // Floor
+    }
+  }
+  return slot;
 }
 
 template < typename Z >
 ae::Int3 aeSparseGrid< Z >::m_GetLocal( ae::Int3 pos ) const
 {
-  const ae::Int3 size = Z::GetSize();
-  return ae::Int3(
-    ae::Mod( pos.x, size.x ),
-    ae::Mod( pos.y, size.y ),
-    ae::Mod( pos.z, size.z )
-  );
+  ae::Int3 local;
+  for ( uint32_t i = 0; i < 3; i++ )
+  {
+    local[ i ] = ( m_shift[ i ] >= 0 ) ? ( pos[ i ] & m_mask[ i ] ) : ae::Mod( pos[ i ], m_size[ i ] );
+  }
+  return local;
+}
+
+template < typename Z >
+aeInitializer< Z >* aeSparseGrid< Z >::m_FindZone( ae::Int3 slot ) const
+{
+  aeInitializer< Z >* zone = nullptr;
+  m_zones.TryGet( slot, &zone );
+  return zone;
+}
+
+template < typename Z >
+aeInitializer< Z >* aeSparseGrid< Z >::m_FindZoneCached( ae::Int3 slot )
+{
+  if ( m_lastZone && m_lastSlot == slot )
+  {
+    return m_lastZone;
+  }
+  aeInitializer< Z >* zone = m_FindZone( slot );
+  if ( zone )
+  {
+    m_lastSlot = slot;
+    m_lastZone = zone;
+  }
+  return zone;
 }
 
 template < typename Z >
@@ -120,19 +194,21 @@ void aeSparseGrid< Z >::Clear()
     ae::Delete( m_zones.GetValue( i ) );
   }
   m_zones.Clear();
+  m_lastZone = nullptr;
 }
 
 template < typename Z >
 void aeSparseGrid< Z >::Set( ae::Int3 pos, const typename Z::GridType& value )
 {
   ae::Int3 slot = m_GetSlot( pos );
-  aeInitializer< Z >* zone = nullptr;
-  if ( !m_zones.TryGet( slot, &zone ) )
+  aeInitializer< Z >* zone = m_FindZoneCached( slot );
+  if ( !zone )
   {
-    const ae::Int3 size = Z::GetSize();
     zone = ae::New< aeInitializer< Z > >( AE_ALLOC_TAG_FIXME, m_initInfo );
-    zone->Get().SetZoneInfo( slot * size );
+    zone->Get().SetZoneInfo( slot * m_size );
     m_zones.Set( slot, zone );
+    m_lastSlot = slot;
+    m_lastZone = zone;
   }
 
   ae::Int3 localPos = m_GetLocal( pos );
@@ -143,10 +219,7 @@ void aeSparseGrid< Z >::Set( ae::Int3 pos, const typename Z::GridType& value )
 template < typename Z >
 typename Z::GridType* aeSparseGrid< Z >::TryGet( ae::Int3 pos )
 {
-  ae::Int3 slot = m_GetSlot( pos );
-
-  aeInitializer< Z >* zone = nullptr;
-  if ( m_zones.TryGet( slot, &zone ) )
+  if ( aeInitializer< Z >* zone = m_FindZoneCached( m_GetSlot( pos ) ) )
   {
     ae::Int3 localPos = m_GetLocal( pos );
     return &zone->Get().Get( localPos );
@@ -158,10 +231,7 @@ typename Z::GridType* aeSparseGrid< Z >::TryGet( ae::Int3 pos )
 template < typename Z >
 const typename Z::GridType* aeSparseGrid< Z >::TryGet( ae::Int3 pos ) const
 {
-  ae::Int3 slot = m_GetSlot( pos );
-
-  aeInitializer< Z >* zone = nullptr;
-  if ( m_zones.TryGet( slot, &zone ) )
+  if ( const aeInitializer< Z >* zone = m_FindZone( m_GetSlot( pos ) ) )
   {
     ae::Int3 localPos = m_GetLocal( pos );
     return &zone->Get().Get( localPos );
@@ -170,6 +240,52 @@ const typename Z::GridType* aeSparseGrid< Z >::TryGet( ae::Int3 pos ) const
   return nullptr;
 }
 
+template < typename Z >
+template < typename Fn >
+void aeSparseGrid< Z >::ForEachInBox( ae::Int3 min, ae::Int3 max, Fn fn )
+{
+  m_ForEachInBox( this, min, max, fn );
+}
+
+template < typename Z >
+template < typename Fn >
+void aeSparseGrid< Z >::ForEachInBox( ae::Int3 min, ae::Int3 max, Fn fn ) const
+{
+  m_ForEachInBox( this, min, max, fn );
+}
+
+template < typename Z >
+template < typename G, typename Fn >
+void aeSparseGrid< Z >::m_ForEachInBox( G* grid, ae::Int3 min, ae::Int3 max, Fn& fn )
+{
+  const ae::Int3 size = grid->m_size;
+  const ae::Int3 slotMin = grid->m_GetSlot( min );
+  const ae::Int3 slotMax = grid->m_GetSlot( max );
+  ae::Int3 slot;
+  for ( slot.z = slotMin.z; slot.z <= slotMax.z; slot.z++ )
+  for ( slot.y = slotMin.y; slot.y <= slotMax.y; slot.y++ )
+  for ( slot.x = slotMin.x; slot.x <= slotMax.x; slot.x++ )
+  {
+    // Zone is const when G is const so the matching Z::Get() is called
+    auto* zone = grid->m_FindZone( slot );
+    if ( !zone )
+    {
+      continue;
+    }
+    typename std::conditional< std::is_const< G >::value, const Z&, Z& >::type z = zone->Get();
+    const ae::Int3 zoneMin = slot * size;
+    const ae::Int3 localMin( std::max( min.x - zoneMin.x, 0 ), std::max( min.y - zoneMin.y, 0 ), std::max( min.z - zoneMin.z, 0 ) );
+    const ae::Int3 localMax( std::min( max.x - zoneMin.x, size.x - 1 ), std::min( max.y - zoneMin.y, size.y - 1 ), std::min( max.z - zoneMin.z, size.z - 1 ) );
+    ae::Int3 local;
+    for ( local.z = localMin.z; local.z <= localMax.z; local.z++ )
+    for ( local.y = localMin.y; local.y <= localMax.y; local.y++ )
+    for ( local.x = localMin.x; local.x <= localMax.x; local.x++ )
+    {
+      fn( zoneMin + local, z.Get( local ) );
+    }
+  }
+}
+
 template < typename Z >
 uint32_t aeSparseGrid< Z >::Length() const
 {
@@ -191,18 +307,14 @@ const Z* aeSparseGrid< Z >::GetZone( uint32_t i ) const
 template < typename Z >
 Z* aeSparseGrid< Z >::GetZone( ae::Int3 pos )
 {
-  ae::Int3 slot = m_GetSlot( pos );
-  aeInitializer< Z >* zone = nullptr;
-  m_zones.TryGet( slot, &zone );
+  aeInitializer< Z >* zone = m_FindZoneCached( m_GetSlot( pos ) );
   return zone ? &zone->Get() : nullptr;
 }
 
 template < typename Z >
 const Z* aeSparseGrid< Z >::GetZone( ae::Int3 pos ) const
 {
-  ae::Int3 slot = m_GetSlot( pos );
-  aeInitializer< Z >* zone = nullptr;
-  m_zones.TryGet( slot, &zone );
+  const aeInitializer< Z >* zone = m_FindZone( m_GetSlot( pos ) );
   return zone ? &zone->Get() : nullptr;
 }
 
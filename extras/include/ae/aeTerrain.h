@@ -127,6 +127,8 @@ const uint32_t kMaxLoadedChunks = kMaxActiveChunks * 2;
 const VertexCount kMaxChunkVerts = VertexCount( ae::MaxValue< uint16_t >() );
 // https://math.stackexchange.com/questions/1879255/average-valence-of-vertex-in-tetrahedral-mesh
 const uint32_t kMaxChunkIndices = uint32_t( kMaxChunkVerts ) * 6; // Average vertex valence
+const uint32_t kPageVertexCount = uint32_t( kMaxChunkVerts ) * 4; // Render page size, shared by many chunks
+const uint32_t kPageIndexCount = kMaxChunkIndices * 4;
 const uint32_t kMaxChunkAllocationsPerTick = 1;
 const aeFloat16 kSkyBrightness = aeFloat16( 5.0f );
 const float kSdfBoundary = 2.0f;
@@ -452,13 +454,16 @@ struct TerrainChunk
   ae::AABB GetAABB() const;
   static ae::AABB GetAABB( ae::Int3 chunkPos );
 
-  void m_SetVertexData( const TerrainVertex* verts, const TerrainIndex* indices, VertexCount vertexCount, uint32_t indexCount );
-  
   uint32_t m_check;
   ae::Int3 m_pos;
   bool m_geoDirty;
   bool m_lightDirty;
-  ae::VertexBuffer m_data;
+  // Location of the chunks vertex data in the Terrain render pages
+  int32_t m_page = -1;
+  uint32_t m_vertexStart = 0;
+  uint32_t m_vertexCount = 0;
+  uint32_t m_indexStart = 0;
+  uint32_t m_indexCount = 0;
   ae::CollisionMesh<> m_mesh = AE_ALLOC_TAG_TERRAIN;
   ae::ListNode< TerrainChunk > m_generatedList;
   
@@ -483,6 +488,10 @@ public:
   void Terminate();
   void Update( ae::Vec3 center, float radius );
   void Render( const class ae::Shader* shader, const ae::UniformList& shaderParams );
+  // Only draws chunks inside the frustum, ordered front to back from viewPos
+  void Render( const class ae::Shader* shader, const ae::UniformList& shaderParams, const ae::Frustum& frustum, ae::Vec3 viewPos );
+  uint32_t GetRenderedChunkCount() const { return m_renderedChunkCount; }
+  uint32_t GetRenderPageCount() const { return m_pages.Length(); }
 
   void SetParams( const TerrainParams& params );
   void GetParams( TerrainParams* outParams );
@@ -523,6 +532,35 @@ private:
   void FreeChunk( TerrainChunk* chunk );
   void m_SetVertexCount( uint32_t chunkIndex, VertexCount count );
   float GetChunkScore( ae::Int3 pos ) const;
+  void m_Render( const class ae::Shader* shader, const ae::UniformList& shaderParams, const ae::Frustum* frustum, ae::Vec3 viewPos );
+
+  // Render pages
+  // @NOTE: Chunk meshes are packed into a few large vertex buffers so all
+  // visible chunks in a page are drawn with a single bind
+  struct PageRange
+  {
+    uint32_t start;
+    uint32_t count;
+  };
+  struct Page
+  {
+    ae::VertexBuffer data;
+    ae::Array< PageRange > freeVertices = AE_ALLOC_TAG_TERRAIN;
+    ae::Array< PageRange > freeIndices = AE_ALLOC_TAG_TERRAIN;
+  };
+  struct ChunkDraw
+  {
+    uint64_t key; // Page in high bits, distance in low bits
+    const TerrainChunk* chunk;
+  };
+  void m_SetVertexData( TerrainChunk* chunk, const TerrainVertex* verts, const TerrainIndex* indices, VertexCount vertexCount, uint32_t indexCount );
+  void m_FreeVertexData( TerrainChunk* chunk );
+  static int32_t m_AllocRange( ae::Array< PageRange >* ranges, uint32_t count );
+  static void m_FreeRange( ae::Array< PageRange >* ranges, uint32_t start, uint32_t count );
+  ae::Array< Page* > m_pages = AE_ALLOC_TAG_TERRAIN;
+  ae::Array< ChunkDraw > m_chunkDraws = AE_ALLOC_TAG_TERRAIN;
+  ae::Array< uint32_t > m_pageIndices = AE_ALLOC_TAG_TERRAIN; // Chunk indices offset by their position in the page
+  uint32_t m_renderedChunkCount = 0;
 
   TerrainParams m_params;
 
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+// AABBTreeTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+namespace
+{
+	struct TestBox
+	{
+		ae::AABB aabb;
+		int32_t proxy = -1;
+	};
+
+	ae::AABB GetRandomAABB( uint64_t& seed )
+	{
+		const ae::Vec3 center( ae::Random( -50.0f, 50.0f, seed ), ae::Random( -50.0f, 50.0f, seed ), ae::Random( -50.0f, 50.0f, seed ) );
+		const ae::Vec3 halfSize( ae::Random( 0.1f, 2.0f, seed ), ae::Random( 0.1f, 2.0f, seed ), ae::Random( 0.1f, 2.0f, seed ) );
+		return ae::AABB( center - halfSize, center + halfSize );
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::AABBTree tests
+//------------------------------------------------------------------------------
+TEST_CASE( "aabb tree query matches brute force", "[AABBTree]" )
+{
+	uint64_t seed = 1234;
+	ae::AABBTree tree( AE_ALLOC_TAG_FIXME, 0.0f );
+	TestBox boxes[ 500 ];
+	for ( TestBox& box : boxes )
+	{
+		box.aabb = GetRandomAABB( seed );
+		box.proxy = tree.Add( box.aabb, &box );
+	}
+	REQUIRE( tree.GetCount() == 500 );
+	REQUIRE( tree.GetHeight() < 20 );
+
+	// Move and remove some boxes
+	for ( uint32_t i = 0; i < 200; i++ )
+	{
+		TestBox& box = boxes[ i ];
+		box.aabb = GetRandomAABB( seed );
+		REQUIRE( tree.Set( box.proxy, box.aabb ) );
+	}
+	for ( uint32_t i = 200; i < 300; i++ )
+	{
+		tree.Remove( boxes[ i ].proxy );
+		boxes[ i ].proxy = -1;
+	}
+	REQUIRE( tree.GetCount() == 400 );
+	REQUIRE( tree.GetHeight() < 20 );
+
+	for ( uint32_t i = 0; i < 50; i++ )
+	{
+		const ae::AABB query = GetRandomAABB( seed );
+		uint32_t expected = 0;
+		for ( const TestBox& box : boxes )
+		{
+			expected += ( box.proxy >= 0 && box.aabb.Intersect( query ) ) ? 1 : 0;
+		}
+		uint32_t found = 0;
+		tree.Query( query, [&]( int32_t proxy, void* userData )
+		{
+			const TestBox* box = (const TestBox*)userData;
+			REQUIRE( box->proxy == proxy );
+			REQUIRE( box->aabb.Intersect( query ) );
+			found++;
+		} );
+		REQUIRE( found == expected );
+	}
+}
+
+TEST_CASE( "aabb tree only reinserts proxies that leave their margin", "[AABBTree]" )
+{
+	ae::AABBTree tree( AE_ALLOC_TAG_FIXME, 0.5f );
+	const int32_t proxy = tree.Add( ae::AABB( ae::Vec3( 0.0f ), ae::Vec3( 1.0f ) ), nullptr );
+	REQUIRE( tree.GetAABB( proxy ).GetMin() == ae::Vec3( -0.5f ) );
+	REQUIRE( tree.GetAABB( proxy ).GetMax() == ae::Vec3( 1.5f ) );
+	REQUIRE( !tree.Set( proxy, ae::AABB( ae::Vec3( 0.25f ), ae::Vec3( 1.25f ) ) ) );
+	REQUIRE( tree.Set( proxy, ae::AABB( ae::Vec3( 1.0f ), ae::Vec3( 2.0f ) ) ) );
+	REQUIRE( tree.GetAABB( proxy ).GetMin() == ae::Vec3( 0.5f ) );
+	tree.Remove( proxy );
+	REQUIRE( tree.GetCount() == 0 );
+	REQUIRE( tree.GetHeight() == 0 );
+}
+
+TEST_CASE( "aabb tree raycast finds the nearest hit", "[AABBTree]" )
+{
+	uint64_t seed = 5678;
+	ae::AABBTree tree( AE_ALLOC_TAG_FIXME, 0.0f );
+	TestBox boxes[ 500 ];
+	for ( TestBox& box : boxes )
+	{
+		box.aabb = GetRandomAABB( seed );
+		box.proxy = tree.Add( box.aabb, &box );
+	}
+
+	uint32_t hitCount = 0;
+	for ( uint32_t i = 0; i < 100; i++ )
+	{
+		const ae::Vec3 source( ae::Random( -60.0f, 60.0f, seed ), ae::Random( -60.0f, 60.0f, seed ), -60.0f );
+		const ae::Vec3 target( ae::Random( -60.0f, 60.0f, seed ), ae::Random( -60.0f, 60.0f, seed ), 60.0f );
+		const ae::Vec3 ray = target - source;
+
+		const TestBox* expected = nullptr;
+		float expectedT = 1.0f;
+		for ( const TestBox& box : boxes )
+		{
+			float t;
+			if ( box.aabb.IntersectRay( source, ray, nullptr, nullptr, &t ) && t < expectedT )
+			{
+				expected = &box;
+				expectedT = t;
+			}
+		}
+
+		const TestBox* closest = nullptr;
+		float closestT = 1.0f;
+		uint32_t visited = 0;
+		tree.Raycast( source, ray, [&]( int32_t, void* userData )
+		{
+			visited++;
+			const TestBox* box = (const TestBox*)userData;
+			float t;
+			if ( box->aabb.IntersectRay( source, ray, nullptr, nullptr, &t ) && t < closestT )
+			{
+				closest = box;
+				closestT = t;
+			}
+			return closestT;
+		} );
+		REQUIRE( closest == expected );
+		REQUIRE( visited < 100 );
+		hitCount += expected ? 1 : 0;
+	}
+	REQUIRE( hitCount > 0 );
+}
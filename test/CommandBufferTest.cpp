@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+// CommandBufferTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+#include <unordered_map>
+
+//------------------------------------------------------------------------------
+// ae::CommandBuffer tests
+//------------------------------------------------------------------------------
+TEST_CASE( "command buffers sort by layer then state", "[CommandBuffer]" )
+{
+	ae::Shader shaderA, shaderB;
+	ae::VertexArray vertsA = AE_ALLOC_TAG_FIXME;
+	ae::VertexArray vertsB = AE_ALLOC_TAG_FIXME;
+	const ae::UniformId u_color = "u_color";
+	ae::UniformList red, blue;
+	red.Set( u_color, ae::Vec4( 1.0f, 0.0f, 0.0f, 1.0f ) );
+	blue.Set( u_color, ae::Vec4( 0.0f, 0.0f, 1.0f, 1.0f ) );
+
+	ae::CommandBuffer commands = AE_ALLOC_TAG_FIXME;
+	commands.Draw( 1, &vertsA, &shaderA, red, 0, 1 ); // 0
+	commands.Draw( 0, &vertsB, &shaderB, blue, 1, 1 ); // 1
+	commands.Draw( 0, &vertsA, &shaderA, red, 2, 1 ); // 2
+	commands.Draw( 0, &vertsB, &shaderB, blue, 3, 1 ); // 3
+	commands.Draw( 0, &vertsA, &shaderA, blue, 4, 1 ); // 4
+	commands.Draw( 0, &vertsA, &shaderA, red, 5, 0 ); // Empty, not recorded
+	REQUIRE( commands.GetCommandCount() == 5 );
+	REQUIRE( commands.GetUniformsCount() == 2 );
+
+	commands.Sort();
+	// Grouped by shader and vertex array in the order first seen, recording
+	// order is kept for identical state
+	const uint32_t expected[] = { 2, 4, 1, 3, 0 };
+	for ( uint32_t i = 0; i < countof( expected ); i++ )
+	{
+		REQUIRE( commands.GetCommand( i ).primitiveStart == expected[ i ] );
+	}
+	REQUIRE( commands.GetCommand( 0 ).bind );
+	REQUIRE( commands.GetCommand( 1 ).bind ); // Uniforms changed
+	REQUIRE( commands.GetCommand( 2 ).bind );
+	REQUIRE( !commands.GetCommand( 3 ).bind );
+	REQUIRE( commands.GetCommand( 4 ).bind ); // Next layer, state differs
+	REQUIRE( commands.GetBindCount() == 4 );
+
+	const ae::UniformList& uniforms = commands.GetUniforms( commands.GetCommand( 1 ).uniformsIndex );
+	REQUIRE( uniforms.Get( u_color )->value.data[ 2 ] == 1.0f );
+
+	commands.Clear();
+	REQUIRE( commands.GetCommandCount() == 0 );
+	REQUIRE( commands.GetUniformsCount() == 0 );
+}
+
+TEST_CASE( "command buffers keep uniform lists with the same hash separate", "[CommandBuffer]" )
+{
+	// Search for two different values that give the lists the same hash
+	const ae::UniformId u_value = "u_value";
+	std::unordered_map< uint32_t, ae::Vec2 > hashes;
+	ae::Vec2 values[ 2 ] = { ae::Vec2( 0.0f ), ae::Vec2( 0.0f ) };
+	for ( uint32_t i = 0; i < 400000; i++ )
+	{
+		ae::UniformList uniforms;
+		const ae::Vec2 value( (float)i, (float)( i % 1000 ) );
+		uniforms.Set( u_value, value );
+		auto result = hashes.emplace( uniforms.GetHash().Get(), value );
+		if ( !result.second )
+		{
+			values[ 0 ] = result.first->second;
+			values[ 1 ] = value;
+			break;
+		}
+	}
+	REQUIRE( values[ 0 ] != values[ 1 ] );
+	ae::UniformList a, b;
+	a.Set( u_value, values[ 0 ] );
+	b.Set( u_value, values[ 1 ] );
+	REQUIRE( a.GetHash() == b.GetHash() );
+	REQUIRE( a != b );
+
+	ae::Shader shader;
+	ae::VertexArray verts = AE_ALLOC_TAG_FIXME;
+	ae::CommandBuffer commands = AE_ALLOC_TAG_FIXME;
+	commands.Draw( 0, &verts, &shader, a, 0, 1 );
+	commands.Draw( 0, &verts, &shader, b, 1, 1 );
+	commands.Draw( 0, &verts, &shader, b, 2, 1 );
+	REQUIRE( commands.GetUniformsCount() == 2 );
+	REQUIRE( commands.GetUniforms( commands.GetCommand( 0 ).uniformsIndex ).Get( u_value )->value.data[ 0 ] == values[ 0 ].x );
+	REQUIRE( commands.GetUniforms( commands.GetCommand( 1 ).uniformsIndex ).Get( u_value )->value.data[ 0 ] == values[ 1 ].x );
+	REQUIRE( commands.GetCommand( 2 ).uniformsIndex == commands.GetCommand( 1 ).uniformsIndex );
+}
+
+TEST_CASE( "command buffers recorded on separate threads can be merged", "[CommandBuffer]" )
+{
+	const uint32_t kThreadCount = 4;
+	const uint32_t kDrawCount = 1000;
+	ae::Shader shaders[ 2 ];
+	ae::VertexArray verts = AE_ALLOC_TAG_FIXME;
+	ae::Array< ae::CommandBuffer > buffers( AE_ALLOC_TAG_FIXME );
+	for ( uint32_t i = 0; i < kThreadCount; i++ )
+	{
+		buffers.Append( AE_ALLOC_TAG_FIXME );
+	}
+
+	std::vector< std::thread > threads;
+	for ( uint32_t i = 0; i < kThreadCount; i++ )
+	{
+		threads.emplace_back( [ &, i ]()
+		{
+			const ae::UniformId u_index = "u_index";
+			for ( uint32_t j = 0; j < kDrawCount; j++ )
+			{
+				ae::UniformList uniforms;
+				uniforms.Set( u_index, (float)( j % 8 ) );
+				buffers[ i ].Draw( 0, &verts, &shaders[ j % 2 ], uniforms, i * kDrawCount + j, 1 );
+			}
+		} );
+	}
+	for ( std::thread& thread : threads )
+	{
+		thread.join();
+	}
+
+	ae::CommandBuffer frame = AE_ALLOC_TAG_FIXME;
+	for ( const ae::CommandBuffer& buffer : buffers )
+	{
+		frame.Append( buffer );
+	}
+	REQUIRE( frame.GetCommandCount() == kThreadCount * kDrawCount );
+	REQUIRE( frame.GetUniformsCount() == 8 );
+
+	frame.Sort();
+	// 2 shaders * 4 uniform lists each
+	REQUIRE( frame.GetBindCount() == 8 );
+	for ( uint32_t i = 0; i < frame.GetCommandCount(); i++ )
+	{
+		const ae::CommandBuffer::Command& command = frame.GetCommand( i );
+		const float index = frame.GetUniforms( command.uniformsIndex ).Get( "u_index" )->value.data[ 0 ];
+		REQUIRE( command.shader == &shaders[ (uint32_t)index % 2 ] );
+		REQUIRE( (uint32_t)index == command.primitiveStart % kDrawCount % 8 );
+	}
+}
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// CompactingAllocatorTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2021 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "ae/aeCompactingAllocator.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// Test helpers
+//------------------------------------------------------------------------------
+struct CompactingAllocation
+{
+  uint32_t* data = nullptr;
+  uint32_t length = 0;
+  uint32_t value = 0;
+};
+
+void CheckCompactingAllocations( const CompactingAllocation* allocs, uint32_t count )
+{
+  for ( uint32_t i = 0; i < count; i++ )
+  {
+    for ( uint32_t j = 0; j < allocs[ i ].length; j++ )
+    {
+      REQUIRE( allocs[ i ].data[ j ] == allocs[ i ].value );
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// aeCompactingAllocator tests
+//------------------------------------------------------------------------------
+TEST_CASE( "compacting allocator reuses freed space and preserves contents", "[aeCompactingAllocator]" )
+{
+  aeCompactingAllocator allocator( 64 * 1024 );
+  CompactingAllocation allocs[ 64 ];
+  uint64_t seed = 123;
+  for ( uint32_t iter = 0; iter < 2000; iter++ )
+  {
+    CompactingAllocation& alloc = allocs[ ae::Random( 0, countof( allocs ), seed ) ];
+    if ( alloc.data )
+    {
+      allocator.Free( &alloc.data );
+      REQUIRE( !alloc.data );
+      alloc.length = 0;
+    }
+    else
+    {
+      alloc.length = ae::Random( 1, 64, seed );
+      alloc.value = iter;
+      allocator.Allocate( &alloc.data, alloc.length * sizeof(uint32_t) );
+      REQUIRE( alloc.data );
+      REQUIRE( (intptr_t)alloc.data % 16 == 0 );
+      for ( uint32_t j = 0; j < alloc.length; j++ )
+      {
+        alloc.data[ j ] = alloc.value;
+      }
+    }
+    if ( iter % 10 == 0 )
+    {
+      allocator.Compact( 256 );
+    }
+    CheckCompactingAllocations( allocs, countof( allocs ) );
+  }
+
+  // Reaches a compact state in a bounded number of budgeted steps
+  uint32_t steps = 0;
+  while ( !allocator.Compact( 256 ) )
+  {
+    steps++;
+    REQUIRE( steps < 1000 );
+    CheckCompactingAllocations( allocs, countof( allocs ) );
+  }
+  CheckCompactingAllocations( allocs, countof( allocs ) );
+
+  allocator.Expand( 128 * 1024 );
+  CheckCompactingAllocations( allocs, countof( allocs ) );
+
+  for ( CompactingAllocation& alloc : allocs )
+  {
+    allocator.Free( &alloc.data );
+  }
+}
+
+TEST_CASE( "compacting allocator uses the smallest free block that fits", "[aeCompactingAllocator]" )
+{
+  aeCompactingAllocator allocator( 4096 );
+  uint8_t* a = nullptr;
+  uint8_t* b = nullptr;
+  uint8_t* c = nullptr;
+  uint8_t* d = nullptr;
+  uint8_t* e = nullptr;
+  allocator.Allocate( &a, 256 );
+  allocator.Allocate( &b, 16 );
+  allocator.Allocate( &c, 64 );
+  allocator.Allocate( &d, 16 );
+  uint8_t* cPrev = c;
+  uint8_t* dPrev = d;
+  allocator.Free( &a );
+  allocator.Free( &c );
+
+  // Fits in both free blocks, the smaller is used and nothing else moves
+  allocator.Allocate( &e, 48 );
+  REQUIRE( e == cPrev );
+  REQUIRE( d == dPrev );
+
+  allocator.Free( &b );
+  allocator.Free( &d );
+  allocator.Free( &e );
+}
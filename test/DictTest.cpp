@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+// DictTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// ae::Dict tests
+//------------------------------------------------------------------------------
+TEST_CASE( "dict stores typed values without loss", "[Dict]" )
+{
+	ae::Dict dict = AE_ALLOC_TAG_FIXME;
+	const ae::Matrix4 transform = ae::Matrix4::Translation( 1.25f, -2.0f, 3.5f ) * ae::Matrix4::RotationY( 0.3f );
+	dict.SetInt( "int", -7 );
+	dict.SetUint( "uint", 4000000000u );
+	dict.SetFloat( "float", 0.123456789f );
+	dict.SetDouble( "double", 0.123456789012345 );
+	dict.SetBool( "bool", true );
+	dict.SetVec3( "vec3", ae::Vec3( 1.0f / 3.0f, 2.0f, -3.0f ) );
+	dict.SetInt2( "int2", ae::Int2( 5, -6 ) );
+	dict.SetMatrix4( "matrix", transform );
+	dict.SetString( "string", "hello" );
+	REQUIRE( dict.Length() == 9 );
+
+	REQUIRE( dict.GetInt( "int", 0 ) == -7 );
+	REQUIRE( dict.GetUint( "uint", 0 ) == 4000000000u );
+	REQUIRE( dict.GetFloat( "float", 0.0f ) == 0.123456789f );
+	REQUIRE( dict.GetDouble( "double", 0.0 ) == 0.123456789012345 );
+	REQUIRE( dict.GetBool( "bool", false ) );
+	REQUIRE( dict.GetVec3( "vec3", ae::Vec3( 0.0f ) ) == ae::Vec3( 1.0f / 3.0f, 2.0f, -3.0f ) );
+	REQUIRE( dict.GetInt2( "int2", ae::Int2( 0 ) ) == ae::Int2( 5, -6 ) );
+	REQUIRE( dict.GetMatrix4( "matrix", ae::Matrix4::Identity() ) == transform );
+	REQUIRE( dict.GetString( "string", "" ) == std::string( "hello" ) );
+	REQUIRE( dict.GetInt( "missing", 3 ) == 3 );
+	REQUIRE( !dict.Has( "missing" ) );
+}
+
+TEST_CASE( "dict converts between strings and other types", "[Dict]" )
+{
+	ae::Dict dict = AE_ALLOC_TAG_FIXME;
+	dict.SetInt( "int", 12 );
+	dict.SetBool( "bool", false );
+	dict.SetVec2( "vec2", ae::Vec2( 1.5f, -2.0f ) );
+	REQUIRE( dict.GetString( "int", "" ) == std::string( "12" ) );
+	REQUIRE( dict.GetString( "bool", "" ) == std::string( "false" ) );
+	REQUIRE( dict.GetString( "vec2", "" ) == std::string( "1.500 -2.000" ) );
+	REQUIRE( dict.GetFloat( "int", 0.0f ) == 12.0f );
+
+	dict.SetString( "number", "42" );
+	dict.SetString( "flag", "true" );
+	dict.SetString( "vec3", "1 2 3" );
+	REQUIRE( dict.GetInt( "number", 0 ) == 42 );
+	REQUIRE( dict.GetBool( "flag", false ) );
+	REQUIRE( dict.GetVec3( "vec3", ae::Vec3( 0.0f ) ) == ae::Vec3( 1.0f, 2.0f, 3.0f ) );
+
+	// Changing the type of an existing key
+	dict.SetFloat( "number", 2.5f );
+	REQUIRE( dict.GetString( "number", "" ) == std::string( "2.500000" ) );
+	dict.SetString( "number", "7" );
+	REQUIRE( dict.GetInt( "number", 0 ) == 7 );
+
+	// Keys keep the order they were first set in
+	REQUIRE( dict.Length() == 6 );
+	REQUIRE( dict.GetKey( 0 ) == std::string( "int" ) );
+	REQUIRE( dict.GetKey( 3 ) == std::string( "number" ) );
+	REQUIRE( dict.GetValue( 3 ) == std::string( "7" ) );
+}
+
+TEST_CASE( "dict strings can be copied from the same dict", "[Dict]" )
+{
+	ae::Dict dict = AE_ALLOC_TAG_FIXME;
+	dict.SetString( "a", "a fairly long string value" );
+	for ( uint32_t i = 0; i < 100; i++ )
+	{
+		// Reads from the dict while it may be growing
+		const ae::Str16 key = ae::Str16::Format( "#", i );
+		dict.SetString( key.c_str(), dict.GetString( "a", "" ) );
+	}
+	REQUIRE( dict.GetString( "99", "" ) == std::string( "a fairly long string value" ) );
+	dict.SetString( "a", "short" );
+	REQUIRE( dict.GetString( "a", "" ) == std::string( "short" ) );
+
+	ae::Dict copy = dict;
+	dict.Clear();
+	REQUIRE( dict.Length() == 0 );
+	REQUIRE( copy.GetString( "50", "" ) == std::string( "a fairly long string value" ) );
+}
+
+TEST_CASE( "dict keys with the same hash are stored separately", "[Dict]" )
+{
+	// These keys have the same 32 bit fnv1a hash
+	REQUIRE( ae::Hash().HashString( "key583084" ).Get() == ae::Hash().HashString( "key1092000" ).Get() );
+	ae::Dict dict = AE_ALLOC_TAG_FIXME;
+	REQUIRE( !dict.Has( "key1092000" ) );
+	dict.SetInt( "key583084", 1 );
+	REQUIRE( !dict.Has( "key1092000" ) );
+	dict.SetString( "key1092000", "two" );
+	REQUIRE( dict.Length() == 2 );
+	REQUIRE( dict.GetInt( "key583084", 0 ) == 1 );
+	REQUIRE( dict.GetString( "key1092000", "" ) == std::string( "two" ) );
+
+	dict.SetInt( "key1092000", 3 );
+	dict.SetFloat( "key583084", 4.0f );
+	REQUIRE( dict.Length() == 2 );
+	REQUIRE( dict.GetFloat( "key583084", 0.0f ) == 4.0f );
+	REQUIRE( dict.GetInt( "key1092000", 0 ) == 3 );
+}
+
+TEST_CASE( "dict strings stay valid until their key changes", "[Dict]" )
+{
+	ae::Dict dict = AE_ALLOC_TAG_FIXME;
+	dict.SetString( "a", "first" );
+	dict.SetFloat( "b", 1.5f );
+	const char* a = dict.GetString( "a", "" );
+	const char* b = dict.GetString( "b", "" );
+	for ( uint32_t i = 0; i < 100; i++ )
+	{
+		const ae::Str16 key = ae::Str16::Format( "key#", i );
+		dict.SetString( key.c_str(), "a value that is longer than the inline buffer" );
+		dict.SetVec3( key.c_str(), ae::Vec3( (float)i ) );
+		REQUIRE( dict.GetValue( dict.Length() - 1 ) );
+	}
+	// Both strings are held while the dict changes
+	REQUIRE( a == std::string( "first" ) );
+	REQUIRE( b == std::string( "1.500000" ) );
+	REQUIRE( dict.GetString( "a", "" ) == a );
+	REQUIRE( dict.GetString( "b", "" ) == b );
+}
+
+TEST_CASE( "dict reuses string storage when values change", "[Dict]" )
+{
+	ae::Dict dict = AE_ALLOC_TAG_FIXME;
+	dict.SetString( "value", "10.5" );
+	const char* value = dict.GetString( "value", "" );
+	dict.SetFloat( "float", 1.0f );
+	const char* formatted = dict.GetString( "float", "" );
+	for ( uint32_t i = 0; i < 1000; i++ )
+	{
+		dict.SetString( "value", ( i % 2 ) ? "10.5" : "9.25" );
+		REQUIRE( dict.GetString( "value", "" ) == value );
+		dict.SetFloat( "float", i * 0.5f );
+		REQUIRE( dict.GetString( "float", "" ) == formatted );
+	}
+	REQUIRE( value == std::string( "10.5" ) );
+	REQUIRE( formatted == std::string( "499.500000" ) );
+}
@@ -0,0 +1,653 @@
+//------------------------------------------------------------------------------
+// EntityTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "ae/Editor.h"
+#include "ae/Entity.h"
+#include "catch2/catch.hpp"
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+//------------------------------------------------------------------------------
+// Test components
+//------------------------------------------------------------------------------
+AE_DEFINE_ENUM_CLASS( LevelTestState, uint8_t,
+	Idle,
+	Walking,
+	Running
+);
+AE_REGISTER_ENUM_CLASS( LevelTestState );
+
+class LevelTestComponent : public ae::Inheritor< ae::Component, LevelTestComponent >
+{
+public:
+	int32_t count = 0;
+	float speed = 0.0f;
+	bool active = false;
+	ae::Vec3 position = ae::Vec3( 0.0f );
+	ae::Str32 label;
+	LevelTestState state = LevelTestState::Idle;
+	ae::Array< int32_t, 4 > values;
+};
+AE_REGISTER_CLASS( LevelTestComponent );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, count );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, speed );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, active );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, position );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, label );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, state );
+AE_REGISTER_CLASS_VAR( LevelTestComponent, values );
+
+class LevelTestTag : public ae::Inheritor< ae::Component, LevelTestTag >
+{
+public:
+	uint32_t group = 0;
+};
+AE_REGISTER_CLASS( LevelTestTag );
+AE_REGISTER_CLASS_VAR( LevelTestTag, group );
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+static ae::Str256 GetTestDirectory( const char* name )
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::filesystem::remove_all( path );
+	return path.string().c_str();
+}
+
+//! Every object gets a LevelTestComponent, every third object also gets a
+//! LevelTestTag. Objects are placed along the x axis \p spacing apart.
+static void BuildTestLevel( ae::EditorLevel* level, uint32_t objectCount, float spacing )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	const char* states[] = { "Idle", "Walking", "Running" };
+	for ( uint32_t i = 0; i < objectCount; i++ )
+	{
+		const ae::EditorObjectId id = i + 1;
+		ae::EditorObject& object = level->objects.Set( id, tag );
+		object.id = id;
+		object.name = ae::Str16::Format( "object#", i );
+		object.transform = ae::Matrix4::Translation( i * spacing, 0.5f, -1.0f );
+
+		ae::EditorComponent& component = object.components.Append( tag );
+		component.type = "LevelTestComponent";
+		component.members.SetInt( "count", (int32_t)i * 3 - 7 );
+		component.members.SetFloat( "speed", i * 0.1f );
+		component.members.SetBool( "active", i % 2 == 1 );
+		component.members.SetVec3( "position", ae::Vec3( (float)i, -0.25f, 1.0f / ( i + 1 ) ) );
+		component.members.SetString( "label", ae::Str32::Format( "label #", i % 5 ).c_str() );
+		component.members.SetString( "state", states[ i % 3 ] );
+		const uint32_t valueCount = i % 5;
+		component.members.SetUint( "values", valueCount );
+		for ( uint32_t j = 0; j < valueCount; j++ )
+		{
+			component.members.SetInt( ae::Str32::Format( "values::#", j ).c_str(), (int32_t)( i + j ) );
+		}
+
+		if ( i % 3 == 0 )
+		{
+			ae::EditorComponent& levelTag = object.components.Append( tag );
+			levelTag.type = "LevelTestTag";
+			levelTag.members.SetUint( "group", i / 3 );
+		}
+	}
+}
+
+static void RequireSameEntities( const ae::Registry& expected, const ae::Registry& actual )
+{
+	REQUIRE( expected.GetComponentCount< LevelTestComponent >() == actual.GetComponentCount< LevelTestComponent >() );
+	REQUIRE( expected.GetComponentCount< LevelTestTag >() == actual.GetComponentCount< LevelTestTag >() );
+	ae::Registry& a = const_cast< ae::Registry& >( actual );
+	for ( uint32_t i = 0; i < expected.GetComponentCount< LevelTestComponent >(); i++ )
+	{
+		const LevelTestComponent& e = expected.GetComponentByIndex< LevelTestComponent >( i );
+		const ae::Entity entity = a.GetEntityByName( e.GetEntityName() );
+		REQUIRE( entity == e.GetEntity() );
+		const LevelTestComponent* c = a.TryGetComponent< LevelTestComponent >( entity );
+		REQUIRE( c );
+		REQUIRE( c->count == e.count );
+		REQUIRE( c->speed == e.speed );
+		REQUIRE( c->active == e.active );
+		REQUIRE( c->position == e.position );
+		REQUIRE( c->label == e.label );
+		REQUIRE( c->state == e.state );
+		REQUIRE( c->values.Length() == e.values.Length() );
+		for ( uint32_t j = 0; j < e.values.Length(); j++ )
+		{
+			REQUIRE( c->values[ j ] == e.values[ j ] );
+		}
+
+		const LevelTestTag* eTag = e.TryGetComponent< LevelTestTag >();
+		const LevelTestTag* cTag = c->TryGetComponent< LevelTestTag >();
+		REQUIRE( (bool)eTag == (bool)cTag );
+		if ( eTag )
+		{
+			REQUIRE( cTag->group == eTag->group );
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::CompiledLevel tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Compiled levels load the same entities as editor levels", "[ae::CompiledLevel]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, 100, 1.0f );
+
+	ae::Registry expected = tag;
+	REQUIRE( expected.Load( &editorLevel ) );
+	REQUIRE( expected.GetComponentCount< LevelTestComponent >() == 100 );
+	REQUIRE( expected.GetComponentCount< LevelTestTag >() == 34 );
+	// Sanity check the editor loader so the comparison below means something
+	const LevelTestComponent& object7 = expected.GetComponent< LevelTestComponent >( "object7" );
+	REQUIRE( object7.count == 14 );
+	REQUIRE( object7.active );
+	REQUIRE( object7.position == ae::Vec3( 7.0f, -0.25f, 1.0f / 8.0f ) );
+	REQUIRE( object7.label == "label 2" );
+	REQUIRE( object7.state == LevelTestState::Walking );
+	REQUIRE( object7.values.Length() == 2 );
+	REQUIRE( object7.values[ 1 ] == 8 );
+
+	ae::CompiledLevel compiled = tag;
+	compiled.Compile( editorLevel );
+	REQUIRE( compiled.GetObjectCount() == 100 );
+	REQUIRE( compiled.GetComponentCount() == 134 );
+
+	const ae::Str256 dir = GetTestDirectory( "ae_compiled_level_test" );
+	ae::Str256 path = dir;
+	ae::FileSystem::AppendToPath( &path, "level.aelv" );
+	REQUIRE( ae::FileSystem::Write( path.c_str(), compiled.GetData(), compiled.GetLength(), true ) == compiled.GetLength() );
+
+	const uint32_t length = ae::FileSystem::GetSize( path.c_str() );
+	REQUIRE( length == compiled.GetLength() );
+	ae::Array< uint8_t > data( tag, 0, length );
+	REQUIRE( ae::FileSystem::Read( path.c_str(), data.Data(), length ) == length );
+	ae::CompiledLevel readLevel = tag;
+	REQUIRE( readLevel.Read( data.Data(), length ) );
+	REQUIRE( readLevel.GetObjectCount() == 100 );
+
+	ae::Registry actual = tag;
+	actual.CreateEntity( "stale" ); // Cleared by Load()
+	uint32_t createCount = 0;
+	REQUIRE( actual.Load( &readLevel, [&]( ae::Entity entity, const char* name, const ae::Matrix4& transform, ae::Registry* registry )
+	{
+		const ae::EditorObject& object = editorLevel.objects.Get( entity );
+		REQUIRE( object.name == name );
+		REQUIRE( object.transform == transform );
+		REQUIRE( registry->GetEntityByName( name ) == entity );
+		createCount++;
+	} ) );
+	REQUIRE( createCount == 100 );
+	REQUIRE( actual.GetEntityByName( "stale" ) == ae::kInvalidEntity );
+	RequireSameEntities( expected, actual );
+
+	std::filesystem::remove_all( dir.c_str() );
+}
+
+TEST_CASE( "Compiled levels skip components that aren't registered", "[ae::CompiledLevel]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, 10, 1.0f );
+	ae::EditorComponent& unknown = editorLevel.objects.Get( 2 ).components.Append( tag );
+	unknown.type = "LevelTestNotRegistered";
+	unknown.members.SetInt( "count", 1 );
+
+	ae::CompiledLevel compiled = tag;
+	compiled.Compile( editorLevel );
+	REQUIRE( compiled.GetObjectCount() == 10 );
+	REQUIRE( compiled.GetComponentCount() == 14 );
+
+	ae::Registry expected = tag;
+	ae::Registry actual = tag;
+	REQUIRE( expected.Load( &editorLevel ) );
+	REQUIRE( actual.Load( &compiled ) );
+	RequireSameEntities( expected, actual );
+}
+
+TEST_CASE( "Invalid compiled levels leave the registry empty", "[ae::CompiledLevel]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, 20, 1.0f );
+	ae::CompiledLevel compiled = tag;
+	compiled.Compile( editorLevel );
+
+	// Cut off in the values section, after all entities have been created
+	ae::CompiledLevel truncated = tag;
+	REQUIRE( truncated.Read( compiled.GetData(), compiled.GetLength() - 4 ) );
+
+	SECTION( "Load" )
+	{
+		ae::Registry registry = tag;
+		registry.CreateEntity( "existing" );
+		REQUIRE( !registry.Load( &truncated ) );
+		REQUIRE( registry.GetComponentCount< LevelTestComponent >() == 0 );
+		REQUIRE( registry.GetComponentCount< LevelTestTag >() == 0 );
+		REQUIRE( registry.GetEntityByName( "existing" ) == ae::kInvalidEntity );
+		REQUIRE( registry.GetEntityByName( "object0" ) == ae::kInvalidEntity );
+		REQUIRE( registry.GetTypeCount() == 0 );
+	}
+	SECTION( "LoadAdditive" )
+	{
+		ae::Registry registry = tag;
+		// Outside of the level's ids so LoadAdditive() can succeed afterwards
+		const ae::Entity existing = registry.CreateEntity( 1000, "existing" );
+		registry.AddComponent< LevelTestTag >( existing )->group = 99;
+		ae::Array< ae::Entity > entities = tag;
+		REQUIRE( !registry.LoadAdditive( &truncated, &entities ) );
+		REQUIRE( entities.Length() == 0 );
+		REQUIRE( registry.GetComponentCount< LevelTestComponent >() == 0 );
+		REQUIRE( registry.GetComponentCount< LevelTestTag >() == 1 );
+		REQUIRE( registry.GetEntityByName( "existing" ) == existing );
+		REQUIRE( registry.GetEntityByName( "object0" ) == ae::kInvalidEntity );
+
+		// The same level can be loaded once the failed load is cleaned up
+		REQUIRE( registry.LoadAdditive( &compiled, &entities ) );
+		REQUIRE( entities.Length() == 20 );
+		REQUIRE( registry.GetComponentCount< LevelTestComponent >() == 20 );
+		REQUIRE( registry.GetComponentCount< LevelTestTag >() == 8 );
+	}
+	SECTION( "Read" )
+	{
+		ae::CompiledLevel level = tag;
+		REQUIRE( !level.Read( compiled.GetData(), 8 ) );
+		ae::Array< uint8_t > data( tag, 0, compiled.GetLength() );
+		memcpy( data.Data(), compiled.GetData(), compiled.GetLength() );
+		data[ 4 ]++; // Version
+		REQUIRE( !level.Read( data.Data(), data.Length() ) );
+	}
+	SECTION( "Header" )
+	{
+		// Header: magic, version, object count, component count, strings length
+		ae::Array< uint8_t > data( tag, 0, compiled.GetLength() );
+		memcpy( data.Data(), compiled.GetData(), compiled.GetLength() );
+		uint32_t stringsLength = 0;
+		memcpy( &stringsLength, &data[ 16 ], sizeof(stringsLength) );
+		REQUIRE( stringsLength > 1 );
+		REQUIRE( data[ 20 + stringsLength - 1 ] == 0 );
+		
+		ae::Registry registry = tag;
+		ae::CompiledLevel level = tag;
+		SECTION( "Unterminated strings" )
+		{
+			data[ 20 + stringsLength - 1 ] = 'x';
+			REQUIRE( level.Read( data.Data(), data.Length() ) );
+			REQUIRE( !registry.Load( &level ) );
+			REQUIRE( registry.GetTypeCount() == 0 );
+		}
+		SECTION( "Component count" )
+		{
+			// Only used to reserve space, so a bad count doesn't stop loading
+			const uint32_t componentCount = ~0u;
+			memcpy( &data[ 12 ], &componentCount, sizeof(componentCount) );
+			REQUIRE( level.Read( data.Data(), data.Length() ) );
+			REQUIRE( registry.Load( &level ) );
+			REQUIRE( registry.GetComponentCount< LevelTestComponent >() == 20 );
+		}
+	}
+}
+
+//! Not run by default, run with: test "[benchmark]"
+TEST_CASE( "Compiled level load time", "[.][benchmark][ae::CompiledLevel]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	const uint32_t objectCount = 100000;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, objectCount, 1.0f );
+
+	ae::Registry registry = tag;
+	double start = ae::GetTime();
+	REQUIRE( registry.Load( &editorLevel ) );
+	const double editorTime = ae::GetTime() - start;
+	registry.Clear();
+
+	ae::CompiledLevel compiled = tag;
+	start = ae::GetTime();
+	compiled.Compile( editorLevel );
+	const double compileTime = ae::GetTime() - start;
+
+	start = ae::GetTime();
+	REQUIRE( registry.Load( &compiled ) );
+	const double compiledTime = ae::GetTime() - start;
+	REQUIRE( registry.GetComponentCount< LevelTestComponent >() == objectCount );
+
+	printf( "%u objects (%u components, %u bytes compiled)\n", objectCount, compiled.GetComponentCount(), compiled.GetLength() );
+	printf( "Load(EditorLevel): %.1fms\n", editorTime * 1000.0 );
+	printf( "CompiledLevel::Compile(): %.1fms\n", compileTime * 1000.0 );
+	printf( "Load(CompiledLevel): %.1fms\n", compiledTime * 1000.0 );
+}
+
+//------------------------------------------------------------------------------
+// ae::LevelStreamer tests
+//------------------------------------------------------------------------------
+// 40 objects 2.5 apart along x, so each 10 unit cell has 4 objects. All cells
+// are at y = 0 and z = -1, so their centers are at y = 5 and z = -5.
+static const uint32_t kStreamObjectCount = 40;
+static const uint32_t kStreamCellObjectCount = 4;
+static const float kStreamCellSize = 10.0f;
+
+static ae::Vec3 GetStreamFocus( float x )
+{
+	return ae::Vec3( x, 5.0f, -5.0f );
+}
+
+static uint32_t GetStreamCellIndex( const ae::StreamedLevel& level, int32_t x )
+{
+	for ( uint32_t i = 0; i < level.GetCellCount(); i++ )
+	{
+		if ( level.GetCellCoord( i ) == ae::Int3( x, 0, -1 ) )
+		{
+			return i;
+		}
+	}
+	FAIL( "No cell at x = " << x );
+	return 0;
+}
+
+//! Returns the number of streamed objects in \p registry and checks that all
+//! objects of loaded cells are there. Objects of cells that are still being
+//! unloaded may also be there.
+static uint32_t RequireStreamedObjects( const ae::StreamedLevel& level, const ae::LevelStreamer& streamer, ae::Registry& registry )
+{
+	uint32_t count = 0;
+	for ( uint32_t i = 0; i < kStreamObjectCount; i++ )
+	{
+		const uint32_t cellIndex = GetStreamCellIndex( level, i / kStreamCellObjectCount );
+		const ae::Str16 name = ae::Str16::Format( "object#", i );
+		const ae::Entity entity = registry.GetEntityByName( name.c_str() );
+		if ( streamer.IsCellLoaded( cellIndex ) )
+		{
+			REQUIRE( entity != ae::kInvalidEntity );
+		}
+		if ( entity != ae::kInvalidEntity )
+		{
+			const LevelTestComponent* component = registry.TryGetComponent< LevelTestComponent >( entity );
+			REQUIRE( component );
+			REQUIRE( component->count == (int32_t)i * 3 - 7 );
+			count++;
+		}
+	}
+	REQUIRE( registry.GetComponentCount< LevelTestComponent >() == count );
+	return count;
+}
+
+//! Returns the loaded cells as a bit per cell x coordinate
+static uint32_t GetLoadedStreamCells( const ae::StreamedLevel& level, const ae::LevelStreamer& streamer )
+{
+	uint32_t result = 0;
+	for ( uint32_t i = 0; i < level.GetCellCount(); i++ )
+	{
+		if ( streamer.IsCellLoaded( i ) )
+		{
+			result |= ( 1 << level.GetCellCoord( i ).x );
+		}
+	}
+	return result;
+}
+
+TEST_CASE( "Streamed levels are split into cells", "[ae::LevelStreamer]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, kStreamObjectCount, 2.5f );
+	ae::StreamedLevel compiled = tag;
+	compiled.Compile( editorLevel, kStreamCellSize );
+	REQUIRE( compiled.GetCellCount() == 10 );
+
+	const ae::Str256 dir = GetTestDirectory( "ae_streamed_level_test" );
+	REQUIRE( compiled.Write( dir.c_str() ) );
+	ae::StreamedLevel level = tag;
+	REQUIRE( level.Read( dir.c_str() ) );
+	REQUIRE( level.GetCellSize() == kStreamCellSize );
+	REQUIRE( level.GetCellCount() == 10 );
+	for ( uint32_t i = 0; i < level.GetCellCount(); i++ )
+	{
+		REQUIRE( level.GetCellCoord( i ) == compiled.GetCellCoord( i ) );
+		REQUIRE( level.GetCellObjectCount( i ) == kStreamCellObjectCount );
+		REQUIRE( !level.GetCellLevel( i ) );
+		const ae::AABB bounds = level.GetCellBounds( i );
+		REQUIRE( bounds.GetMin() == ae::Vec3( level.GetCellCoord( i ).x * kStreamCellSize, 0.0f, -kStreamCellSize ) );
+		REQUIRE( bounds.GetMax() == bounds.GetMin() + ae::Vec3( kStreamCellSize ) );
+	}
+	std::filesystem::remove_all( dir.c_str() );
+}
+
+TEST_CASE( "Level streamer loads and unloads cells around the focus", "[ae::LevelStreamer]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, kStreamObjectCount, 2.5f );
+	ae::StreamedLevel compiled = tag;
+	compiled.Compile( editorLevel, kStreamCellSize );
+	const ae::Str256 dir = GetTestDirectory( "ae_level_streamer_test" );
+	REQUIRE( compiled.Write( dir.c_str() ) );
+	ae::StreamedLevel level = tag;
+	REQUIRE( level.Read( dir.c_str() ) );
+
+	ae::Registry registry = tag;
+	ae::LevelStreamer streamer = tag;
+	// Cells are read synchronously in Update() without threads
+	streamer.Initialize( &level, &registry, dir.c_str(), 0 );
+	uint32_t createCount = 0;
+	streamer.SetCreateObjectFn( [&]( ae::Entity entity, const char* name, const ae::Matrix4& transform, ae::Registry* r )
+	{
+		REQUIRE( r == &registry );
+		REQUIRE( r->GetEntityByName( name ) == entity );
+		REQUIRE( transform == editorLevel.objects.Get( entity ).transform );
+		createCount++;
+	} );
+	const float loadRadius = 6.0f;
+	const float unloadRadius = 16.0f;
+
+	// Inside cell 0, 5 units from cell 1
+	streamer.Update( GetStreamFocus( 5.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b11 );
+	REQUIRE( streamer.GetLoadedCellCount() == 2 );
+	REQUIRE( streamer.GetPendingCellCount() == 0 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 8 );
+	REQUIRE( createCount == 8 );
+
+	// Nothing changes while the focus stays put
+	streamer.Update( GetStreamFocus( 5.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b11 );
+	REQUIRE( createCount == 8 );
+
+	// Inside cell 4, cells 0 and 1 are out of the unload radius
+	streamer.Update( GetStreamFocus( 45.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b111000 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 12 );
+	REQUIRE( createCount == 20 );
+
+	// Cell 4 is between the load and unload radius so it stays loaded, cell 5
+	// is out of the unload radius and cell 2 is in the load radius
+	streamer.Update( GetStreamFocus( 32.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b11100 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 12 );
+	REQUIRE( createCount == 24 );
+
+	// Entities that aren't streamed are left alone
+	const ae::Entity player = registry.CreateEntity( 1000, "player" );
+	registry.AddComponent< LevelTestTag >( player );
+	streamer.Terminate();
+	REQUIRE( registry.GetComponentCount< LevelTestComponent >() == 0 );
+	REQUIRE( registry.GetComponentCount< LevelTestTag >() == 1 );
+	REQUIRE( registry.GetEntityByName( "player" ) == player );
+
+	std::filesystem::remove_all( dir.c_str() );
+}
+
+TEST_CASE( "Level streamer respects the object budget", "[ae::LevelStreamer]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, kStreamObjectCount, 2.5f );
+	// Cells stay in memory, so nothing is read from disk
+	ae::StreamedLevel level = tag;
+	level.Compile( editorLevel, kStreamCellSize );
+	ae::Registry registry = tag;
+	ae::LevelStreamer streamer = tag;
+	streamer.Initialize( &level, &registry, nullptr, 0 );
+	streamer.SetObjectBudget( kStreamCellObjectCount );
+
+	// Cells 0, 1 and 2 are in range and are loaded nearest first, one per update
+	const float loadRadius = 16.0f;
+	const float unloadRadius = 26.0f;
+	streamer.Update( GetStreamFocus( 5.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1 );
+	REQUIRE( streamer.GetPendingCellCount() == 2 );
+	streamer.Update( GetStreamFocus( 5.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b11 );
+	streamer.Update( GetStreamFocus( 5.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b111 );
+	REQUIRE( streamer.GetPendingCellCount() == 0 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 12 );
+
+	// Jump to cell 9, everything loaded so far is unloaded while cells 9, 8
+	// and 7 are loaded
+	uint32_t prevCells = GetLoadedStreamCells( level, streamer );
+	uint32_t prevCount = 12;
+	uint32_t updateCount = 0;
+	while ( GetLoadedStreamCells( level, streamer ) != 0b1110000000 || streamer.GetPendingCellCount() )
+	{
+		REQUIRE( updateCount < 20 );
+		ae::Array< bool > before = tag;
+		for ( uint32_t i = 0; i < kStreamObjectCount; i++ )
+		{
+			before.Append( registry.GetEntityByName( ae::Str16::Format( "object#", i ).c_str() ) != ae::kInvalidEntity );
+		}
+		streamer.Update( GetStreamFocus( 95.0f ), loadRadius, unloadRadius );
+		updateCount++;
+
+		uint32_t added = 0, removed = 0;
+		for ( uint32_t i = 0; i < kStreamObjectCount; i++ )
+		{
+			const bool after = registry.GetEntityByName( ae::Str16::Format( "object#", i ).c_str() ) != ae::kInvalidEntity;
+			added += ( after && !before[ i ] );
+			removed += ( !after && before[ i ] );
+		}
+		// At most one whole cell is loaded past the budget
+		REQUIRE( removed <= kStreamCellObjectCount );
+		REQUIRE( added <= kStreamCellObjectCount );
+		const uint32_t cells = GetLoadedStreamCells( level, streamer );
+		if ( updateCount == 1 )
+		{
+			REQUIRE( ( cells & ~prevCells ) == ( 1 << 9 ) ); // Nearest first
+		}
+		const uint32_t count = RequireStreamedObjects( level, streamer, registry );
+		REQUIRE( count == prevCount + added - removed );
+		prevCells = cells;
+		prevCount = count;
+	}
+	// 12 objects to remove and 12 to add, 4 at a time
+	REQUIRE( updateCount == 3 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 12 );
+
+	// No limit. Cell 2 is still being unloaded, so it finishes unloading before
+	// it's loaded again by the next update.
+	streamer.SetObjectBudget( 0 );
+	streamer.Update( GetStreamFocus( 15.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1011 );
+	streamer.Update( GetStreamFocus( 15.0f ), loadRadius, unloadRadius );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1111 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 16 );
+}
+
+TEST_CASE( "Level streamer reloads cells that come back in range while unloading", "[ae::LevelStreamer]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, kStreamObjectCount, 2.5f );
+	ae::StreamedLevel level = tag;
+	level.Compile( editorLevel, kStreamCellSize );
+	ae::Registry registry = tag;
+	ae::LevelStreamer streamer = tag;
+	streamer.Initialize( &level, &registry, nullptr, 0 );
+
+	streamer.Update( GetStreamFocus( 5.0f ), 0.0f, 0.0f );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1 );
+
+	// Half of cell 0 is removed before it's wanted again
+	streamer.SetObjectBudget( kStreamCellObjectCount / 2 );
+	streamer.Update( GetStreamFocus( 95.0f ), 0.0f, 0.0f );
+	REQUIRE( !streamer.IsCellLoaded( GetStreamCellIndex( level, 0 ) ) );
+	REQUIRE( registry.GetEntityByName( "object0" ) != ae::kInvalidEntity );
+	REQUIRE( registry.GetEntityByName( "object3" ) == ae::kInvalidEntity );
+
+	uint32_t updateCount = 0;
+	do
+	{
+		REQUIRE( updateCount < 4 );
+		streamer.Update( GetStreamFocus( 5.0f ), 0.0f, 0.0f );
+		updateCount++;
+		RequireStreamedObjects( level, streamer, registry );
+	} while ( !streamer.IsCellLoaded( GetStreamCellIndex( level, 0 ) ) );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == kStreamCellObjectCount );
+}
+
+TEST_CASE( "Level streamer skips cells that fail to load", "[ae::LevelStreamer]" )
+{
+	const ae::Tag tag = AE_ALLOC_TAG_FIXME;
+	ae::EditorLevel editorLevel = tag;
+	BuildTestLevel( &editorLevel, kStreamObjectCount, 2.5f );
+	ae::StreamedLevel compiled = tag;
+	compiled.Compile( editorLevel, kStreamCellSize );
+	const ae::Str256 dir = GetTestDirectory( "ae_level_streamer_fail_test" );
+	REQUIRE( compiled.Write( dir.c_str() ) );
+	ae::StreamedLevel level = tag;
+	REQUIRE( level.Read( dir.c_str() ) );
+
+	// Cell 1 is missing and cell 2 is truncated after its header
+	const uint32_t cell1 = GetStreamCellIndex( level, 1 );
+	const uint32_t cell2 = GetStreamCellIndex( level, 2 );
+	std::filesystem::remove( level.GetCellPath( dir.c_str(), cell1 ).c_str() );
+	const ae::CompiledLevel* cell2Level = compiled.GetCellLevel( cell2 );
+	REQUIRE( ae::FileSystem::Write( level.GetCellPath( dir.c_str(), cell2 ).c_str(), cell2Level->GetData(), cell2Level->GetLength() - 4, false ) );
+
+	ae::Registry registry = tag;
+	ae::LevelStreamer streamer = tag;
+	streamer.Initialize( &level, &registry, dir.c_str(), 2 );
+	for ( uint32_t i = 0; i < 1000 && ( !streamer.GetLoadedCellCount() || streamer.GetPendingCellCount() ); i++ )
+	{
+		streamer.Update( GetStreamFocus( 15.0f ), 16.0f, 26.0f );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	REQUIRE( streamer.GetPendingCellCount() == 0 );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1001 );
+	REQUIRE( RequireStreamedObjects( level, streamer, registry ) == 8 );
+
+	// Failed cells aren't retried
+	streamer.Update( GetStreamFocus( 15.0f ), 16.0f, 26.0f );
+	REQUIRE( streamer.GetPendingCellCount() == 0 );
+	REQUIRE( GetLoadedStreamCells( level, streamer ) == 0b1001 );
+
+	streamer.Terminate();
+	std::filesystem::remove_all( dir.c_str() );
+}
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+// HotSpotTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2021 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "ae/aeHotSpot.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// Test helpers
+//------------------------------------------------------------------------------
+const uint32_t kTile_Air = 0;
+const uint32_t kTile_Wall = 1;
+const uint32_t kTileMask_Collision = 1;
+
+void InitializeHotSpotBox( HotSpotWorld* world, uint32_t threadCount, uint32_t size )
+{
+  world->Initialize( 1.0f / 60.0f, threadCount );
+  world->SetCollisionMask( kTileMask_Collision );
+  world->SetTileProperties( kTile_Wall, kTileMask_Collision );
+  for ( uint32_t i = 0; i < size; i++ )
+  {
+    world->SetTile( ae::Int2( i, 0 ), kTile_Wall );
+    world->SetTile( ae::Int2( i, size - 1 ), kTile_Wall );
+    world->SetTile( ae::Int2( 0, i ), kTile_Wall );
+    world->SetTile( ae::Int2( size - 1, i ), kTile_Wall );
+  }
+}
+
+//------------------------------------------------------------------------------
+// HotSpotWorld tests
+//------------------------------------------------------------------------------
+TEST_CASE( "hot spot objects should land on the ground", "[aeHotSpot]" )
+{
+  HotSpotWorld world;
+  InitializeHotSpotBox( &world, 1, 8 );
+  HotSpotObject* obj = world.CreateObject();
+  obj->Warp( ae::Vec2( 3.0f, 4.0f ) );
+  uint32_t groundCount = 0;
+  obj->onCollision.Add( &world, [ &groundCount ]( const HotSpotObject::CollisionInfo* info )
+  {
+    if ( info->normal == ae::Int2( 0, 1 ) ) { groundCount++; }
+  } );
+  for ( uint32_t i = 0; i < 120; i++ )
+  {
+    obj->AddGravity( ae::Vec2( 0.0f, -10.0f ) );
+    world.Update( 1.0f / 60.0f );
+  }
+  REQUIRE( obj->IsOnGround() );
+  REQUIRE( obj->GetPosition().y == Approx( 1.0f ) );
+  REQUIRE( groundCount > 0 );
+}
+
+TEST_CASE( "hot spot collision callbacks can create objects", "[aeHotSpot]" )
+{
+  HotSpotWorld world;
+  InitializeHotSpotBox( &world, 1, 8 );
+  HotSpotObject* obj = world.CreateObject();
+  obj->Warp( ae::Vec2( 3.0f, 4.0f ) );
+  uint32_t collisionCount = 0;
+  obj->onCollision.Add( &world, [ &world, &collisionCount ]( const HotSpotObject::CollisionInfo* info )
+  {
+    const HotSpotObject::CollisionInfo expected = *info;
+    // Grows the world's arrays while the collision is being sent
+    for ( uint32_t i = 0; i < 64; i++ )
+    {
+      HotSpotObject* newObj = world.CreateObject();
+      newObj->Warp( ae::Vec2( 5.0f, 5.0f ) );
+      newObj->SetVelocity( ae::Vec2( 1.0f, 0.0f ) );
+    }
+    REQUIRE( info->normal == expected.normal );
+    REQUIRE( info->position == expected.position );
+    collisionCount++;
+  } );
+  for ( uint32_t i = 0; i < 120 && !collisionCount; i++ )
+  {
+    obj->AddGravity( ae::Vec2( 0.0f, -10.0f ) );
+    world.Update( 1.0f / 60.0f );
+  }
+  REQUIRE( collisionCount > 0 );
+  REQUIRE( world.GetObjectCount() == 1 + 64 * collisionCount );
+  // New objects are simulated on the next update
+  world.Update( 1.0f / 60.0f );
+  REQUIRE( world.GetObject( 1 )->GetPosition() != ae::Vec2( 5.0f, 5.0f ) );
+}
+
+TEST_CASE( "hot spot simulation should not depend on thread count", "[aeHotSpot]" )
+{
+  const uint32_t kObjectCount = 500;
+  HotSpotWorld world0;
+  HotSpotWorld world1;
+  InitializeHotSpotBox( &world0, 1, 64 );
+  InitializeHotSpotBox( &world1, 4, 64 );
+  world0.SetObjectCollisionEnabled( true );
+  world1.SetObjectCollisionEnabled( true );
+  for ( uint32_t i = 0; i < kObjectCount; i++ )
+  {
+    ae::Vec2 pos( 2.0f + ( i % 50 ) * 1.2f, 2.0f + ( i / 50 ) * 1.5f );
+    ae::Vec2 vel( ( i % 7 ) - 3.0f, ( i % 5 ) - 2.0f );
+    world0.CreateObject()->Warp( pos );
+    world0.GetObject( i )->SetVelocity( vel );
+    world1.CreateObject()->Warp( pos );
+    world1.GetObject( i )->SetVelocity( vel );
+  }
+  for ( uint32_t i = 0; i < 60; i++ )
+  {
+    for ( uint32_t j = 0; j < kObjectCount; j++ )
+    {
+      world0.GetObject( j )->AddGravity( ae::Vec2( 0.0f, -10.0f ) );
+      world1.GetObject( j )->AddGravity( ae::Vec2( 0.0f, -10.0f ) );
+    }
+    world0.Update( 1.0f / 60.0f );
+    world1.Update( 1.0f / 60.0f );
+  }
+  for ( uint32_t i = 0; i < kObjectCount; i++ )
+  {
+    REQUIRE( world0.GetObject( i )->GetPosition() == world1.GetObject( i )->GetPosition() );
+    REQUIRE( world0.GetObject( i )->GetVelocity() == world1.GetObject( i )->GetVelocity() );
+  }
+}
+
+TEST_CASE( "hot spot objects should be pushed apart when object collision is enabled", "[aeHotSpot]" )
+{
+  HotSpotWorld world;
+  InitializeHotSpotBox( &world, 1, 16 );
+  world.SetObjectCollisionEnabled( true );
+  HotSpotObject* obj0 = world.CreateObject();
+  HotSpotObject* obj1 = world.CreateObject();
+  obj0->Warp( ae::Vec2( 6.0f, 5.0f ) );
+  obj1->Warp( ae::Vec2( 6.5f, 5.0f ) );
+  obj1->SetMass( 3.0f );
+  HotSpotObject* hit = nullptr;
+  obj0->onCollision.Add( &world, [ &hit ]( const HotSpotObject::CollisionInfo* info ){ hit = info->object; } );
+
+  world.Update( 1.0f / 60.0f );
+  REQUIRE( hit == obj1 );
+  float separation = obj1->GetPosition().x - obj0->GetPosition().x;
+  REQUIRE( separation == Approx( 1.0f ) );
+  // The heavier object moves less
+  REQUIRE( 6.0f - obj0->GetPosition().x == Approx( 0.375f ) );
+  REQUIRE( obj1->GetPosition().x - 6.5f == Approx( 0.125f ) );
+}
+
+TEST_CASE( "hot spot collisions are only sent for pairs that were resolved", "[aeHotSpot]" )
+{
+  HotSpotWorld world;
+  InitializeHotSpotBox( &world, 1, 16 );
+  world.SetObjectCollisionEnabled( true );
+  HotSpotObject* obj0 = world.CreateObject();
+  HotSpotObject* obj1 = world.CreateObject();
+  HotSpotObject* obj2 = world.CreateObject();
+  // obj1 and obj2 overlap at first, but resolving obj0 with each of them
+  // pushes them apart before their own pair is resolved
+  obj0->Warp( ae::Vec2( 6.0f, 5.0f ) );
+  obj1->Warp( ae::Vec2( 6.5f, 5.0f ) );
+  obj2->Warp( ae::Vec2( 5.6f, 5.0f ) );
+  ae::Array< const HotSpotObject* > hits1 = AE_ALLOC_TAG_FIXME;
+  ae::Array< const HotSpotObject* > hits2 = AE_ALLOC_TAG_FIXME;
+  obj1->onCollision.Add( &world, [ &hits1 ]( const HotSpotObject::CollisionInfo* info ){ hits1.Append( info->object ); } );
+  obj2->onCollision.Add( &world, [ &hits2 ]( const HotSpotObject::CollisionInfo* info ){ hits2.Append( info->object ); } );
+
+  world.Update( 1.0f / 60.0f );
+  REQUIRE( obj1->GetPosition().x - obj2->GetPosition().x >= 1.0f );
+  REQUIRE( hits1.Length() == 1 );
+  REQUIRE( hits1[ 0 ] == obj0 );
+  REQUIRE( hits2.Length() == 1 );
+  REQUIRE( hits2[ 0 ] == obj0 );
+}
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// InstanceCullerTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+namespace
+{
+	const float kFov = 0.9f;
+	const ae::Vec3 kCameraPos( 0.0f );
+	ae::Frustum GetTestFrustum()
+	{
+		const ae::Matrix4 worldToView = ae::Matrix4::WorldToView( kCameraPos, ae::Vec3( 0.0f, 0.0f, -1.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) );
+		const ae::Matrix4 viewToProj = ae::Matrix4::ViewToProjection( kFov, 1.0f, 0.5f, 100.0f );
+		return ae::Frustum( viewToProj * worldToView );
+	}
+}
+
+//------------------------------------------------------------------------------
+// ae::InstanceCuller tests
+//------------------------------------------------------------------------------
+TEST_CASE( "instance culler matches frustum intersection", "[InstanceCuller]" )
+{
+	const ae::Frustum frustum = GetTestFrustum();
+	ae::InstanceCuller culler = AE_ALLOC_TAG_FIXME;
+	culler.Initialize( sizeof(uint32_t), 1 );
+	uint32_t expected = 0;
+	uint32_t index = 0;
+	for ( int32_t z = -20; z < 20; z++ )
+	for ( int32_t y = -20; y < 20; y++ )
+	for ( int32_t x = -20; x < 20; x++ )
+	{
+		const ae::Sphere bounds( ae::Vec3( x, y, z ) * 3.0f, 0.5f + ( index % 4 ) );
+		culler.Add( bounds, &index );
+		expected += frustum.Intersects( bounds ) ? 1 : 0;
+		index++;
+	}
+	REQUIRE( culler.GetInstanceCount() == 40 * 40 * 40 );
+	culler.Cull( frustum, kCameraPos, kFov );
+	REQUIRE( culler.GetVisibleCount( 0 ) == expected );
+	REQUIRE( expected > 0 );
+	REQUIRE( expected < culler.GetInstanceCount() );
+
+	// Visible data is in the original order
+	const uint32_t* visible = (const uint32_t*)culler.GetVisibleData( 0 );
+	for ( uint32_t i = 1; i < expected; i++ )
+	{
+		REQUIRE( visible[ i - 1 ] < visible[ i ] );
+	}
+}
+
+TEST_CASE( "instance culler selects lods by screen size", "[InstanceCuller]" )
+{
+	ae::InstanceCuller culler = AE_ALLOC_TAG_FIXME;
+	culler.Initialize( sizeof(uint32_t), 3 );
+	culler.SetLodScreenSize( 0, 0.1f );
+	culler.SetLodScreenSize( 1, 0.01f );
+	culler.SetLodScreenSize( 2, 0.001f );
+	// Screen size of a sphere with radius 1 is 1 / ( distance * tan( fov / 2 ) )
+	const float tanHalfFov = tanf( kFov * 0.5f );
+	const float distances[] = { 2.0f, 50.0f, 5.0f, 90.0f, 150.0f };
+	for ( uint32_t i = 0; i < countof( distances ); i++ )
+	{
+		culler.Add( ae::Sphere( ae::Vec3( 0.0f, 0.0f, -distances[ i ] ), 1.0f ), &i );
+	}
+	culler.Cull( GetTestFrustum(), kCameraPos, kFov );
+	REQUIRE( 1.0f / ( 5.0f * tanHalfFov ) > 0.1f );
+	REQUIRE( 1.0f / ( 50.0f * tanHalfFov ) > 0.01f );
+	REQUIRE( culler.GetVisibleCount( 0 ) == 2 );
+	REQUIRE( culler.GetVisibleCount( 1 ) == 2 );
+	REQUIRE( culler.GetVisibleCount( 2 ) == 0 ); // The last instance is outside the far plane
+	const uint32_t* lod0 = (const uint32_t*)culler.GetVisibleData( 0 );
+	const uint32_t* lod1 = (const uint32_t*)culler.GetVisibleData( 1 );
+	REQUIRE( lod0[ 0 ] == 0 );
+	REQUIRE( lod0[ 1 ] == 2 );
+	REQUIRE( lod1[ 0 ] == 1 );
+	REQUIRE( lod1[ 1 ] == 3 );
+
+	// Move the far instance in range of the smallest lod
+	uint32_t data = 4;
+	culler.Set( 4, ae::Sphere( ae::Vec3( 0.0f, 0.0f, -95.0f ), 0.1f ), &data );
+	culler.Remove( 0 );
+	culler.Cull( GetTestFrustum(), kCameraPos, kFov );
+	REQUIRE( culler.GetVisibleCount( 0 ) == 1 );
+	REQUIRE( culler.GetVisibleCount( 1 ) == 2 );
+	REQUIRE( culler.GetVisibleCount( 2 ) == 1 );
+	REQUIRE( *(const uint32_t*)culler.GetVisibleData( 2 ) == 4 );
+}
+
+TEST_CASE( "instance culler uploads only visible instances", "[InstanceCuller]" )
+{
+	ae::NullGraphics = true;
+	ae::ResetGraphicsStats();
+	{
+		ae::InstanceCuller culler = AE_ALLOC_TAG_FIXME;
+		culler.Initialize( sizeof(ae::Vec3), 1 );
+		for ( uint32_t i = 0; i < 1000; i++ )
+		{
+			const ae::Vec3 pos( 0.0f, 0.0f, ( i % 2 ) ? -10.0f : 10.0f ); // Half are behind the camera
+			culler.Add( ae::Sphere( pos, 1.0f ), &pos );
+		}
+		culler.Cull( GetTestFrustum(), kCameraPos, kFov );
+		ae::InstanceData instanceData;
+		instanceData.Initialize( sizeof(ae::Vec3), culler.GetInstanceCount(), ae::Vertex::Usage::Dynamic );
+		instanceData.AddAttribute( "a_offset", 3, ae::Vertex::Type::Float, 0 );
+		REQUIRE( culler.Upload( 0, &instanceData ) == 500 );
+		REQUIRE( ae::GetGraphicsStats().uploadedBytes == 500 * sizeof(ae::Vec3) );
+	}
+	ae::NullGraphics = false;
+}
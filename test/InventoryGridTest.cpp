@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+// InventoryGridTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2021 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "ae/aeInventoryGrid.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// aeInventoryGrid tests
+//------------------------------------------------------------------------------
+TEST_CASE( "inventory grid shapes can be set, retrieved, and removed", "[aeInventoryGrid]" )
+{
+  aeInventoryGrid< int32_t > grid = AE_ALLOC_TAG_FIXME;
+  int32_t a = 1;
+  int32_t b = 2;
+  grid.Set( a, ae::RectInt::FromPointAndSize( 0, 0, 2, 3 ) );
+  ae::Int2 cells[] = { ae::Int2( 5, 5 ), ae::Int2( 6, 5 ), ae::Int2( 6, 6 ) };
+  grid.Set( b, cells, countof( cells ) );
+  REQUIRE( grid.Length() == 2 );
+
+  REQUIRE( *grid.TryGet( ae::Int2( 0, 0 ) ) == 1 );
+  REQUIRE( *grid.TryGet( ae::Int2( 1, 2 ) ) == 1 );
+  REQUIRE( !grid.TryGet( ae::Int2( 2, 0 ) ) );
+  REQUIRE( *grid.TryGet( ae::Int2( 6, 6 ) ) == 2 );
+  REQUIRE( grid.IsFree( ae::Int2( 5, 6 ) ) );
+
+  grid.Remove( ae::Int2( 1, 1 ) );
+  REQUIRE( grid.Length() == 1 );
+  REQUIRE( !grid.TryGet( ae::Int2( 0, 0 ) ) );
+  REQUIRE( *grid.TryGet( ae::Int2( 5, 5 ) ) == 2 );
+
+  grid.Remove( b );
+  REQUIRE( grid.Length() == 0 );
+  REQUIRE( grid.IsFree( ae::Int2( 5, 5 ) ) );
+}
+
+TEST_CASE( "inventory grid finds the first free fit", "[aeInventoryGrid]" )
+{
+  aeInventoryGrid< int32_t > grid = AE_ALLOC_TAG_FIXME;
+  const ae::RectInt bounds = ae::RectInt::FromPointAndSize( 0, 0, 6, 4 );
+  int32_t value = 1;
+  grid.Set( value, ae::RectInt::FromPointAndSize( 0, 0, 2, 2 ) );
+  grid.Set( value, ae::RectInt::FromPointAndSize( 3, 1, 1, 1 ) );
+
+  ae::Int2 pos;
+  REQUIRE( grid.FindFirstFit( bounds, ae::Int2( 2, 2 ), &pos ) );
+  REQUIRE( pos == ae::Int2( 4, 0 ) );
+  REQUIRE( grid.FindFirstFit( bounds, ae::Int2( 3, 2 ), &pos ) );
+  REQUIRE( pos == ae::Int2( 0, 2 ) );
+  REQUIRE( grid.FindFirstFit( bounds, ae::Int2( 1, 1 ), &pos ) );
+  REQUIRE( pos == ae::Int2( 2, 0 ) );
+  REQUIRE( !grid.FindFirstFit( bounds, ae::Int2( 7, 1 ), &pos ) );
+  REQUIRE( !grid.FindFirstFit( bounds, ae::Int2( 4, 3 ), &pos ) );
+
+  // L shape that hooks around the single occupied cell
+  ae::Int2 cells[] = { ae::Int2( 0, 0 ), ae::Int2( 1, 0 ), ae::Int2( 0, 1 ) };
+  REQUIRE( grid.FindFirstFit( bounds, cells, countof( cells ), &pos ) );
+  REQUIRE( pos == ae::Int2( 2, 0 ) );
+  for ( ae::Int2& cell : cells )
+  {
+    cell += pos;
+  }
+  grid.Set( value, cells, countof( cells ) );
+  REQUIRE( !grid.IsFree( ae::Int2( 3, 0 ) ) );
+}
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+// NameTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+#include <thread>
+
+//------------------------------------------------------------------------------
+// ae::Name tests
+//------------------------------------------------------------------------------
+TEST_CASE( "Names are compared and hashed as integers", "[Name]" )
+{
+	ae::Name empty;
+	REQUIRE( empty.Empty() );
+	REQUIRE( empty == ae::Name( "" ) );
+	REQUIRE( strcmp( empty.c_str(), "" ) == 0 );
+
+	ae::Name a = "NameTestA";
+	ae::Name b = ae::Str32( "NameTestB" );
+	REQUIRE( !a.Empty() );
+	REQUIRE( a != b );
+	REQUIRE( a == ae::Name( ae::String( "NameTestA" ) ) );
+	REQUIRE( a == "NameTestA" );
+	REQUIRE( a != "NameTestB" );
+	REQUIRE( a.GetHash() == ae::GetHash( "NameTestA" ) );
+	REQUIRE( ae::GetHash( a ) == a.GetHash() );
+	REQUIRE( strcmp( a.c_str(), "NameTestA" ) == 0 );
+	REQUIRE( a.c_str() == ae::Name( "NameTestA" ).c_str() );
+	REQUIRE( ae::Str64::Format( "<#>", b ) == "<NameTestB>" );
+}
+
+TEST_CASE( "Hashed names are computed at compile time", "[Name]" )
+{
+	static constexpr ae::Name kHashed = ae::Name::Hashed( "NameTestHashed" );
+	AE_STATIC_ASSERT( kHashed == ae::Name::Hashed( "NameTestHashed" ) );
+	REQUIRE( kHashed.GetHash() == ae::GetHash( "NameTestHashed" ) );
+	REQUIRE( strcmp( kHashed.c_str(), "" ) == 0 ); // Not interned yet
+	REQUIRE( kHashed == ae::Name( "NameTestHashed" ) );
+	REQUIRE( strcmp( kHashed.c_str(), "NameTestHashed" ) == 0 );
+}
+
+TEST_CASE( "Names with the same hash are both stored", "[Name]" )
+{
+	// These strings have the same 32 bit fnv1a hash
+	REQUIRE( ae::GetHash( "key583084" ) == ae::GetHash( "key1092000" ) );
+	const ae::Name a = "key583084";
+	const ae::Name b = "key1092000";
+	REQUIRE( a != b );
+	REQUIRE( a.GetHash() == ae::GetHash( "key583084" ) );
+	REQUIRE( strcmp( a.c_str(), "key583084" ) == 0 );
+	REQUIRE( strcmp( b.c_str(), "key1092000" ) == 0 );
+	REQUIRE( ae::Name( "key1092000" ) == b );
+	REQUIRE( ae::Name::Find( "key1092000" ) == b );
+	REQUIRE( b == "key1092000" );
+	REQUIRE( a != "key1092000" );
+	REQUIRE( b != "key583084" );
+
+	ae::Map< ae::Name, int32_t > map = AE_ALLOC_TAG_FIXME;
+	map.Set( a, 1 );
+	map.Set( b, 2 );
+	REQUIRE( map.Get( ae::Name::Find( "key583084" ) ) == 1 );
+	REQUIRE( map.Get( ae::Name::Find( "key1092000" ) ) == 2 );
+	REQUIRE( !map.TryGet( ae::Name::Find( "NameTestNotAdded" ) ) );
+}
+
+TEST_CASE( "Names can be used as map keys", "[Name]" )
+{
+	ae::Map< ae::Name, int32_t > map = AE_ALLOC_TAG_FIXME;
+	map.Set( "NameTestOne", 1 );
+	map.Set( "NameTestTwo", 2 );
+	REQUIRE( map.Get( ae::Name::Hashed( "NameTestOne" ) ) == 1 );
+	REQUIRE( map.Get( "NameTestTwo" ) == 2 );
+	REQUIRE( !map.TryGet( ae::Name::Hashed( "NameTestThree" ) ) );
+	REQUIRE( strcmp( map.GetKey( 0 ).c_str(), "NameTestOne" ) == 0 );
+}
+
+TEST_CASE( "Names can be added from multiple threads", "[Name]" )
+{
+	const uint32_t kThreadCount = 4;
+	const uint32_t kNameCount = 1000;
+	std::thread threads[ kThreadCount ];
+	for ( std::thread& thread : threads )
+	{
+		thread = std::thread( []()
+		{
+			for ( uint32_t i = 0; i < kNameCount; i++ )
+			{
+				const ae::Name name = ae::Str32::Format( "NameTestThread#", i );
+				AE_ASSERT( strcmp( name.c_str(), ae::Str32::Format( "NameTestThread#", i ).c_str() ) == 0 );
+			}
+		} );
+	}
+	for ( std::thread& thread : threads )
+	{
+		thread.join();
+	}
+	for ( uint32_t i = 0; i < kNameCount; i++ )
+	{
+		const ae::Name name = ae::Name::Hashed( ae::Str32::Format( "NameTestThread#", i ).c_str() );
+		REQUIRE( name.c_str() == ae::Name( ae::Str32::Format( "NameTestThread#", i ) ).c_str() );
+		REQUIRE( strcmp( name.c_str(), ae::Str32::Format( "NameTestThread#", i ).c_str() ) == 0 );
+	}
+}
+
+TEST_CASE( "Skeleton bones are found by name", "[Name]" )
+{
+	ae::Skeleton skeleton = AE_ALLOC_TAG_FIXME;
+	skeleton.Initialize( 4 );
+	const ae::Bone* arm = skeleton.AddBone( skeleton.GetRoot(), "arm", ae::Matrix4::Identity() );
+	const ae::Bone* hand = skeleton.AddBone( arm, "hand", ae::Matrix4::Identity() );
+	REQUIRE( skeleton.GetBoneByName( "arm" ) == arm );
+	REQUIRE( skeleton.GetBoneByName( ae::Name( "hand" ) ) == hand );
+	REQUIRE( skeleton.GetBoneByName( "root" ) == skeleton.GetRoot() );
+	REQUIRE( !skeleton.GetBoneByName( "foot" ) );
+	REQUIRE( hand->name == "hand" );
+
+	ae::Skeleton copy = AE_ALLOC_TAG_FIXME;
+	copy.Initialize( &skeleton );
+	REQUIRE( copy.GetBoneCount() == 3 );
+	REQUIRE( copy.GetBoneByName( "hand" )->name == hand->name );
+	REQUIRE( copy.GetBoneByName( "hand" )->parent == copy.GetBoneByName( ae::Name( "arm" ) ) );
+}
+
+TEST_CASE( "Animation keyframes are found by bone name", "[Name]" )
+{
+	ae::Animation animation = AE_ALLOC_TAG_FIXME;
+	animation.duration = 1.0f;
+	ae::Array< ae::Keyframe >& armKeyframes = animation.keyframes.Set( ae::Name( "arm" ), AE_ALLOC_TAG_FIXME );
+	armKeyframes.Append( ae::Keyframe( ae::Matrix4::Translation( ae::Vec3( 1.0f, 2.0f, 3.0f ) ) ) );
+	REQUIRE( animation.GetKeyframeByPercent( "arm", 0.0f ).translation == ae::Vec3( 1.0f, 2.0f, 3.0f ) );
+	REQUIRE( animation.GetKeyframeByTime( "arm", 0.5f ).translation == ae::Vec3( 1.0f, 2.0f, 3.0f ) );
+	REQUIRE( animation.GetKeyframeByPercent( ae::Name( "arm" ), 0.0f ).translation == ae::Vec3( 1.0f, 2.0f, 3.0f ) );
+
+	REQUIRE( animation.GetKeyframeByPercent( "AnimationTestNotAdded", 0.0f ).translation == ae::Vec3( 0.0f ) );
+	REQUIRE( animation.GetKeyframeByTime( "AnimationTestNotAdded", 0.5f ).translation == ae::Vec3( 0.0f ) );
+	REQUIRE( ae::Name::Find( "AnimationTestNotAdded" ).c_str()[ 0 ] == 0 );
+}
@@ -0,0 +1,228 @@
+//------------------------------------------------------------------------------
+// NullGraphicsTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+namespace
+{
+	const char* kVertexShader = R"(
+		AE_UNIFORM_HIGHP mat4 u_worldToProj;
+		AE_IN_HIGHP vec3 a_position;
+		void main()
+		{
+			gl_Position = u_worldToProj * vec4( a_position, 1.0 );
+		}
+	)";
+	const char* kFragmentShader = R"(
+		AE_UNIFORM vec4 u_color;
+		uniform highp sampler2D u_tex;
+		void main()
+		{
+			AE_COLOR = u_color * AE_TEXTURE2D( u_tex, vec2( 0.0 ) );
+		}
+	)";
+
+	struct NullGraphicsScope
+	{
+		NullGraphicsScope() { ae::NullGraphics = true; ae::ResetGraphicsStats(); }
+		~NullGraphicsScope() { ae::NullGraphics = false; }
+	};
+}
+
+//------------------------------------------------------------------------------
+// ae::NullGraphics tests
+//------------------------------------------------------------------------------
+TEST_CASE( "null graphics shaders reflect declared uniforms", "[NullGraphics]" )
+{
+	NullGraphicsScope scope;
+	ae::Shader shader;
+	shader.Initialize( kVertexShader, kFragmentShader );
+	REQUIRE( shader.HasUniform( "u_worldToProj" ) );
+	REQUIRE( shader.HasUniform( "u_color" ) );
+	REQUIRE( shader.HasUniform( "u_tex" ) );
+	REQUIRE( !shader.HasUniform( "a_position" ) );
+	REQUIRE( !shader.HasUniform( "u_missing" ) );
+}
+
+TEST_CASE( "null graphics records draws, state changes and uploads", "[NullGraphics]" )
+{
+	NullGraphicsScope scope;
+	ae::Shader shader;
+	shader.Initialize( kVertexShader, kFragmentShader );
+	ae::Texture2D texture;
+	uint8_t pixels[ 4 * 4 * 4 ] = { 0 };
+	texture.Initialize( pixels, 4, 4, ae::Texture::Format::RGBA8, ae::Texture::Type::Uint8, ae::Texture::Filter::Nearest, ae::Texture::Wrap::Clamp, false );
+	REQUIRE( texture.GetTexture() );
+	REQUIRE( ae::GetGraphicsStats().uploadedBytes == sizeof(pixels) );
+
+	ae::VertexArray verts = AE_ALLOC_TAG_FIXME;
+	verts.Initialize( sizeof(ae::Vec3), 0, 6, 0, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Static );
+	verts.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, 0 );
+	const ae::Vec3 positions[] = { ae::Vec3( 0.0f ), ae::Vec3( 1.0f, 0.0f, 0.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) };
+	verts.SetVertices( positions, countof( positions ) );
+
+	ae::UniformList uniforms;
+	uniforms.Set( "u_worldToProj", ae::Matrix4::Identity() );
+	uniforms.Set( "u_color", ae::Vec4( 1.0f ) );
+	uniforms.Set( "u_tex", &texture );
+
+	ae::ResetGraphicsStats();
+	verts.Draw( &shader, uniforms );
+	verts.Draw( &shader, uniforms );
+	const ae::GraphicsStats& stats = ae::GetGraphicsStats();
+	REQUIRE( stats.drawCount == 2 );
+	REQUIRE( stats.primitiveCount == 2 );
+	REQUIRE( stats.bindCount == 2 );
+	REQUIRE( stats.shaderChangeCount <= 1 );
+	REQUIRE( stats.uniformUploadCount == 3 ); // Identical uniforms aren't re-sent
+	REQUIRE( stats.uploadedBytes == sizeof(positions) );
+
+	// Only the changed value is uploaded
+	uniforms.Set( "u_color", ae::Vec4( 0.5f ) );
+	verts.Draw( &shader, uniforms );
+	REQUIRE( stats.drawCount == 3 );
+	REQUIRE( stats.uniformUploadCount == 4 );
+}
+
+TEST_CASE( "null graphics command buffers skip redundant binds", "[NullGraphics]" )
+{
+	NullGraphicsScope scope;
+	ae::Shader shader;
+	shader.Initialize( kVertexShader, "void main() {}" );
+	ae::VertexArray verts = AE_ALLOC_TAG_FIXME;
+	verts.Initialize( sizeof(ae::Vec3), 0, 300, 0, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Static );
+	verts.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, 0 );
+	ae::Array< ae::Vec3 > positions( AE_ALLOC_TAG_FIXME, ae::Vec3( 0.0f ), 300 );
+	verts.SetVertices( positions.Data(), positions.Length() );
+
+	ae::UniformList uniforms[ 2 ];
+	uniforms[ 0 ].Set( "u_worldToProj", ae::Matrix4::Identity() );
+	uniforms[ 1 ].Set( "u_worldToProj", ae::Matrix4::Scaling( 2.0f ) );
+	ae::CommandBuffer commands = AE_ALLOC_TAG_FIXME;
+	for ( uint32_t i = 0; i < 100; i++ )
+	{
+		commands.Draw( 0, &verts, &shader, uniforms[ i % 2 ], i, 1 );
+	}
+	commands.Sort();
+
+	ae::ResetGraphicsStats();
+	commands.Submit();
+	REQUIRE( ae::GetGraphicsStats().drawCount == 100 );
+	REQUIRE( ae::GetGraphicsStats().bindCount == 2 );
+	REQUIRE( ae::GetGraphicsStats().uploadedBytes == positions.Length() * sizeof(ae::Vec3) );
+}
+
+TEST_CASE( "null graphics debug lines and text can be rendered", "[NullGraphics]" )
+{
+	NullGraphicsScope scope;
+	ae::DebugLines debugLines = AE_ALLOC_TAG_FIXME;
+	debugLines.Initialize( 64 );
+	debugLines.AddLine( ae::Vec3( 0.0f ), ae::Vec3( 1.0f ), ae::Color::Red() );
+	debugLines.Render( ae::Matrix4::Identity() );
+	REQUIRE( ae::GetGraphicsStats().drawCount == 2 ); // X-ray and regular passes
+
+	ae::Texture2D font;
+	font.Initialize( nullptr, 16, 16, ae::Texture::Format::R8, ae::Texture::Type::Uint8, ae::Texture::Filter::Nearest, ae::Texture::Wrap::Clamp, false );
+	ae::TextRender text = AE_ALLOC_TAG_FIXME;
+	text.Initialize( 4, 64, &font, 8, 1.0f );
+	text.Add( ae::Vec3( 0.0f ), ae::Vec2( 1.0f ), "hello", ae::Color::White(), 0, 0 );
+	text.Render( ae::Matrix4::Identity() );
+	REQUIRE( ae::GetGraphicsStats().drawCount == 3 );
+}
+
+TEST_CASE( "null graphics text layouts are cached between renders", "[NullGraphics]" )
+{
+	NullGraphicsScope scope;
+	ae::Texture2D font;
+	font.Initialize( nullptr, 16 * 8, 16 * 8, ae::Texture::Format::R8, ae::Texture::Type::Uint8, ae::Texture::Filter::Nearest, ae::Texture::Wrap::Clamp, false );
+	ae::TextRender text = AE_ALLOC_TAG_FIXME;
+	text.Initialize( 8, 64, &font, 8, 1.0f );
+	for ( uint32_t i = 0; i < 3; i++ )
+	{
+		text.Add( ae::Vec3( 0.0f ), ae::Vec2( 1.0f ), "hello world", ae::Color::White(), 0, 0 );
+		text.Add( ae::Vec3( 10.0f ), ae::Vec2( 2.0f ), "hello world", ae::Color::Red(), 0, 0 );
+		text.Add( ae::Vec3( 0.0f ), ae::Vec2( 1.0f ), "hello world", ae::Color::White(), 5, 0 );
+		text.Add( ae::Vec3( 0.0f ), ae::Vec2( 1.0f ), "hello world", ae::Color::White(), 0, 4 );
+		ae::ResetGraphicsStats();
+		text.Render( ae::Matrix4::Identity() );
+		REQUIRE( ae::GetGraphicsStats().drawCount == 1 );
+		REQUIRE( ae::GetGraphicsStats().primitiveCount == ( 10 + 10 + 10 + 4 ) * 2 );
+		REQUIRE( text.GetLayoutCount() == 3 ); // Position, size and color don't affect layout
+	}
+
+	// Layouts that are no longer used are eventually discarded
+	for ( uint32_t i = 0; i < 100; i++ )
+	{
+		const ae::Str32 str = ae::Str32::Format( "frame #", i );
+		text.Add( ae::Vec3( 0.0f ), ae::Vec2( 1.0f ), str.c_str(), ae::Color::White(), 0, 0 );
+		text.Render( ae::Matrix4::Identity() );
+	}
+	REQUIRE( text.GetLayoutCount() < 64 );
+}
+
+TEST_CASE( "null graphics debug shapes are drawn as instances", "[NullGraphics]" )
+{
+	NullGraphicsScope scope;
+	ae::DebugLines debugLines = AE_ALLOC_TAG_FIXME;
+	debugLines.Initialize( 16 );
+	debugLines.SetXRayEnabled( false );
+	for ( uint32_t i = 0; i < 100; i++ )
+	{
+		REQUIRE( debugLines.AddAABB( ae::Vec3( i ), ae::Vec3( 1.0f ), ae::Color::Red() ) == 24 );
+		REQUIRE( debugLines.AddSphere( ae::Vec3( i ), 1.0f, ae::Color::Blue(), 16 ) == 16 * 2 * 3 );
+		REQUIRE( debugLines.AddLine( ae::Vec3( 0.0f ), ae::Vec3( i ), ae::Color::Green() ) == 2 );
+	}
+	// Buffers grow past the initial size
+	REQUIRE( debugLines.GetVertexCount() == 100 * ( 24 + 96 + 2 ) );
+	ae::ResetGraphicsStats();
+	debugLines.Render( ae::Matrix4::Identity() );
+	REQUIRE( ae::GetGraphicsStats().drawCount == 3 ); // Lines, boxes and circles
+	REQUIRE( ae::GetGraphicsStats().primitiveCount == 100 * ( 12 + 48 + 1 ) );
+	REQUIRE( debugLines.GetVertexCount() == 0 );
+
+	// Fixed size when growing is disabled
+	debugLines.SetGrowEnabled( false );
+	REQUIRE( debugLines.AddLine( ae::Vec3( 0.0f ), ae::Vec3( 1.0f ), ae::Color::Green() ) == 2 );
+	REQUIRE( debugLines.AddAABB( ae::Vec3( 0.0f ), ae::Vec3( 1.0f ), ae::Color::Red() ) == 0 );
+	REQUIRE( debugLines.AddCircle( ae::Vec3( 0.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ), 1.0f, ae::Color::Red(), 7 ) == 14 );
+	REQUIRE( debugLines.GetVertexCount() == 16 );
+}
+
+TEST_CASE( "debug shape instance transforms match rotated points", "[NullGraphics]" )
+{
+	const ae::Vec3 normal = ae::Vec3( 1.0f, 2.0f, 3.0f ).SafeNormalizeCopy();
+	const ae::Quaternion rotation( normal, ae::Vec3( 0.0f, 0.0f, 1.0f ) );
+	const ae::Vec3 p( 0.3f, 0.0f, 0.7f );
+	const ae::Vec3 expected = rotation.Rotate( p ) * 2.0f + ae::Vec3( 1.0f, 2.0f, 3.0f );
+	const ae::Matrix4 transform = ae::Matrix4::Translation( ae::Vec3( 1.0f, 2.0f, 3.0f ) ) * rotation.GetTransformMatrix() * ae::Matrix4::Scaling( 2.0f );
+	const ae::Vec3 result = ( transform * ae::Vec4( p, 1.0f ) ).GetXYZ();
+	REQUIRE( result.x == Approx( expected.x ).margin( 0.0001f ) );
+	REQUIRE( result.y == Approx( expected.y ).margin( 0.0001f ) );
+	REQUIRE( result.z == Approx( expected.z ).margin( 0.0001f ) );
+}
@@ -148,3 +148,113 @@ TEST_CASE( "signal send should result in the correct functions being called", "[
     REQUIRE( signal.Length() == 0 );
   }
 }
+
+TEST_CASE( "signal send order and removal during send", "[aeSignal]" )
+{
+  aeSignalList< int > signal;
+  Thing things[ 3 ];
+  ae::Array< int > order = AE_ALLOC_TAG_FIXME;
+
+  SECTION( "delegates should be called in the order they were added" )
+  {
+    for ( int i = 0; i < 3; i++ )
+    {
+      signal.Add( &things[ i ], [ &order, i ](){ order.Append( i ); } );
+    }
+    signal.Send();
+    REQUIRE( order.Length() == 3 );
+    REQUIRE( order[ 0 ] == 0 );
+    REQUIRE( order[ 1 ] == 1 );
+    REQUIRE( order[ 2 ] == 2 );
+  }
+
+  SECTION( "lambdas taking a value should receive the sent value" )
+  {
+    signal.Add( &things[ 0 ], [ &order ]( int v ){ order.Append( v ); } );
+    signal.Send();
+    REQUIRE( order.Length() == 0 );
+    signal.Send( 5 );
+    REQUIRE( order.Length() == 1 );
+    REQUIRE( order[ 0 ] == 5 );
+  }
+
+  SECTION( "removing a later delegate during send should skip it" )
+  {
+    aeSignalList< int >* s = &signal;
+    Thing* t = things;
+    signal.Add( &things[ 0 ], [ s, t ](){ t[ 0 ].Fn(); s->Remove( &t[ 1 ] ); } );
+    signal.Add( &things[ 1 ], &Thing::Fn );
+    signal.Add( &things[ 2 ], &Thing::Fn );
+    signal.Send();
+    REQUIRE( things[ 0 ].callCount == 1 );
+    REQUIRE( things[ 1 ].callCount == 0 );
+    REQUIRE( things[ 2 ].callCount == 1 );
+    REQUIRE( signal.Length() == 2 );
+  }
+
+  SECTION( "removing the current delegate during send should be safe" )
+  {
+    aeSignalList< int >* s = &signal;
+    Thing* t = things;
+    signal.Add( &things[ 0 ], [ s, t ](){ t[ 0 ].Fn(); s->Remove( &t[ 0 ] ); } );
+    signal.Add( &things[ 1 ], &Thing::Fn );
+    signal.Send();
+    signal.Send();
+    REQUIRE( things[ 0 ].callCount == 1 );
+    REQUIRE( things[ 1 ].callCount == 2 );
+    REQUIRE( signal.Length() == 1 );
+  }
+
+  SECTION( "delegates added during send should not be called until the next send" )
+  {
+    aeSignalList< int >* s = &signal;
+    Thing* t = things;
+    signal.Add( &things[ 0 ], [ s, t ](){ t[ 0 ].Fn(); s->Add( &t[ 1 ], &Thing::Fn ); } );
+    signal.Send();
+    REQUIRE( things[ 1 ].callCount == 0 );
+    signal.Send();
+    REQUIRE( things[ 0 ].callCount == 2 );
+    REQUIRE( things[ 1 ].callCount == 1 );
+  }
+}
+
+//------------------------------------------------------------------------------
+// ae::Delegate tests
+//------------------------------------------------------------------------------
+TEST_CASE( "delegates should call bound functions", "[aeSignal]" )
+{
+  Thing thing;
+  REQUIRE( !ae::Delegate< int >() );
+  REQUIRE( !ae::Delegate< int >().Call() );
+
+  ae::Delegate< int > fn( &thing, &Thing::Fn );
+  REQUIRE( fn.GetObj() == &thing );
+  REQUIRE( fn.Call() );
+  REQUIRE( thing.val == 1 );
+
+  ae::Delegate< int > fnInt( &thing, &Thing::FnInt );
+  REQUIRE( !fnInt.Call() );
+  REQUIRE( fnInt.Call( 3 ) );
+  REQUIRE( thing.val == 3 );
+
+  Thing* thingP = ae::New< Thing >( AE_ALLOC_TAG_FIXME );
+  ae::Delegate< int > fnRef( aeRef< Thing >( thingP ), &Thing::FnInt );
+  REQUIRE( fnRef.Call( 4 ) );
+  REQUIRE( thingP->val == 4 );
+  ae::Delete( thingP );
+  REQUIRE( !fnRef.GetObj() );
+  REQUIRE( !fnRef.Call( 5 ) );
+}
+
+TEST_CASE( "refs should find their object after the refable sequence wraps", "[aeRef]" )
+{
+  Thing thing;
+  aeRefableSequence() = ~0u;
+  {
+    Thing other;
+  }
+  REQUIRE( aeRefableSequence() != 0 );
+  aeRef< Thing > thingRef( &thing );
+  REQUIRE( thingRef == &thing );
+  REQUIRE( !thingRef.Lost() );
+}
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+// SparseGridTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2021 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "ae/aeSparseGrid.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// aeSparseGrid tests
+//------------------------------------------------------------------------------
+TEST_CASE( "sparse grid values can be set and retrieved", "[aeSparseGrid]" )
+{
+  aeSparseGrid< aeSparseGridZone< int32_t, 4, 4, 1 > > pow2;
+  aeSparseGrid< aeSparseGridZone< int32_t, 3, 5, 1 > > other;
+  REQUIRE( !pow2.TryGet( ae::Int3( 0 ) ) );
+  REQUIRE( !other.TryGet( ae::Int3( 0 ) ) );
+
+  for ( int32_t y = -9; y <= 9; y++ )
+  {
+    for ( int32_t x = -9; x <= 9; x++ )
+    {
+      pow2.Set( ae::Int3( x, y, 0 ), x * 100 + y );
+      other.Set( ae::Int3( x, y, 0 ), x * 100 + y );
+    }
+  }
+  REQUIRE( pow2.Length() == 6 * 6 ); // -12 to 11 with zones of 4
+  REQUIRE( other.Length() == 7 * 4 ); // -9 to 11 with zones of 3, -10 to 9 with zones of 5
+
+  const auto& constPow2 = pow2;
+  const auto& constOther = other;
+  for ( int32_t y = -9; y <= 9; y++ )
+  {
+    for ( int32_t x = -9; x <= 9; x++ )
+    {
+      REQUIRE( *pow2.TryGet( ae::Int3( x, y, 0 ) ) == x * 100 + y );
+      REQUIRE( *other.TryGet( ae::Int3( x, y, 0 ) ) == x * 100 + y );
+      REQUIRE( *constPow2.TryGet( ae::Int3( x, y, 0 ) ) == x * 100 + y );
+      REQUIRE( *constOther.TryGet( ae::Int3( x, y, 0 ) ) == x * 100 + y );
+    }
+  }
+  REQUIRE( *pow2.TryGet( ae::Int3( -12, -12, 0 ) ) == 0 );
+  REQUIRE( !pow2.TryGet( ae::Int3( -13, 0, 0 ) ) );
+  REQUIRE( !pow2.TryGet( ae::Int3( 0, 0, 1 ) ) );
+
+  pow2.Clear();
+  REQUIRE( pow2.Length() == 0 );
+  REQUIRE( !pow2.TryGet( ae::Int3( 0 ) ) );
+}
+
+TEST_CASE( "sparse grid box iteration visits each existing cell once", "[aeSparseGrid]" )
+{
+  aeSparseGrid< aeSparseGridZone< int32_t, 4, 4, 1 > > grid;
+  grid.Set( ae::Int3( -3, -3, 0 ), 1 );
+  grid.Set( ae::Int3( 5, 2, 0 ), 2 );
+  grid.Set( ae::Int3( 20, 20, 0 ), 3 ); // Outside of box
+
+  uint32_t count = 0;
+  int32_t sum = 0;
+  grid.ForEachInBox( ae::Int3( -5, -5, 0 ), ae::Int3( 6, 6, 0 ), [&]( ae::Int3 pos, int32_t& value )
+  {
+    REQUIRE( *grid.TryGet( pos ) == value );
+    REQUIRE( pos.x >= -5 );
+    REQUIRE( pos.y >= -5 );
+    REQUIRE( pos.x <= 6 );
+    REQUIRE( pos.y <= 6 );
+    value += 10;
+    count++;
+    sum += value;
+  } );
+  // Only zones (-4,-4)-(-1,-1) and (4,0)-(7,3) exist within the box
+  REQUIRE( count == 4 * 4 + 3 * 4 );
+  REQUIRE( sum == 1 + 2 + 10 * (int32_t)count );
+  REQUIRE( *grid.TryGet( ae::Int3( -3, -3, 0 ) ) == 11 );
+
+  const auto& constGrid = grid;
+  count = 0;
+  constGrid.ForEachInBox( ae::Int3( 5, 2, 0 ), ae::Int3( 5, 2, 0 ), [&]( ae::Int3 pos, const int32_t& value )
+  {
+    REQUIRE( pos == ae::Int3( 5, 2, 0 ) );
+    REQUIRE( value == 12 );
+    count++;
+  } );
+  REQUIRE( count == 1 );
+}
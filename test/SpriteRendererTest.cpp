@@ -0,0 +1,319 @@
+//------------------------------------------------------------------------------
+// SpriteRendererTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2021 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "ae/SpriteRenderer.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// ae::SpriteBatcher tests
+//------------------------------------------------------------------------------
+TEST_CASE( "sprite sort keys order by group then depth", "[SpriteBatcher]" )
+{
+  using Batcher = ae::SpriteBatcher;
+  REQUIRE( Batcher::GetSortKey( 0, 1000.0f ) < Batcher::GetSortKey( 1, -1000.0f ) );
+  REQUIRE( Batcher::GetSortKey( 1, -2.0f ) < Batcher::GetSortKey( 1, -1.0f ) );
+  REQUIRE( Batcher::GetSortKey( 1, -1.0f ) < Batcher::GetSortKey( 1, 0.0f ) );
+  REQUIRE( Batcher::GetSortKey( 1, 0.0f ) < Batcher::GetSortKey( 1, 0.5f ) );
+  REQUIRE( Batcher::GetSortKey( 1, 0.5f ) < Batcher::GetSortKey( 1, 3.0f ) );
+}
+
+TEST_CASE( "sprite batcher merges sprites of the same group", "[SpriteBatcher]" )
+{
+  ae::SpriteBatcher batcher = AE_ALLOC_TAG_FIXME;
+  batcher.Sort();
+  REQUIRE( batcher.GetBatchCount() == 0 );
+
+  batcher.Add( 2, 0.0f ); // 0
+  batcher.Add( 0, 0.0f ); // 1
+  batcher.Add( 2, -1.0f ); // 2
+  batcher.Add( 0, 0.0f ); // 3
+  batcher.Add( 1, 5.0f ); // 4
+  batcher.Add( 0, -3.0f ); // 5
+  batcher.Sort();
+
+  REQUIRE( batcher.GetSpriteCount() == 6 );
+  const uint32_t expected[] = { 5, 1, 3, 4, 2, 0 };
+  for ( uint32_t i = 0; i < 6; i++ )
+  {
+    REQUIRE( batcher.GetSpriteIndex( i ) == expected[ i ] );
+  }
+
+  REQUIRE( batcher.GetBatchCount() == 3 );
+  REQUIRE( batcher.GetBatch( 0 ).group == 0 );
+  REQUIRE( batcher.GetBatch( 0 ).start == 0 );
+  REQUIRE( batcher.GetBatch( 0 ).count == 3 );
+  REQUIRE( batcher.GetBatch( 1 ).group == 1 );
+  REQUIRE( batcher.GetBatch( 1 ).start == 3 );
+  REQUIRE( batcher.GetBatch( 1 ).count == 1 );
+  REQUIRE( batcher.GetBatch( 2 ).group == 2 );
+  REQUIRE( batcher.GetBatch( 2 ).start == 4 );
+  REQUIRE( batcher.GetBatch( 2 ).count == 2 );
+
+  batcher.Clear();
+  REQUIRE( batcher.GetSpriteCount() == 0 );
+  batcher.Sort();
+  REQUIRE( batcher.GetBatchCount() == 0 );
+}
+
+TEST_CASE( "sprite batcher sorts large scenes into a few batches", "[SpriteBatcher]" )
+{
+  const uint32_t kCount = 10000;
+  const uint32_t kGroupCount = 4;
+  ae::SpriteBatcher batcher = AE_ALLOC_TAG_FIXME;
+  batcher.Reserve( kCount );
+  uint64_t seed = 1234;
+  for ( uint32_t i = 0; i < kCount; i++ )
+  {
+    batcher.Add( ae::Random( 0, (int32_t)kGroupCount, seed ), ae::Random( -10.0f, 10.0f, seed ) );
+  }
+  batcher.Sort();
+
+  REQUIRE( batcher.GetSpriteCount() == kCount );
+  REQUIRE( batcher.GetBatchCount() == kGroupCount );
+  uint32_t total = 0;
+  for ( uint32_t i = 0; i < batcher.GetBatchCount(); i++ )
+  {
+    REQUIRE( batcher.GetBatch( i ).group == i );
+    REQUIRE( batcher.GetBatch( i ).start == total );
+    total += batcher.GetBatch( i ).count;
+  }
+  REQUIRE( total == kCount );
+
+  // Every sprite appears exactly once
+  ae::Array< bool > seen( AE_ALLOC_TAG_FIXME, false, kCount );
+  for ( uint32_t i = 0; i < kCount; i++ )
+  {
+    uint32_t index = batcher.GetSpriteIndex( i );
+    REQUIRE( !seen[ index ] );
+    seen[ index ] = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+// ae::SpriteRenderer tests
+//------------------------------------------------------------------------------
+TEST_CASE( "sprite renderer draws each group once", "[SpriteRenderer]" )
+{
+  ae::NullGraphics = true;
+  {
+    const char* vertexShader = "AE_IN_HIGHP vec4 a_position; void main() { gl_Position = a_position; }";
+    const char* fragmentShader = "AE_UNIFORM sampler2D u_tex; void main() {}";
+    ae::Shader shader;
+    shader.Initialize( vertexShader, fragmentShader );
+    ae::Texture2D texture;
+    texture.Initialize( nullptr, 1, 1, ae::Texture::Format::RGBA8, ae::Texture::Type::Uint8, ae::Texture::Filter::Nearest, ae::Texture::Wrap::Clamp, false );
+    ae::UniformList uniforms;
+    uniforms.Set( "u_tex", &texture );
+
+    const uint32_t kCount = 10000;
+    const uint32_t kGroupCount = 3;
+    ae::SpriteRenderer spriteRenderer = AE_ALLOC_TAG_FIXME;
+    spriteRenderer.Initialize( kGroupCount, kCount );
+    for ( uint32_t i = 0; i < kCount; i++ )
+    {
+      const ae::Rect quad = ae::Rect::FromCenterAndSize( ae::Vec2( (float)i, 0.0f ), ae::Vec2( 1.0f ) );
+      spriteRenderer.AddSprite( i % kGroupCount, quad, ae::Rect::FromPoints( ae::Vec2( 0.0f ), ae::Vec2( 1.0f ) ), ae::Color::White() );
+    }
+    for ( uint32_t i = 0; i < kGroupCount; i++ )
+    {
+      spriteRenderer.SetParams( i, &shader, uniforms );
+    }
+
+    ae::ResetGraphicsStats();
+    spriteRenderer.Render();
+    REQUIRE( spriteRenderer.GetDrawCount() == kGroupCount );
+    REQUIRE( ae::GetGraphicsStats().drawCount == kGroupCount );
+    REQUIRE( ae::GetGraphicsStats().primitiveCount == kCount * 2 );
+    spriteRenderer.Terminate();
+  }
+  ae::NullGraphics = false;
+}
+
+//------------------------------------------------------------------------------
+// ae::AtlasPacker tests
+//------------------------------------------------------------------------------
+static bool AtlasRectsOverlap( ae::RectInt a, ae::RectInt b )
+{
+  const ae::Int2 aMin = a.GetPos();
+  const ae::Int2 aMax = aMin + a.GetSize();
+  const ae::Int2 bMin = b.GetPos();
+  const ae::Int2 bMax = bMin + b.GetSize();
+  return aMin.x < bMax.x && bMin.x < aMax.x && aMin.y < bMax.y && bMin.y < aMax.y;
+}
+
+TEST_CASE( "atlas packer fills the atlas exactly", "[AtlasPacker]" )
+{
+  ae::AtlasPacker atlas = AE_ALLOC_TAG_FIXME;
+  atlas.Initialize( 64, 64, 0 );
+  ae::Array< uint32_t > ids = AE_ALLOC_TAG_FIXME;
+  for ( uint32_t i = 0; i < 16; i++ )
+  {
+    const uint32_t id = atlas.Insert( 16, 16 );
+    REQUIRE( id );
+    ids.Append( id );
+  }
+  REQUIRE( atlas.Insert( 16, 16 ) == 0 );
+  REQUIRE( atlas.Insert( 1, 1 ) == 0 );
+  REQUIRE( atlas.GetCount() == 16 );
+  REQUIRE( atlas.GetUsedArea() == 64 * 64 );
+  for ( uint32_t i = 0; i < ids.Length(); i++ )
+  {
+    const ae::RectInt rect = atlas.GetRect( ids[ i ] );
+    REQUIRE( rect.GetSize() == ae::Int2( 16 ) );
+    REQUIRE( rect.GetPos().x >= 0 );
+    REQUIRE( rect.GetPos().y >= 0 );
+    REQUIRE( rect.GetPos().x + 16 <= 64 );
+    REQUIRE( rect.GetPos().y + 16 <= 64 );
+    for ( uint32_t j = 0; j < i; j++ )
+    {
+      REQUIRE( !AtlasRectsOverlap( rect, atlas.GetRect( ids[ j ] ) ) );
+    }
+  }
+
+  // Removed space is reused
+  const ae::RectInt removedRect = atlas.GetRect( ids[ 5 ] );
+  atlas.Remove( ids[ 5 ] );
+  const uint32_t id = atlas.Insert( 16, 16 );
+  REQUIRE( id );
+  REQUIRE( atlas.GetRect( id ).GetPos() == removedRect.GetPos() );
+
+  atlas.Clear();
+  REQUIRE( atlas.GetCount() == 0 );
+  REQUIRE( atlas.Insert( 64, 64 ) );
+}
+
+TEST_CASE( "atlas packer combines removed space", "[AtlasPacker]" )
+{
+  ae::AtlasPacker atlas = AE_ALLOC_TAG_FIXME;
+  atlas.Initialize( 64, 64, 0 );
+  uint32_t ids[ 4 ];
+  for ( uint32_t i = 0; i < 4; i++ )
+  {
+    ids[ i ] = atlas.Insert( 32, 32 );
+    REQUIRE( ids[ i ] );
+  }
+  REQUIRE( atlas.Insert( 64, 32 ) == 0 );
+
+  // Remove two entries next to each other so their space can be combined
+  uint32_t a = 0, b = 0;
+  for ( uint32_t i = 0; i < 4 && !b; i++ )
+  {
+    for ( uint32_t j = i + 1; j < 4; j++ )
+    {
+      if ( atlas.GetRect( ids[ i ] ).GetPos().y == atlas.GetRect( ids[ j ] ).GetPos().y )
+      {
+        a = ids[ i ];
+        b = ids[ j ];
+        break;
+      }
+    }
+  }
+  REQUIRE( b );
+  atlas.Remove( a );
+  REQUIRE( atlas.Insert( 64, 32 ) == 0 );
+  atlas.Remove( b );
+  const uint32_t wide = atlas.Insert( 64, 32 );
+  REQUIRE( wide );
+  REQUIRE( atlas.GetRect( wide ).GetPos().x == 0 );
+}
+
+TEST_CASE( "atlas packer padding, borders and alignment", "[AtlasPacker]" )
+{
+  ae::AtlasPacker atlas = AE_ALLOC_TAG_FIXME;
+  atlas.Initialize( 128, 64, 1, 2, 8 );
+  const uint32_t id0 = atlas.Insert( 10, 5 );
+  const uint32_t id1 = atlas.Insert( 3, 3 );
+  REQUIRE( id0 );
+  REQUIRE( id1 );
+  for ( uint32_t id : { id0, id1 } )
+  {
+    const ae::RectInt rect = atlas.GetRect( id );
+    const ae::RectInt borderRect = atlas.GetBorderRect( id );
+    REQUIRE( borderRect.GetPos().x % 8 == 0 );
+    REQUIRE( borderRect.GetPos().y % 8 == 0 );
+    REQUIRE( rect.GetPos() == borderRect.GetPos() + ae::Int2( 2 ) );
+    REQUIRE( borderRect.GetSize() == rect.GetSize() + ae::Int2( 4 ) );
+
+    const ae::Rect uvs = atlas.GetUVs( id );
+    const ae::Vec2 size( 128.0f, 64.0f );
+    REQUIRE( uvs.GetMin() == ae::Vec2( rect.GetPos() ) / size );
+    REQUIRE( uvs.GetMax() == ae::Vec2( rect.GetPos() + rect.GetSize() ) / size );
+  }
+  // 10 + 2 * 2 border + 1 padding rounded up to the 8 texel alignment
+  REQUIRE( atlas.GetUsedArea() == 16 * 16 + 8 * 8 );
+
+  // Padding of entries on the edges may hang off the atlas
+  atlas.Clear();
+  REQUIRE( atlas.Insert( 124, 60 ) );
+}
+
+TEST_CASE( "atlas packer random inserts and removes never overlap", "[AtlasPacker]" )
+{
+  ae::AtlasPacker atlas = AE_ALLOC_TAG_FIXME;
+  atlas.Initialize( 256, 256, 1, 1 );
+  ae::Array< uint32_t > ids = AE_ALLOC_TAG_FIXME;
+  uint64_t seed = 1234;
+  uint32_t insertCount = 0;
+  for ( uint32_t i = 0; i < 2000; i++ )
+  {
+    if ( ids.Length() && ae::Random( 0, 3, seed ) == 0 )
+    {
+      const uint32_t index = ae::Random( 0, (int32_t)ids.Length(), seed );
+      atlas.Remove( ids[ index ] );
+      ids.Remove( index );
+    }
+    else if ( const uint32_t id = atlas.Insert( ae::Random( 1, 40, seed ), ae::Random( 1, 40, seed ) ) )
+    {
+      ids.Append( id );
+      insertCount++;
+    }
+  }
+  REQUIRE( insertCount > 200 );
+  REQUIRE( atlas.GetCount() == ids.Length() );
+  for ( uint32_t i = 0; i < ids.Length(); i++ )
+  {
+    const ae::RectInt rect = atlas.GetBorderRect( ids[ i ] );
+    REQUIRE( rect.GetPos().x >= 0 );
+    REQUIRE( rect.GetPos().y >= 0 );
+    REQUIRE( rect.GetPos().x + rect.GetSize().x <= 256 );
+    REQUIRE( rect.GetPos().y + rect.GetSize().y <= 256 );
+    // Grow by the padding so neighbors must be at least one texel apart
+    const ae::RectInt padded = ae::RectInt::FromPointAndSize( rect.GetPos(), rect.GetSize() + ae::Int2( 1 ) );
+    for ( uint32_t j = 0; j < ids.Length(); j++ )
+    {
+      if ( i != j )
+      {
+        REQUIRE( !AtlasRectsOverlap( padded, atlas.GetBorderRect( ids[ j ] ) ) );
+      }
+    }
+  }
+  while ( ids.Length() )
+  {
+    atlas.Remove( ids[ ids.Length() - 1 ] );
+    ids.Remove( ids.Length() - 1 );
+  }
+  REQUIRE( atlas.GetUsedArea() == 0 );
+  REQUIRE( atlas.Insert( 254, 254 ) );
+}
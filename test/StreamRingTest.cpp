@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+// StreamRingTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// ae::StreamRing tests
+//------------------------------------------------------------------------------
+TEST_CASE( "stream ring regions wrap once released", "[StreamRing]" )
+{
+	ae::StreamRing ring;
+	ring.Initialize( 30 );
+	uint32_t offset = ~0;
+	REQUIRE( ring.Begin( 10, 0, &offset ) );
+	REQUIRE( offset == 0 );
+	REQUIRE( ring.GetRetiredCount() == 0 );
+	REQUIRE( ring.Begin( 10, 1, &offset ) );
+	REQUIRE( offset == 10 );
+	REQUIRE( ring.Begin( 10, 2, &offset ) );
+	REQUIRE( offset == 20 );
+	REQUIRE( ring.GetRetiredCount() == 2 );
+	REQUIRE( ring.GetRetiredFence( 0 ) == 1 );
+	REQUIRE( ring.GetRetiredFence( 1 ) == 2 );
+
+	// Full until the oldest region is released
+	REQUIRE( !ring.Begin( 5, 3, &offset ) );
+	REQUIRE( ring.GetRetiredCount() == 2 );
+	REQUIRE( ring.GetOffset() == 20 );
+	ring.Release();
+	REQUIRE( ring.Begin( 5, 3, &offset ) );
+	REQUIRE( offset == 0 );
+	REQUIRE( ring.GetRetiredCount() == 2 );
+	REQUIRE( ring.GetRetiredFence( 0 ) == 2 );
+	REQUIRE( ring.GetRetiredFence( 1 ) == 3 );
+
+	// Wrapped regions can only grow up to the oldest region
+	REQUIRE( ring.Extend( 5 ) );
+	REQUIRE( ring.GetCount() == 10 );
+	REQUIRE( !ring.Extend( 1 ) );
+	REQUIRE( !ring.Begin( 1, 4, &offset ) );
+	ring.Release();
+	REQUIRE( ring.Begin( 1, 4, &offset ) );
+	REQUIRE( offset == 10 );
+}
+
+TEST_CASE( "stream ring limits retired regions", "[StreamRing]" )
+{
+	ae::StreamRing ring;
+	ring.Initialize( 1000 );
+	const uint32_t maxRegions = ae::StreamRing::kMaxRegions;
+	for ( uint32_t i = 0; i <= maxRegions; i++ )
+	{
+		REQUIRE( ring.Begin( 1, i, nullptr ) );
+	}
+	REQUIRE( ring.GetRetiredCount() == maxRegions );
+	REQUIRE( !ring.Begin( 1, 100, nullptr ) );
+	ring.Release();
+	REQUIRE( ring.Begin( 1, 100, nullptr ) );
+	REQUIRE( ring.GetOffset() == maxRegions + 1 );
+}
+
+TEST_CASE( "dynamic vertex arrays only upload appended vertices", "[StreamRing]" )
+{
+	ae::NullGraphics = true;
+	ae::ResetGraphicsStats();
+	const ae::GraphicsStats& stats = ae::GetGraphicsStats();
+	{
+		ae::VertexArray verts = AE_ALLOC_TAG_FIXME;
+		verts.Initialize( sizeof(ae::Vec3), sizeof(uint16_t), 64, 96, ae::Vertex::Primitive::Triangle, ae::Vertex::Usage::Dynamic, ae::Vertex::Usage::Dynamic );
+		verts.AddAttribute( "a_position", 3, ae::Vertex::Type::Float, 0 );
+		const ae::Vec3 positions[] = { ae::Vec3( 0.0f ), ae::Vec3( 1.0f, 0.0f, 0.0f ), ae::Vec3( 0.0f, 1.0f, 0.0f ) };
+		const uint16_t indices[] = { 0, 1, 2 };
+		for ( uint32_t i = 0; i < 20; i++ )
+		{
+			verts.AppendIndices( indices, countof( indices ), verts.GetVertexCount() );
+			verts.AppendVertices( positions, countof( positions ) );
+			verts.Upload();
+		}
+		REQUIRE( verts.GetVertexCount() == 60 );
+		REQUIRE( stats.uploadedBytes == 20 * ( sizeof(positions) + sizeof(indices) ) );
+
+		// Uploads from the start keep streaming without waiting
+		for ( uint32_t i = 0; i < 100; i++ )
+		{
+			verts.ClearVertices();
+			verts.ClearIndices();
+			verts.AppendIndices( indices, countof( indices ), 0 );
+			verts.AppendVertices( positions, countof( positions ) );
+			verts.Upload();
+		}
+		REQUIRE( stats.uploadedBytes == 120 * ( sizeof(positions) + sizeof(indices) ) );
+		REQUIRE( stats.streamWaitCount == 0 );
+	}
+	ae::NullGraphics = false;
+}
@@ -25,6 +25,7 @@
 //------------------------------------------------------------------------------
 #include "aether.h"
 #include "catch2/catch.hpp"
+#include <cfloat>
 
 #if _AE_WINDOWS_
 	// @NOTE: Disable a few warnings caused by catch2 that should not affect correctness
@@ -259,3 +260,240 @@ TEST_CASE( "FromString fail", "[aeString]" )
 	REQUIRE( ae::FromString( ".", false ) == false );
 	REQUIRE( ae::FromString( ".", true ) == true );
 }
+
+TEST_CASE( "Float formatting matches printf", "[aeString]" )
+{
+	uint64_t seed = 4321;
+	auto check = []( double value )
+	{
+		char expected[ 512 ];
+		char result[ 512 ];
+		for ( uint32_t precision : { 0u, 1u, 3u, 4u, 6u, 9u } )
+		{
+			snprintf( expected, sizeof(expected), "%.*f", precision, value );
+			REQUIRE( ae::FormatFloatFixed( result, sizeof(result), value, precision ) == strlen( expected ) );
+			REQUIRE( std::string( result ) == expected );
+			snprintf( expected, sizeof(expected), "%.*g", precision, value );
+			REQUIRE( ae::FormatFloatGeneral( result, sizeof(result), value, precision ) == strlen( expected ) );
+			REQUIRE( std::string( result ) == expected );
+		}
+	};
+	for ( double value : { 0.0, -0.0, 0.0625, 0.5, 1.5, 2.5, -2.5, 9.9995, 9.99951, 99999.5, 0.0001, 0.00001, 1e15, 1e30, 1e-30, 123456789.0, (double)FLT_MAX, (double)FLT_MIN, DBL_MAX, (double)INFINITY, -(double)INFINITY, (double)NAN } )
+	{
+		check( value );
+	}
+	for ( uint32_t i = 0; i < 20000; i++ )
+	{
+		const float scale = powf( 10.0f, (float)ae::Random( -8, 12, seed ) );
+		const float value = ae::Random( -1.0f, 1.0f, seed ) * scale;
+		check( value );
+		check( value * 1.0000001 );
+	}
+}
+
+TEST_CASE( "Str::Format matches std::ostream", "[aeString]" )
+{
+	uint64_t seed = 8765;
+	for ( uint32_t i = 0; i < 10000; i++ )
+	{
+		const float value = ae::Random( -1.0f, 1.0f, seed ) * powf( 10.0f, (float)ae::Random( -8, 12, seed ) );
+		const int64_t integer = (int64_t)( value * 1000.0f );
+		std::ostringstream stream;
+		stream << std::setprecision( 4 ) << value << " " << integer << " " << (uint16_t)i;
+		REQUIRE( ae::Str128::Format( "# # #", value, integer, (uint16_t)i ) == stream.str().c_str() );
+	}
+	REQUIRE( ae::Str128::Format( "#", ae::Vec3( 1.0f, -0.5f, 123456.0f ) ) == "1 -0.5 1.235e+05" );
+	REQUIRE( ae::Str128::Format( "# #", ae::Int2( -3, 4 ), true ) == "-3 4 true" );
+	REQUIRE( ae::Str128::Format( "#", (uint8_t)'a' ) == "a" );
+}
+
+TEST_CASE( "FormatTo writes into a caller buffer", "[aeString]" )
+{
+	static_assert( ae::GetFormatArgCount( "# and #" ) == 2, "" );
+	static_assert( ae::GetFormatArgCount( "none" ) == 0, "" );
+
+	char buf[ 16 ];
+	REQUIRE( ae::FormatTo( buf, sizeof(buf), "#: #", "pos", ae::Vec2( 1.5f, 2.0f ) ) == 10 );
+	REQUIRE( strcmp( buf, "pos: 1.5 2" ) == 0 );
+	REQUIRE( ae::FormatTo( buf, sizeof(buf), "# #", ae::Str16( "abc" ), std::string( "def" ) ) == 7 );
+	REQUIRE( strcmp( buf, "abc def" ) == 0 );
+
+	// Truncated but null terminated, returning the full length
+	REQUIRE( ae::FormatTo( buf, 8, "value: #", 123456 ) == 13 );
+	REQUIRE( strcmp( buf, "value: " ) == 0 );
+	REQUIRE( ae::FormatTo( buf, 0, "#", 1 ) == 1 );
+
+	REQUIRE( ae::Str256::Format( "#", ae::Matrix4::Scaling( 2.0f ) ) == "2 0 0 0 0 2 0 0 0 0 2 0 0 0 0 1" );
+	// Types without a fast path use their std::ostream operator
+	const ae::AABB aabb( ae::Vec3( 0.0f ), ae::Vec3( 1.0f ) );
+	std::ostringstream stream;
+	stream << std::setprecision( 4 ) << aabb;
+	REQUIRE( ae::Str256::Format( "#", aabb ) == stream.str().c_str() );
+
+	ae::Str64 str = "a";
+	str += ae::Str16( "-#-", 5 );
+	REQUIRE( str == "a-5-" );
+	REQUIRE( ae::Str64::Format( "no args #" ) == "no args #" );
+}
+
+TEST_CASE( "Number parsing matches strtod", "[aeString]" )
+{
+	uint64_t seed = 2468;
+	char str[ 64 ];
+	for ( uint32_t i = 0; i < 20000; i++ )
+	{
+		const float value = ae::Random( -1.0f, 1.0f, seed ) * powf( 10.0f, (float)ae::Random( -10, 12, seed ) );
+		for ( const char* format : { "%.3f", "%.9g", "%.17g", "  %e" } )
+		{
+			snprintf( str, sizeof(str), format, value );
+			const char* end = nullptr;
+			char* expectedEnd = nullptr;
+			const float f = ae::ParseFloat( str, &end );
+			REQUIRE( f == strtof( str, &expectedEnd ) );
+			REQUIRE( end == expectedEnd );
+			const double d = ae::ParseDouble( str, &end );
+			REQUIRE( d == strtod( str, &expectedEnd ) );
+			REQUIRE( end == expectedEnd );
+		}
+	}
+	for ( const char* s : { "", "-", ".", "1e", "1e+", " 12abc", "-0", "0x1p3", "inf", "-nan", "1.5e400", "1e-400", "00012.5000", "123456789012345678901234" } )
+	{
+		const char* end = nullptr;
+		char* expectedEnd = nullptr;
+		const double expected = strtod( s, &expectedEnd );
+		const double d = ae::ParseDouble( s, &end );
+		REQUIRE( end == expectedEnd );
+		REQUIRE( ( d == expected || ( std::isnan( d ) && std::isnan( expected ) ) ) );
+		REQUIRE( std::signbit( d ) == std::signbit( expected ) );
+	}
+	for ( const char* s : { "0", "-12", "+7", " 42x", "0x1F", "017", "09", "-9223372036854775809", "99999999999999999999", "x" } )
+	{
+		for ( uint32_t base : { 0u, 10u, 16u } )
+		{
+			const char* end = nullptr;
+			char* expectedEnd = nullptr;
+			REQUIRE( ae::ParseInt( s, &end, base ) == strtoll( s, &expectedEnd, base ) );
+			REQUIRE( end == expectedEnd );
+			REQUIRE( ae::ParseUint( s, &end, base ) == strtoull( s, &expectedEnd, base ) );
+			REQUIRE( end == expectedEnd );
+		}
+	}
+}
+
+TEST_CASE( "Float parsing matches strtof near float midpoints", "[aeString]" )
+{
+	// Rounding to double first and then to float gives the wrong result for
+	// some of these, so doubles that land exactly on a midpoint aren't used
+	REQUIRE( ae::ParseFloat( "1.000001847743988" ) == strtof( "1.000001847743988", nullptr ) );
+	REQUIRE( ae::ParseFloat( "4.298708290662034e-06" ) == strtof( "4.298708290662034e-06", nullptr ) );
+	REQUIRE( ae::ParseFloat( "82.53351211547852" ) == strtof( "82.53351211547852", nullptr ) );
+	uint64_t seed = 1357;
+	char str[ 64 ];
+	for ( uint32_t i = 0; i < 20000; i++ )
+	{
+		const float value = ae::Random( 0.0f, 1.0f, seed ) * powf( 10.0f, (float)ae::Random( -8, 9, seed ) );
+		const double midpoint = ( (double)value + (double)nextafterf( value, INFINITY ) ) * 0.5;
+		for ( const char* format : { "%.9g", "%.12g", "%.15g", "%.16g", "%.17g", "-%.16g" } )
+		{
+			snprintf( str, sizeof(str), format, midpoint );
+			const char* end = nullptr;
+			char* expectedEnd = nullptr;
+			REQUIRE( ae::ParseFloat( str, &end ) == strtof( str, &expectedEnd ) );
+			REQUIRE( end == expectedEnd );
+		}
+	}
+}
+
+TEST_CASE( "String stores short strings inline", "[aeString]" )
+{
+	ae::String str( AE_ALLOC_TAG_FIXME );
+	REQUIRE( str.Empty() );
+	REQUIRE( str == "" );
+	REQUIRE( str.Size() == ae::String::kMaxInlineLength );
+	str = "123456789012345";
+	REQUIRE( str.Length() == ae::String::kMaxInlineLength );
+	REQUIRE( str.Size() == ae::String::kMaxInlineLength );
+	str += "6";
+	REQUIRE( str.Length() == 16 );
+	REQUIRE( str.Size() > ae::String::kMaxInlineLength );
+	REQUIRE( str == "1234567890123456" );
+	REQUIRE( str.GetHash() == ae::GetHash( "1234567890123456" ) );
+	REQUIRE( str.GetTag() == AE_ALLOC_TAG_FIXME );
+	REQUIRE( sizeof(ae::String) <= sizeof(std::string) );
+
+	str.Clear();
+	REQUIRE( str.Empty() );
+	REQUIRE( str.Size() > ae::String::kMaxInlineLength ); // Memory is kept
+
+	// Non-ASCII characters hash the same as const char* and ae::Name
+	const char* cafe = "caf\xc3\xa9"; // UTF-8 "café"
+	str = cafe;
+	REQUIRE( str.GetHash() == ae::GetHash( cafe ) );
+	REQUIRE( str.GetHash() == ae::Name( cafe ).GetHash() );
+	str = "caf";
+	str += "\xc3\xa9";
+	REQUIRE( str == cafe );
+	REQUIRE( str.GetHash() == ae::GetHash( cafe ) );
+	str += " \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e"; // UTF-8 " 日本語 日本語"
+	REQUIRE( str.Length() > ae::String::kMaxInlineLength );
+	REQUIRE( str.GetHash() == ae::GetHash( str.c_str() ) );
+}
+
+TEST_CASE( "String copy, move and append", "[aeString]" )
+{
+	const char* longStr = "a string that is too long to be stored inline";
+	ae::String a( AE_ALLOC_TAG_FIXME, longStr );
+	ae::String b = a;
+	REQUIRE( b == a );
+	REQUIRE( b.c_str() != a.c_str() );
+	REQUIRE( b.GetTag() == a.GetTag() );
+
+	const char* data = a.c_str();
+	ae::String c = std::move( a );
+	REQUIRE( c.c_str() == data ); // Heap memory is moved
+	REQUIRE( c == longStr );
+	REQUIRE( a.Empty() );
+
+	ae::String d = "short";
+	ae::String e = std::move( d );
+	REQUIRE( e == "short" );
+
+	c += c;
+	REQUIRE( c.Length() == 2 * strlen( longStr ) );
+	REQUIRE( strncmp( c.c_str() + strlen( longStr ), longStr, strlen( longStr ) ) == 0 );
+	c = c.c_str() + 2;
+	REQUIRE( c.Length() == 2 * strlen( longStr ) - 2 );
+	REQUIRE( c[ 0 ] == 's' );
+}
+
+TEST_CASE( "String ae::Str interop", "[aeString]" )
+{
+	ae::Str32 fixed = "fixed";
+	ae::String str = fixed;
+	REQUIRE( str == fixed );
+	REQUIRE( str == "fixed" );
+	REQUIRE( "fixed" == str );
+	str += ae::Str16( " #", 5 );
+	REQUIRE( str.ToStr< 16 >() == "fixed 5" );
+	REQUIRE( str != fixed );
+	REQUIRE( ae::Str64::Format( "<#>", str ) == "<fixed 5>" );
+	REQUIRE( ae::String( "a" ) < ae::String( "b" ) );
+}
+
+TEST_CASE( "String hash is cached and used as a map key", "[aeString]" )
+{
+	ae::String str = "key";
+	REQUIRE( str.GetHash() == ae::GetHash( "key" ) );
+	REQUIRE( ae::GetHash( str ) == str.GetHash() );
+	str += "s";
+	REQUIRE( str.GetHash() == ae::GetHash( "keys" ) );
+
+	ae::Map< ae::String, int32_t > map = AE_ALLOC_TAG_FIXME;
+	map.Set( "one", 1 );
+	map.Set( ae::String( AE_ALLOC_TAG_FIXME, "a key that is longer than the inline storage" ), 2 );
+	REQUIRE( map.Get( "one" ) == 1 );
+	REQUIRE( map.Get( "a key that is longer than the inline storage" ) == 2 );
+	REQUIRE( map.Remove( "one" ) );
+	REQUIRE( map.Get( "a key that is longer than the inline storage" ) == 2 );
+	REQUIRE( !map.TryGet( "two" ) );
+}
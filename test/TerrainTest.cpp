@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+// TerrainTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2021 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "ae/aeTerrain.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// ae::Terrain tests
+//------------------------------------------------------------------------------
+TEST_CASE( "terrain only renders chunks inside the frustum", "[Terrain]" )
+{
+  ae::NullGraphics = true;
+  ae::Terrain* terrain = ae::New< ae::Terrain >( AE_ALLOC_TAG_FIXME );
+  terrain->Initialize( 0, true );
+  // Flat slab so only chunks near z=0 have vertices
+  ae::SdfBox* box = terrain->sdf.CreateSdf< ae::SdfBox >();
+  box->SetTransform( ae::Matrix4::Scaling( ae::Vec3( 200.0f, 200.0f, 10.0f ) ) );
+  // Without worker threads each update generates one chunk
+  for ( uint32_t i = 0; i < 500; i++ )
+  {
+    terrain->Update( ae::Vec3( 0.0f ), 60.0f );
+  }
+
+  ae::Shader shader;
+  shader.Initialize( "void main() {}", "void main() {}" );
+  ae::UniformList uniforms;
+  ae::ResetGraphicsStats();
+  terrain->Render( &shader, uniforms );
+  const uint32_t loadedCount = terrain->GetRenderedChunkCount();
+  REQUIRE( loadedCount > 8 );
+  REQUIRE( terrain->GetRenderPageCount() == 1 );
+  REQUIRE( ae::GetGraphicsStats().bindCount == 1 );
+  REQUIRE( ae::GetGraphicsStats().drawCount <= loadedCount );
+
+  // Looking down +x from the origin only sees about a quarter of the chunks
+  const ae::Vec3 viewPos( 0.0f, 0.0f, 5.0f );
+  const ae::Matrix4 worldToView = ae::Matrix4::WorldToView( viewPos, ae::Vec3( 1.0f, 0.0f, 0.0f ), ae::Vec3( 0.0f, 0.0f, 1.0f ) );
+  const ae::Matrix4 viewToProj = ae::Matrix4::ViewToProjection( 0.5f, 1.0f, 0.5f, 1000.0f );
+  ae::ResetGraphicsStats();
+  terrain->Render( &shader, uniforms, ae::Frustum( viewToProj * worldToView ), viewPos );
+  const uint32_t visibleCount = terrain->GetRenderedChunkCount();
+  REQUIRE( visibleCount > 0 );
+  REQUIRE( visibleCount < loadedCount / 2 );
+  REQUIRE( ae::GetGraphicsStats().bindCount == 1 );
+  REQUIRE( ae::GetGraphicsStats().drawCount <= visibleCount );
+
+  terrain->Terminate();
+  ae::Delete( terrain );
+  ae::NullGraphics = false;
+}
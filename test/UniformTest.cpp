@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// UniformTest.cpp
+//------------------------------------------------------------------------------
+// Copyright (c) 2020 John Hughes
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//------------------------------------------------------------------------------
+// Headers
+//------------------------------------------------------------------------------
+#include "aether.h"
+#include "catch2/catch.hpp"
+
+//------------------------------------------------------------------------------
+// ae::UniformId tests
+//------------------------------------------------------------------------------
+TEST_CASE( "uniform ids are shared by name", "[UniformId]" )
+{
+	ae::UniformId invalid;
+	REQUIRE( !invalid );
+	REQUIRE( invalid.GetName() == "" );
+
+	ae::UniformId a = "u_testA";
+	ae::UniformId b = "u_testB";
+	REQUIRE( a );
+	REQUIRE( b );
+	REQUIRE( a != b );
+	REQUIRE( a == ae::UniformId( "u_testA" ) );
+	REQUIRE( a.GetName() == "u_testA" );
+	REQUIRE( b.GetName() == "u_testB" );
+}
+
+//------------------------------------------------------------------------------
+// ae::UniformList tests
+//------------------------------------------------------------------------------
+TEST_CASE( "uniform list values can be set by id or name", "[UniformList]" )
+{
+	const ae::UniformId u_scale = "u_scale";
+	const ae::UniformId u_color = "u_color";
+	const ae::UniformId u_unset = "u_unset";
+
+	ae::UniformList uniforms;
+	uniforms.Set( u_scale, 2.0f );
+	uniforms.Set( "u_color", ae::Vec4( 1.0f, 2.0f, 3.0f, 4.0f ) );
+	REQUIRE( !uniforms.Get( u_unset ) );
+
+	const ae::UniformList::Value* scale = uniforms.Get( "u_scale" );
+	REQUIRE( scale );
+	REQUIRE( scale == uniforms.Get( u_scale ) );
+	REQUIRE( scale->size == 1 );
+	REQUIRE( scale->value.data[ 0 ] == 2.0f );
+
+	const ae::UniformList::Value* color = uniforms.Get( u_color );
+	REQUIRE( color );
+	REQUIRE( color->size == 4 );
+	REQUIRE( color->value.data[ 3 ] == 4.0f );
+
+	// Replacing a value keeps a single entry
+	uniforms.Set( u_scale, ae::Vec2( 3.0f, 4.0f ) );
+	scale = uniforms.Get( u_scale );
+	REQUIRE( scale->size == 2 );
+	REQUIRE( scale->value.data[ 1 ] == 4.0f );
+}
+
+TEST_CASE( "uniform list hash changes when values change", "[UniformList]" )
+{
+	const ae::UniformId u_scale = "u_scale";
+	ae::UniformList a;
+	ae::UniformList b;
+	a.Set( u_scale, 1.0f );
+	b.Set( "u_scale", 1.0f );
+	REQUIRE( a.GetHash() == b.GetHash() );
+	b.Set( u_scale, 2.0f );
+	REQUIRE( a.GetHash() != b.GetHash() );
+}